@@ -0,0 +1,195 @@
+/*
+ * Compression.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef COMPRESSION_H_
+#define COMPRESSION_H_
+
+#include <Definition.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+/*
+ * Optional gzip and zstd support for the exporters and importers. Define HAVE_ZLIB and/or HAVE_ZSTD and link with zlib and/or libzstd
+ * to enable them, without them only uncompressed files can be written and read.
+ * The Visual Studio and Xcode projects define HAVE_ZLIB and link with zlib, HAVE_ZSTD has to be added where libzstd is available.
+ */
+
+/*
+ * Size of the buffer compressed data is collected in before it's written
+ */
+
+#define COMPRESSION_BUFFER_SIZE (1 << 18)
+
+#define COMPRESSION_GZIP_LEVEL 6
+#define COMPRESSION_ZSTD_LEVEL 3
+
+namespace Helix {
+	/*
+	 * Compression: The supported formats. The format of a file that is written is selected by its extension, ".gz" or ".zst",
+	 * while files that are read are identified by their contents. Does not depend on Maya.
+	 */
+
+	class VHELIXAPI Compression {
+	public:
+		enum Format {
+			kNone,
+			kGzip,
+			kZstd
+		};
+
+		static Format FromFilename(const char *filename);
+
+		/*
+		 * Whether the format was enabled when building, kNone always is
+		 */
+
+		static bool IsSupported(Format format);
+
+		static const char *Name(Format format);
+
+		/*
+		 * Read the whole file into buffer, decompressing it if it's compressed. Returns false if the file could not be read
+		 * or is compressed in an unsupported format
+		 */
+
+		static bool ReadFile(const char *filename, std::vector<char> & buffer);
+
+		/*
+		 * Identify the format from the first bytes of a file
+		 */
+
+		static Format FromMagic(const char *data, size_t length);
+	};
+
+	/*
+	 * InputFile: A file read in chunks and decompressed while it is read, so that compressed files never have to fit in memory.
+	 * The format is identified by the contents of the file
+	 */
+
+	class VHELIXAPI InputFile {
+	public:
+		InputFile();
+		~InputFile();
+
+		/*
+		 * Returns false if the file can not be opened or is compressed in an unsupported format
+		 */
+
+		bool open(const char *filename);
+
+		/*
+		 * Read up to length bytes of decompressed data. Returns the number of bytes read, 0 at the end of the file or if the file
+		 * can't be read, see good()
+		 */
+
+		size_t read(char *data, size_t length);
+
+		/*
+		 * Start over from the beginning of the file. Compressed files can't be seeked in, so this is the only way back
+		 */
+
+		bool rewind();
+
+		void close();
+
+		inline bool isOpen() const {
+			return m_file != NULL;
+		}
+
+		/*
+		 * False if reading failed or the compressed data was corrupt or truncated
+		 */
+
+		inline bool good() const {
+			return m_good;
+		}
+
+		inline Compression::Format format() const {
+			return m_format;
+		}
+
+		/*
+		 * Bytes of decompressed data read so far
+		 */
+
+		inline unsigned long long position() const {
+			return m_position;
+		}
+
+	private:
+		InputFile(const InputFile &);
+		InputFile & operator=(const InputFile &);
+
+		bool fill();
+
+		FILE *m_file;
+		void *m_stream; // z_stream or ZSTD_DCtx.
+		Compression::Format m_format;
+		std::vector<char> m_input;
+		size_t m_inputBegin, m_inputEnd; // Compressed data read but not yet decompressed.
+		unsigned long long m_position;
+		bool m_good, m_end, m_frameComplete; // Frame complete: The last zstd frame has been fully decompressed.
+	};
+
+	/*
+	 * OutputFile: A file written in the format selected by its filename. Uncompressed files are written in text mode like std::ofstream does
+	 */
+
+	class VHELIXAPI OutputFile {
+	public:
+		OutputFile();
+		~OutputFile();
+
+		/*
+		 * Returns false if the file can not be created or its format is not supported
+		 */
+
+		bool open(const char *filename);
+
+		bool write(const char *data, size_t length);
+
+		/*
+		 * Finish the compressed stream and close the file. Returns false if anything failed to be written
+		 */
+
+		bool close();
+
+		inline bool isOpen() const {
+			return m_file != NULL;
+		}
+
+		inline Compression::Format format() const {
+			return m_format;
+		}
+
+		/*
+		 * Bytes written to the file so far, after compression
+		 */
+
+		inline unsigned long long bytesWritten() const {
+			return m_bytesWritten;
+		}
+
+	private:
+		OutputFile(const OutputFile &);
+		OutputFile & operator=(const OutputFile &);
+
+		bool compress(const char *data, size_t length, bool finish);
+		bool writeOutput(size_t length);
+
+		FILE *m_file;
+		void *m_stream; // z_stream or ZSTD_CCtx.
+		Compression::Format m_format;
+		std::vector<char> m_output;
+		unsigned long long m_bytesWritten;
+		bool m_good;
+	};
+}
+
+#endif /* COMPRESSION_H_ */
@@ -64,6 +64,10 @@ namespace DNA {
 
 	MStatus CalculateBasePairPositions(double index, MVector & forward, MVector & backward, double offset = 0.0, double totalNumBases = 0);
 
+	// Same as above but without any Maya types, for code that must run outside of the main thread or without a scene
+
+	void CalculateBasePairPositions(double index, double forward[3], double backward[3], double offset = 0.0, double totalNumBases = 0);
+
 	/*
 	 * A small API for managing the DNA enumerations
 	 */
@@ -28,6 +28,15 @@
 #pragma warning( disable : 4251 )
 #endif /* _MSC_VER */
 
+/*
+ * The C++11 standard library (threads, atomics, chrono). Visual Studio always has it, the Xcode project targets the old libstdc++
+ * that doesn't. Without it, Parallel.h and the export pipeline run everything on the calling thread
+ */
+
+#if !defined(HAVE_CXX11) && (defined(_MSC_VER) || __cplusplus >= 201103L)
+#define HAVE_CXX11
+#endif /* N HAVE_CXX11 */
+
 #include <iostream>
 
 /*
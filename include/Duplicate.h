@@ -41,11 +41,7 @@ namespace Helix {
 		static void *creator();
 
 	private:
-		class DuplicateWithProgressBar : public Controller::Duplicate {
-			void onProgressStart(unsigned int process, unsigned int range);
-			void onProgressStep();
-			void onProgressDone();
-		} m_operation;
+		Controller::Duplicate m_operation;
 	};
 }
 
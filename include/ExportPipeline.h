@@ -0,0 +1,176 @@
+/*
+ * ExportPipeline.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef EXPORTPIPELINE_H_
+#define EXPORTPIPELINE_H_
+
+#include <Definition.h>
+#include <TextWriter.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_CXX11
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif /* HAVE_CXX11 */
+
+/*
+ * Number of items (strands) formatted together by one worker
+ */
+
+#define EXPORT_CHUNK_SIZE 16
+
+/*
+ * Number of formatted chunks per worker that may wait for the writer before the workers stop, limits the memory used
+ */
+
+#define EXPORT_CHUNKS_PER_THREAD 4
+
+/*
+ * The export pipeline: the exporters capture everything from Maya on the main thread, the formatting of the captured items
+ * is then done by ParallelFormat. Items are formatted in chunks by a pool of workers into memory buffers, while the calling thread
+ * writes the finished buffers in their original order, so the output is identical to formatting everything serially.
+ *
+ * Like ParallelFor, the formatters must not call the Maya API. Without HAVE_CXX11 the items are formatted directly into the output.
+ */
+
+namespace Helix {
+#ifdef HAVE_CXX11
+	template<typename FormatterT>
+	class ParallelFormatState {
+	public:
+		inline ParallelFormatState(TextWriter & output, size_t count, FormatterT & formatter, size_t chunkSize, size_t window) :
+				m_output(output), m_formatter(formatter), m_count(count), m_chunkSize(chunkSize), m_numChunks((count + chunkSize - 1) / chunkSize),
+				m_window(window), m_next(0), m_written(0), m_buffers(window), m_ready(window, false) {
+
+		}
+
+		/*
+		 * Run by every worker thread
+		 */
+
+		void work() {
+			TextWriter buffer(m_output.format(), m_output.precision());
+
+			for (size_t chunk = m_next++; chunk < m_numChunks; chunk = m_next++) {
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+
+					while (chunk >= m_written + m_window)
+						m_condition.wait(lock);
+				}
+
+				const size_t end = std::min(m_count, (chunk + 1) * m_chunkSize);
+
+				for (size_t i = chunk * m_chunkSize; i < end; ++i)
+					m_formatter(i, buffer);
+
+				std::lock_guard<std::mutex> lock(m_mutex);
+				buffer.swap(m_buffers[chunk % m_window]);
+				buffer.clear();
+				m_ready[chunk % m_window] = true;
+				m_condition.notify_all();
+			}
+		}
+
+		/*
+		 * Run by the calling thread, writes the chunks in order as they become ready
+		 */
+
+		void write() {
+			std::string data;
+
+			for (size_t chunk = 0; chunk < m_numChunks; ++chunk) {
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+
+					while (!m_ready[chunk % m_window])
+						m_condition.wait(lock);
+
+					data.swap(m_buffers[chunk % m_window]);
+					m_ready[chunk % m_window] = false;
+					m_written = chunk + 1;
+					m_condition.notify_all();
+				}
+
+				m_output.write(data.data(), data.size());
+				data.clear();
+			}
+		}
+
+	private:
+		TextWriter & m_output;
+		FormatterT & m_formatter;
+		const size_t m_count, m_chunkSize, m_numChunks, m_window;
+		std::atomic<size_t> m_next;
+		size_t m_written;
+		std::vector<std::string> m_buffers;
+		std::vector<bool> m_ready;
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+	};
+
+	template<typename FormatterT>
+	class ParallelFormatWorker {
+	public:
+		inline ParallelFormatWorker(ParallelFormatState<FormatterT> & state) : m_state(state) {
+
+		}
+
+		inline void operator() () {
+			m_state.work();
+		}
+
+	private:
+		ParallelFormatState<FormatterT> & m_state;
+	};
+#endif /* HAVE_CXX11 */
+
+	/*
+	 * Calls formatter(i, buffer) for every i in [0, count) and writes the buffers to output in order. Returns output.good()
+	 */
+
+	template<typename FormatterT>
+	bool ParallelFormat(TextWriter & output, size_t count, FormatterT & formatter, size_t chunkSize = EXPORT_CHUNK_SIZE) {
+#ifdef HAVE_CXX11
+		const size_t numChunks = (count + chunkSize - 1) / chunkSize;
+		const size_t numThreads = std::min(numChunks, size_t(std::max(1u, std::thread::hardware_concurrency())));
+#else
+		const size_t numThreads = 1;
+		(void) chunkSize;
+#endif /* N HAVE_CXX11 */
+
+		if (numThreads <= 1) {
+			for (size_t i = 0; i < count; ++i)
+				formatter(i, output);
+
+			return output.good();
+		}
+
+#ifdef HAVE_CXX11
+		ParallelFormatState<FormatterT> state(output, count, formatter, chunkSize, numThreads * EXPORT_CHUNKS_PER_THREAD);
+		std::vector<std::thread> threads;
+		threads.reserve(numThreads);
+
+		for (size_t i = 0; i < numThreads; ++i)
+			threads.push_back(std::thread(ParallelFormatWorker<FormatterT>(state)));
+
+		state.write();
+
+		for (std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it)
+			it->join();
+#endif /* HAVE_CXX11 */
+
+		return output.good();
+	}
+}
+
+#endif /* EXPORTPIPELINE_H_ */
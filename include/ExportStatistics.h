@@ -0,0 +1,110 @@
+/*
+ * ExportStatistics.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef EXPORTSTATISTICS_H_
+#define EXPORTSTATISTICS_H_
+
+#include <Definition.h>
+#include <TextWriter.h>
+
+#include <cstddef>
+#include <string>
+
+/*
+ * ExportStatistics: Where the time of an export went, filled in by the exporters given one. Every phase is measured without the phases
+ * entered from within it, so the phases add up to the time of the export:
+ *  - traversal: Walking the strands and looking them up in the strand index and cache.
+ *  - capture: Reading the helices and bases from the scene.
+ *  - materials: Finding the materials and colors of the bases.
+ *  - layout: Arranging the captured data (caDNAno lattice).
+ *  - format: Formatting the text, on the worker threads of the export pipeline.
+ *  - write: Compressing and writing to the file.
+ *
+ * Does not depend on Maya.
+ */
+
+namespace Helix {
+	class VHELIXAPI ExportStatistics {
+	public:
+		enum Phase {
+			kTraversal,
+			kCapture,
+			kMaterials,
+			kLayout,
+			kFormat,
+			kWrite,
+			kNumPhases
+		};
+
+		std::string exporter, filename;
+		double seconds[kNumPhases];
+		size_t helices, strands, bases, reused; // Reused: Strands taken from the cache of a previous export.
+		unsigned long long bytes; // Written to the files, after compression.
+
+		ExportStatistics(const char *exporter = "");
+
+		static const char *PhaseName(Phase phase);
+
+		double totalSeconds() const;
+
+		/*
+		 * Switch to phase, the time since the previous switch goes to the current phase. Returns the current phase, pass it to leave()
+		 */
+
+		Phase enter(Phase phase);
+		void leave(Phase previous);
+
+		/*
+		 * Count the bytes of a closed file, and move the time it spent writing from the phase it was written in to kWrite
+		 */
+
+		void addFile(const TextWriter & file, Phase writtenIn);
+
+		/*
+		 * Human readable multi line report
+		 */
+
+		std::string str() const;
+
+		/*
+		 * The report as a JSON object, for tracking export performance over time
+		 */
+
+		void writeJSON(TextWriter & output) const;
+		bool writeReport(const char *filename) const;
+
+	private:
+		Phase m_current;
+		double m_since;
+	};
+
+	/*
+	 * Attributes the time it exists to a phase of the statistics, if there are any
+	 */
+
+	class ExportPhaseTimer {
+	public:
+		inline ExportPhaseTimer(ExportStatistics *statistics, ExportStatistics::Phase phase) : m_statistics(statistics), m_previous(ExportStatistics::kNumPhases) {
+			if (m_statistics)
+				m_previous = m_statistics->enter(phase);
+		}
+
+		inline ~ExportPhaseTimer() {
+			if (m_statistics)
+				m_statistics->leave(m_previous);
+		}
+
+	private:
+		ExportPhaseTimer(const ExportPhaseTimer &);
+		ExportPhaseTimer & operator=(const ExportPhaseTimer &);
+
+		ExportStatistics *m_statistics;
+		ExportStatistics::Phase m_previous;
+	};
+}
+
+#endif /* EXPORTSTATISTICS_H_ */
@@ -11,6 +11,12 @@
 /*
  * Command for exporting the strand sequences of the target, selected or all helices
  * The result will be passed out as an MStringArray
+ *
+ * -t <base or helix> (multi use), -f <filename> skips the file dialog, -format comma|colon|csv|plate and -maxLength <n> skips strands longer than n bases,
+ * such as the scaffold
+ * -full true recaptures every strand instead of reusing the strands that haven't changed since the previous export
+ * -stats times the phases of the export and returns them and the counters instead of the strands, as "name=value" strings
+ * -report <filename> writes the same as JSON, see ExportStatistics
  */
 
 #include <Definition.h>
@@ -28,6 +28,12 @@ namespace Helix {
 		// Standard utility metods
 		//
 
+		/*
+		 * Any change to the helix is reported to the ChangeTracker, the world space translations of its bases depend on its transform
+		 */
+
+		virtual MStatus setDependentsDirty(const MPlug &plug, MPlugArray &plugArray);
+
 		static void *creator();
 		static MStatus initialize();
 
@@ -22,11 +22,16 @@ namespace Helix {
 		friend void MNodeMessage_preRemovalCallbackFunc(MObject & node, void *clientData);
 		friend void MModelMessage_removedFromModelCallbackFunc(MObject & node, void *clientData);
 		friend void MModelMessage_addedToModelCallbackFunc(MObject & node, void *clientData);
+		friend class RepairConstraints;
 	public:
 		HelixBase();
 		virtual ~HelixBase();
 
-		//virtual void postConstructor();
+		/*
+		 * Bases created while a file is read are queued for RepairConstraints
+		 */
+
+		virtual void postConstructor();
 
 		/*
 		 * Here we listen to connect/disconnect events on the forward and backward connections.
@@ -37,6 +42,13 @@ namespace Helix {
 		//MStatus connectionMade(const MPlug &plug, const MPlug &otherPlug, bool asSrc);
 		//MStatus connectionBroken(const MPlug &plug, const MPlug &otherPlug, bool asSrc);
 
+		/*
+		 * Translations of the base are forwarded to the HelixEndIndex, as the end bases of the helix are sorted by their Z coordinate
+		 * Translations and label changes are reported to the ChangeTracker. A translation also reevaluates the aimConstraints of a queued base
+		 */
+
+		virtual MStatus setDependentsDirty(const MPlug &plug, MPlugArray &plugArray);
+
 		static void *creator();
 		static MStatus initialize();
 
@@ -49,6 +61,7 @@ namespace Helix {
 		static MObject aForward, aBackward, aLabel;
 
 	private:
+		bool m_constraintsPending;
 		
 
 		/*
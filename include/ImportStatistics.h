@@ -0,0 +1,63 @@
+/*
+ * ImportStatistics.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef IMPORTSTATISTICS_H_
+#define IMPORTSTATISTICS_H_
+
+#include <Definition.h>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Rough number of bases per second the importers create in the scene, only used for the estimated build time of a dry run
+ */
+
+#define IMPORT_ESTIMATED_BASES_PER_SECOND 2000.0
+
+/*
+ * Only the first dangling references are described in the report, the rest are only counted
+ */
+
+#define IMPORT_MAX_DANGLING_DESCRIPTIONS 20
+
+/*
+ * ImportStatistics: What an importer would create from a file, filled in by the DryRun methods of the importers from their parse and plan stages.
+ * Strands are counted before any automatic nicking. Does not depend on Maya.
+ */
+
+namespace Helix {
+	class VHELIXAPI ImportStatistics {
+	public:
+		size_t helices, bases, strands, crossovers, danglingReferences;
+		std::vector<std::string> dangling; // Descriptions of the first dangling references.
+
+		inline ImportStatistics() : helices(0), bases(0), strands(0), crossovers(0), danglingReferences(0) {}
+
+		void addDangling(const std::string & description);
+
+		inline double estimatedBuildSeconds() const {
+			return double(bases) / IMPORT_ESTIMATED_BASES_PER_SECOND;
+		}
+
+		/*
+		 * Human readable multi line report
+		 */
+
+		std::string str() const;
+
+		/*
+		 * Count the strands formed by `count` bases joined by the given forward connections (from, to). Circular strands are counted as well
+		 */
+
+		static size_t CountStrands(size_t count, const std::vector< std::pair<unsigned int, unsigned int> > & connections);
+	};
+}
+
+#endif /* IMPORTSTATISTICS_H_ */
@@ -0,0 +1,37 @@
+/*
+ * MeshTranslator.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef MESHTRANSLATOR_H_
+#define MESHTRANSLATOR_H_
+
+#include <Definition.h>
+
+#include <maya/MPxFileTranslator.h>
+
+#include <controller/MeshExporter.h>
+
+#define HELIX_MESH_FILE_DESCRIPTION "vHelix mesh (glTF, OBJ, PLY)"
+
+namespace Helix {
+	/*
+	 * Export only, writes the bases and helix cylinders as instanced meshes with the MeshExporter. The extension selects the format
+	 */
+
+	class MeshTranslator : public MPxFileTranslator {
+	public:
+		virtual MStatus writer (const MFileObject& file, const MString& optionsString, MPxFileTranslator::FileAccessMode mode);
+		virtual bool haveWriteMethod () const;
+		virtual bool haveReadMethod () const;
+		virtual bool canBeOpened () const;
+		virtual MString defaultExtension () const;
+		virtual MPxFileTranslator::MFileKind identifyFile (	const MFileObject& file, const char *buffer, short size) const;
+
+		static void *creator();
+	};
+}
+
+#endif /* MESHTRANSLATOR_H_ */
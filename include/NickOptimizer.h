@@ -0,0 +1,105 @@
+/*
+ * NickOptimizer.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef NICKOPTIMIZER_H_
+#define NICKOPTIMIZER_H_
+
+#include <Definition.h>
+
+#include <cstddef>
+#include <vector>
+
+/*
+ * Default distance in bases a nick should keep from a crossover
+ */
+
+#define NICK_CROSSOVER_DISTANCE 3
+
+/*
+ * NickOptimizer: Decides where to nick (break) long staple strands. Strands are described only by their length, the offsets where
+ * nicking is allowed and the offsets of their crossovers, thus the optimizer does not depend on Maya and can be run headless
+ * or on several threads. Writing the nicks back into the scene is up to the caller, see Controller::NickStrands.
+ *
+ * A nick at offset i separates base i - 1 from base i, i.e. it is a disconnect_backward on base i. For circular strands offset 0
+ * separates the last and first base.
+ *
+ * Nick sites are chosen by dynamic programming over the allowed offsets, minimizing the squared deviation of every staple from the
+ * target length plus a penalty for every nick closer than crossoverDistance to a crossover, under the constraint that all staples
+ * are within [minLength, maxLength]. If there is no such solution, the strand is cut into equally long pieces as close as the allowed
+ * offsets permit and the result is marked as not feasible. Linear strands that are not longer than maxLength are left as they are.
+ */
+
+namespace Helix {
+	class VHELIXAPI NickOptimizer {
+	public:
+		struct Options {
+			unsigned int minLength, maxLength, targetLength, crossoverDistance;
+			double crossoverPenalty;
+
+			/*
+			 * targetLength defaults to the middle of the allowed interval
+			 */
+
+			inline Options(unsigned int minLength, unsigned int maxLength, unsigned int targetLength = 0, unsigned int crossoverDistance = NICK_CROSSOVER_DISTANCE) :
+				minLength(minLength), maxLength(maxLength), targetLength(targetLength > 0 ? targetLength : (minLength + maxLength) / 2), crossoverDistance(crossoverDistance), crossoverPenalty(double(maxLength) * double(maxLength)) {}
+		};
+
+		struct Strand {
+			unsigned int length;
+			bool circular;
+			std::vector<unsigned int> sites; // Sorted offsets where a nick is allowed. If empty, every offset is allowed.
+			std::vector<unsigned int> crossovers; // Sorted offsets i where base i - 1 and base i are on different helices.
+
+			inline Strand(unsigned int length = 0, bool circular = false) : length(length), circular(circular) {}
+		};
+
+		struct Result {
+			std::vector<unsigned int> nicks; // Sorted offsets to nick at.
+			bool feasible;
+
+			inline Result() : feasible(true) {}
+		};
+
+		inline NickOptimizer(const Options & options) : m_options(options) {}
+
+		void optimize(const Strand & strand, Result & result) const;
+
+		/*
+		 * Strands are independent of each other and are optimized in parallel. Returns the number of strands that could not be nicked within the constraints
+		 */
+
+		size_t optimize(const std::vector<Strand> & strands, std::vector<Result> & results) const;
+
+		inline const Options & options() const {
+			return m_options;
+		}
+
+	private:
+		/*
+		 * Solve for a linear strand of the given length where `positions` are the allowed offsets, including 0 and length as the strand ends.
+		 * Returns false if the constraints can not be met. `cost` is set to the total cost of the solution
+		 */
+
+		bool solveLinear(const std::vector<unsigned int> & positions, const std::vector<double> & penalties, std::vector<unsigned int> & nicks, double & cost) const;
+
+		void optimizeLinear(const Strand & strand, const std::vector<unsigned int> & sites, Result & result) const;
+		void optimizeCircular(const Strand & strand, const std::vector<unsigned int> & sites, Result & result) const;
+
+		/*
+		 * When there is no feasible solution, place `count` nicks at the sites closest to equally spaced offsets
+		 */
+
+		void fallback(const Strand & strand, const std::vector<unsigned int> & sites, unsigned int count, Result & result) const;
+
+		double lengthCost(unsigned int length) const;
+		double sitePenalty(const Strand & strand, unsigned int offset) const;
+
+		Options m_options;
+	};
+}
+
+#endif /* NICKOPTIMIZER_H_ */
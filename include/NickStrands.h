@@ -0,0 +1,45 @@
+/*
+ * NickStrands.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef NICKSTRANDS_H_
+#define NICKSTRANDS_H_
+
+/*
+ * Command for nicking long strands into staples within a length interval, avoiding nicks close to crossovers.
+ * Works on the strands of the given or selected bases, see NickOptimizer for how the nick sites are chosen
+ */
+
+#include <Definition.h>
+
+#include <controller/Disconnect.h>
+#include <controller/PaintStrand.h>
+
+#include <maya/MPxCommand.h>
+
+#define MEL_NICKSTRANDS_COMMAND "nickStrands"
+
+namespace Helix {
+	class VHELIXAPI NickStrands : public MPxCommand {
+	public:
+		virtual ~NickStrands();
+
+		virtual MStatus doIt(const MArgList & args);
+		virtual MStatus undoIt();
+		virtual MStatus redoIt();
+		virtual bool isUndoable() const;
+		virtual bool hasSyntax() const;
+
+		static MSyntax newSyntax();
+		static void *creator();
+
+	private:
+		Controller::Disconnect m_operation;
+		Controller::PaintMultipleStrandsWithNewColorFunctor m_functor;
+	};
+}
+
+#endif /* NICKSTRANDS_H_ */
@@ -0,0 +1,87 @@
+/*
+ * NucleotideTemplate.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef NUCLEOTIDETEMPLATE_H_
+#define NUCLEOTIDETEMPLATE_H_
+
+#include <Definition.h>
+
+#include <cstddef>
+
+/*
+ * The largest nucleotide (guanosine) has 22 heavy atoms
+ */
+
+#define NUCLEOTIDE_MAX_ATOMS 22
+
+/*
+ * P, OP1 and OP2 are the first atoms of every template, they're left out of the 5' end of a strand
+ */
+
+#define NUCLEOTIDE_PHOSPHATE_ATOMS 3
+
+namespace Helix {
+	/*
+	 * NucleotideTemplate: The heavy atoms of an idealized B-DNA nucleotide, for writing all-atom structures. The bases are the standard
+	 * reference frames of Olson et al. (2001) as used by 3DNA, the sugar-phosphate backbone is C2'-endo with standard bond lengths and angles
+	 * and closes to the phosphate of the next nucleotide with the twist and rise of vHelix.
+	 *
+	 * The atoms are stored relative to a base frame: The origin is on the helix axis in the plane of the base pair, the radial axis points
+	 * towards the backbone of the base as placed by vHelix and the axial axis along the helix in the 5' to 3' direction of the strand.
+	 * The coordinates are in Ångström and kept as separate arrays so that transform() vectorizes.
+	 *
+	 * Does not depend on Maya.
+	 */
+
+	class VHELIXAPI NucleotideTemplate {
+	public:
+		/*
+		 * base is A, T, G or C, anything else gives a T like the oxDNA export. baseAngle is the angle in degrees from the dyad axis of the base pair
+		 * to the radial axis, half the angle between the two bases of a pair (DNA::OPPOSITE_ROTATION / 2)
+		 */
+
+		NucleotideTemplate(char base, double baseAngle);
+
+		/*
+		 * DA, DT, DG or DC
+		 */
+
+		inline const char *residueName() const {
+			return m_residueName;
+		}
+
+		inline size_t size() const {
+			return m_size;
+		}
+
+		/*
+		 * PDB atom name, such as "C1'"
+		 */
+
+		inline const char *atomName(size_t atom) const {
+			return m_names[atom];
+		}
+
+		inline char element(size_t atom) const {
+			return m_names[atom][0];
+		}
+
+		/*
+		 * Place all atoms in a base frame. radial and axial are unit vectors, origin is in Ångström. Writes size() coordinates to x, y and z
+		 */
+
+		void transform(const double origin[3], const double radial[3], const double axial[3], double *x, double *y, double *z) const;
+
+	private:
+		double m_radial[NUCLEOTIDE_MAX_ATOMS], m_tangential[NUCLEOTIDE_MAX_ATOMS], m_axial[NUCLEOTIDE_MAX_ATOMS];
+		const char *m_names[NUCLEOTIDE_MAX_ATOMS];
+		const char *m_residueName;
+		size_t m_size;
+	};
+}
+
+#endif /* NUCLEOTIDETEMPLATE_H_ */
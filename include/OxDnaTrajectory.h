@@ -0,0 +1,105 @@
+/*
+ * OxDnaTrajectory.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef OXDNATRAJECTORY_H_
+#define OXDNATRAJECTORY_H_
+
+/*
+ * Command for playing back oxDNA trajectories on the bases of an imported oxDNA structure.
+ * Importing a configuration file with more than one frame attaches it automatically, another trajectory can be attached with -file.
+ * Frames are read on demand through the frame index of Controller::OxDnaTrajectory, either when the time slider changes (-followTime, on by default),
+ * explicitly with -frame, or all of them as keyframes with -keyframe. The number of frames of the attached trajectory is returned as the result.
+ * Moving the bases with -frame and keyframing them with -keyframe can be undone, keyframing again reuses the curves of the previous time
+ */
+
+#include <Definition.h>
+
+#include <controller/OxDnaTrajectory.h>
+#include <model/Base.h>
+
+#include <vector>
+
+#include <maya/MPxCommand.h>
+#include <maya/MAnimCurveChange.h>
+#include <maya/MDGModifier.h>
+#include <maya/MDagPath.h>
+#include <maya/MMatrix.h>
+#include <maya/MTime.h>
+#include <maya/MVector.h>
+
+#define MEL_OXDNATRAJECTORY_COMMAND "oxDnaTrajectory"
+
+namespace Helix {
+	class VHELIXAPI OxDnaTrajectory : public MPxCommand {
+	public:
+		OxDnaTrajectory();
+		virtual ~OxDnaTrajectory();
+
+		virtual MStatus doIt(const MArgList & args);
+		virtual MStatus undoIt();
+		virtual MStatus redoIt();
+		virtual bool isUndoable() const;
+		virtual bool hasSyntax() const;
+
+		static MSyntax newSyntax();
+		static void *creator();
+
+		/*
+		 * Attach the trajectory to the given bases, indexed by nucleotide id. The transforms of the helices are cached, thus attach again if they are moved
+		 */
+
+		static MStatus Load(const char *filename, const std::vector<Model::Base> & bases);
+		static void Unload();
+
+		/*
+		 * Move the bases to the positions of the given frame
+		 */
+
+		static MStatus ShowFrame(size_t frame);
+
+		/*
+		 * Set translation keyframes on all bases for every frame, frame 0 being placed at startFrame. Curves that don't exist yet are created
+		 * through modifier, and the keys are recorded in change, for undo
+		 */
+
+		static MStatus Keyframe(MDGModifier & modifier, MAnimCurveChange & change);
+
+		/*
+		 * Registered in main.cpp
+		 */
+
+		static void MDGMessage_TimeChange_CallbackFunc(MTime & time, void *clientData);
+		static void MSceneMessage_Unload_CallbackFunc(void *clientData);
+
+	private:
+		static MStatus CreateKeys(MDGModifier & modifier, MAnimCurveChange & change);
+		static MStatus GetTranslations(const std::vector<MDagPath> & bases, std::vector<MVector> & translations);
+		static MStatus SetTranslations(const std::vector<MDagPath> & bases, const std::vector<MVector> & translations);
+
+		/*
+		 * For undo: The bases moved by -frame, before and after, and the curves and keys created by -keyframe
+		 */
+
+		std::vector<MDagPath> m_bases;
+		std::vector<MVector> m_previousTranslations, m_translations;
+		long m_previousFrame, m_frame;
+		MDGModifier m_curveModifier;
+		MAnimCurveChange m_curveChange;
+		bool m_previousFollowTime, m_moved, m_keyframed;
+
+		static Controller::OxDnaTrajectory *s_trajectory; // NULL if no trajectory is attached.
+		static std::vector<MDagPath> s_bases;
+		static std::vector<unsigned int> s_parents; // Index into s_parentInverseMatrices for every base.
+		static std::vector<MMatrix> s_parentInverseMatrices;
+		static std::vector<double> s_translations;
+		static int s_startFrame;
+		static long s_currentFrame;
+		static bool s_followTime;
+	};
+}
+
+#endif /* OXDNATRAJECTORY_H_ */
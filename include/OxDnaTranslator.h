@@ -4,10 +4,16 @@
 #include <Definition.h>
 
 #include <maya/MDagPath.h>
+#include <maya/MObjectArray.h>
+#include <maya/MProgressWindow.h>
 #include <maya/MPxFileTranslator.h>
+#include <maya/MVector.h>
 
+#include <model/Strand.h>
 #include <controller/OxDnaExporter.h>
 
+#include <list>
+
 #define HELIX_OXDNA_FILE_TYPE	"oxDNA " HELIX_OXDNA_TOP_FILE_TYPE ", " HELIX_OXDNA_CONF_FILE_TYPE
 
 namespace Helix {
@@ -22,6 +28,27 @@ namespace Helix {
 		virtual MPxFileTranslator::MFileKind identifyFile (	const MFileObject& file, const char *buffer, short size) const;
 
 		static void *creator();
+
+		/*
+		 * Every strand passing through the bases of the helices, once each. If given, the bounds of the world translations of the bases
+		 * are returned as well. Shows the progress per helix with the given title. Shared with the PdbTranslator
+		 */
+
+		static MStatus CollectStrands(const MObjectArray & helices, const MString & title, std::list<Model::Strand> & strands, MVector *minTranslation = NULL, MVector *maxTranslation = NULL);
+	};
+
+	/*
+	 * Advances the progress window for every captured strand
+	 */
+
+	template<typename ExporterT>
+	class ExporterWithAdvanceProgress : public ExporterT {
+	protected:
+
+		MStatus doExecute(Model::Strand & element) {
+			MProgressWindow::advanceProgress(1);
+			return ExporterT::doExecute(element);
+		}
 	};
 }
 
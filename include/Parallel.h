@@ -0,0 +1,84 @@
+/*
+ * Parallel.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <Definition.h>
+
+#include <algorithm>
+#include <vector>
+
+#ifdef HAVE_CXX11
+#include <atomic>
+#include <thread>
+#endif /* HAVE_CXX11 */
+
+/*
+ * Helpers for running Maya independent work on several threads. Never call the Maya API from the functors, it is not thread safe
+ */
+
+namespace Helix {
+	/*
+	 * Calls functor(i) for every i in [0, count). Indices are handed out one at a time to the worker threads,
+	 * so work items of very different sizes (helices of different lengths etc) are still balanced.
+	 * The calling thread takes part in the work and the call returns when all items are done. Without HAVE_CXX11 the items are done in order
+	 * on the calling thread
+	 */
+
+#ifdef HAVE_CXX11
+	template<typename FunctorT>
+	class ParallelForWorker {
+	public:
+		inline ParallelForWorker(FunctorT & functor, std::atomic<size_t> & next, size_t count) : m_functor(functor), m_next(next), m_count(count) {
+
+		}
+
+		inline void operator() () {
+			for (size_t i = m_next++; i < m_count; i = m_next++)
+				m_functor(i);
+		}
+
+	private:
+		FunctorT & m_functor;
+		std::atomic<size_t> & m_next;
+		size_t m_count;
+	};
+#endif /* HAVE_CXX11 */
+
+	template<typename FunctorT>
+	void ParallelFor(size_t count, FunctorT & functor) {
+#ifdef HAVE_CXX11
+		const size_t numThreads = std::min(count, size_t(std::max(1u, std::thread::hardware_concurrency())));
+#else
+		const size_t numThreads = 1;
+#endif /* N HAVE_CXX11 */
+
+		if (numThreads <= 1) {
+			for (size_t i = 0; i < count; ++i)
+				functor(i);
+
+			return;
+		}
+
+#ifdef HAVE_CXX11
+		std::atomic<size_t> next(0);
+		std::vector<std::thread> threads;
+		threads.reserve(numThreads - 1);
+
+		for (size_t i = 0; i < numThreads - 1; ++i)
+			threads.push_back(std::thread(ParallelForWorker<FunctorT>(functor, next, count)));
+
+		ParallelForWorker<FunctorT>(functor, next, count)();
+
+		for (std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it)
+			it->join();
+#endif /* HAVE_CXX11 */
+	}
+}
+
+#endif /* PARALLEL_H_ */
@@ -0,0 +1,37 @@
+/*
+ * PdbTranslator.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef PDBTRANSLATOR_H_
+#define PDBTRANSLATOR_H_
+
+#include <Definition.h>
+
+#include <maya/MPxFileTranslator.h>
+
+#include <controller/PdbExporter.h>
+
+#define HELIX_PDB_FILE_DESCRIPTION "All-atom PDB, mmCIF"
+
+namespace Helix {
+	/*
+	 * Export only, writes an all-atom model of the strands with the PdbExporter. The .cif extension selects mmCIF
+	 */
+
+	class PdbTranslator : public MPxFileTranslator {
+	public:
+		virtual MStatus writer (const MFileObject& file, const MString& optionsString, MPxFileTranslator::FileAccessMode mode);
+		virtual bool haveWriteMethod () const;
+		virtual bool haveReadMethod () const;
+		virtual bool canBeOpened () const;
+		virtual MString defaultExtension () const;
+		virtual MPxFileTranslator::MFileKind identifyFile (	const MFileObject& file, const char *buffer, short size) const;
+
+		static void *creator();
+	};
+}
+
+#endif /* PDBTRANSLATOR_H_ */
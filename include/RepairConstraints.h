@@ -0,0 +1,95 @@
+/*
+ * RepairConstraints.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef REPAIRCONSTRAINTS_H_
+#define REPAIRCONSTRAINTS_H_
+
+/*
+ * Command for repairing the aimConstraints of bases in newly opened/imported files.
+ * There seems to be a bug with newly opened/imported files that their aimConstraints fails to retarget the bases.
+ *
+ * Reading a file does no per-base work besides queueing the bases created while it is read (see HelixBase::postConstructor).
+ * The queued bases are repaired the first time they are needed: When Maya is idle after the file has been read, before an export
+ * that reads their orientation, or directly after the file has been read if Maya is not interactive, as batch and mayapy scripts
+ * never become idle before their next command. Queued bases that are moved before that are dropped, moving them reevaluates their
+ * constraints anyway. Only bases whose aimConstraint doesn't aim at its target are repaired, by reapplying their translation.
+ *
+ * The number of repaired bases is returned as the result of the command.
+ * -benchmark also reports the time it took to read the last file, how much of that the repair adds, and the time of checking
+ * every base in the scene against the previous behavior of reapplying the translation of every base
+ */
+
+#include <Definition.h>
+
+#include <iostream>
+#include <vector>
+
+#include <maya/MPxCommand.h>
+#include <maya/MObject.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MTimer.h>
+
+#define MEL_REPAIRCONSTRAINTS_COMMAND "repairConstraints"
+
+namespace Helix {
+	class VHELIXAPI RepairConstraints : public MPxCommand {
+	public:
+		RepairConstraints();
+		virtual ~RepairConstraints();
+
+		virtual MStatus doIt(const MArgList & args);
+		virtual MStatus undoIt ();
+		virtual MStatus redoIt ();
+		virtual bool isUndoable () const;
+		virtual bool hasSyntax () const;
+
+		static MSyntax newSyntax ();
+		static void *creator();
+
+		/*
+		 * Queue a base created while a file is being read
+		 */
+
+		static void Enqueue(const MObject & base);
+
+		/*
+		 * Check and repair the queued bases now. Called by exporters before they read the orientation of the bases
+		 */
+
+		static MStatus Repair(unsigned int & numChecked, unsigned int & numRepaired);
+
+		/*
+		 * Returns true if the aimConstraint of the base does not aim the base towards its target. Bases without aimConstraints are never stale
+		 */
+
+		static bool IsStale(const MObject & base, MStatus & status);
+
+		/*
+		 * Called when a file has been read. Queues the command to be executed once Maya is idle, or repairs the bases directly
+		 * if Maya is not interactive. Multiple calls before the command has been executed only queues it once
+		 */
+
+		static MStatus FileRead();
+
+		/*
+		 * Registered in main.cpp for kBeforeOpen and kBeforeImport, times the reading of the file
+		 */
+
+		static void MSceneMessage_BeforeRead_CallbackFunc(void *clientData);
+
+	private:
+		static MStatus Benchmark();
+
+		static std::vector<MObjectHandle> s_pending;
+		static bool s_scheduled;
+		static MTimer s_readTimer;
+		static double s_readSeconds, s_repairSeconds;
+		static unsigned int s_numQueued;
+	};
+}
+
+#endif /* REPAIRCONSTRAINTS_H_ */
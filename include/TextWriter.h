@@ -0,0 +1,181 @@
+/*
+ * TextWriter.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef TEXTWRITER_H_
+#define TEXTWRITER_H_
+
+#include <Compression.h>
+
+#include <cstddef>
+#include <string>
+
+/*
+ * Number of bytes collected before they are written to the file
+ */
+
+#define TEXTWRITER_BUFFER_SIZE (1 << 20)
+
+/*
+ * Enough for any double formatted by FormatDouble
+ */
+
+#define TEXTWRITER_DOUBLE_SIZE 32
+
+namespace Helix {
+	/*
+	 * TextWriter: Buffered text output for the exporters replacing std::ofstream. Lines should be ended with '\n' as nothing is flushed
+	 * until the buffer is full or the file is closed. Without a file, the text is only collected in memory and can be retrieved with str().
+	 * Files ending with .gz or .zst are compressed while they are written, see Compression.
+	 *
+	 * Doubles are formatted by a fast path that falls back to snprintf whenever it can not guarantee the same result, the formats are:
+	 *  - kDefault: precision significant digits, identical to the default formatting of iostreams (%g).
+	 *  - kShortest: the shortest of 15, 16 or 17 significant digits that reads back as the same double. It is not always the true shortest
+	 *    representation a Grisu or Ryu style algorithm would give, 5e-324 is written as 4.94065645841247e-324. Values that read back from
+	 *    9 digits take the fast path, others up to three snprintf calls.
+	 *  - kFixed: precision decimals (%f).
+	 *
+	 * Does not depend on Maya.
+	 */
+
+	class VHELIXAPI TextWriter {
+	public:
+		enum Format {
+			kDefault,
+			kShortest,
+			kFixed
+		};
+
+		TextWriter(Format format = kDefault, int precision = 6);
+		~TextWriter();
+
+		/*
+		 * Open the file, returns false if it can not be created or its compression is not supported
+		 */
+
+		bool open(const char *filename);
+
+		/*
+		 * Write everything buffered and close the file. Returns false if anything failed to be written
+		 */
+
+		bool close();
+
+		bool flush();
+
+		inline bool good() const {
+			return m_good;
+		}
+
+		/*
+		 * Bytes written to the file so far, after compression
+		 */
+
+		inline unsigned long long bytesWritten() const {
+			return m_file.bytesWritten();
+		}
+
+		/*
+		 * Time spent compressing and writing to the file so far
+		 */
+
+		inline double writeSeconds() const {
+			return m_writeSeconds;
+		}
+
+		inline void setFormat(Format format, int precision) {
+			m_format = format;
+			m_precision = precision;
+		}
+
+		inline Format format() const {
+			return m_format;
+		}
+
+		inline int precision() const {
+			return m_precision;
+		}
+
+		inline void write(const char *data, size_t length) {
+			m_buffer.append(data, length);
+			reserve();
+		}
+
+		inline TextWriter & operator<<(const char *str) {
+			m_buffer.append(str);
+			reserve();
+			return *this;
+		}
+
+		inline TextWriter & operator<<(const std::string & str) {
+			m_buffer.append(str);
+			reserve();
+			return *this;
+		}
+
+		inline TextWriter & operator<<(char c) {
+			m_buffer.push_back(c);
+			reserve();
+			return *this;
+		}
+
+		TextWriter & operator<<(int value);
+		TextWriter & operator<<(unsigned int value);
+		TextWriter & operator<<(unsigned long value);
+		TextWriter & operator<<(unsigned long long value);
+		TextWriter & operator<<(double value);
+
+		/*
+		 * The text buffered but not yet written
+		 */
+
+		inline const std::string & str() const {
+			return m_buffer;
+		}
+
+		inline void clear() {
+			m_buffer.clear();
+		}
+
+		/*
+		 * Exchange the buffered text with buffer, for handing text formatted in memory over to another thread
+		 */
+
+		inline void swap(std::string & buffer) {
+			m_buffer.swap(buffer);
+		}
+
+		/*
+		 * Format value into buffer, which must hold at least TEXTWRITER_DOUBLE_SIZE characters. Returns the length, buffer is not null terminated
+		 */
+
+		static size_t FormatDouble(double value, char *buffer, Format format, int precision);
+
+		/*
+		 * Seconds on a steady clock, for timing the writes and the phases of ExportStatistics. Without C++11 it's the wall clock
+		 */
+
+		static double Now();
+
+	private:
+		inline void reserve() {
+			if (m_file.isOpen() && m_buffer.size() >= TEXTWRITER_BUFFER_SIZE)
+				flush();
+		}
+
+		TextWriter(const TextWriter &);
+		TextWriter & operator=(const TextWriter &);
+
+		std::string m_buffer;
+		OutputFile m_file;
+		Format m_format;
+		int m_precision;
+		double m_writeSeconds;
+		bool m_good;
+	};
+}
+
+#endif /* TEXTWRITER_H_ */
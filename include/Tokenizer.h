@@ -0,0 +1,89 @@
+/*
+ * Tokenizer.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef TOKENIZER_H_
+#define TOKENIZER_H_
+
+#include <Definition.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+ * Tokenizer: Splits a line of text into whitespace separated tokens without copying it, used by the text based importers.
+ * Lines are meant to be dispatched on their first token and the numeric fields parsed directly from the tokens,
+ * instead of trying a number of sscanf patterns on every line.
+ *
+ * Does not depend on Maya.
+ */
+
+namespace Helix {
+	class VHELIXAPI Tokenizer {
+	public:
+		struct Token {
+			const char *begin, *end;
+
+			inline size_t length() const {
+				return size_t(end - begin);
+			}
+
+			inline std::string str() const {
+				return std::string(begin, end);
+			}
+
+			inline bool operator==(const char *string) const {
+				const size_t string_length = strlen(string);
+				return string_length == length() && strncmp(begin, string, string_length) == 0;
+			}
+
+			inline bool operator!=(const char *string) const {
+				return !(*this == string);
+			}
+		};
+
+		/*
+		 * Split the line into tokens. The line must be valid while the tokens are used. Returns the number of tokens
+		 */
+
+		size_t tokenize(const char *begin, const char *end);
+
+		inline size_t tokenize(const std::string & line) {
+			return tokenize(line.data(), line.data() + line.size());
+		}
+
+		inline size_t size() const {
+			return m_tokens.size();
+		}
+
+		inline const Token & operator[](size_t index) const {
+			return m_tokens[index];
+		}
+
+		/*
+		 * Parse the token at the given index. Returns false if there is no such token or it is not a valid number
+		 */
+
+		bool toDouble(size_t index, double & value) const;
+		bool toInt(size_t index, int & value) const;
+		bool toUnsigned(size_t index, unsigned int & value) const;
+
+		/*
+		 * Parse decimal numbers without going through strtod/sscanf. Numbers with more significant digits than a double can represent
+		 * exactly or with large exponents are passed on to strtod so the result is always correctly rounded
+		 */
+
+		static bool ParseDouble(const char *begin, const char *end, double & value);
+		static bool ParseFloat(const char *begin, const char *end, float & value);
+		static bool ParseInt(const char *begin, const char *end, int & value);
+
+	private:
+		std::vector<Token> m_tokens;
+	};
+}
+
+#endif /* TOKENIZER_H_ */
@@ -0,0 +1,128 @@
+/*
+ * BuildExecutor.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef CONTROLLER_BUILDEXECUTOR_H_
+#define CONTROLLER_BUILDEXECUTOR_H_
+
+#include <Definition.h>
+#include <Utility.h>
+
+#include <maya/MString.h>
+#include <maya/MTimer.h>
+
+/*
+ * Number of work items between updates of the progress window and checks for cancellation
+ */
+
+#define BUILD_BATCH_SIZE 256
+
+namespace Helix {
+	namespace Controller {
+		/*
+		 * BuildExecutor: Shared progress handling for operations creating large numbers of nodes. The work is divided into phases,
+		 * every phase reports its items with step() or advance(), but the progress window is only updated once per batch of items.
+		 * At the end of every batch the user may cancel with escape, step() and advance() then return false and the caller is expected to
+		 * stop, roll back what it created and return the status of finish().
+		 *
+		 * finish() displays the number of bases created and the throughput in bases per second.
+		 */
+
+		class VHELIXAPI BuildExecutor {
+		public:
+			/*
+			 * If showProgress is false nothing is displayed and the operation can not be cancelled, the bases are still counted
+			 */
+
+			BuildExecutor(const MString & title, bool showProgress = true, unsigned int batchSize = BUILD_BATCH_SIZE);
+			~BuildExecutor();
+
+			/*
+			 * Start a new phase with `range` items, ending the previous one
+			 */
+
+			void begin(const MString & status, unsigned int range);
+
+			/*
+			 * An item that created `bases` bases is done. Returns false if the operation was cancelled
+			 */
+
+			inline bool step(unsigned int bases = 1) {
+				m_bases += bases;
+				return advance();
+			}
+
+			/*
+			 * `count` items not creating any bases are done. Returns false if the operation was cancelled
+			 */
+
+			inline bool advance(unsigned int count = 1) {
+				if ((m_pending += count) >= m_batchSize)
+					flush();
+
+				return !m_cancelled;
+			}
+
+			/*
+			 * End the current phase
+			 */
+
+			void end();
+
+			/*
+			 * End the operation and report the throughput. Returns MStatus::kFailure if the operation was cancelled
+			 */
+
+			MStatus finish();
+
+			inline bool cancelled() const {
+				return m_cancelled;
+			}
+
+			inline unsigned int bases() const {
+				return m_bases;
+			}
+
+			/*
+			 * Only valid after finish
+			 */
+
+			inline double seconds() const {
+				return m_seconds;
+			}
+
+			inline double basesPerSecond() const {
+				return m_seconds > 0.0 ? double(m_bases) / m_seconds : 0.0;
+			}
+
+			/*
+			 * Delete the given objects when rolling back a cancelled operation, objects that were never created are skipped.
+			 * Deleting a helix deletes its bases
+			 */
+
+			template<typename It>
+			static void RollBack(It it, It end) {
+				MStatus status;
+
+				for (; it != end; ++it) {
+					if (*it)
+						HMEVALUATE(status = it->deleteNode(), status);
+				}
+			}
+
+		private:
+			void flush();
+
+			MString m_title;
+			MTimer m_timer;
+			unsigned int m_batchSize, m_pending, m_bases;
+			double m_seconds;
+			bool m_showProgress, m_started, m_cancelled, m_finished;
+		};
+	}
+}
+
+#endif /* CONTROLLER_BUILDEXECUTOR_H_ */
@@ -15,7 +15,8 @@ namespace Helix {
 		 * Duplicate controller: Duplicates a given list of helices.
 		 * This is a two step process: Duplicate helices + bases and then connect them
 		 * in order to do that the first step needs to generate a base relationship table to track the old bases relation to the new bases
-		 * thus being able to create the bindings in the new helices
+		 * thus being able to create the bindings in the new helices.
+		 * Progress is shown through a BuildExecutor, if the user cancels, everything created is removed
 		 */
 
 		class VHELIXAPI Duplicate {
@@ -24,15 +25,6 @@ namespace Helix {
 			MStatus undo();
 			MStatus redo();
 
-		protected:
-			/*
-			 * Callbacks for progress bars etc.
-			 * There are two processes, duplicate and connect
-			 */
-			virtual void onProgressStart(unsigned int process, unsigned int range);
-			virtual void onProgressStep();
-			virtual void onProgressDone();
-
 		private:
 			/*
 			 * They need to be copied here for the redo process to operate on something
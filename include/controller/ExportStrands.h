@@ -4,18 +4,90 @@
 #include <controller/Operation.h>
 
 #include <model/Strand.h>
+#include <model/StrandCache.h>
+#include <model/StrandIndex.h>
+
+#include <ExportStatistics.h>
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include <maya/MObjectArray.h>
+
+/*
+ * The plate layout assigns strands to the wells of 96 well plates, row by row
+ */
+
+#define EXPORT_PLATE_ROWS 8
+#define EXPORT_PLATE_COLUMNS 12
 
 namespace Helix {
 	namespace Controller {
 		class VHELIXAPI ExportStrands : public Operation<Model::Strand> {
 		public:
+			/*
+			 * COMMA_SEPARATED and COLON_SEPARATED write the strand name and sequence of every strand. CSV writes a header and the name,
+			 * sequence, length and 5' and 3' end bases of every strand, PLATE_LAYOUT the plate, well, name and sequence of every strand
+			 */
+
 			enum Mode {
 				COMMA_SEPARATED,
-				COLON_SEPARATED
+				COLON_SEPARATED,
+				CSV,
+				PLATE_LAYOUT
 			};
 
+			inline ExportStrands() : m_maxLength(0), m_reused(0), m_statistics(NULL), m_incremental(true) {
+
+			}
+
 			MStatus write(const MString & filename, Mode mode = COMMA_SEPARATED);
 
+			/*
+			 * Bulk export: Collect every strand passing through the given bases once. The strands are looked up in the strand index,
+			 * so no strand is traversed more than once and never backwards
+			 */
+
+			MStatus collect(const MObjectArray & bases);
+
+			/*
+			 * Strands longer than this, such as the scaffold, are not exported. 0 exports all strands
+			 */
+
+			inline void setMaxLength(unsigned int maxLength) {
+				m_maxLength = maxLength;
+			}
+
+			inline size_t size() const {
+				return m_export_data.size();
+			}
+
+			/*
+			 * The strands are cached between exports, and strands that haven't changed since they were last exported are not
+			 * traversed again. Disabling it recaptures every strand
+			 */
+
+			inline void setIncremental(bool incremental) {
+				m_incremental = incremental;
+			}
+
+			/*
+			 * Number of strands taken from the cache
+			 */
+
+			inline size_t reused() const {
+				return m_reused;
+			}
+
+			/*
+			 * Time the phases of the export and count what was written in statistics, NULL disables it
+			 */
+
+			inline void setStatistics(ExportStatistics *statistics) {
+				m_statistics = statistics;
+			}
+
 			virtual void onProgressStep();
 
 		protected:
@@ -29,17 +101,36 @@ namespace Helix {
 			 */
 
 			struct Data {
-				/*inline Data(const MString & _strand_name, const MString & _sequence) : strand_name(_strand_name), sequence(_sequence) {
+				std::string strand_name, // Will be the two end bases for a strand not in a loop, if it's a loop, then any base name
+						sequence, // Not MStrings as they are formatted on worker threads.
+						five_prime, three_prime; // Empty if the strand is a loop.
+				size_t length;
+			};
 
-				}*/
+			/*
+			 * Collect the data of an indexed strand in a single forward traversal
+			 */
 
-				MString strand_name, // Will be the two end bases for a strand not in a loop, if it's a loop, then any base name
-						sequence;
-			};
+			MStatus collectStrand(Model::StrandIndex::Strand & strand);
+
+			/*
+			 * Shared by all exports
+			 */
+
+			static Model::StrandCache<Data> & Cache();
 
 			std::list<Data> m_export_data;
+			std::vector<bool> m_visited; // Strands of the strand index already collected.
+			unsigned int m_maxLength;
+			size_t m_reused;
+			ExportStatistics *m_statistics;
+			bool m_incremental;
+
+			/*
+			 * Formats the line of one strand, defined in the .cpp file
+			 */
 
-			friend std::ostream & operator<<(std::ostream & stream, const ExportStrands::Data & data);
+			class DataFormatter;
 		};
 	}
 }
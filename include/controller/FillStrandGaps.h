@@ -16,6 +16,12 @@
 
 #include <vector>
 
+#if defined(WIN32) || defined(WIN64)
+#include <unordered_set>
+#else
+#include <tr1/unordered_set>
+#endif /* N Windows */
+
 namespace Helix {
 	namespace Controller {
 		class FillStrandGaps {
@@ -73,6 +79,13 @@ namespace Helix {
 			std::vector<Model::Base> undoable;
 			std::vector < std::pair<Model::Base, Model::Base> > previously_connected;
 			std::vector<Redoable> redoable;
+
+			// Bases already queued for filling. A base is reached multiple times if both it and its helix or strand are targeted
+#if defined(WIN32) || defined(WIN64)
+			std::unordered_set<Model::Base> visited;
+#else
+			std::tr1::unordered_set<Model::Base> visited;
+#endif /* N Windows */
 		};
 	}
 }
@@ -0,0 +1,144 @@
+/*
+ * JSONExporter.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef _CONTROLLER_JSONEXPORTER_H_
+#define _CONTROLLER_JSONEXPORTER_H_
+
+#include <Definition.h>
+#include <ExportStatistics.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <maya/MObjectArray.h>
+#include <maya/MStatus.h>
+
+/*
+ * The length of the vstrands arrays is rounded up to a multiple of this, as caDNAno does for the honeycomb lattice
+ */
+
+#define JSON_EXPORT_LENGTH_STEP 21
+
+/*
+ * Half the width of the square of lattice cells a helix may initially be assigned to, centered on its nearest cell.
+ * The square is doubled for a helix that can't be assigned within it
+ */
+
+#define JSON_EXPORT_LATTICE_RADIUS 2
+
+namespace Helix {
+	namespace Controller {
+		/*
+		 * JSONExporter: Writes the helices of the scene as a caDNAno (version 2) json file. Like the JSONImporter, the export is done in phases:
+		 * The scene is captured into plain arrays, a layout of caDNAno helices and slots is created from them without touching the scene
+		 * and the layout is then written helix by helix to a TextWriter. No document tree is built.
+		 *
+		 * The layout is the reverse of the importer: The helices are assigned to cells of the honeycomb lattice with a minimum cost assignment
+		 * on their distances to the cells, and bases to indices by their translation along the helix axis. Loops and skips can not be recovered
+		 * from the scene, every base gets its own index.
+		 */
+
+		class VHELIXAPI JSONExporter {
+		public:
+			/*
+			 * Everything the layout needs from the scene. All indices are into the arrays of the scene
+			 */
+
+			struct Scene {
+				struct Helix {
+					double translation[3], axis[3]; // World space, the axis is normalized.
+				};
+
+				struct Base {
+					unsigned int helix, strand;
+					double translation[3]; // World space.
+					int forward, backward, opposite; // -1 if not connected or not exported. opposite is only captured if neither neighbour is on the same helix.
+				};
+
+				std::vector<Helix> helices;
+				std::vector<Base> bases;
+				std::vector<int> colors; // The color of every strand as 0xRRGGBB, -1 if it has none.
+			};
+
+			struct Layout {
+				/*
+				 * An occupied index of either strand of a helix. The connections are the helix num and index of the previous and the next base, -1 if none
+				 */
+
+				struct Slot {
+					int index;
+					int connections[4];
+
+					inline bool operator<(const Slot & slot) const {
+						return index < slot.index;
+					}
+				};
+
+				struct Helix {
+					int num, row, col;
+					std::vector<Slot> strands[2]; // scaf (the longest strand), stap. Sorted on index.
+					std::vector< std::pair<int, int> > stap_colors; // index, color
+				};
+
+				std::vector<Helix> helices; // Sorted on num.
+				int length; // Of the vstrands arrays.
+				std::string name;
+
+				double latticeError; // Root mean square distance in nm between the helices and their lattice cells.
+				unsigned int displacedBases; // Bases that could not be given the index closest to their translation.
+				unsigned int misdirectedBases; // Bases on a helix where their strand runs opposite to what caDNAno expects, which caDNAno can't represent.
+
+				inline Layout() : length(0), latticeError(0.0), displacedBases(0), misdirectedBases(0) {}
+			};
+
+			/*
+			 * Phase one: capture the given helices and their bases. Connections to bases of helices that are not given are dropped.
+			 * The phases of this and the following functions are timed in statistics if given
+			 */
+
+			static MStatus Capture(const MObjectArray & helices, Scene & scene, ExportStatistics *statistics = NULL);
+
+			/*
+			 * Phase two: assign lattice cells, numbers and indices. Does not touch the scene
+			 */
+
+			static void CreateLayout(const Scene & scene, Layout & layout);
+
+			/*
+			 * Phase three: write the layout. Helices are formatted in parallel. Returns false if the file could not be written
+			 */
+
+			static bool Write(const char *filename, const Layout & layout, ExportStatistics *statistics = NULL);
+
+			/*
+			 * All three phases, reports the quality of the layout
+			 */
+
+			static MStatus Export(const char *filename, const MObjectArray & helices, ExportStatistics *statistics = NULL);
+
+			/*
+			 * Assign every point (x, y) in the lattice plane to a unique honeycomb cell (row, col) minimizing the sum of the squared distances.
+			 * Returns the root mean square distance. The cells are relative, rows and columns may be negative
+			 */
+
+			static double AssignLatticeCells(const std::vector< std::pair<double, double> > & points, std::vector< std::pair<int, int> > & cells);
+
+			/*
+			 * Position of a honeycomb cell, the same as used by the JSONImporter except for centering
+			 */
+
+			static void LatticePosition(int row, int col, double & x, double & y);
+
+		private:
+			class Assignment;
+			class HelixFormatter;
+		};
+	}
+}
+
+#endif /* N _CONTROLLER_JSONEXPORTER_H_ */
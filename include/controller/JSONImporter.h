@@ -2,16 +2,20 @@
 #define _JSONIMPORTER_H_
 
 #include <Definition.h>
+#include <ImportStatistics.h>
 
 #include <model/Base.h>
 #include <model/Helix.h>
 
+#include <controller/JSONReader.h>
+
 #include <json/json.h>
 
 #include <map>
 #include <vector>
 #include <string>
 #include <list>
+#include <algorithm>
 
 #include <tuple>
 
@@ -23,11 +27,88 @@ namespace Helix {
 
 		class VHELIXAPI JSONImporter {
 		public:
+			/*
+			 * Which parser to use for reading the file. The streaming parser fills the binary structures below directly,
+			 * the DOM parser is the original jsoncpp based one and is kept for comparison
+			 */
+
+			enum Reader {
+				kReaderStream,
+				kReaderDOM
+			};
+
+			/*
+			 * The import is done in two phases: First a plan is made of everything that should be created. The plan is made up of
+			 * plain arrays and doesn't touch the scene, thus it can be created headless and in parallel. The plan is then built in the scene.
+			 * All indices are into the arrays of the plan
+			 */
+
+			struct Plan {
+				struct Helix {
+					int num;
+					double translation[3], rotation[3]; // rotation is XYZ euler angles in radians
+					double cylinderOrigin, cylinderHeight;
+				};
+
+				struct Base {
+					unsigned int helix;
+					double translation[3];
+					std::string name;
+				};
+
+				/*
+				 * A base that should be painted and all the bases of its strand. color is 0xRRGGBB or kScaffoldColor
+				 */
+
+				struct Paint {
+					unsigned int base;
+					int color;
+				};
+
+				static const int kScaffoldColor = -1;
+
+				std::vector<Helix> helices;
+				std::vector<Base> bases;
+				std::vector< std::pair<unsigned int, unsigned int> > forwardConnections; // from, to
+				std::vector< std::pair<unsigned int, unsigned int> > oppositeConnections;
+				std::vector<Paint> paint;
+				std::string name, filename;
+				unsigned int crossovers; // Forward connections between different helices.
+				std::vector< std::pair<int, int> > dangling; // Helix num and index of the bases connected to a base that does not exist, these connections are dropped.
+
+				inline Plan() : crossovers(0) {}
+			};
+
 			/*
 			 * Parse the json file
 			 */
 
-			MStatus parseFile(const char *filename);
+			MStatus parseFile(const char *filename, Reader reader = kReaderStream);
+
+			/*
+			 * Phase one: read the file and create the plan. Does not touch the scene
+			 */
+
+			static MStatus CreatePlan(const char *filename, Plan & plan, Reader reader = kReaderStream);
+
+			/*
+			 * Phase two: create everything in the plan
+			 */
+
+			MStatus build(const Plan & plan);
+
+			/*
+			 * Read the file `iterations` times with each of the parsers, without creating anything in the scene.
+			 * Returns the total time spent in seconds by each parser and fails if their results differ
+			 */
+
+			static MStatus Benchmark(const char *filename, unsigned int iterations, double & streamSeconds, double & domSeconds);
+
+			/*
+			 * Read and plan the file and report what would be created, without touching the scene
+			 */
+
+			static MStatus DryRun(const char *filename, ImportStatistics & statistics, Reader reader = kReaderStream);
 
 		protected:
 			/*
@@ -36,7 +117,6 @@ namespace Helix {
 
 			struct Base {
 				int connections[4]; // to helix, to base, from helix, from base
-				std::vector<Model::Base> bases; // only used by the create method to manage the created bases
 
 				// if [-1, -1, -1, -1] it's no base
 				bool isValid() const {
@@ -54,21 +134,66 @@ namespace Helix {
 				bool hasNextConnection() const {
 					return connections[2] + connections[3] != -2;
 				}
+
+				bool operator==(const Base & base) const {
+					return std::equal(connections, connections + 4, base.connections);
+				}
 			};
 
 			struct Helix {
 				std::vector<Base> stap, scaf; // the strands
 				std::vector<int> loop, skip;
 				int col, row, direction; // coordinates for the helix
-				std::vector<int> stap_colors;
+				std::vector< std::pair<int, int> > stap_colors; // staple base index, color
 
-				Model::Helix helix;
+				bool operator==(const Helix & helix) const {
+					return stap == helix.stap && scaf == helix.scaf && loop == helix.loop && skip == helix.skip && col == helix.col && row == helix.row && direction == helix.direction && stap_colors == helix.stap_colors;
+				}
 			};
 
 			struct file {
 				std::map<int, Helix> helices; // Maps "num" in JSON file to a helix
+				std::vector<int> order; // The "num" of the helices in the order they appear in the file
 				std::string name, filename;
-			} m_file;
+			};
+
+			/*
+			 * Fill the binary structures from the file, doesn't touch the scene
+			 */
+
+			static MStatus ReadStream(const char *filename, file & f);
+			static MStatus ReadDOM(const char *filename, file & f);
+
+			/*
+			 * Read the contents of a vstrands object, the kObjectBegin token has already been read
+			 */
+
+			static bool ReadVStrand(JSONReader & reader, Helix & helix, int & num);
+
+			/*
+			 * Create the plan from the binary structures. Helices are planned in parallel
+			 */
+
+			static void CreatePlan(const file & f, Plan & plan);
+
+			/*
+			 * Used by CreatePlan. The plan of a single helix with its own base indices,
+			 * slots[k][i] is the range of bases created for scaf (k = 0) or stap (k = 1) at caDNAno index i
+			 */
+
+			struct HelixPlan {
+				Plan::Helix helix;
+				std::vector<Plan::Base> bases;
+				std::vector< std::pair<unsigned int, unsigned int> > forwardConnections, oppositeConnections, crossConnections;
+				std::vector<Plan::Paint> colors, scaffold;
+				std::vector< std::pair<unsigned int, unsigned int> > slots[2]; // first, count
+				unsigned int offset; // index of the first base in the final plan
+				unsigned int crossovers; // set by PlanCrossConnections
+				std::vector< std::pair<int, int> > dangling;
+			};
+
+			class PlanHelix;
+			class PlanCrossConnections;
 		};
 	}
 }
@@ -0,0 +1,120 @@
+/*
+ * JSONReader.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef _CONTROLLER_JSONREADER_H_
+#define _CONTROLLER_JSONREADER_H_
+
+#include <Definition.h>
+
+#include <string>
+#include <vector>
+
+/*
+ * JSONReader: A pull parser for JSON documents. Unlike the bundled jsoncpp Json::Reader, no document tree is built.
+ * Instead the caller asks for one token at a time and stores the values directly into its own structures.
+ * Separators (',' and ':') are consumed silently, thus an object is read as a sequence of key and value tokens.
+ *
+ * The reader does not depend on Maya and can be used headless.
+ */
+
+namespace Helix {
+	namespace Controller {
+		class VHELIXAPI JSONReader {
+		public:
+			enum Token {
+				kObjectBegin,
+				kObjectEnd,
+				kArrayBegin,
+				kArrayEnd,
+				kString,
+				kNumber,
+				kTrue,
+				kFalse,
+				kNull,
+				kEnd,
+				kError
+			};
+
+			/*
+			 * The buffer must be valid during the lifetime of the reader
+			 */
+
+			JSONReader(const char *begin, const char *end);
+
+			/*
+			 * Read the whole file into the buffer. Returns false if the file could not be read
+			 */
+
+			static bool ReadFile(const char *filename, std::vector<char> & buffer);
+
+			/*
+			 * Read the next token
+			 */
+
+			Token next();
+
+			/*
+			 * Values of the last token read. string() is valid after kString, number() and integer() after kNumber
+			 */
+
+			inline const std::string & string() const {
+				return m_string;
+			}
+
+			inline double number() const {
+				return m_number;
+			}
+
+			inline int integer() const {
+				return int(m_number);
+			}
+
+			/*
+			 * Skip the rest of the value started by the given token, i.e. if it is kObjectBegin or kArrayBegin, skip until the matching end
+			 */
+
+			bool skip(Token token);
+
+			/*
+			 * Read a whole array of integers. The kArrayBegin token must not have been read yet
+			 */
+
+			bool readIntegers(std::vector<int> & values);
+
+			/*
+			 * Read an array of arrays of exactly `width` integers, appended to `values`. The kArrayBegin token must not have been read yet
+			 */
+
+			bool readIntegerTuples(std::vector<int> & values, size_t width);
+
+			/*
+			 * For error reporting
+			 */
+
+			inline size_t offset() const {
+				return m_it - m_begin;
+			}
+
+		private:
+			bool readString();
+			bool readNumber();
+			bool readLiteral(const char *literal, size_t length);
+
+			inline void skipWhitespace() {
+				while (m_it != m_end && (*m_it == ' ' || *m_it == '\n' || *m_it == '\r' || *m_it == '\t' || *m_it == ',' || *m_it == ':'))
+					++m_it;
+			}
+
+			const char *m_begin, *m_it, *m_end;
+
+			std::string m_string;
+			double m_number;
+		};
+	}
+}
+
+#endif /* N _CONTROLLER_JSONREADER_H_ */
@@ -0,0 +1,150 @@
+/*
+ * MeshExporter.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef _CONTROLLER_MESHEXPORTER_H_
+#define _CONTROLLER_MESHEXPORTER_H_
+
+#include <Definition.h>
+
+#include <vector>
+
+#include <maya/MObjectArray.h>
+#include <maya/MStatus.h>
+
+#define HELIX_OBJ_FILE_TYPE "obj"
+#define HELIX_PLY_FILE_TYPE "ply"
+#define HELIX_GLTF_FILE_TYPE "glb"
+
+/*
+ * Number of segments around the helix cylinders
+ */
+
+#define MESH_EXPORT_CYLINDER_SEGMENTS 32
+
+/*
+ * Number of instances formatted together by one worker. A base is about 10 kB of OBJ text
+ */
+
+#define MESH_EXPORT_CHUNK_SIZE 64
+
+/*
+ * Colors as 0xRRGGBB of bases without a material and of the helix cylinders. The cylinders are transparent in glTF
+ */
+
+#define MESH_EXPORT_DEFAULT_COLOR 0x808080
+#define MESH_EXPORT_CYLINDER_COLOR 0xB0B0B0
+#define MESH_EXPORT_CYLINDER_ALPHA 0.3
+
+namespace Helix {
+	namespace Controller {
+		/*
+		 * MeshExporter: Writes the design as a mesh for offline rendering, without baking any shapes in Maya. Every base is an instance of the
+		 * BackboneArrow drawn by the BaseShape and every helix an instance of a cylinder over the range of its HelixShape. Like the JSONExporter,
+		 * the scene is first captured into plain arrays and the file is then written in one linear pass:
+		 *
+		 *  - glTF (binary .glb): The two meshes are written once, followed by a translation, rotation and scale per instance using the
+		 *    EXT_mesh_gpu_instancing extension. The instances are grouped by color, every group is a node with its own material.
+		 *  - OBJ: The meshes are transformed and written instance by instance, with the color of the instance as vertex colors.
+		 *  - PLY (binary): Like OBJ, but without normals.
+		 *
+		 * Units are nm like in Maya. OBJ and PLY are formatted in parallel by the export pipeline, and compressed if the filename ends with .gz or .zst.
+		 */
+
+		class VHELIXAPI MeshExporter {
+		public:
+			enum Format {
+				kObj,
+				kPly,
+				kGltf
+			};
+
+			struct Scene {
+				struct Helix {
+					double translation[3], rotation[4], scale[3]; // World space, the rotation is a quaternion (x, y, z, w).
+					double origo, height; // Range of the HelixShape along the helix axis, the height is 0 if the helix has none.
+				};
+
+				struct Base {
+					unsigned int helix;
+					int color; // 0xRRGGBB of the material of the base, -1 if it has none.
+					double translation[3], rotation[4], scale[3]; // World space, from the inclusive matrix of the base. The rotation is a quaternion (x, y, z, w).
+				};
+
+				std::vector<Helix> helices;
+				std::vector<Base> bases;
+			};
+
+			/*
+			 * A triangle mesh with separate indices for positions and normals, like OBJ
+			 */
+
+			struct Mesh {
+				std::vector<float> positions, normals; // x, y, z.
+				std::vector<unsigned int> corners; // Position and normal index of every corner of every triangle.
+
+				inline size_t numPositions() const {
+					return positions.size() / 3;
+				}
+
+				inline size_t numNormals() const {
+					return normals.size() / 3;
+				}
+
+				inline size_t numTriangles() const {
+					return corners.size() / 6;
+				}
+			};
+
+			/*
+			 * Phase one: Capture the given helices, their bases and the colors of the bases
+			 */
+
+			static MStatus Capture(const MObjectArray & helices, Scene & scene);
+
+			/*
+			 * Phase two: Write the captured scene. Cylinders are left out unless cylinders is set. Returns false if the file could not be written
+			 */
+
+			static bool Write(const char *filename, Format format, const Scene & scene, bool cylinders);
+
+			/*
+			 * Both phases, the format is given by the filename
+			 */
+
+			static MStatus Export(const char *filename, const MObjectArray & helices, bool cylinders);
+
+			/*
+			 * The format given by the extension of the filename, before any compression suffix. Returns false if it is none of them
+			 */
+
+			static bool FormatFromFilename(const char *filename, Format & format);
+
+			/*
+			 * The BackboneArrow of the BaseShape, with duplicate positions and normals merged
+			 */
+
+			static const Mesh & BackboneArrow();
+
+			/*
+			 * A cylinder of radius DNA::RADIUS and height 1 along the z axis, centered on the origin, with caps
+			 */
+
+			static const Mesh & Cylinder();
+
+		private:
+			class Instances;
+			class ObjFormatter;
+			class PlyFormatter;
+
+			static bool WriteObj(const char *filename, const Instances & instances);
+			static bool WritePly(const char *filename, const Instances & instances);
+			static bool WriteGltf(const char *filename, const Instances & instances);
+		};
+	}
+}
+
+#endif /* N _CONTROLLER_MESHEXPORTER_H_ */
@@ -0,0 +1,65 @@
+/*
+ * NickStrands.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef _CONTROLLER_NICKSTRANDS_H_
+#define _CONTROLLER_NICKSTRANDS_H_
+
+#include <Definition.h>
+#include <NickOptimizer.h>
+
+#include <model/Base.h>
+#include <model/StrandIndex.h>
+
+#include <vector>
+
+/*
+ * Bridges the scene and the Maya independent NickOptimizer: Describes indexed strands for the optimizer and maps its results back to bases.
+ * Used by the text based importer when autostapling and by the nickStrands command
+ */
+
+namespace Helix {
+	namespace Controller {
+		class VHELIXAPI NickStrands {
+		public:
+			inline NickStrands(const NickOptimizer::Options & options) : m_optimizer(options), m_infeasible(0) {}
+
+			/*
+			 * Add a strand to be nicked, `sites` are the allowed nick offsets along the strand, empty meaning all of them.
+			 * Crossovers are found by comparing the helices of consecutive bases
+			 */
+
+			MStatus add(Model::StrandIndex::Strand & strand, const std::vector<unsigned int> & sites = std::vector<unsigned int>());
+
+			/*
+			 * Run the optimizer on all added strands. `nickBases` receives the bases that should be disconnected backward to apply the nicks.
+			 * Only reads from the scene, thus the caller decides how to apply them (directly or through the undoable Controller::Disconnect)
+			 */
+
+			void optimize(std::vector<Model::Base> & nickBases);
+
+			/*
+			 * Number of strands that could not be nicked within the length constraints during the last call to optimize
+			 */
+
+			inline size_t infeasible() const {
+				return m_infeasible;
+			}
+
+			inline size_t size() const {
+				return m_descriptions.size();
+			}
+
+		private:
+			NickOptimizer m_optimizer;
+			std::vector<NickOptimizer::Strand> m_descriptions;
+			std::vector< std::vector<Model::Base> > m_bases;
+			size_t m_infeasible;
+		};
+	}
+}
+
+#endif /* N _CONTROLLER_NICKSTRANDS_H_ */
@@ -2,14 +2,19 @@
 #define _CONTROLLER_OXDNAEXPORTER_H_
 
 #include <controller/Operation.h>
+#include <model/Object.h>
 #include <model/Strand.h>
+#include <model/StrandCache.h>
 
 #include <DNA.h>
+#include <ExportStatistics.h>
+#include <TextWriter.h>
 
 #include <list>
+#include <string>
 #include <vector>
 
-#include <maya/MQuaternion.h>
+#include <maya/MObjectHandle.h>
 
 #if defined(WIN32) || defined(WIN64)
 #include <unordered_map>
@@ -23,7 +28,7 @@
 
 /*
  * OxDnaExporter: Generates .top and .conf with the strands of the scene that can be used together with oxDNA for simulating
- * DNA models. See https://dna.physics.ox.ac.uk for more information.
+ * DNA models. See https://dna.physics.ox.ac.uk for more information. Filenames ending with .gz or .zst are compressed.
  *
  * All strands must have been assigned sequences.
  */
@@ -31,42 +36,166 @@ namespace Helix {
 	namespace Controller {
 		class VHELIXAPI OxDnaExporter : public Operation<Model::Strand> {
 		public:
+			OxDnaExporter();
 
 			/*
 			 * Writes what is currently stored in m_strands. Use the Operation interface to populate it.
 			 */
 			MStatus write(const char *topology_filename, const char *configuration_filename, const char *vhelix_filename, const MVector & minTranslation, const MVector & maxTranslation) const;
 
+			/*
+			 * How the coordinates are formatted, the default is the 6 significant digits oxDNA files have always been written with
+			 */
+
+			inline void setFormat(TextWriter::Format format, int precision) {
+				m_format = format;
+				m_precision = precision;
+			}
+
+			/*
+			 * Whether the .vhelix glue file is written. Without it, the names and materials of the bases are never looked up.
+			 * Must be set before the strands are executed
+			 */
+
+			inline void setVhelix(bool vhelix) {
+				m_vhelix = vhelix;
+			}
+
+			/*
+			 * The captured strands are cached between exports, and strands that haven't changed since they were last exported are
+			 * reused instead of captured again. Disabling it recaptures every strand. Must be set before the strands are executed
+			 */
+
+			inline void setIncremental(bool incremental) {
+				m_incremental = incremental;
+			}
+
+			/*
+			 * Number of strands taken from the cache
+			 */
+
+			inline size_t reused() const {
+				return m_reused;
+			}
+
+			/*
+			 * Time the phases of the export and count what was written in statistics, NULL disables it. Must be set before the strands are executed
+			 */
+
+			inline void setStatistics(ExportStatistics *statistics) {
+				m_statistics = statistics;
+			}
+
+			/*
+			 * Write the files `iterations` times with write() and with the original iostream based implementation (to the same filenames with
+			 * a .benchmark suffix) and measure the total time of each. The iostream implementation formats doubles the same way as the writer in
+			 * all three formats, the benchmark fails if the topology or configuration files differ. The .benchmark files are removed unless they differ.
+			 */
+			MStatus benchmark(const char *topology_filename, const char *configuration_filename, const char *vhelix_filename, const MVector & minTranslation, const MVector & maxTranslation, unsigned int iterations, double & writerSeconds, double & streamSeconds) const;
+
+			/*
+			 * Write the files `iterations` times uncompressed and with every supported compression and display the time and the number
+			 * of bytes written of each. The filenames decide which of the variants is kept, the others are removed.
+			 */
+			MStatus benchmarkCompression(const char *topology_filename, const char *configuration_filename, const char *vhelix_filename, const MVector & minTranslation, const MVector & maxTranslation, unsigned int iterations) const;
+
 		protected:
 
 			virtual MStatus doExecute(Model::Strand & element);
+
+			inline ExportStatistics *statistics() const {
+				return m_statistics;
+			}
 			MStatus doUndo(Model::Strand & element, Empty & undoData);
 			MStatus doRedo(Model::Strand & element, Empty & redoData);
 
 		private:
+			MStatus writeStream(const char *topology_filename, const char *configuration_filename, const char *vhelix_filename, const MVector & minTranslation, const MVector & maxTranslation) const;
+
+			TextWriter::Format m_format;
+			int m_precision;
+
+		protected:
 			/*
-			 * For exporting a strand we need its sequence (the labels are the only identifiers used) and whether its a circular strand.
-			 *
+			 * Every base and helix is only captured once, the first time a strand passes through the helix. All bases of the helix are then
+			 * read in one pass, using the world matrix of the helix instead of looking up the world transform of every base.
+			 * The strands only keep indices to the captured bases along with the direction along the helix axis of each base.
+			 * The PdbExporter writes the same captured data.
 			 */
+
 			struct Base {
 				DNA::Name label;
-				MVector translation, normal, tangent; // Tangent is the normalized vector between the helix axis and the base.
-				MString name, helixName, material;
+				MVector translation, tangent; // Tangent is the normalized vector between the helix axis and the base.
+				double axial; // Translation along the helix axis, in the helix coordinate system.
+				unsigned int helix;
+				std::string name, material; // Only captured if the vhelix file is written. Not MStrings as they are formatted on worker threads.
+			};
+
+			struct Helix {
+				MVector translation, normal, axis; // The normal is the normalized axis.
+				std::string name;
+				MObjectHandle object;
+				bool basesCaptured; // False if the helix was only taken from the cache along with a strand, its bases are then captured on demand.
 			};
 
 			struct Strand {
-				MString name;
-				std::vector<Base> strand;
+				struct Member {
+					unsigned int base;
+					int direction;
+				};
+
+				std::vector<Member> strand;
 				bool circular;
 			};
 
-			std::list<Strand> m_strands;
+		private:
+			/*
+			 * A strand as stored in the cache, with the bases it passes through and their helices. The base indices of the strand
+			 * and the helix indices of the bases are into these
+			 */
 
-			struct Helix {
-				MVector translation, normal;
+			struct CachedStrand {
+				Strand strand;
+				std::vector<Base> bases;
+				std::vector<Helix> helices;
+				bool vhelix; // Whether the names and materials were captured.
 			};
 
-			std::tr1::unordered_map<std::string, Helix> m_helices;
+			/*
+			 * Formats the lines of one strand of either file, defined in the .cpp file
+			 */
+
+			class StrandFormatter;
+
+			MStatus captureHelix(Model::Helix & helix, unsigned int & index);
+			MStatus captureMaterials();
+
+			void reuse(const CachedStrand & cached);
+			MStatus store(Model::StrandIndex::Strand & strand, const Strand & outstrand, const std::vector<MObjectHandle> & bases, Model::ChangeTracker::revision_t revision) const;
+
+			/*
+			 * Shared by all exports
+			 */
+
+			static Model::StrandCache<CachedStrand> & Cache();
+
+#if defined(WIN32) || defined(WIN64)
+			typedef std::unordered_map<MObjectHandle, unsigned int, Model::ObjectHandleHash> object_index_map_t;
+#else
+			typedef std::tr1::unordered_map<MObjectHandle, unsigned int, Model::ObjectHandleHash> object_index_map_t;
+#endif /* N Windows */
+
+		protected:
+			std::list<Strand> m_strands;
+			std::vector<Base> m_bases;
+			std::vector<Helix> m_helices;
+
+		private:
+			std::vector<Model::Material> m_materials;
+			object_index_map_t m_baseIndices, m_helixIndices, m_baseMaterials;
+			size_t m_reused;
+			ExportStatistics *m_statistics;
+			bool m_vhelix, m_materialsCaptured, m_incremental;
 		};
 	}
 }
@@ -10,10 +10,13 @@
 
 #include <Definition.h>
 #include <DNA.h>
+#include <ImportStatistics.h>
 
 #include <model/Helix.h>
 #include <model/Base.h>
 
+#include <string>
+#include <vector>
 
 #include <maya/MString.h>
 #include <maya/MVector.h>
@@ -22,28 +25,89 @@ namespace Helix {
 	namespace Controller {
 		class VHELIXAPI OxDnaImporter {
 		public:
+			inline OxDnaImporter() : m_frames(0) {}
+
+			/*
+			 * The parsed files. oxDNA nucleotide ids are dense, thus bases are stored at their id and all references are indices into the arrays.
+			 * Creating the plan does not touch the scene, see CreatePlan
+			 */
+
+			struct Plan {
+				struct Base {
+					unsigned int strand;
+					int forward, backward; // Nucleotide ids as given by the topology file, -1 if not connected.
+					char label;
+					double translation[3]; // Backbone position in nm.
+					std::string name, helixName, material;
+					int helix; // Index into helices, -1 if the base was never named in the vhelix file.
+
+					inline Base() : strand(0), forward(-1), backward(-1), label('?'), helix(-1) {
+						translation[0] = translation[1] = translation[2] = 0.0;
+					}
+				};
+
+				struct Helix {
+					std::string name;
+					double translation[3], normal[3];
+				};
+
+				std::vector<Base> bases;
+				std::vector<Helix> helices;
+				std::vector<unsigned int> strandOffsets; // Index of the first base of every strand, in the order the strands appear.
+				unsigned int configurations; // Number of base lines read from the first frame of the configuration file.
+				unsigned int frames; // Number of frames in the configuration file, more than one if it is a trajectory.
+
+				inline Plan() : configurations(0), frames(0) {}
+			};
+
 			MStatus read(const char *topology_filename, const char *configuration_filename, const char *vhelix_filename);
 
+			/*
+			 * Parse the three files into the plan without creating anything. Can be used headless
+			 */
+
+			static MStatus CreatePlan(const char *topology_filename, const char *configuration_filename, const char *vhelix_filename, Plan & plan);
+
+			/*
+			 * Parse the files and report what would be created, without touching the scene. Crossovers are only known for bases named in the vhelix file
+			 */
+
+			static MStatus DryRun(const char *topology_filename, const char *configuration_filename, const char *vhelix_filename, ImportStatistics & statistics);
+
+			/*
+			 * Create the helices and bases of the plan in the scene
+			 */
+
+			MStatus build(const Plan & plan);
+
+			/*
+			 * The bases created by the last build, indexed by nucleotide id
+			 */
+
+			inline const std::vector<Model::Base> & bases() const {
+				return m_bases;
+			}
+
+			/*
+			 * Number of frames in the configuration file of the last build
+			 */
+
+			inline unsigned int frames() const {
+				return m_frames;
+			}
+
 		protected:
 			virtual void onProcessStart(int count) = 0;
 			virtual void onProcessStep() = 0;
 			virtual void onProcessEnd() = 0;
 
 		private:
-			struct Base {
-				unsigned int strand;
-				int forward, backward;
-
-				DNA::Name label;
-				MVector translation;
-				MString name, helixName, material;
-				Model::Base base;
-			};
+			std::vector<Model::Base> m_bases;
+			unsigned int m_frames;
 
-			struct Helix {
-				MVector translation, normal;
-				Model::Helix helix;
-			};
+			static MStatus ReadTopology(const char *filename, Plan & plan);
+			static MStatus ReadConfiguration(const char *filename, Plan & plan);
+			static MStatus ReadVHelix(const char *filename, Plan & plan);
 		};
 	}
 }
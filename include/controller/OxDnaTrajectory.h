@@ -0,0 +1,87 @@
+/*
+ * OxDnaTrajectory.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef CONTROLLER_OXDNATRAJECTORY_H_
+#define CONTROLLER_OXDNATRAJECTORY_H_
+
+#include <Definition.h>
+#include <Compression.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+/*
+ * Rescale from the center of the base to the backbone position and from oxDNA units to nm
+ */
+
+#define OXDNA_BACKBONE_OFFSET -0.35
+#define OXDNA_LENGTH_UNIT 0.8518
+
+/*
+ * OxDnaTrajectory: Random access to the frames of an oxDNA trajectory (or a single configuration, which is a trajectory with one frame).
+ * When opened, the file is scanned once for the "t = " lines that start every frame and their offsets are stored, any frame can then be read
+ * by seeking directly to it, thus scrubbing through a large trajectory never rereads the file from the start.
+ * Compressed (gzip or zstd) files are decompressed while they are read instead, they can't be seeked in: Playing them forward continues
+ * from the previous frame, while going back decompresses them again from the start.
+ *
+ * Does not depend on Maya.
+ */
+
+namespace Helix {
+	namespace Controller {
+		class VHELIXAPI OxDnaTrajectory {
+		public:
+			inline OxDnaTrajectory() : m_size(0), m_nucleotides(0) {}
+
+			/*
+			 * Open the file and build the frame index. Returns false if the file could not be read.
+			 * If nucleotides is not 0, it's the number of nucleotides of the topology and readFrame fails on frames with any other number
+			 */
+
+			bool open(const char *filename, size_t nucleotides = 0);
+			void close();
+
+			inline bool isOpen() const {
+				return !m_offsets.empty();
+			}
+
+			inline size_t frames() const {
+				return m_offsets.size();
+			}
+
+			inline const std::string & filename() const {
+				return m_filename;
+			}
+
+			/*
+			 * Read the backbone positions in nm of all nucleotides in the given frame, three values per nucleotide in nucleotide id order.
+			 * Returns false if there is no such frame, it could not be read, it has malformed lines or the wrong number of nucleotides
+			 */
+
+			bool readFrame(size_t index, std::vector<double> & translations);
+
+			/*
+			 * Parse the nucleotide lines of a frame in memory, appending to `translations`. Header lines (t, b, E) and empty lines are skipped.
+			 * Returns false if any other line is not a nucleotide
+			 */
+
+			static bool ParseFrame(const char *begin, const char *end, std::vector<double> & translations);
+
+		private:
+			std::string m_filename;
+			std::ifstream m_file;
+			std::vector<long long> m_offsets; // Where every frame starts, the "t = " line.
+			long long m_size;
+			size_t m_nucleotides; // Expected in every frame, 0 if any number is accepted.
+			std::vector<char> m_buffer;
+			InputFile m_input; // Used instead of m_file if the file is compressed.
+		};
+	}
+}
+
+#endif /* CONTROLLER_OXDNATRAJECTORY_H_ */
@@ -0,0 +1,78 @@
+/*
+ * PdbExporter.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef _CONTROLLER_PDBEXPORTER_H_
+#define _CONTROLLER_PDBEXPORTER_H_
+
+#include <controller/OxDnaExporter.h>
+
+#include <NucleotideTemplate.h>
+
+#define HELIX_PDB_FILE_TYPE "pdb"
+#define HELIX_MMCIF_FILE_TYPE "cif"
+
+/*
+ * Number of nucleotides formatted together by one worker. Strands are split over several chunks, the scaffold alone can have
+ * more than 150000 atoms
+ */
+
+#define PDB_EXPORT_CHUNK_SIZE 128
+
+/*
+ * The fixed columns of the PDB format limit the atom serial numbers, residue numbers and chains. Larger structures wrap around
+ * and should be written as mmCIF instead
+ */
+
+#define PDB_MAX_SERIAL 99999
+#define PDB_MAX_RESIDUE 9999
+#define PDB_CHAINS "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789"
+
+namespace Helix {
+	namespace Controller {
+		/*
+		 * PdbExporter: Writes an all-atom model of the strands as PDB or mmCIF, for use as a starting structure of molecular dynamics simulations.
+		 * The strands are captured exactly like for the oxDNA export, and every base is replaced by a NucleotideTemplate placed in its frame:
+		 * The helix axis, the direction from the axis to the base and the direction of the strand along the axis.
+		 *
+		 * Every strand is a chain and every base a residue numbered from the 5' end, which has no phosphate. The atoms are generated while
+		 * the file is written, a chunk of nucleotides at a time by the export pipeline, so the memory used does not grow with the number of atoms.
+		 * Filenames ending with .gz or .zst are compressed.
+		 */
+
+		class VHELIXAPI PdbExporter : public OxDnaExporter {
+		public:
+			enum Format {
+				kPdb,
+				kMmCif
+			};
+
+			PdbExporter();
+
+			/*
+			 * mmCIF if the filename ends with .cif or .mmcif, before any compression suffix, PDB otherwise
+			 */
+
+			static Format FormatFromFilename(const char *filename);
+
+			/*
+			 * Write the atoms of the strands executed so far. numAtoms is set to the number of atoms written. The formatting and writing are
+			 * timed in the statistics given to setStatistics, if any
+			 */
+
+			MStatus writeAtoms(const char *filename, unsigned long long & numAtoms) const;
+
+		private:
+			/*
+			 * Formats the atoms of one nucleotide, defined in the .cpp file
+			 */
+
+			class ResidueFormatter;
+		};
+	}
+}
+
+#endif /* _CONTROLLER_PDBEXPORTER_H_ */
@@ -8,19 +8,61 @@
 #ifndef ROUTEDMESHIMPORTER_H_
 #define ROUTEDMESHIMPORTER_H_
 
+#include <ImportStatistics.h>
 #include <Utility.h>
 
+#include <string>
 #include <vector>
 
 namespace Helix {
 	namespace Controller {
+		/*
+		 * Imports a scaffold routed along the edges of a mesh. The file lists the mesh vertices ("v x y z"), the route as a sequence
+		 * of vertex indices ("e index [start end [angle]]") where every edge with a cylinder range becomes a helix, and optionally
+		 * the rotation of the first helix ("r angle").
+		 *
+		 * Importing is done in two phases: CreatePlan parses the file and calculates the helix transforms without touching the scene,
+		 * build then instantiates the plan in bulk.
+		 */
+
 		class VHELIXAPI RoutedMeshImporter {
 		public:
+			/*
+			 * Everything required to build the scene, no Maya types so that plans can be created and inspected headless
+			 */
+
+			struct Plan {
+				struct Helix {
+					double transform[4][4]; // Row major in Maya's row vector convention: the rows are the x, y and z axes and the translation.
+					int bases;
+				};
+
+				std::vector<Helix> helices;
+				std::vector< std::pair<unsigned int, unsigned int> > crossovers; // Scaffold crossovers from the forward 3' end of the first helix to the forward 5' end of the second.
+				std::string filename;
+			};
+
 			MStatus read(const char *filename);
 
-		private:
-			std::vector<MVector> m_vertices;
+			/*
+			 * Phase one: parse the file and calculate the helices. Does not touch the scene
+			 */
+
+			static MStatus CreatePlan(const char *filename, Plan & plan);
 
+			/*
+			 * Phase two: create the helices, bases and connections of a plan
+			 */
+
+			MStatus build(const Plan & plan);
+
+			/*
+			 * Parse and plan the file and report what would be created, without touching the scene
+			 */
+
+			static MStatus DryRun(const char *filename, ImportStatistics & statistics);
+
+		private:
 			struct Edge {
 				unsigned int vertex;
 				bool hasCylinder;
@@ -29,8 +71,11 @@ namespace Helix {
 				double angle;
 			};
 
-			std::vector<Edge> m_edges;
-			double m_initialRotation;
+			struct Vertex {
+				double position[3];
+			};
+
+			static MStatus Read(const char *filename, std::vector<Vertex> & vertices, std::vector<Edge> & edges, double & initialRotation);
 		};
 	}
 }
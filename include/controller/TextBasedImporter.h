@@ -2,6 +2,8 @@
 #define _TEXTBASEDCONTROLLER_H_
 
 #include <DNA.h>
+#include <ImportStatistics.h>
+#include <Tokenizer.h>
 #include <Utility.h>
 
 #include <model/Base.h>
@@ -23,13 +25,19 @@ namespace Helix {
 		public:
 			MStatus read(const char *filename, int nicking_min_length = 0, int nicking_max_length = 0);
 
+			/*
+			 * Parse the file and report what would be created, without touching the scene. Strands are counted before autostaple nicking
+			 */
+
+			static MStatus DryRun(const char *filename, ImportStatistics & statistics);
+
 		private:
 			struct Base {
 				std::string name, helixName, materialName;
 				MVector position;
 				DNA::Name label;
 
-				inline Base(const char *name, const MVector & position, const char *materialName, const DNA::Name & label) : name(name), materialName(materialName), position(position), label(label) {}
+				inline Base(const std::string & name, const std::string & helixName, const MVector & position, const std::string & materialName, const DNA::Name & label) : name(name), helixName(helixName), materialName(materialName), position(position), label(label) {}
 				inline Base() {}
 			};
 
@@ -38,10 +46,10 @@ namespace Helix {
 				MQuaternion orientation;
 				std::string name;
 				unsigned int bases; // Bases automatically added with the 'hb' command.
+				Model::Helix helix; // Set when the helix has been created.
 
-				inline Helix(const MVector & position, const MQuaternion & orientation, const char *name, unsigned int bases = 0) : position(position), orientation(orientation), name(name), bases(bases) {}
+				inline Helix(const MVector & position, const MQuaternion & orientation, const std::string & name, unsigned int bases = 0) : position(position), orientation(orientation), name(name), bases(bases) {}
 				inline Helix() : bases(0) {}
-				inline bool operator==(const char *name) const { return this->name == name; }
 			};
 
 			struct Connection {
@@ -56,18 +64,39 @@ namespace Helix {
 
 				std::string fromHelixName, toHelixName, fromName, toName; // Only used when fromType/toType are kNamed.
 
-				inline Connection(const char *fromHelixName, const char *fromName, const char *toHelixName, const char *toName, Type fromType, Type toType) : fromType(fromType), toType(toType), fromHelixName(fromHelixName), toHelixName(toHelixName), fromName(fromName), toName(toName) {}
+				inline Connection(const std::string & fromHelixName, const std::string & fromName, const std::string & toHelixName, const std::string & toName, Type fromType, Type toType) : fromType(fromType), toType(toType), fromHelixName(fromHelixName), toHelixName(toHelixName), fromName(fromName), toName(toName) {}
 
 				static Type TypeFromString(const char *type);
 			};
 
 #if defined(WIN32) || defined(WIN64)
 			typedef std::unordered_map<std::string, DNA::Name> explicit_base_labels_t;
+			typedef std::unordered_map<std::string, size_t> helix_index_map_t;
 #else
 			typedef std::tr1::unordered_map<std::string, DNA::Name> explicit_base_labels_t;
+			typedef std::tr1::unordered_map<std::string, size_t> helix_index_map_t;
 #endif /* Not windows */
 
+			/*
+			 * Parse a single line. Lines are dispatched on their first token, unknown or malformed lines are ignored
+			 */
+
+			void parseLine(const Tokenizer & tokenizer, bool & autostaple, std::vector< std::pair<std::string, std::string> > & paintStrands);
+
+			/*
+			 * Parse every line of the file, does not touch the scene
+			 */
+
+			MStatus parse(const char *filename, bool & autostaple, std::vector< std::pair<std::string, std::string> > & paintStrands);
+
+			/*
+			 * Returns the created helix with the given name or NULL if there is no such helix. If several helices share a name, the first one is returned
+			 */
+
+			Model::Helix *findHelix(const std::string & name);
+
 			std::vector<Helix> helices;
+			helix_index_map_t helixIndices; // Name to index in helices.
 			std::vector<Connection> connections;
 			std::vector<Base> explicitBases; // Bases explicitly created with the 'b' command.
 			explicit_base_labels_t explicitBaseLabels;
@@ -49,6 +49,12 @@ namespace Helix {
 
 			static MStatus AllSelected(MObjectArray & selectedBases);
 
+			/*
+			 * Used to obtain a list of all bases in the scene
+			 */
+
+			static MStatus All(MObjectArray & bases);
+
 			/*
 			 * Handle materials (colors) of the base
 			 */
@@ -143,4 +149,6 @@ namespace Helix {
 	}
 }
 
+DEFINE_OBJECT_HASH(Helix::Model::Base)
+
 #endif /* _MODEL_BASE_H_ */
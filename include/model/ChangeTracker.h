@@ -0,0 +1,119 @@
+/*
+ * ChangeTracker.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef _MODEL_CHANGETRACKER_H_
+#define _MODEL_CHANGETRACKER_H_
+
+#include <Definition.h>
+
+#include <model/Object.h>
+
+#include <maya/MObject.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MPlug.h>
+#include <maya/MString.h>
+
+#if defined(WIN32) || defined(WIN64)
+#include <unordered_map>
+#else
+#include <tr1/unordered_map>
+#endif /* N Windows */
+
+/*
+ * ChangeTracker: Stamps every base and helix with a revision when something an exporter reads from it changes. Exporters keep what they
+ * captured along with the revision it was captured at (see StrandCache), and only have to capture it again if any of its nodes has a newer revision.
+ *
+ * Bases are touched when their label or translation plugs are dirtied (by HelixBase::setDependentsDirty, which also touches the opposite base
+ * as its label is derived from the connection), when their forward, backward or label connections change, when their material changes or when
+ * they're renamed. Helices are touched when any of their plugs is dirtied (by Helix::setDependentsDirty) and when they're renamed, as the names
+ * of their bases include them. Creating a new scene or opening a file invalidates everything.
+ *
+ * Changes to the transforms of the parents of the helices and reparenting of bases and helices are not tracked, the StrandCache compares the
+ * parents of the bases and the world matrices of the helices itself.
+ */
+
+namespace Helix {
+	namespace Model {
+		class VHELIXAPI ChangeTracker {
+		public:
+			typedef unsigned long long revision_t;
+
+			static ChangeTracker & Instance();
+
+			/*
+			 * The node (a base or a helix) has been changed
+			 */
+
+			inline void touch(const MObject & node) {
+				m_revisions[MObjectHandle(node)] = ++m_revision;
+			}
+
+			/*
+			 * Everything captured until now is out of date
+			 */
+
+			void clear();
+
+			/*
+			 * The current revision. Anything captured now is up to date until a node is touched
+			 */
+
+			inline revision_t revision() const {
+				return m_revision;
+			}
+
+			/*
+			 * The revision the node was last touched at, 0 if it has never been touched
+			 */
+
+			inline revision_t revision(const MObjectHandle & node) const {
+				revision_map_t::const_iterator it = m_revisions.find(node);
+
+				return it == m_revisions.end() ? 0 : it->second;
+			}
+
+			/*
+			 * Whether something captured at the given revision is still up to date as far as the node is concerned
+			 */
+
+			inline bool isClean(const MObjectHandle & node, revision_t captured) const {
+				return captured >= m_cleared && revision(node) <= captured;
+			}
+
+			/*
+			 * Registered in main.cpp
+			 */
+
+			static void MDGMessage_Connection_CallbackFunc(MPlug & srcPlug, MPlug & destPlug, bool made, void *clientData);
+			static void MDGMessage_NodeRemoved_CallbackFunc(MObject & node, void *clientData);
+			static void MNodeMessage_NameChanged_CallbackFunc(MObject & node, const MString & previousName, void *clientData);
+			static void MSceneMessage_Clear_CallbackFunc(void *clientData);
+
+		private:
+			inline ChangeTracker() : m_revision(1), m_cleared(1) {
+
+			}
+
+			/*
+			 * Touches the node if it's a base or a helix, or the base if it's the shape of one
+			 */
+
+			void touchNode(const MObject & node);
+
+#if defined(WIN32) || defined(WIN64)
+			typedef std::unordered_map<MObjectHandle, revision_t, ObjectHandleHash> revision_map_t;
+#else
+			typedef std::tr1::unordered_map<MObjectHandle, revision_t, ObjectHandleHash> revision_map_t;
+#endif /* N Windows */
+
+			revision_map_t m_revisions;
+			revision_t m_revision, m_cleared; // Anything captured before m_cleared is out of date.
+		};
+	}
+}
+
+#endif /* _MODEL_CHANGETRACKER_H_ */
@@ -53,9 +53,7 @@ namespace Helix {
 			static MStatus AllSelected(MObjectArray & selectedHelices);
 
 			/*
-			 * Used to obtain a list of all Helices in the scene.
-			 *
-			 * TODO: Make a general GetAllObjectsOfType to use for both helices and bases in a scene.
+			 * Used to obtain a list of all Helices in the scene. See also Base::All
 			 */
 			static MStatus All(MObjectArray & helices);
 
@@ -191,4 +189,6 @@ namespace Helix {
 	}
 }
 
+DEFINE_OBJECT_HASH(Helix::Model::Helix)
+
 #endif /* _MODEL_HELIX_H_ */
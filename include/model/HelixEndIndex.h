@@ -0,0 +1,98 @@
+/*
+ * HelixEndIndex.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef _MODEL_HELIXENDINDEX_H_
+#define _MODEL_HELIXENDINDEX_H_
+
+#include <model/Helix.h>
+#include <model/Base.h>
+
+#include <vector>
+
+#include <maya/MPlug.h>
+
+#if defined(WIN32) || defined(WIN64)
+#include <unordered_map>
+#include <unordered_set>
+#else
+#include <tr1/unordered_map>
+#include <tr1/unordered_set>
+#endif /* N Windows */
+
+/*
+ * HelixEndIndex: Caches the 5' and 3' end bases of every queried helix sorted by their Z coordinate, used by the
+ * Helix::getForward/BackwardFive/ThreePrime methods. Without it, every query has to evaluate the type and translation of all the bases of the helix.
+ *
+ * Connection changes and translations of bases don't invalidate the whole helix, instead the changed bases are queued
+ * and only they are reevaluated on the next query of their helix.
+ */
+
+namespace Helix {
+	namespace Model {
+		class VHELIXAPI HelixEndIndex {
+		public:
+			static HelixEndIndex & Instance();
+
+			/*
+			 * Type is either Base::FIVE_PRIME_END or Base::THREE_PRIME_END. Returns the base with the smallest or largest Z coordinate
+			 * Returns MStatus::kNotFound if the helix doesn't have any end bases of the given type
+			 */
+
+			MStatus find(Helix & helix, Base::Type type, bool largestZ, Base & base);
+
+			/*
+			 * The base has been connected, disconnected, translated, added or removed
+			 */
+
+			void invalidate(const MObject & base);
+
+			inline void clear() {
+				m_helices.clear();
+			}
+
+			/*
+			 * Registered in main.cpp
+			 */
+
+			static void MDGMessage_Connection_CallbackFunc(MPlug & srcPlug, MPlug & destPlug, bool made, void *clientData);
+			static void MDGMessage_NodeAddedRemoved_CallbackFunc(MObject & node, void *clientData);
+			static void MSceneMessage_Clear_CallbackFunc(void *clientData);
+
+		private:
+			inline HelixEndIndex() {
+
+			}
+
+			typedef std::vector< std::pair<Base, double> > end_bases_t;
+
+#if defined(WIN32) || defined(WIN64)
+			typedef std::unordered_set<Base> base_set_t;
+#else
+			typedef std::tr1::unordered_set<Base> base_set_t;
+#endif /* N Windows */
+
+			struct Ends {
+				end_bases_t fivePrime, threePrime; // Sorted by Z
+				base_set_t pending;
+			};
+
+#if defined(WIN32) || defined(WIN64)
+			typedef std::unordered_map<Helix, Ends> helix_ends_map_t;
+#else
+			typedef std::tr1::unordered_map<Helix, Ends> helix_ends_map_t;
+#endif /* N Windows */
+
+			MStatus build(Helix & helix, Ends & ends);
+			MStatus update(Helix & helix, Ends & ends);
+			MStatus insert(Base & base, Ends & ends);
+
+			helix_ends_map_t m_helices;
+		};
+	}
+}
+
+#endif /* _MODEL_HELIXENDINDEX_H_ */
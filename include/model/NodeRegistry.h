@@ -0,0 +1,89 @@
+/*
+ * NodeRegistry.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef _MODEL_NODEREGISTRY_H_
+#define _MODEL_NODEREGISTRY_H_
+
+#include <Definition.h>
+
+#include <model/Object.h>
+
+#include <vector>
+
+#include <maya/MObject.h>
+#include <maya/MObjectArray.h>
+#include <maya/MObjectHandle.h>
+
+#if defined(WIN32) || defined(WIN64)
+#include <unordered_map>
+#else
+#include <tr1/unordered_map>
+#endif /* N Windows */
+
+/*
+ * NodeRegistry: Tracks all Helix and HelixBase nodes in the scene. Kept up to date by node added/removed messages so that
+ * "all helices" or "all bases" queries scale with the number of vHelix nodes and not with the size of the DAG.
+ */
+
+namespace Helix {
+	namespace Model {
+		class VHELIXAPI NodeRegistry {
+		public:
+			static NodeRegistry & Instance();
+
+			/*
+			 * Append the currently existing nodes to the array
+			 */
+
+			MStatus helices(MObjectArray & helices) const;
+			MStatus bases(MObjectArray & bases) const;
+
+			inline size_t numHelices() const {
+				return m_helices.nodes.size();
+			}
+
+			inline size_t numBases() const {
+				return m_bases.nodes.size();
+			}
+
+			/*
+			 * Registered in main.cpp
+			 */
+
+			static void MDGMessage_NodeAdded_CallbackFunc(MObject & node, void *clientData);
+			static void MDGMessage_NodeRemoved_CallbackFunc(MObject & node, void *clientData);
+
+		private:
+			inline NodeRegistry() {
+
+			}
+
+			/*
+			 * Nodes are stored in an array for fast enumeration, the map allows them to be removed in constant time
+			 */
+
+			class NodeSet {
+			public:
+				void insert(const MObject & node);
+				void erase(const MObject & node);
+				MStatus append(MObjectArray & array) const;
+
+				std::vector<MObjectHandle> nodes;
+
+#if defined(WIN32) || defined(WIN64)
+				std::unordered_map<MObjectHandle, size_t, ObjectHandleHash> indices;
+#else
+				std::tr1::unordered_map<MObjectHandle, size_t, ObjectHandleHash> indices;
+#endif /* N Windows */
+			};
+
+			NodeSet m_helices, m_bases;
+		};
+	}
+}
+
+#endif /* _MODEL_NODEREGISTRY_H_ */
@@ -15,6 +15,13 @@
 #include <maya/MDGModifier.h>
 #include <maya/MGlobal.h>
 #include <maya/MSelectionList.h>
+#include <maya/MObjectHandle.h>
+
+#include <functional>
+
+#if !defined(WIN32) && !defined(WIN64)
+#include <tr1/functional>
+#endif /* N Windows */
 
 /*
  * Object: Base class for Helix and Base objects in the Model namespace.
@@ -46,8 +53,34 @@
 	inline bool operator==(MObject object, ClassName & _this) { return _this == object; }													\
 	inline bool operator==(MDagPath dagPath, ClassName & _this) { return _this == dagPath; }										
 
+// Makes the class usable as a key in unordered_map/unordered_set. Must be used in the global namespace with the fully qualified class name.
+// The tr1 containers are used on all other platforms than Windows, thus they need their own specialization
+#define DEFINE_OBJECT_HASH_SPECIALIZATION(ClassName)																						\
+	template<> struct hash<ClassName> : public std::unary_function<ClassName, size_t> {													\
+		inline size_t operator()(const ClassName & object) const { return size_t(object.hashCode()); }										\
+	};
+
+#if defined(WIN32) || defined(WIN64)
+#define DEFINE_OBJECT_HASH(ClassName)																										\
+	namespace std { DEFINE_OBJECT_HASH_SPECIALIZATION(ClassName) }
+#else
+#define DEFINE_OBJECT_HASH(ClassName)																										\
+	namespace std { DEFINE_OBJECT_HASH_SPECIALIZATION(ClassName) namespace tr1 { DEFINE_OBJECT_HASH_SPECIALIZATION(ClassName) } }
+#endif /* N Windows */
+
 namespace Helix {
 	namespace Model {
+		/*
+		 * Hash for MObjectHandle keys of unordered_map/unordered_set, for nodes that aren't wrapped in an Object
+		 */
+
+		class ObjectHandleHash {
+		public:
+			inline size_t operator() (const MObjectHandle & handle) const {
+				return size_t(handle.hashCode());
+			}
+		};
+
 		class VHELIXAPI Object {
 		public:
 
@@ -155,6 +188,9 @@ namespace Helix {
 			}
 
 			inline bool operator==(Object & object) {
+				if (!m_object.isNull() && !object.m_object.isNull())
+					return m_object == object.m_object;
+
 				MStatus status;
 				MObject thisObject = getObject(status);
 
@@ -175,12 +211,13 @@ namespace Helix {
 
 			/*
 			 * Some STL code requires the operator== to be const
-			 * Notice: The above code is faster as it allows for caching.
-			 * According to the specification, even though the compiler could choose the most restrictive
-			 * it will always choose the ones above when possible
+			 * The MObject is cached by the const getObject too, so this is just as fast as the above
 			 */
 
 			inline bool operator==(const Object & object) const {
+				if (!m_object.isNull() && !object.m_object.isNull())
+					return m_object == object.m_object;
+
 				MStatus status;
 				MObject thisObject = getObject(status);
 
@@ -241,8 +278,8 @@ namespace Helix {
 			MDagPath & getDagPath(MStatus & status);
 
 			/*
-			 * Notice: As mentioned above, these methods are convenient in the STL library
-			 * but are slower because they're not able to cache the values for faster access
+			 * Notice: As mentioned above, these methods are convenient in the STL library.
+			 * The MObject is cached but the MDagPath is not, so prefer the non-const versions when the path is needed
 			 */
 
 			MObject getObject(MStatus & status) const;
@@ -260,6 +297,24 @@ namespace Helix {
 				return !m_object.isNull() || m_dagPath.isValid();
 			}
 
+			/*
+			 * Identity: A hash of the node this object refers to, see MObjectHandle::hashCode.
+			 * Equal objects have equal hash codes, invalid or deleted objects return 0. Used by the std::hash specializations
+			 */
+
+			inline unsigned int hashCode() const {
+				MStatus status;
+				MObject object = getObject(status);
+
+				return status ? MObjectHandle(object).hashCode() : 0;
+			}
+
+			/*
+			 * Ordering for std::map and std::set. Orders by hashCode and only compares the node names when hashes collide
+			 */
+
+			bool operator<(const Object & object) const;
+
 			/*
 			 * Positions/Orientations
 			 */
@@ -344,7 +399,8 @@ namespace Helix {
 			MStatus LoadAnyDagPathFromObject();
 
 			// Inheriting classes must go through above methods and can't access these directly
-			MObject m_object;
+			// m_object is mutable as it is a cache that is resolved on demand from m_dagPath, also by the const methods
+			mutable MObject m_object;
 			MDagPath m_dagPath;
 		};
 
@@ -352,4 +408,6 @@ namespace Helix {
 	}
 }
 
+DEFINE_OBJECT_HASH(Helix::Model::Object)
+
 #endif /* _MODEL_OBJECT_H_ */
@@ -0,0 +1,204 @@
+/*
+ * StrandCache.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef _MODEL_STRANDCACHE_H_
+#define _MODEL_STRANDCACHE_H_
+
+#include <model/ChangeTracker.h>
+#include <model/Object.h>
+#include <model/StrandIndex.h>
+
+#include <Utility.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <maya/MDagPath.h>
+#include <maya/MFnDagNode.h>
+#include <maya/MMatrix.h>
+#include <maya/MObjectHandle.h>
+
+#if defined(WIN32) || defined(WIN64)
+#include <unordered_map>
+#else
+#include <tr1/unordered_map>
+#endif /* N Windows */
+
+/*
+ * StrandCache: What an exporter captured for every strand, kept between exports. A strand is identified by the base it starts at in the StrandIndex.
+ * The captured data is reused as long as the strand still consists of the same bases and none of them or their helices have been touched
+ * in the ChangeTracker since it was captured, so an export after a small edit only has to capture the strands that were changed.
+ *
+ * Circular strands may have been captured starting at any of their bases, the bases are compared starting at the first one captured.
+ *
+ * As the ChangeTracker doesn't see changes to the transforms above the helices, nor reparenting, the parent of every base and the world
+ * matrix of every helix are also kept and compared. A strand is captured again if any of its bases has moved to another helix or any of
+ * its helices has moved in world space.
+ */
+
+namespace Helix {
+	namespace Model {
+		template<typename DataT>
+		class StrandCache {
+		public:
+			/*
+			 * The data captured for the strand, or NULL if it was never captured or has changed since
+			 */
+
+			const DataT *find(StrandIndex::Strand & strand) {
+				MStatus status;
+
+				if (strand.bases.empty())
+					return NULL;
+
+				const MObjectHandle front(strand.front().getObject(status));
+
+				if (!status)
+					return NULL;
+
+				typename entry_map_t::const_iterator it = m_entries.find(front);
+
+				if (it == m_entries.end())
+					return NULL;
+
+				const Entry & entry = it->second;
+				const size_t size = strand.size();
+
+				if (entry.circular != strand.circular || entry.bases.size() != size)
+					return NULL;
+
+				const size_t offset = size_t(std::find(entry.bases.begin(), entry.bases.end(), front) - entry.bases.begin());
+
+				if (offset == size || (offset != 0 && !strand.circular))
+					return NULL;
+
+				const ChangeTracker & tracker(ChangeTracker::Instance());
+
+				for (size_t i = 0; i < size; ++i) {
+					const MObjectHandle & base = entry.bases[(offset + i) % size];
+
+					if (!(base == strand.bases[i].getObject(status)) || !status || !tracker.isClean(base, entry.revision))
+						return NULL;
+
+					if (!(entry.parents[(offset + i) % size] == Parent(base)))
+						return NULL;
+				}
+
+				for (size_t i = 0; i < entry.helices.size(); ++i) {
+					MDagPath helix_dagPath;
+
+					if (!entry.helices[i].isValid() || !tracker.isClean(entry.helices[i], entry.revision))
+						return NULL;
+
+					if (!MDagPath::getAPathTo(entry.helices[i].object(), helix_dagPath) || !(helix_dagPath.inclusiveMatrix(&status) == entry.matrices[i]) || !status)
+						return NULL;
+				}
+
+				return &entry.data;
+			}
+
+			/*
+			 * Store the data captured for the strand. bases are the bases of the strand in the order they were captured, revision is
+			 * ChangeTracker::revision() from before the capture started
+			 */
+
+			MStatus insert(StrandIndex::Strand & strand, const std::vector<MObjectHandle> & bases, const DataT & data, ChangeTracker::revision_t revision) {
+				MStatus status;
+				MObject front;
+				HMEVALUATE_RETURN(front = strand.front().getObject(status), status);
+
+				Entry & entry = m_entries[MObjectHandle(front)];
+				entry.bases = bases;
+				entry.parents.clear();
+				entry.helices.clear();
+				entry.matrices.clear();
+				entry.revision = revision;
+				entry.circular = strand.circular;
+				entry.data = data;
+
+				entry.parents.reserve(bases.size());
+
+				for (std::vector<MObjectHandle>::const_iterator it = bases.begin(); it != bases.end(); ++it) {
+					const MObjectHandle helix(Parent(*it));
+					entry.parents.push_back(helix);
+
+					if (!helix.isValid() || std::find(entry.helices.begin(), entry.helices.end(), helix) != entry.helices.end())
+						continue;
+
+					MDagPath helix_dagPath;
+					HMEVALUATE_RETURN(status = MDagPath::getAPathTo(helix.object(), helix_dagPath), status);
+
+					MMatrix matrix;
+					HMEVALUATE_RETURN(matrix = helix_dagPath.inclusiveMatrix(&status), status);
+
+					entry.helices.push_back(helix);
+					entry.matrices.push_back(matrix);
+				}
+
+				return MStatus::kSuccess;
+			}
+
+			/*
+			 * Remove the strands that no longer start at the same base, and thus will never be found again
+			 */
+
+			void prune() {
+				StrandIndex & strandIndex(StrandIndex::Instance());
+
+				for (typename entry_map_t::iterator it = m_entries.begin(); it != m_entries.end();) {
+					StrandIndex::Entry entry;
+
+					if (!it->first.isValid() || !strandIndex.find(Base(it->first.object()), entry) || entry.ordinal != 0)
+						it = m_entries.erase(it);
+					else
+						++it;
+				}
+			}
+
+			inline void clear() {
+				m_entries.clear();
+			}
+
+			inline size_t size() const {
+				return m_entries.size();
+			}
+
+		private:
+			/*
+			 * The helix of the base, a null handle if it has none
+			 */
+
+			static MObjectHandle Parent(const MObjectHandle & base) {
+				MStatus status;
+				MFnDagNode dagNode(base.object(), &status);
+
+				if (!status || dagNode.parentCount() == 0)
+					return MObjectHandle();
+
+				return MObjectHandle(dagNode.parent(0));
+			}
+
+			struct Entry {
+				std::vector<MObjectHandle> bases, parents, helices; // parents holds the helix of every base.
+				std::vector<MMatrix> matrices; // The world matrix of every helix.
+				ChangeTracker::revision_t revision;
+				bool circular;
+				DataT data;
+			};
+
+#if defined(WIN32) || defined(WIN64)
+			typedef std::unordered_map<MObjectHandle, Entry, ObjectHandleHash> entry_map_t;
+#else
+			typedef std::tr1::unordered_map<MObjectHandle, Entry, ObjectHandleHash> entry_map_t;
+#endif /* N Windows */
+
+			entry_map_t m_entries;
+		};
+	}
+}
+
+#endif /* _MODEL_STRANDCACHE_H_ */
@@ -0,0 +1,158 @@
+/*
+ * StrandIndex.h
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#ifndef _MODEL_STRANDINDEX_H_
+#define _MODEL_STRANDINDEX_H_
+
+#include <model/Object.h>
+#include <model/Strand.h>
+
+#include <vector>
+
+#include <maya/MObjectHandle.h>
+#include <maya/MPlug.h>
+
+#if defined(WIN32) || defined(WIN64)
+#include <unordered_map>
+#else
+#include <tr1/unordered_map>
+#endif /* N Windows */
+
+/*
+ * StrandIndex: A scene wide cache of all strands. Iterating a Strand resolves the forward/backward plug connections for every step,
+ * which is what makes full scene traversals (exporters, painters, length counting) slow. The index does this resolution once and stores
+ * every strand as an ordered array of bases, starting at its 5' end (or at an arbitrary base if the strand is circular).
+ *
+ * The index is marked dirty by a connection callback on the forward/backward attributes of the HelixBase nodes (and when HelixBase
+ * nodes are added or removed) and is only rebuilt when it is queried again, so a batch of connection changes only results in a single rebuild.
+ */
+
+namespace Helix {
+	namespace Model {
+		class VHELIXAPI StrandIndex {
+		public:
+			/*
+			 * Where in the index a base is found: The strand it belongs to and its ordinal position along it
+			 */
+
+			struct Entry {
+				unsigned int strand, ordinal;
+			};
+
+			struct Strand {
+				std::vector<Base> bases;
+				bool circular;
+
+				typedef std::vector<Base>::iterator iterator;
+				typedef std::vector<Base>::const_iterator const_iterator;
+
+				inline iterator begin() {
+					return bases.begin();
+				}
+
+				inline iterator end() {
+					return bases.end();
+				}
+
+				inline const_iterator begin() const {
+					return bases.begin();
+				}
+
+				inline const_iterator end() const {
+					return bases.end();
+				}
+
+				inline size_t size() const {
+					return bases.size();
+				}
+
+				/*
+				 * The base the strand starts at, the 5' end unless the strand is circular
+				 */
+
+				inline Base & front() {
+					return bases.front();
+				}
+			};
+
+			typedef std::vector<Strand>::iterator iterator;
+			typedef std::vector<Strand>::const_iterator const_iterator;
+
+			static StrandIndex & Instance();
+
+			/*
+			 * Iterate over all strands in the scene. Both begin() and end() rebuild the index if it is dirty, so they can be called in any order
+			 */
+
+			iterator begin();
+			iterator end();
+
+			size_t size();
+
+			/*
+			 * Find the strand and position of the given base. Returns MStatus::kNotFound if the base is not in the scene
+			 */
+
+			MStatus find(const Base & base, Entry & entry);
+
+			/*
+			 * Convenience method: Find the strand the base belongs to
+			 */
+
+			MStatus find(const Base & base, Strand * & strand);
+
+			inline Strand & strand(unsigned int index) {
+				return m_strands[index];
+			}
+
+			/*
+			 * Forces a rebuild on the next query
+			 */
+
+			inline void invalidate() {
+				m_dirty = true;
+			}
+
+			inline bool isDirty() const {
+				return m_dirty;
+			}
+
+			/*
+			 * Rebuilds the index if it has been invalidated
+			 */
+
+			MStatus validate();
+
+			/*
+			 * Registered in main.cpp
+			 */
+
+			static void MDGMessage_Connection_CallbackFunc(MPlug & srcPlug, MPlug & destPlug, bool made, void *clientData);
+			static void MDGMessage_NodeAddedRemoved_CallbackFunc(MObject & node, void *clientData);
+			static void MSceneMessage_Invalidate_CallbackFunc(void *clientData);
+
+		private:
+			inline StrandIndex() : m_dirty(true) {
+
+			}
+
+			MStatus rebuild();
+
+#if defined(WIN32) || defined(WIN64)
+			typedef std::unordered_map<MObjectHandle, Entry, ObjectHandleHash> base_entry_map_t;
+#else
+			typedef std::tr1::unordered_map<MObjectHandle, Entry, ObjectHandleHash> base_entry_map_t;
+#endif /* N Windows */
+
+			std::vector<Strand> m_strands;
+			base_entry_map_t m_entries;
+			bool m_dirty;
+		};
+	}
+}
+
+#endif /* _MODEL_STRANDINDEX_H_ */
@@ -11,6 +11,12 @@
 #include <list>
 #include <algorithm>
 
+#if defined(WIN32) || defined(WIN64)
+#include <unordered_map>
+#else
+#include <tr1/unordered_map>
+#endif /* N Windows */
+
 #define CONNECT_SUGGESTIONS_LOCATOR_ID 0x02114123
 #define CONNECT_SUGGESTIONS_LOCATOR_NAME "connectSuggestionsLocator"
 
@@ -123,6 +129,29 @@ namespace Helix {
 
 			static std::list<BasePair> s_closeBasesTable;
 
+			/*
+			 * Every base in the s_closeBasesTable maps to the pairs it is part of, so that removing the suggestions of a base
+			 * doesn't require a scan of the whole table. Always modify the table through the methods below to keep them in sync
+			 */
+
+#if defined(WIN32) || defined(WIN64)
+			typedef std::unordered_multimap<Model::Base, std::list<BasePair>::iterator> close_bases_index_t;
+#else
+			typedef std::tr1::unordered_multimap<Model::Base, std::list<BasePair>::iterator> close_bases_index_t;
+#endif /* N Windows */
+
+			static close_bases_index_t s_closeBasesIndex;
+
+			static void AddCloseBases(Model::Base & first, Model::Base & second);
+			static void RemoveCloseBases(const Model::Base & base, bool detachCallbacks = true);
+			static void RemoveCloseBasePair(const BasePair & pair);
+
+			/*
+			 * Removes the index entry of the other base in the pair pointing to the same element in the s_closeBasesTable
+			 */
+
+			static void UnindexOtherCloseBase(const Model::Base & base, std::list<BasePair>::iterator it);
+
 			/*
 			 * Generate connection data for the elements in question
 			 */
@@ -0,0 +1,546 @@
+/*
+ * Compression.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <Compression.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif /* HAVE_ZLIB */
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif /* HAVE_ZSTD */
+
+namespace Helix {
+	static bool EndsWith(const char *str, const char *suffix) {
+		const size_t length = strlen(str), suffix_length = strlen(suffix);
+
+		return length >= suffix_length && strcmp(str + length - suffix_length, suffix) == 0;
+	}
+
+	Compression::Format Compression::FromFilename(const char *filename) {
+		if (EndsWith(filename, ".gz"))
+			return kGzip;
+		else if (EndsWith(filename, ".zst"))
+			return kZstd;
+		else
+			return kNone;
+	}
+
+	Compression::Format Compression::FromMagic(const char *data, size_t length) {
+		const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+
+		if (length >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b)
+			return kGzip;
+		else if (length >= 4 && bytes[0] == 0x28 && bytes[1] == 0xb5 && bytes[2] == 0x2f && bytes[3] == 0xfd)
+			return kZstd;
+		else
+			return kNone;
+	}
+
+	bool Compression::IsSupported(Format format) {
+		switch (format) {
+		case kGzip:
+#ifdef HAVE_ZLIB
+			return true;
+#else
+			return false;
+#endif /* N HAVE_ZLIB */
+		case kZstd:
+#ifdef HAVE_ZSTD
+			return true;
+#else
+			return false;
+#endif /* N HAVE_ZSTD */
+		default:
+			return true;
+		}
+	}
+
+	const char *Compression::Name(Format format) {
+		switch (format) {
+		case kGzip:
+			return "gzip";
+		case kZstd:
+			return "zstd";
+		default:
+			return "uncompressed";
+		}
+	}
+
+	bool Compression::ReadFile(const char *filename, std::vector<char> & buffer) {
+		InputFile file;
+
+		if (!file.open(filename))
+			return false;
+
+		buffer.clear();
+
+		for (;;) {
+			const size_t offset = buffer.size();
+			buffer.resize(offset + COMPRESSION_BUFFER_SIZE);
+
+			const size_t count = file.read(&buffer[offset], COMPRESSION_BUFFER_SIZE);
+			buffer.resize(offset + count);
+
+			if (count == 0)
+				break;
+		}
+
+		return file.good();
+	}
+
+	InputFile::InputFile() : m_file(NULL), m_stream(NULL), m_format(Compression::kNone), m_inputBegin(0), m_inputEnd(0), m_position(0), m_good(true), m_end(false), m_frameComplete(true) {
+
+	}
+
+	InputFile::~InputFile() {
+		close();
+	}
+
+	bool InputFile::open(const char *filename) {
+		close();
+
+		if (!(m_file = fopen(filename, "rb")))
+			return false;
+
+		m_input.resize(COMPRESSION_BUFFER_SIZE);
+		m_position = 0;
+		m_good = true;
+		m_end = false;
+		m_frameComplete = true;
+
+		/*
+		 * The first chunk identifies the format and is then decompressed like the rest
+		 */
+
+		fill();
+		m_format = Compression::FromMagic(&m_input[0], m_inputEnd);
+
+		if (!m_good || !Compression::IsSupported(m_format)) {
+			close();
+			return false;
+		}
+
+		switch (m_format) {
+#ifdef HAVE_ZLIB
+		case Compression::kGzip:
+			{
+				z_stream *stream = new z_stream;
+				memset(stream, 0, sizeof(z_stream));
+
+				// 15 + 32 detects the gzip header.
+				if (inflateInit2(stream, 15 + 32) != Z_OK) {
+					delete stream;
+					close();
+					return false;
+				}
+
+				m_stream = stream;
+			}
+			break;
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+		case Compression::kZstd:
+			if (!(m_stream = ZSTD_createDCtx())) {
+				close();
+				return false;
+			}
+			break;
+#endif /* HAVE_ZSTD */
+		default:
+			break;
+		}
+
+		return true;
+	}
+
+	bool InputFile::fill() {
+		m_inputBegin = 0;
+		m_inputEnd = fread(&m_input[0], 1, m_input.size(), m_file);
+
+		if (ferror(m_file))
+			m_good = false;
+
+		return m_inputEnd > 0;
+	}
+
+	size_t InputFile::read(char *data, size_t length) {
+		size_t produced = 0;
+
+		if (!m_file || !m_good)
+			return 0;
+
+		switch (m_format) {
+#ifdef HAVE_ZLIB
+		case Compression::kGzip:
+			{
+				z_stream *stream = static_cast<z_stream *>(m_stream);
+
+				while (produced < length && !m_end) {
+					bool end_of_file = false;
+
+					if (m_inputBegin == m_inputEnd && !fill()) {
+						if (!m_good)
+							break;
+
+						end_of_file = true;
+					}
+
+					// avail_in and avail_out are only 32 bits.
+					stream->next_in = reinterpret_cast<Bytef *>(&m_input[m_inputBegin]);
+					stream->avail_in = uInt(m_inputEnd - m_inputBegin);
+					stream->next_out = reinterpret_cast<Bytef *>(data + produced);
+					stream->avail_out = uInt(std::min(length - produced, size_t(UINT_MAX)));
+
+					const uInt available = stream->avail_out;
+					const int result = inflate(stream, Z_NO_FLUSH);
+					m_inputBegin = m_inputEnd - stream->avail_in;
+					produced += available - stream->avail_out;
+
+					if (result == Z_STREAM_END) {
+						// Concatenated gzip members.
+						if ((m_inputBegin < m_inputEnd || fill()) && inflateReset(stream) == Z_OK)
+							continue;
+
+						m_end = true;
+					}
+					else if (result == Z_BUF_ERROR) {
+						if (end_of_file) {
+							m_good = false; // Truncated file.
+							m_end = true;
+						}
+					}
+					else if (result != Z_OK) {
+						m_good = false;
+						break;
+					}
+				}
+			}
+			break;
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+		case Compression::kZstd:
+			{
+				ZSTD_DCtx *context = static_cast<ZSTD_DCtx *>(m_stream);
+
+				while (produced < length && !m_end) {
+					bool end_of_file = false;
+
+					if (m_inputBegin == m_inputEnd && !fill()) {
+						if (!m_good)
+							break;
+
+						end_of_file = true;
+					}
+
+					if (end_of_file && m_frameComplete) {
+						m_end = true;
+						break;
+					}
+
+					ZSTD_inBuffer input = { &m_input[0], m_inputEnd, m_inputBegin };
+					ZSTD_outBuffer output = { data, length, produced };
+					const size_t result = ZSTD_decompressStream(context, &output, &input);
+
+					if (ZSTD_isError(result)) {
+						m_good = false;
+						break;
+					}
+
+					m_inputBegin = input.pos;
+					m_frameComplete = result == 0;
+
+					// Nothing left to flush from the context, the last frame was cut short.
+					if (end_of_file && output.pos == produced && !m_frameComplete) {
+						m_good = false;
+						m_end = true;
+						break;
+					}
+
+					produced = output.pos;
+				}
+			}
+			break;
+#endif /* HAVE_ZSTD */
+		default:
+			{
+				const size_t buffered = std::min(length, m_inputEnd - m_inputBegin);
+
+				if (buffered > 0) {
+					memcpy(data, &m_input[m_inputBegin], buffered);
+					m_inputBegin += buffered;
+					produced = buffered;
+				}
+
+				if (produced < length) {
+					produced += fread(data + produced, 1, length - produced, m_file);
+
+					if (ferror(m_file))
+						m_good = false;
+				}
+			}
+			break;
+		}
+
+		m_position += produced;
+
+		return produced;
+	}
+
+	bool InputFile::rewind() {
+		if (!m_file)
+			return false;
+
+		if (fseek(m_file, 0, SEEK_SET) != 0)
+			return m_good = false;
+
+		switch (m_format) {
+#ifdef HAVE_ZLIB
+		case Compression::kGzip:
+			if (inflateReset(static_cast<z_stream *>(m_stream)) != Z_OK)
+				return m_good = false;
+			break;
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+		case Compression::kZstd:
+			if (ZSTD_isError(ZSTD_DCtx_reset(static_cast<ZSTD_DCtx *>(m_stream), ZSTD_reset_session_only)))
+				return m_good = false;
+			break;
+#endif /* HAVE_ZSTD */
+		default:
+			break;
+		}
+
+		clearerr(m_file);
+		m_inputBegin = m_inputEnd = 0;
+		m_position = 0;
+		m_good = true;
+		m_end = false;
+		m_frameComplete = true;
+
+		return true;
+	}
+
+	void InputFile::close() {
+		if (!m_file)
+			return;
+
+		switch (m_format) {
+#ifdef HAVE_ZLIB
+		case Compression::kGzip:
+			if (m_stream) {
+				inflateEnd(static_cast<z_stream *>(m_stream));
+				delete static_cast<z_stream *>(m_stream);
+			}
+			break;
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+		case Compression::kZstd:
+			ZSTD_freeDCtx(static_cast<ZSTD_DCtx *>(m_stream));
+			break;
+#endif /* HAVE_ZSTD */
+		default:
+			break;
+		}
+
+		fclose(m_file);
+
+		m_file = NULL;
+		m_stream = NULL;
+		m_format = Compression::kNone;
+		m_input.clear();
+		m_inputBegin = m_inputEnd = 0;
+	}
+
+	OutputFile::OutputFile() : m_file(NULL), m_stream(NULL), m_format(Compression::kNone), m_bytesWritten(0), m_good(true) {
+
+	}
+
+	OutputFile::~OutputFile() {
+		close();
+	}
+
+	bool OutputFile::open(const char *filename) {
+		close();
+
+		m_format = Compression::FromFilename(filename);
+
+		if (!Compression::IsSupported(m_format))
+			return false;
+
+		if (!(m_file = fopen(filename, m_format == Compression::kNone ? "w" : "wb")))
+			return false;
+
+		m_bytesWritten = 0;
+		m_good = true;
+
+		switch (m_format) {
+#ifdef HAVE_ZLIB
+		case Compression::kGzip:
+			{
+				z_stream *stream = new z_stream;
+				memset(stream, 0, sizeof(z_stream));
+
+				// 15 + 16 writes a gzip header instead of a zlib one.
+				if (deflateInit2(stream, COMPRESSION_GZIP_LEVEL, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+					delete stream;
+					fclose(m_file);
+					m_file = NULL;
+					return false;
+				}
+
+				m_stream = stream;
+			}
+			break;
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+		case Compression::kZstd:
+			{
+				ZSTD_CCtx *context = ZSTD_createCCtx();
+
+				if (!context) {
+					fclose(m_file);
+					m_file = NULL;
+					return false;
+				}
+
+				ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, COMPRESSION_ZSTD_LEVEL);
+				m_stream = context;
+			}
+			break;
+#endif /* HAVE_ZSTD */
+		default:
+			break;
+		}
+
+		m_output.resize(COMPRESSION_BUFFER_SIZE);
+
+		return true;
+	}
+
+	bool OutputFile::writeOutput(size_t length) {
+		if (length > 0 && fwrite(&m_output[0], 1, length, m_file) != length)
+			m_good = false;
+
+		m_bytesWritten += length;
+		return m_good;
+	}
+
+	bool OutputFile::compress(const char *data, size_t length, bool finish) {
+#if !defined(HAVE_ZLIB) && !defined(HAVE_ZSTD)
+		/*
+		 * Uncompressed output has no stream to end
+		 */
+
+		(void) finish;
+#endif /* !HAVE_ZLIB && !HAVE_ZSTD */
+
+		switch (m_format) {
+#ifdef HAVE_ZLIB
+		case Compression::kGzip:
+			{
+				z_stream *stream = static_cast<z_stream *>(m_stream);
+
+				do {
+					// avail_in is only 32 bits.
+					const size_t count = std::min(length, size_t(UINT_MAX));
+					stream->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+					stream->avail_in = uInt(count);
+					data += count;
+					length -= count;
+
+					const int flush = finish && length == 0 ? Z_FINISH : Z_NO_FLUSH;
+					int result;
+
+					do {
+						stream->next_out = reinterpret_cast<Bytef *>(&m_output[0]);
+						stream->avail_out = uInt(m_output.size());
+
+						if ((result = deflate(stream, flush)) == Z_STREAM_ERROR)
+							return m_good = false;
+
+						if (!writeOutput(m_output.size() - stream->avail_out))
+							return false;
+					} while (stream->avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+				} while (length > 0);
+			}
+			return m_good;
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+		case Compression::kZstd:
+			{
+				ZSTD_CCtx *context = static_cast<ZSTD_CCtx *>(m_stream);
+				ZSTD_inBuffer input = { data, length, 0 };
+				const ZSTD_EndDirective mode = finish ? ZSTD_e_end : ZSTD_e_continue;
+				size_t remaining;
+
+				do {
+					ZSTD_outBuffer output = { &m_output[0], m_output.size(), 0 };
+
+					if (ZSTD_isError(remaining = ZSTD_compressStream2(context, &output, &input, mode)))
+						return m_good = false;
+
+					if (!writeOutput(output.pos))
+						return false;
+				} while (finish ? remaining != 0 : input.pos < input.size);
+			}
+			return m_good;
+#endif /* HAVE_ZSTD */
+		default:
+			if (length > 0 && fwrite(data, 1, length, m_file) != length)
+				m_good = false;
+
+			m_bytesWritten += length;
+			return m_good;
+		}
+	}
+
+	bool OutputFile::write(const char *data, size_t length) {
+		if (!m_file)
+			return false;
+
+		return length == 0 || compress(data, length, false);
+	}
+
+	bool OutputFile::close() {
+		if (!m_file)
+			return m_good;
+
+		if (m_format != Compression::kNone)
+			compress("", 0, true);
+
+		switch (m_format) {
+#ifdef HAVE_ZLIB
+		case Compression::kGzip:
+			deflateEnd(static_cast<z_stream *>(m_stream));
+			delete static_cast<z_stream *>(m_stream);
+			break;
+#endif /* HAVE_ZLIB */
+#ifdef HAVE_ZSTD
+		case Compression::kZstd:
+			ZSTD_freeCCtx(static_cast<ZSTD_CCtx *>(m_stream));
+			break;
+#endif /* HAVE_ZSTD */
+		default:
+			break;
+		}
+
+		if (fclose(m_file) != 0)
+			m_good = false;
+
+		m_file = NULL;
+		m_stream = NULL;
+		m_output.clear();
+
+		return m_good;
+	}
+}
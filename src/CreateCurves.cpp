@@ -7,7 +7,6 @@
 #include <maya/MSelectionList.h>
 #include <maya/MGlobal.h>
 #include <maya/MFnDagNode.h>
-#include <maya/MItDag.h>
 
 #include <Helix.h>
 #include <HelixBase.h>
@@ -85,30 +84,10 @@ namespace Helix {
 				 * Extract all helices
 				 */
 
-				MItDag itDag(MItDag::kDepthFirst, MFn::kPluginTransformNode, &status);
-
-				if (!status) {
-					status.perror("MItDag::#ctor");
+				if (!(status = Model::Helix::All(helices))) {
+					status.perror("Helix::All");
 					return status;
 				}
-
-				for(; !itDag.isDone(); itDag.next()) {
-					MObject object = itDag.currentItem(&status);
-
-					if (!status) {
-						status.perror("MItDag::currentItem");
-						return status;
-					}
-
-					MFnDagNode dagNode(object);
-					if (dagNode.typeId(&status) == Helix::id)
-						helices.append(object);
-
-					if (!status) {
-						status.perror("MFnDagNode::typeId");
-						return status;
-					}
-				}
 			}
 		}
 		else {
@@ -14,6 +14,8 @@
 #include <Locator.h>
 #include <Utility.h>
 
+#include <controller/BuildExecutor.h>
+
 #include <cmath>
 #include <functional>
 
@@ -58,15 +60,8 @@ namespace Helix {
 
 		// Setup the progress window
 		//
-		if (showProgressBar) {
-			if (!MProgressWindow::reserve())
-				MGlobal::displayWarning("Failed to reserve the progress window");
-
-			MProgressWindow::setTitle("Create new helix");
-			MProgressWindow::setProgressStatus("Generating new helix bases...");
-			MProgressWindow::setProgressRange(0, bases * 2);
-			MProgressWindow::startProgress();
-		}
+		Controller::BuildExecutor executor("Create new helix", showProgressBar);
+		executor.begin("Generating new helix bases...", bases * 2);
 
 		/*
 		 * Create the helix
@@ -157,8 +152,14 @@ namespace Helix {
 				else
 					base_objects[j] = MObject::kNullObj;
 
-				if (showProgressBar)
-					MProgressWindow::advanceProgress(1);
+				if (!(created[j] ? executor.step() : executor.advance())) {
+					/*
+					 * Cancelled, the bases are removed with the helix
+					 */
+
+					HMEVALUATE(status = helix.deleteNode(), status);
+					return executor.finish();
+				}
 			}
 
 			/*
@@ -208,8 +209,7 @@ namespace Helix {
 		/*if (!(status = Model::Helix::RefreshCylinderOrBases()))
 			status.perror("Helix::RefreshCylinderOrBases");*/
 
-		if (showProgressBar)
-			MProgressWindow::endProgress();
+		HMEVALUATE(status = executor.finish(), status);
 
 		/*
 		 * Select the newly created Helix
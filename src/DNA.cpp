@@ -46,19 +46,28 @@ y=ystart-self.STEP*numBases/2.0+i*self.STEP+0.165
 
 		 */
 
+		double forward_array[3], backward_array[3];
+
+		CalculateBasePairPositions(index, forward_array, backward_array, offset, totalNumBases);
+
+		forward = MVector(forward_array);
+		backward = MVector(backward_array);
+
+		return MStatus::kSuccess;
+	}
+
+	void CalculateBasePairPositions(double index, double forward[3], double backward[3], double offset, double totalNumBases) {
 		double rad = Helix::toRadians(offset) + index * Helix::toRadians(-PITCH);
 
-		forward.x = ONE_MINUS_SPHERE_RADIUS * sin(rad);
-		forward.y = ONE_MINUS_SPHERE_RADIUS * cos(rad);
-		forward.z = index * STEP + Z_SHIFT - totalNumBases * STEP / 2;
+		forward[0] = ONE_MINUS_SPHERE_RADIUS * sin(rad);
+		forward[1] = ONE_MINUS_SPHERE_RADIUS * cos(rad);
+		forward[2] = index * STEP + Z_SHIFT - totalNumBases * STEP / 2;
 
 		rad += Helix::toRadians(OPPOSITE_ROTATION);
 
-		backward.x = ONE_MINUS_SPHERE_RADIUS * sin(rad);
-		backward.y = ONE_MINUS_SPHERE_RADIUS * cos(rad);
-		backward.z = index * STEP + Z_SHIFT - totalNumBases * STEP / 2;
-
-		return MStatus::kSuccess;
+		backward[0] = ONE_MINUS_SPHERE_RADIUS * sin(rad);
+		backward[1] = ONE_MINUS_SPHERE_RADIUS * cos(rad);
+		backward[2] = index * STEP + Z_SHIFT - totalNumBases * STEP / 2;
 	}
 
 	/*
@@ -13,10 +13,8 @@
 #include <maya/MSelectionList.h>
 #include <maya/MArgDatabase.h>
 #include <maya/MSyntax.h>
-#include <maya/MItDag.h>
 #include <maya/MCommandResult.h>
 #include <maya/MGlobal.h>
-#include <maya/MProgressWindow.h>
 #include <maya/MFnDagNode.h>
 
 #include <model/Helix.h>
@@ -30,26 +28,6 @@ namespace Helix {
 
 	}
 
-	void Duplicate::DuplicateWithProgressBar::onProgressStart(unsigned int process, unsigned int range) {
-		static const char *msg[] = { "Generating new helices and bases...", "Connecting bases..." };
-
-		if (!MProgressWindow::reserve())
-			MGlobal::displayWarning("Failed to reserve the progress window");
-
-		MProgressWindow::setTitle("Duplicate helices");
-		MProgressWindow::setProgressStatus(msg[process]);
-		MProgressWindow::setProgressRange(0, range);
-		MProgressWindow::startProgress();
-	}
-
-	void Duplicate::DuplicateWithProgressBar::onProgressStep() {
-		MProgressWindow::advanceProgress(1);
-	}
-
-	void Duplicate::DuplicateWithProgressBar::onProgressDone() {
-		MProgressWindow::endProgress();
-	}
-
 	MStatus Duplicate::doIt(const MArgList & args) {
 		// Find out our targets. First either by -target or selection
 		//
@@ -103,20 +81,9 @@ namespace Helix {
 			if (target_helices.length() == 0) {
 				// If there's still no selected helices, duplicate the whole scene
 
-				MItDag dagIt(MItDag::kBreadthFirst, MFn::kTransform, &status);
-
-				for(; !dagIt.isDone(); dagIt.next()) {
-					MObject node = dagIt.currentItem(&status);
-
-					if (!status) {
-						status.perror("MItDag::currentItem");
-						return status;
-					}
-
-					MFnDagNode node_dagNode(node);
-
-					if (node_dagNode.typeId(&status) == Helix::id)
-						target_helices.append(node);
+				if (!(status = Model::Helix::All(target_helices))) {
+					status.perror("Helix::All");
+					return status;
 				}
 			}
 		}
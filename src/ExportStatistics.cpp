@@ -0,0 +1,115 @@
+/*
+ * ExportStatistics.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <ExportStatistics.h>
+
+#include <sstream>
+
+namespace Helix {
+	ExportStatistics::ExportStatistics(const char *exporter) : exporter(exporter), helices(0), strands(0), bases(0), reused(0), bytes(0), m_current(kNumPhases), m_since(0.0) {
+		for (int i = 0; i < kNumPhases; ++i)
+			seconds[i] = 0.0;
+	}
+
+	const char *ExportStatistics::PhaseName(Phase phase) {
+		static const char *names[] = { "traversal", "capture", "materials", "layout", "format", "write" };
+
+		return phase < kNumPhases ? names[phase] : "";
+	}
+
+	double ExportStatistics::totalSeconds() const {
+		double total = 0.0;
+
+		for (int i = 0; i < kNumPhases; ++i)
+			total += seconds[i];
+
+		return total;
+	}
+
+	ExportStatistics::Phase ExportStatistics::enter(Phase phase) {
+		const double now = TextWriter::Now();
+		const Phase previous = m_current;
+
+		if (m_current != kNumPhases)
+			seconds[m_current] += now - m_since;
+
+		m_current = phase;
+		m_since = now;
+
+		return previous;
+	}
+
+	void ExportStatistics::leave(Phase previous) {
+		enter(previous);
+	}
+
+	void ExportStatistics::addFile(const TextWriter & file, Phase writtenIn) {
+		bytes += file.bytesWritten();
+		seconds[writtenIn] -= file.writeSeconds();
+		seconds[kWrite] += file.writeSeconds();
+	}
+
+	std::string ExportStatistics::str() const {
+		std::ostringstream stream;
+
+		stream << "Export statistics (" << exporter << "): " << filename << std::endl;
+
+		for (int i = 0; i < kNumPhases; ++i)
+			stream << PhaseName(Phase(i)) << ": " << seconds[i] << " s" << std::endl;
+
+		stream << "Total: " << totalSeconds() << " s" << std::endl
+			<< "Helices: " << helices << std::endl
+			<< "Strands: " << strands << " (" << reused << " reused)" << std::endl
+			<< "Bases: " << bases << std::endl
+			<< "Bytes: " << bytes;
+
+		return stream.str();
+	}
+
+	/*
+	 * Only the filename may need escaping
+	 */
+
+	static void WriteJSONString(TextWriter & output, const std::string & string) {
+		output << '"';
+
+		for (std::string::const_iterator it = string.begin(); it != string.end(); ++it) {
+			if (*it == '"' || *it == '\\')
+				output << '\\';
+
+			if ((unsigned char) *it >= 0x20)
+				output << *it;
+		}
+
+		output << '"';
+	}
+
+	void ExportStatistics::writeJSON(TextWriter & output) const {
+		output << "{\n\t\"exporter\": ";
+		WriteJSONString(output, exporter);
+		output << ",\n\t\"filename\": ";
+		WriteJSONString(output, filename);
+		output << ",\n\t\"seconds\": {";
+
+		for (int i = 0; i < kNumPhases; ++i)
+			output << (i > 0 ? ", " : " ") << '"' << PhaseName(Phase(i)) << "\": " << seconds[i];
+
+		output << " },\n\t\"total_seconds\": " << totalSeconds() << ",\n\t\"helices\": " << (unsigned long long) helices << ",\n\t\"strands\": " << (unsigned long long) strands <<
+			",\n\t\"reused\": " << (unsigned long long) reused << ",\n\t\"bases\": " << (unsigned long long) bases << ",\n\t\"bytes\": " << bytes << "\n}\n";
+	}
+
+	bool ExportStatistics::writeReport(const char *filename) const {
+		TextWriter output;
+
+		if (!output.open(filename))
+			return false;
+
+		writeJSON(output);
+
+		return output.close();
+	}
+}
@@ -10,10 +10,12 @@
 #include <HelixBase.h>
 #include <DNA.h>
 
+#include <Helix.h>
+
 #include <model/Helix.h>
+#include <model/StrandIndex.h>
 
 #include <maya/MSyntax.h>
-#include <maya/MItDag.h>
 #include <maya/MDagPath.h>
 #include <maya/MDagPathArray.h>
 #include <maya/MArgDatabase.h>
@@ -24,12 +26,35 @@
 #include <maya/MCommandResult.h>
 #include <maya/MProgressWindow.h>
 
-#include <list>
-#include <functional>
-#include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <string>
 
 namespace Helix {
+	/*
+	 * The statistics as "name=value" strings, the result of the -stats flag
+	 */
+
+	static MStatus StatisticsToStringArray(const ExportStatistics & statistics, MStringArray & result) {
+		MStatus status;
+
+		HMEVALUATE_RETURN(status = result.append(MString("exporter=") + statistics.exporter.c_str()), status);
+		HMEVALUATE_RETURN(status = result.append(MString("filename=") + statistics.filename.c_str()), status);
+
+		for (int i = 0; i < ExportStatistics::kNumPhases; ++i) {
+			HMEVALUATE_RETURN(status = result.append(MString(ExportStatistics::PhaseName(ExportStatistics::Phase(i))) + "=" + statistics.seconds[i]), status);
+		}
+
+		HMEVALUATE_RETURN(status = result.append(MString("total=") + statistics.totalSeconds()), status);
+		HMEVALUATE_RETURN(status = result.append(MString("helices=") + (unsigned int) statistics.helices), status);
+		HMEVALUATE_RETURN(status = result.append(MString("strands=") + (unsigned int) statistics.strands), status);
+		HMEVALUATE_RETURN(status = result.append(MString("reused=") + (unsigned int) statistics.reused), status);
+		HMEVALUATE_RETURN(status = result.append(MString("bases=") + (unsigned int) statistics.bases), status);
+		HMEVALUATE_RETURN(status = result.append(MString("bytes=") + std::to_string(statistics.bytes).c_str()), status);
+
+		return MStatus::kSuccess;
+	}
+
 	ExportStrands::ExportStrands() {
 
 	}
@@ -38,10 +63,39 @@ namespace Helix {
 
 	}
 
+	/*
+	 * Append the base, or all bases of the helix
+	 */
+
+	static MStatus AppendBases(const MObject & object, MObjectArray & bases) {
+		MStatus status;
+		MFnDagNode dagNode(object);
+		MTypeId typeId;
+
+		HMEVALUATE_RETURN(typeId = dagNode.typeId(&status), status);
+
+		if (typeId == HelixBase::id)
+			return bases.append(object);
+
+		if (typeId == Helix::id) {
+			Model::Helix helix(object);
+
+			for (Model::Helix::BaseIterator it = helix.begin(); it != helix.end(); ++it) {
+				MObject baseObject;
+				HMEVALUATE_RETURN(baseObject = it->getObject(status), status);
+				HMEVALUATE_RETURN(status = bases.append(baseObject), status);
+			}
+		}
+
+		return MStatus::kSuccess;
+	}
+
 	MStatus ExportStrands::doIt(const MArgList & args) {
 		MStatus status;
-		MDagPathArray targets;
-		MString excelFilePath;
+		MObjectArray bases;
+		MString filename, format, report;
+		unsigned int maxLength = 0;
+		bool full = false;
 
 		MArgDatabase argDatabase(syntax(), args, &status);
 
@@ -50,6 +104,10 @@ namespace Helix {
 			return status;
 		}
 
+		/*
+		 * Targets can be bases or helices, without any the selected bases, then the selected helices and then all bases are exported
+		 */
+
 		if (argDatabase.isFlagSet("-t")) {
 			unsigned int numTargets = argDatabase.numberOfFlagUses("-t");
 
@@ -68,136 +126,119 @@ namespace Helix {
 					return status;
 				}
 
-				MDagPath target_dagPath;
 				MObject target_object;
 
-				if (!(status = selectionList.getDagPath(0, target_dagPath, target_object))) {
-					status.perror("MSelectionList::getDagPath");
+				if (!(status = selectionList.getDependNode(0, target_object))) {
+					status.perror("MSelectionList::getDependNode");
 					return status;
 				}
 
-				targets.append(target_dagPath);
+				HMEVALUATE_RETURN(status = AppendBases(target_object, bases), status);
 			}
 		}
 
 		if (argDatabase.isFlagSet("-f")) {
-			if (!(status = argDatabase.getFlagArgument("-f", 0, excelFilePath))) {
+			if (!(status = argDatabase.getFlagArgument("-f", 0, filename))) {
 				status.perror("MArgDatabase::getFlagArgument 1");
 				return status;
 			}
 		}
 
-		if (targets.length() == 0) {
-			// Find out target by select, or all targets
-			//
-
-			MObjectArray selectedBases;
-
-			if (!(status = Model::Base::AllSelected(selectedBases))) {
-				status.perror("Helix::AllSelected");
-				return status;
-			}
+		if (argDatabase.isFlagSet("-fo")) {
+			HMEVALUATE_RETURN(status = argDatabase.getFlagArgument("-fo", 0, format), status);
+		}
 
-			if (selectedBases.length() == 0) {
-				// Export ALL bases, this might be a bit slow..
-				// TODO: Use Model::Base::All instead.
+		if (argDatabase.isFlagSet("-ml")) {
+			HMEVALUATE_RETURN(status = argDatabase.getFlagArgument("-ml", 0, maxLength), status);
+		}
 
-				MItDag dagIt(MItDag::kBreadthFirst, MFn::kTransform, &status);
+		if (argDatabase.isFlagSet("-fu")) {
+			HMEVALUATE_RETURN(status = argDatabase.getFlagArgument("-fu", 0, full), status);
+		}
 
-				if (!status) {
-					status.perror("MItDag::#ctor");
-					return status;
-				}
+		if (argDatabase.isFlagSet("-rp")) {
+			HMEVALUATE_RETURN(status = argDatabase.getFlagArgument("-rp", 0, report), status);
+		}
 
-				for(; !dagIt.isDone(); dagIt.next()) {
-					MDagPath dagPath;
+		const bool stats = argDatabase.isFlagSet("-st");
 
-					if (!(status = dagIt.getPath(dagPath))) {
-						status.perror("MItDag::getPath");
-						return status;
-					}
+		if (bases.length() == 0) {
+			HMEVALUATE_RETURN(status = Model::Base::AllSelected(bases), status);
+		}
 
-					MFnDagNode dagNode(dagPath);
+		if (bases.length() == 0) {
+			MObjectArray helices;
+			HMEVALUATE_RETURN(status = Model::Helix::AllSelected(helices), status);
 
-					if (dagNode.typeId(&status) == HelixBase::id) {
-						if (!(status = targets.append(dagPath))) {
-							status.perror("MObjectArray::append");
-							return status;
-						}
-					}
-				}
+			for (unsigned int i = 0; i < helices.length(); ++i) {
+				HMEVALUATE_RETURN(status = AppendBases(helices[i], bases), status);
 			}
-			else {
-				for(unsigned int i = 0; i < selectedBases.length(); ++i) {
-					MFnDagNode dagNode(selectedBases[i]);
-					MDagPath dagPath;
-
-					if (!(status = dagNode.getPath(dagPath))) {
-						status.perror("MFnDagNode::getPath");
-						return status;
-					}
+		}
 
-					targets.append(dagPath);
-				}
-			}
+		if (bases.length() == 0) {
+			HMEVALUATE_RETURN(status = Model::Base::All(bases), status);
 		}
 
-		if (targets.length() == 0) {
+		if (bases.length() == 0) {
 			MGlobal::displayError("Nothing to export");
 			return MStatus::kSuccess;
 		}
 
-		if (!MProgressWindow::reserve())
-			MGlobal::displayWarning("Failed to reserve the progress window");
+		if (filename.length() == 0) {
+			MCommandResult commandResult;
 
-		MProgressWindow::setTitle("Export strands");
-		MProgressWindow::setProgressStatus("Isolating strands");
-		MProgressWindow::setProgressRange(0, targets.length());
-		MProgressWindow::startProgress();		
+			if (!(status = MGlobal::executeCommand("fileDialog2 -caption \"Export to text file\" -fileFilter \"Comma-separated values (*.csv);;Colon-separated values (*.csv);;"
+					"Comma-separated values with header and strand ends (*.csv);;Plate layout (*.csv);;Plain text (*.txt);;All files (*.*)\" -rf true -fileMode 0", commandResult))) {
+				status.perror("MGlobal::executeCommand");
+				return status;
+			}
 
-		std::list<Model::Strand> strands;
-		std::list<Model::Strand>::iterator it;
+			MStringArray result;
 
-		for(unsigned int i = 0; i < targets.length(); ++i) {
-			Model::Base base(targets[i]);
+			if (!(status = commandResult.getResult(result))) {
+				status.perror("MCommandResult::getResult");
+				return status;
+			}
 
-			if ((it = std::find_if(strands.begin(), strands.end(), std::bind2nd(std::ptr_fun(&Model::Strand::Contains_base), base))) == strands.end()) {
+			if (result.length() < 1) {
 				/*
-				 * The strand represented by the Base is not already present, add it.
+				 * User cancelled the export operation
 				 */
 
-				strands.push_back(Model::Strand(base));
+				return MStatus::kSuccess;
 			}
 
-			MProgressWindow::advanceProgress(1);
-		}
-
-		MProgressWindow::endProgress();
-		
-		MCommandResult commandResult;
-
-		if (!(status = MGlobal::executeCommand("fileDialog2 -caption \"Export to text file\" -fileFilter \"Comma-separated values (*.csv);;Colon-separated values (*.csv);;Plain text (*.txt);;All files (*.*)\" -rf true -fileMode 0", commandResult))) {
-			status.perror("MGlobal::executeCommand");
-			return status;
-		}
-
-		MStringArray result;
-
-		if (!(status = commandResult.getResult(result))) {
-			status.perror("MCommandResult::getResult");
-			return status;
-		}
+			filename = result[0];
 
-		if (result.length() < 1) {
 			/*
-			 * User cancelled the export operation
+			 * The plain text and all files filters export colon-separated values
 			 */
 
-			return MStatus::kSuccess;
+			if (result.length() > 1) {
+				if (strstr(result[1].asChar(), "header") != NULL)
+					format = "csv";
+				else if (strstr(result[1].asChar(), "Plate") != NULL)
+					format = "plate";
+				else if (strstr(result[1].asChar(), "Comma") == NULL)
+					format = "colon";
+			}
+		}
+
+		Controller::ExportStrands::Mode mode = Controller::ExportStrands::COMMA_SEPARATED;
+
+		if (format == "colon")
+			mode = Controller::ExportStrands::COLON_SEPARATED;
+		else if (format == "csv")
+			mode = Controller::ExportStrands::CSV;
+		else if (format == "plate")
+			mode = Controller::ExportStrands::PLATE_LAYOUT;
+		else if (format.length() > 0 && format != "comma") {
+			MGlobal::displayError(MString("Unknown format \"") + format + "\", expected comma, colon, csv or plate");
+			return MStatus::kInvalidParameter;
 		}
 
 		/*
-		 * Do the actual data collection on the strands
+		 * Collect every strand once, in a single pass over the bases
 		 */
 
 		if (!MProgressWindow::reserve())
@@ -205,22 +246,51 @@ namespace Helix {
 
 		MProgressWindow::setTitle("Export strands");
 		MProgressWindow::setProgressStatus("Extracting strand sequences");
-		MProgressWindow::setProgressRange(0, (int) strands.size());
+		MProgressWindow::setProgressRange(0, (int) Model::StrandIndex::Instance().size());
 		MProgressWindow::startProgress();
 
-		std::for_each(strands.begin(), strands.end(), m_operation.execute());
+		ExportStatistics statistics("strands");
+		statistics.filename = filename.asChar();
+
+		m_operation.setMaxLength(maxLength);
+		m_operation.setIncremental(!full);
+
+		if (stats || report.length() > 0)
+			m_operation.setStatistics(&statistics);
+
+		status = m_operation.collect(bases);
 
 		MProgressWindow::endProgress();
 
+		if (!status) {
+			m_operation.setStatistics(NULL);
+			status.perror("ExportStrands::collect");
+			return status;
+		}
+
 		/*
 		 * Write to file
 		 */
 
-		if (!(status = m_operation.write(result[0], strstr(result[1].asChar(), "Comma") != NULL ? Controller::ExportStrands::COMMA_SEPARATED : Controller::ExportStrands::COLON_SEPARATED))) {
+		status = m_operation.write(filename, mode);
+		m_operation.setStatistics(NULL);
+
+		if (!status) {
 			status.perror("ExportStrands::write");
 			return status;
 		}
 
+		MGlobal::displayInfo(MString("Exported ") + (unsigned int) m_operation.size() + " strands to \"" + filename + "\", " + (unsigned int) m_operation.reused() + " unchanged since the previous export");
+
+		if (report.length() > 0 && !statistics.writeReport(report.asChar()))
+			MGlobal::displayWarning(MString("Failed to write the export report \"") + report + "\"");
+
+		if (stats) {
+			MStringArray result;
+			HMEVALUATE_RETURN(status = StatisticsToStringArray(statistics, result), status);
+			setResult(result);
+		}
+
 		return MStatus::kSuccess;
 	}
 
@@ -251,6 +321,12 @@ namespace Helix {
 		syntax.makeFlagMultiUse("-t");
 
 		syntax.addFlag("-e", "-excel", MSyntax::kString);
+		syntax.addFlag("-f", "-file", MSyntax::kString);
+		syntax.addFlag("-fo", "-format", MSyntax::kString);
+		syntax.addFlag("-ml", "-maxLength", MSyntax::kUnsigned);
+		syntax.addFlag("-fu", "-full", MSyntax::kBoolean);
+		syntax.addFlag("-st", "-stats");
+		syntax.addFlag("-rp", "-report", MSyntax::kString);
 
 		return syntax;
 	}
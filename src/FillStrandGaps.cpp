@@ -2,7 +2,6 @@
 #include <Utility.h>
 
 #include <maya/MFnDagNode.h>
-#include <maya/MItDag.h>
 #include <maya/MSyntax.h>
 
 #include <Helix.h>
@@ -49,18 +48,11 @@ namespace Helix {
 				 * Extract all helices
 				 */
 
-				MItDag itDag(MItDag::kDepthFirst, MFn::kPluginTransformNode, &status);
-				HMEVALUATE_RETURN_DESCRIPTION("MItDag::#ctor", status);
+				MObjectArray helices;
+				HMEVALUATE_RETURN(status = Model::Helix::All(helices), status);
 
-				for (; !itDag.isDone(); itDag.next()) {
-					MObject object;
-					HMEVALUATE_RETURN(object = itDag.currentItem(&status), status);
-
-					bool is_helix;
-					HMEVALUATE_RETURN(is_helix = MFnDagNode(object).typeId(&status) == Helix::id, status);
-					if (is_helix)
-						targets.push_back(object);
-				}
+				for (unsigned int i = 0; i < helices.length(); ++i)
+					targets.push_back(helices[i]);
 			}
 		}
 
@@ -12,7 +12,6 @@
 #include <model/Base.h>
 
 #include <maya/MSyntax.h>
-#include <maya/MItDag.h>
 #include <maya/MFnDagNode.h>
 #include <maya/MSelectionList.h>
 #include <maya/MGlobal.h>
@@ -36,20 +35,15 @@ namespace Helix {
 		// Traverse the scene, find bases and select the ones that does not have a backward connection (i think? :D)
 		//
 
-		MItDag itDag(MItDag::kBreadthFirst, MFn::kTransform, &status);
+		MObjectArray bases;
 
-		if (!status) {
-			status.perror("MItDag::#ctor");
+		if (!(status = Model::Base::All(bases))) {
+			status.perror("Base::All");
 			return status;
 		}
 
-		for (; !itDag.isDone(); itDag.next()) {
-			Model::Base base(itDag.currentItem(&status));
-
-			if (!status) {
-				status.perror("MItDag::currentItem");
-				return status;
-			}
+		for (unsigned int i = 0; i < bases.length(); ++i) {
+			Model::Base base(bases[i]);
 
 			if (base.type(status) == Model::Base::FIVE_PRIME_END)
 				activeSelectionList.add(base.getObject(status));
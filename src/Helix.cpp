@@ -8,6 +8,8 @@
 #include <Helix.h>
 #include <maya/MFnMatrixAttribute.h>
 
+#include <model/ChangeTracker.h>
+
 #include <view/ConnectSuggestionsLocatorNode.h>
 
 namespace Helix {
@@ -22,6 +24,12 @@ namespace Helix {
 
 	}
 
+	MStatus Helix::setDependentsDirty(const MPlug &plug, MPlugArray &plugArray) {
+		Model::ChangeTracker::Instance().touch(thisMObject());
+
+		return MPxTransform::setDependentsDirty(plug, plugArray);
+	}
+
 	void *Helix::creator() {
 		return new Helix();
 	}
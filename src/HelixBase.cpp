@@ -9,6 +9,7 @@
 #include <DNA.h>
 #include <Utility.h>
 #include <TargetHelixBaseBackward.h>
+#include <RepairConstraints.h>
 
 #include <maya/MFnNumericAttribute.h>
 #include <maya/MFnEnumAttribute.h>
@@ -25,6 +26,8 @@
 #include <algorithm>
 
 #include <model/Base.h>
+#include <model/ChangeTracker.h>
+#include <model/HelixEndIndex.h>
 #include <view/ConnectSuggestionsLocatorNode.h>
 
 namespace Helix {
@@ -66,7 +69,7 @@ namespace Helix {
 	MObject HelixBase::aForward, HelixBase::aBackward, HelixBase::aLabel;
 	MTypeId HelixBase::id(HELIX_HELIXBASE_ID);
 
-	HelixBase::HelixBase()/* : m_nodeRevived(false), m_nodeIsBeingRemoved(false)*/ {
+	HelixBase::HelixBase() : m_constraintsPending(false)/*, m_nodeRevived(false), m_nodeIsBeingRemoved(false)*/ {
 
 	}
 
@@ -74,6 +77,15 @@ namespace Helix {
 
 	}
 
+	void HelixBase::postConstructor() {
+		MPxTransform::postConstructor();
+
+		if (MFileIO::isReadingFile()) {
+			m_constraintsPending = true;
+			RepairConstraints::Enqueue(thisMObject());
+		}
+	}
+
 	//void HelixBase::postConstructor() {
 		// See the callback definition at the end of the file for information about what it does.
 		//
@@ -123,6 +135,35 @@ namespace Helix {
 	//	return MPxTransform::connectionBroken(plug, otherPlug, asSrc);
 	//}
 
+	MStatus HelixBase::setDependentsDirty(const MPlug &plug, MPlugArray &plugArray) {
+		const MObject attribute = plug.attribute();
+
+		if (attribute == MPxTransform::translate || attribute == MPxTransform::translateX || attribute == MPxTransform::translateY || attribute == MPxTransform::translateZ) {
+			Model::HelixEndIndex::Instance().invalidate(thisMObject());
+			Model::ChangeTracker::Instance().touch(thisMObject());
+
+			// Translations set while the file is being read are what fails to retarget the constraints.
+			if (!MFileIO::isReadingFile())
+				m_constraintsPending = false;
+		}
+		else if (attribute == aLabel) {
+			/*
+			 * The label of the opposite base is derived from this one
+			 */
+
+			Model::ChangeTracker & tracker(Model::ChangeTracker::Instance());
+			MPlugArray oppositePlugs;
+			tracker.touch(thisMObject());
+
+			if (MPlug(thisMObject(), aLabel).connectedTo(oppositePlugs, true, true)) {
+				for (unsigned int i = 0; i < oppositePlugs.length(); ++i)
+					tracker.touch(oppositePlugs[i].node());
+			}
+		}
+
+		return MPxTransform::setDependentsDirty(plug, plugArray);
+	}
+
 	void *HelixBase::creator() {
 		return new HelixBase();
 	}
@@ -0,0 +1,73 @@
+/*
+ * ImportStatistics.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <ImportStatistics.h>
+
+#include <sstream>
+
+namespace Helix {
+	void ImportStatistics::addDangling(const std::string & description) {
+		if (dangling.size() < IMPORT_MAX_DANGLING_DESCRIPTIONS)
+			dangling.push_back(description);
+
+		++danglingReferences;
+	}
+
+	std::string ImportStatistics::str() const {
+		std::ostringstream stream;
+
+		stream << "Helices: " << helices << std::endl
+			<< "Bases: " << bases << std::endl
+			<< "Strands: " << strands << std::endl
+			<< "Crossovers: " << crossovers << std::endl
+			<< "Dangling references: " << danglingReferences << std::endl;
+
+		for (std::vector<std::string>::const_iterator it(dangling.begin()); it != dangling.end(); ++it)
+			stream << "\t" << *it << std::endl;
+
+		if (danglingReferences > dangling.size())
+			stream << "\t(" << (danglingReferences - dangling.size()) << " more)" << std::endl;
+
+		stream << "Estimated build time: " << estimatedBuildSeconds() << " s";
+
+		return stream.str();
+	}
+
+	size_t ImportStatistics::CountStrands(size_t count, const std::vector< std::pair<unsigned int, unsigned int> > & connections) {
+		/*
+		 * Union-find over the bases, every connection between two bases not yet on the same strand merges two strands
+		 */
+
+		std::vector<size_t> parents(count);
+
+		for (size_t i = 0; i < count; ++i)
+			parents[i] = i;
+
+		size_t strands = count;
+
+		for (std::vector< std::pair<unsigned int, unsigned int> >::const_iterator it(connections.begin()); it != connections.end(); ++it) {
+			if (it->first >= count || it->second >= count)
+				continue;
+
+			size_t roots[] = { it->first, it->second };
+
+			for (int i = 0; i < 2; ++i) {
+				while (parents[roots[i]] != roots[i]) {
+					parents[roots[i]] = parents[parents[roots[i]]];
+					roots[i] = parents[roots[i]];
+				}
+			}
+
+			if (roots[0] != roots[1]) {
+				parents[roots[1]] = roots[0];
+				--strands;
+			}
+		}
+
+		return strands;
+	}
+}
@@ -15,6 +15,9 @@
 //#include <Locator.h>
 #include <Utility.h>
 
+#include <controller/JSONExporter.h>
+#include <model/Helix.h>
+
 #include <maya/MArgDatabase.h>
 #include <maya/MGlobal.h>
 #include <maya/MSyntax.h>
@@ -28,8 +31,11 @@
 #include <maya/MPlugArray.h>
 #include <maya/MQuaternion.h>
 #include <maya/MMatrix.h>
+#include <maya/MStringArray.h>
+#include <maya/MTimer.h>
 
 #include <cstring>
+#include <cstdio>
 
 //#include <json/json.h>
 
@@ -40,17 +46,101 @@
 
 namespace Helix {
 	MStatus JSONTranslator::writer (const MFileObject& file, const MString& optionsString, MPxFileTranslator::FileAccessMode mode) {
-		std::cerr << "Can't write JSON files yet" << std::endl;
+		MStatus status;
+		MObjectArray helices;
+		HMEVALUATE_RETURN(status = Model::Helix::AllSelected(helices), status);
 
-		return MStatus::kSuccess;
+		if (helices.length() == 0) {
+			HMEVALUATE_RETURN(status = Model::Helix::All(helices), status);
+		}
+
+		if (helices.length() == 0) {
+			MGlobal::displayError("Nothing to export. Aborting...");
+			return MStatus::kSuccess;
+		}
+
+		/*
+		 * Options: json_stats=1 reports the time of every phase of the export, json_report=<file> writes the same as JSON, see ExportStatistics
+		 */
+
+		unsigned int stats = 0;
+		MString report_filename;
+		MStringArray options_array;
+		optionsString.split(';', options_array);
+		for (unsigned int i = 0; i < options_array.length(); ++i) {
+			sscanf(options_array[i].asChar(), "json_stats=%u", &stats);
+
+			if (options_array[i].indexW("json_report=") == 0 && options_array[i].length() > strlen("json_report="))
+				report_filename = options_array[i].substringW(int(strlen("json_report=")), int(options_array[i].length()) - 1);
+		}
+
+		if (stats == 0 && report_filename.length() == 0)
+			return Controller::JSONExporter::Export(file.fullName().asChar(), helices);
+
+		ExportStatistics statistics("caDNAno");
+		statistics.filename = file.fullName().asChar();
+
+		HMEVALUATE_RETURN(status = Controller::JSONExporter::Export(file.fullName().asChar(), helices, &statistics), status);
+
+		if (stats != 0)
+			MGlobal::displayInfo(statistics.str().c_str());
+
+		if (report_filename.length() > 0 && !statistics.writeReport(report_filename.asChar()))
+			MGlobal::displayWarning(MString("Failed to write the export report \"") + report_filename + "\"");
+
+		return status;
 	}
 
 	MStatus JSONTranslator::reader (const MFileObject& file, const MString & options, MPxFileTranslator::FileAccessMode mode) {
-		return m_operator.parseFile(file.fullName().asChar());
+		MStatus status;
+
+		/*
+		 * Options: json_reader=dom uses the old jsoncpp based parser. json_benchmark=N reads the file N times with both parsers before importing it.
+		 * dry_run=1 parses and plans the file and reports what would be created, without creating anything
+		 */
+
+		Controller::JSONImporter::Reader reader = Controller::JSONImporter::kReaderStream;
+		unsigned int benchmark_iterations = 0, dry_run = 0;
+		MStringArray options_array;
+		options.split(';', options_array);
+		for (unsigned int i = 0; i < options_array.length(); ++i) {
+			char reader_name[16];
+
+			if (sscanf(options_array[i].asChar(), "json_reader=%15s", reader_name) == 1 && strcmp(reader_name, "dom") == 0)
+				reader = Controller::JSONImporter::kReaderDOM;
+
+			sscanf(options_array[i].asChar(), "json_benchmark=%u", &benchmark_iterations);
+			sscanf(options_array[i].asChar(), "dry_run=%u", &dry_run);
+		}
+
+		if (benchmark_iterations > 0) {
+			double streamSeconds, domSeconds;
+
+			HMEVALUATE_RETURN(status = Controller::JSONImporter::Benchmark(file.fullName().asChar(), benchmark_iterations, streamSeconds, domSeconds), status);
+
+			MGlobal::displayInfo(MString("Parsed \"") + file.fullName() + "\" " + benchmark_iterations + " times. Streaming parser: " + streamSeconds + " s, DOM parser: " + domSeconds + " s");
+		}
+
+		if (dry_run) {
+			ImportStatistics statistics;
+			MTimer timer;
+
+			timer.beginTimer();
+			status = Controller::JSONImporter::DryRun(file.fullName().asChar(), statistics, reader);
+			timer.endTimer();
+
+			HMEVALUATE_RETURN_DESCRIPTION("JSONImporter::DryRun", status);
+
+			MGlobal::displayInfo(MString("Dry run of \"") + file.fullName() + "\" in " + timer.elapsedTime() + " s, nothing was created\n" + statistics.str().c_str());
+
+			return MStatus::kSuccess;
+		}
+
+		return m_operator.parseFile(file.fullName().asChar(), reader);
 	}
 
 	bool JSONTranslator::haveWriteMethod () const {
-		return false;
+		return true;
 	}
 
 	bool JSONTranslator::haveReadMethod () const {
@@ -681,373 +771,5 @@ namespace Helix {
 		MProgressWindow::endProgress();
 
 		return MStatus::kSuccess;
-	}
-
-	//
-	// The JSON Exporter part
-	//
-
-	// Data structure for saving helices for export
-
-	class JSON_export_helix;
-
-	class JSON_export_base {
-	public:
-
-		MObject m_base;
-		int m_index;
-
-		JSON_export_helix *m_next_helix;
-		int m_next_base;
-
-		JSON_export_helix *m_prev_helix;
-		int m_prev_base;
-
-		inline JSON_export_base(const MObject & base, int index = -1, JSON_export_helix *next_helix = NULL, int next_base = -1, JSON_export_helix *prev_helix = NULL, int prev_base = -1) : m_base(base), m_index(index), m_next_helix(next_helix), m_next_base(next_base), m_prev_helix(prev_helix), m_prev_base(prev_base) {
-
-		}
-	};
-
-	class JSON_export_helix {
-	public:
-
-		MDagPath m_helix;
-		std::vector<JSON_export_base> m_strands[2]; // First scaf then stap
-		bool m_odd; // If the direction of the base is negative when projected on the Z-axis, m_odd is true
-
-		inline JSON_export_helix(const MDagPath & helix, bool odd = false) : m_helix(helix), m_odd(odd) {
-
-		}
-	};
-
-	// Utility method, looks up the connected bases from the given `base` and translates them using the table `helices` into pointers and indices
-
-	MStatus TranslateConnectionForExport(const MObject & base, const std::vector<JSON_export_helix> & helices, const JSON_export_helix **target_helices, int target_bases[2]) {
-		MStatus status;
-
-		MPlug plugs[] = { MPlug(base, HelixBase::aForward), MPlug(base, HelixBase::aBackward) };
-
-		for(size_t i = 0; i < 2; ++i) {
-			MPlugArray plugArray;
-			bool connected = plugs[i].connectedTo(plugArray, true, true, &status);
-
-			if (!status) {
-				status.perror("MPlugArray[i]::connectedTo");
-				return status;
-			}
-
-			bool foundConnection = false;
-
-			if (connected) {
-				// Find out if any of the connected is another base
-
-				for(unsigned int j = 0; j < plugArray.length(); ++j) {
-					MFnDagNode target_dagNode(plugArray[j].node(&status));
-
-					if (!status) {
-						status.perror("MPlugArray[j]::node");
-						return status;
-					}
-
-					if (target_dagNode.typeId(&status) == HelixBase::id) {
-						// We found a connected base, use this one
-
-						MObject target_base = target_dagNode.object(&status);
-
-						if (!status) {
-							status.perror("MFnDagNode::object");
-							return status;
-						}
-
-						// Find the base in the "table" of helices/bases
-
-						for(std::vector<JSON_export_helix>::const_iterator it = helices.begin(); it != helices.end(); ++it) {
-							for(unsigned int k = 0; k < 2; ++k) {
-								unsigned int l = 0;
-								for(std::vector<JSON_export_base>::const_iterator bit = it->m_strands[k].begin(); bit != it->m_strands[k].end(); ++bit, ++l) {
-									if (bit->m_base == target_base) {
-										target_helices[i] = &(*it);
-										target_bases[i] = l;//bit->m_index;
-
-										foundConnection = true;
-										break;
-									}
-								}
-							}
-
-							if (foundConnection)
-								break;
-						}
-					}
-
-					if (foundConnection)
-						break;
-				}
-			}
-
-			// Assume no connection exist
-
-			if (!foundConnection) {
-				target_helices[i] = NULL;
-				target_bases[i] = -1;
-			}
-		}
-
-		return MStatus::kSuccess;
-	}
-
-	// This method sets the m_odd flag, and projects all bases onto the XY-plane to figure out their ordering for m_index. It chooses scaf or stap depending on the direction of the helix
-
-	MStatus GenerateHelixBaseDataForExport(JSON_export_helix & helix) {
-		MStatus status;
-		MQuaternion rotation_quaternion;
-
-		if (!(status = MFnTransform(helix.m_helix).getRotation(rotation_quaternion, MSpace::kWorld))) {
-			status.perror("MFnTransform::getRotation");
-			return status;
-		}
-
-		helix.m_odd = (rotation_quaternion.asMatrix() * MVector::zAxis).z > 0.0;
-
-		// If odd is false, use the positive directed bases as the scaffold (along the z-axis)
-		// If odd is true, use the negative directed bases as the scaffold
-
-		std::cerr << "The helix " << helix.m_helix.fullPathName().asChar() << ", is an " << (helix.m_odd ? "odd" : "even") << " one" << std::endl;
-
-		MFnDagNode helix_dagNode(helix.m_helix);
-
-		MObjectArray unsorted_strands[2]; // We put them here as either 0 = scaf, 1 = stap, then later on we'll sort them using their z-axis value
-
-		size_t childCount = helix_dagNode.childCount(&status);
-
-		if (!status) {
-			status.perror("MFnDagNode::childCount");
-			return status;
-		}
-
-		for(unsigned int i = 0; i < childCount; ++i) {
-			MObject child_object = helix_dagNode.child(i, &status);
-
-			if (!status) {
-				status.perror("MFnDagNode::child");
-				return status;
-			}
-
-			MFnDagNode child_dagNode(child_object);
-
-			if (child_dagNode.typeId(&status) == HelixBase::id) {
-				bool isForward = HelixBase_isForward(child_object, &status);
-
-				if (!status) {
-					status.perror("HelixBase_isForward");
-					return status;
-				}
-
-				unsorted_strands[isForward ? 0 : 1].append(child_object);
-			}
-
-			if (!status) {
-				status.perror("MFnDagNode::typeId");
-				return status;
-			}
-		}
-
-		for(size_t i = 0; i < 2; ++i) {
-			MObjectArray sorted;
-
-			if (!(status = HelixBases_sort(unsorted_strands[i], sorted))) {
-				status.perror("HelixBases_sort");
-				return status;
-			}
-
-			// Now translate them into the structures, some cleanup here could increase performance
-
-			for(unsigned int j = 0; j < sorted.length(); ++j)
-				helix.m_strands[i].push_back(JSON_export_base(sorted[j]));
-		}
-
-		return MStatus::kSuccess;
-	}
-
-	// Using the m_odd attribute of the helix, and measuring the number of inter-helix connections between each pair of helix, try to figure out some kind of a logic structure
-
-	class JSON_export_helix_position {
-	public:
-		int m_num, m_row, m_col;
-
-		inline JSON_export_helix_position(int num = 0, int row = 0, int col = 0) : m_num(num), m_row(row), m_col(col) {
-
-		}
-	};
-
-	MStatus OptimizeConnectedHelicesOrdering(const std::vector<JSON_export_helix> & helices, std::vector<std::pair<JSON_export_helix *, JSON_export_helix_position> > & result) {
-
-		return MStatus::kSuccess;
-	}
-
-	MStatus JSONTranslator::writer (const MFileObject& file, const MString& optionsString, MPxFileTranslator::FileAccessMode mode) {
-		MStatus status;
-
-		Json::StyledWriter writer;
-		Json::Value root(Json::objectValue);
-
-		// Ok, now fill the JSON document with the scene data
-		//
-
-		std::vector<JSON_export_helix> helices;
-
-		MItDag dagIt(MItDag::kBreadthFirst, MFn::kTransform, &status);
-
-		for(; !dagIt.isDone(); dagIt.next()) {
-			MDagPath path;
-
-			if (!(status = dagIt.getPath(path))) {
-				status.perror("MItDag::getPath");
-				return status;
-			}
-
-			MFnDagNode dagNode(path);
-
-			if (dagNode.typeId(&status) == Helix::id) {
-				// Found a helix, export it
-
-				JSON_export_helix helix(path);
-
-				if (!(status = GenerateHelixBaseDataForExport(helix))) {
-					status.perror("GenerateHelixBaseDataForExport");
-					return status;
-				}
-
-				// Now the helix should contain all the bases, sorted on their z axis value, ready for export
-
-				helices.push_back(helix);
-			}
-
-			if (!status) {
-				status.perror("MFnDagNode::typeId");
-				return status;
-			}
-		}
-
-		// Now, iterate over the helices we're exporting to extract their targets
-		//
-
-		for(std::vector<JSON_export_helix>::iterator it = helices.begin(); it != helices.end(); ++it) {
-			for(size_t i = 0; i < 2; ++i) {
-				for(std::vector<JSON_export_base>::iterator bit = it->m_strands[i].begin(); bit != it->m_strands[i].end(); ++bit) {
-					const JSON_export_helix *target_helices[2];
-					int target_bases[2];
-
-					if (!(status = TranslateConnectionForExport(bit->m_base, helices, target_helices, target_bases))) {
-						status.perror("TranslateConnectionForExport");
-						return status;
-					}
-
-					// FIXME
-					bit->m_next_helix = const_cast<JSON_export_helix *>(target_helices[0]);
-					bit->m_prev_helix = const_cast<JSON_export_helix *>(target_helices[1]);
-					bit->m_next_base = target_bases[0];
-					bit->m_prev_base = target_bases[1];
-				}
-			}
-		}
-
-		// Ok, our structure is ready for export, just write it to the JSON interface
-		//
-
-		// DEBUG: Dump some info:
-
-		/*std::cerr << "Dumping data:" << std::endl;
-		for(std::vector<JSON_export_helix>::iterator it = helices.begin(); it != helices.end(); ++it) {
-			std::cerr << "Helix: " << it->m_helix.fullPathName().asChar() << std::endl;
-
-			for(size_t i = 0; i < 2; ++i) {
-				std::cerr << "strand no " << i << std::endl;
-
-				for(std::vector<JSON_export_base>::iterator bit = it->m_strands[i].begin(); bit != it->m_strands[i].end(); ++bit) {
-					std::cerr << MFnDagNode(bit->m_base).fullPathName() << ": [ ";
-					if (bit->m_prev_helix)
-						std::cerr << bit->m_prev_helix->m_helix.fullPathName().asChar();
-					else
-						std::cerr << "(null)";
-
-					std::cerr << ", " << bit->m_prev_base << ", ";
-					if (bit->m_next_helix)
-						std::cerr << bit->m_next_helix->m_helix.fullPathName().asChar();
-					else
-						std::cerr << "(null)";
-
-					std::cerr << ", " << bit->m_next_base << "]\t";
-				}
-
-				std::cerr << std::endl;
-			}
-		}
-
-
-		std::cerr << "End dump" << std::endl;*
-
-		std::string document = writer.write(root);
-		std::fstream fileh(file.fullName().asChar(), std::ios_base::out);
-
-		if (!fileh) {
-			MGlobal::displayError(MString("Failed to open file \"") + file.fullName() + "\" for writing");
-			return MStatus::kFailure;
-		}
-
-		// Fill the root JSON element with all elements required
-
-		// FIXME: Generate the correct date and all that...
-		root ["name"] = Json::Value(Json::StaticString("fixme"));
-
-		Json::Value & vstrands = root["vstrands"] = Json::Value(Json::arrayValue);
-
-		for(std::vector<JSON_export_helix>::iterator it = helices.begin(); it != helices.end(); ++it) {
-			Json::Value helix(Json::objectValue);
-
-			Json::Value strands[] = { helix["stap"] = Json::Value(Json::objectValue), helix["scaf"] = Json::Value(Json::objectValue) };
-
-			// Write staples and scaffolds arrays
-
-			for(size_t i = 0; i < 2; ++i) {
-				int prev_helix, next_helix; // These need to be figured out, we only have the pointer to the helices
-			}
-
-			// Write num, row, col, skip and loop (skip and loop are just arrays of zeroes)
-		}
-
-		fileh << document;
-
-		fileh.close();
-
-		return MStatus::kSuccess;
-	}
-
-	MPxFileTranslator::MFileKind JSONTranslator::identifyFile(const MFileObject& file, const char* buffer, short size) const {
-		MString filePath = file.resolvedFullName().toLowerCase();
-		return strstr(filePath.asChar(), ".json") != NULL ? MPxFileTranslator::kIsMyFileType : MPxFileTranslator::kNotMyFileType;
-	}
-
-	// The generic implementation part
-	//
-
-	bool JSONTranslator::haveWriteMethod () const {
-		return true;
-	}
-
-	bool JSONTranslator::haveReadMethod () const {
-		return true;
-	}
-
-	bool JSONTranslator::canBeOpened () const {
-		return true;
-	}
-
-	MString JSONTranslator::defaultExtension () const {
-		return MString("json");
-	}
-
-	void *JSONTranslator::creator() {
-		return new JSONTranslator();
 	}*/
 }
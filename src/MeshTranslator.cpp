@@ -0,0 +1,70 @@
+/*
+ * MeshTranslator.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <Utility.h>
+#include <MeshTranslator.h>
+
+#include <model/Helix.h>
+
+#include <cstdio>
+
+#include <maya/MStringArray.h>
+
+namespace Helix {
+	MStatus MeshTranslator::writer (const MFileObject& file, const MString& optionsString, MPxFileTranslator::FileAccessMode mode) {
+		MStatus status;
+		MObjectArray helices;
+		HMEVALUATE_RETURN(status = Model::Helix::AllSelected(helices), status);
+
+		if (helices.length() == 0) {
+			HMEVALUATE_RETURN(status = Model::Helix::All(helices), status);
+		}
+
+		if (helices.length() == 0) {
+			MGlobal::displayError("Nothing to export. Aborting...");
+			return MStatus::kSuccess;
+		}
+
+		/*
+		 * Options: mesh_cylinders=0 leaves out the helix cylinders. The file is compressed if the filename ends with .gz or .zst
+		 */
+
+		unsigned int cylinders = 1;
+		MStringArray options_array;
+		optionsString.split(';', options_array);
+		for (unsigned int i = 0; i < options_array.length(); ++i)
+			sscanf(options_array[i].asChar(), "mesh_cylinders=%u", &cylinders);
+
+		return Controller::MeshExporter::Export(file.fullName().asChar(), helices, cylinders != 0);
+	}
+
+	bool MeshTranslator::haveWriteMethod () const {
+		return true;
+	}
+
+	bool MeshTranslator::haveReadMethod () const {
+		return false;
+	}
+
+	bool MeshTranslator::canBeOpened () const {
+		return false;
+	}
+
+	MString MeshTranslator::defaultExtension () const {
+		return HELIX_GLTF_FILE_TYPE;
+	}
+
+	MPxFileTranslator::MFileKind MeshTranslator::identifyFile (const MFileObject& file, const char *buffer, short size) const {
+		Controller::MeshExporter::Format format;
+
+		return Controller::MeshExporter::FormatFromFilename(file.resolvedFullName().asChar(), format) ? MPxFileTranslator::kIsMyFileType : MPxFileTranslator::kNotMyFileType;
+	}
+
+	void *MeshTranslator::creator() {
+		return new MeshTranslator();
+	}
+}
@@ -0,0 +1,286 @@
+/*
+ * NickOptimizer.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <NickOptimizer.h>
+#include <Parallel.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace Helix {
+	/*
+	 * Runs the optimizer on one strand per index, used with ParallelFor
+	 */
+
+	class NickOptimizerFunctor {
+	public:
+		inline NickOptimizerFunctor(const NickOptimizer & optimizer, const std::vector<NickOptimizer::Strand> & strands, std::vector<NickOptimizer::Result> & results) : m_optimizer(optimizer), m_strands(strands), m_results(results) {
+
+		}
+
+		inline void operator() (size_t index) {
+			m_optimizer.optimize(m_strands[index], m_results[index]);
+		}
+
+	private:
+		const NickOptimizer & m_optimizer;
+		const std::vector<NickOptimizer::Strand> & m_strands;
+		std::vector<NickOptimizer::Result> & m_results;
+	};
+
+	void NickOptimizer::optimize(const Strand & strand, Result & result) const {
+		result.nicks.clear();
+		result.feasible = true;
+
+		if (strand.length == 0)
+			return;
+
+		/*
+		 * Linear strands can not be nicked at their 5' end
+		 */
+
+		std::vector<unsigned int> sites;
+		sites.reserve(strand.sites.empty() ? strand.length : strand.sites.size());
+
+		if (strand.sites.empty()) {
+			for (unsigned int i = strand.circular ? 0 : 1; i < strand.length; ++i)
+				sites.push_back(i);
+		}
+		else {
+			for (std::vector<unsigned int>::const_iterator it(strand.sites.begin()); it != strand.sites.end(); ++it) {
+				if (*it < strand.length && (strand.circular || *it > 0) && (sites.empty() || sites.back() != *it))
+					sites.push_back(*it);
+			}
+		}
+
+		if (strand.circular)
+			optimizeCircular(strand, sites, result);
+		else
+			optimizeLinear(strand, sites, result);
+	}
+
+	size_t NickOptimizer::optimize(const std::vector<Strand> & strands, std::vector<Result> & results) const {
+		results.resize(strands.size());
+
+		NickOptimizerFunctor functor(*this, strands, results);
+		ParallelFor(strands.size(), functor);
+
+		size_t infeasible = 0;
+
+		for (std::vector<Result>::const_iterator it(results.begin()); it != results.end(); ++it) {
+			if (!it->feasible)
+				++infeasible;
+		}
+
+		return infeasible;
+	}
+
+	bool NickOptimizer::solveLinear(const std::vector<unsigned int> & positions, const std::vector<double> & penalties, std::vector<unsigned int> & nicks, double & cost) const {
+		const size_t count = positions.size();
+		const unsigned int minLength = std::max(1u, m_options.minLength), maxLength = m_options.maxLength;
+		const double infinity = std::numeric_limits<double>::infinity();
+
+		std::vector<double> costs(count, infinity);
+		std::vector<size_t> previous(count, 0);
+		costs[0] = 0.0;
+
+		/*
+		 * Positions are sorted, thus the possible predecessors of every position form a window [first, last] sliding along the array
+		 */
+
+		size_t first = 0, last = 0;
+
+		for (size_t j = 1; j < count; ++j) {
+			while (first < j && positions[j] - positions[first] > maxLength)
+				++first;
+
+			while (last + 1 < j && positions[j] - positions[last + 1] >= minLength)
+				++last;
+
+			if (positions[j] - positions[last] < minLength)
+				continue;
+
+			for (size_t i = first; i <= last; ++i) {
+				if (costs[i] == infinity)
+					continue;
+
+				const double candidate = costs[i] + lengthCost(positions[j] - positions[i]) + penalties[j];
+
+				if (candidate < costs[j]) {
+					costs[j] = candidate;
+					previous[j] = i;
+				}
+			}
+		}
+
+		if (costs[count - 1] == infinity)
+			return false;
+
+		cost = costs[count - 1];
+		nicks.clear();
+
+		for (size_t j = previous[count - 1]; j != 0; j = previous[j])
+			nicks.push_back(positions[j]);
+
+		std::reverse(nicks.begin(), nicks.end());
+
+		return true;
+	}
+
+	void NickOptimizer::optimizeLinear(const Strand & strand, const std::vector<unsigned int> & sites, Result & result) const {
+		if (strand.length <= m_options.maxLength)
+			return;
+
+		std::vector<unsigned int> positions;
+		std::vector<double> penalties;
+		positions.reserve(sites.size() + 2);
+		penalties.reserve(sites.size() + 2);
+
+		positions.push_back(0);
+		penalties.push_back(0.0);
+
+		for (std::vector<unsigned int>::const_iterator it(sites.begin()); it != sites.end(); ++it) {
+			positions.push_back(*it);
+			penalties.push_back(sitePenalty(strand, *it));
+		}
+
+		positions.push_back(strand.length);
+		penalties.push_back(0.0);
+
+		double cost;
+
+		if (!solveLinear(positions, penalties, result.nicks, cost))
+			fallback(strand, sites, (strand.length + m_options.maxLength - 1) / m_options.maxLength - 1, result);
+	}
+
+	void NickOptimizer::optimizeCircular(const Strand & strand, const std::vector<unsigned int> & sites, Result & result) const {
+		if (sites.empty()) {
+			result.feasible = false;
+			return;
+		}
+
+		/*
+		 * Every solution has a nick within the first maxLength bases, try every such site as the one the strand is opened at
+		 * and solve the remaining linear problem
+		 */
+
+		std::vector<unsigned int> positions, nicks;
+		std::vector<double> penalties;
+		positions.reserve(sites.size() + 1);
+		penalties.reserve(sites.size() + 1);
+
+		double bestCost = std::numeric_limits<double>::infinity();
+
+		for (size_t s = 0; s < sites.size() && sites[s] <= m_options.maxLength; ++s) {
+			const unsigned int start = sites[s];
+
+			positions.clear();
+			penalties.clear();
+
+			positions.push_back(0);
+			penalties.push_back(0.0);
+
+			for (size_t i = 1; i < sites.size(); ++i) {
+				const unsigned int site = sites[(s + i) % sites.size()];
+				positions.push_back((site + strand.length - start) % strand.length);
+				penalties.push_back(sitePenalty(strand, site));
+			}
+
+			positions.push_back(strand.length);
+			penalties.push_back(0.0);
+
+			double cost;
+
+			if (!solveLinear(positions, penalties, nicks, cost))
+				continue;
+
+			cost += sitePenalty(strand, start);
+
+			if (cost < bestCost) {
+				bestCost = cost;
+
+				result.nicks.clear();
+				result.nicks.push_back(start);
+
+				for (std::vector<unsigned int>::const_iterator it(nicks.begin()); it != nicks.end(); ++it)
+					result.nicks.push_back((*it + start) % strand.length);
+
+				std::sort(result.nicks.begin(), result.nicks.end());
+			}
+		}
+
+		if (bestCost == std::numeric_limits<double>::infinity())
+			fallback(strand, sites, std::max(1u, (strand.length + m_options.maxLength - 1) / m_options.maxLength), result);
+	}
+
+	void NickOptimizer::fallback(const Strand & strand, const std::vector<unsigned int> & sites, unsigned int count, Result & result) const {
+		result.nicks.clear();
+		result.feasible = false;
+
+		count = std::min(count, (unsigned int) sites.size());
+
+		std::vector<bool> used(sites.size(), false);
+
+		for (unsigned int k = 0; k < count; ++k) {
+			const unsigned int desired = strand.circular ? (unsigned int) ((unsigned long long) k * strand.length / count) : (unsigned int) ((unsigned long long) (k + 1) * strand.length / (count + 1));
+
+			/*
+			 * Find the closest unused site, searching outwards from the first site not less than the desired offset
+			 */
+
+			const size_t index = size_t(std::lower_bound(sites.begin(), sites.end(), desired) - sites.begin());
+			size_t below = index, above = index, best = sites.size();
+
+			while (best == sites.size()) {
+				while (below > 0 && used[below - 1])
+					--below;
+
+				while (above < sites.size() && used[above])
+					++above;
+
+				if (below > 0 && (above == sites.size() || desired - sites[below - 1] <= sites[above] - desired))
+					best = below - 1;
+				else
+					best = above;
+			}
+
+			used[best] = true;
+			result.nicks.push_back(sites[best]);
+		}
+
+		std::sort(result.nicks.begin(), result.nicks.end());
+	}
+
+	double NickOptimizer::lengthCost(unsigned int length) const {
+		const double deviation = double(length) - double(m_options.targetLength);
+		return deviation * deviation;
+	}
+
+	double NickOptimizer::sitePenalty(const Strand & strand, unsigned int offset) const {
+		if (strand.crossovers.empty() || m_options.crossoverDistance == 0)
+			return 0.0;
+
+		/*
+		 * Distance to the closest crossover, wrapping around for circular strands
+		 */
+
+		std::vector<unsigned int>::const_iterator it(std::lower_bound(strand.crossovers.begin(), strand.crossovers.end(), offset));
+		unsigned int distance = std::numeric_limits<unsigned int>::max();
+
+		if (it != strand.crossovers.end())
+			distance = std::min(distance, *it - offset);
+		else if (strand.circular)
+			distance = std::min(distance, strand.crossovers.front() + strand.length - offset);
+
+		if (it != strand.crossovers.begin())
+			distance = std::min(distance, offset - *(it - 1));
+		else if (strand.circular)
+			distance = std::min(distance, offset + strand.length - strand.crossovers.back());
+
+		return distance < m_options.crossoverDistance ? m_options.crossoverPenalty * double(m_options.crossoverDistance - distance) : 0.0;
+	}
+}
@@ -0,0 +1,173 @@
+/*
+ * NickStrands.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <NickStrands.h>
+#include <DNA.h>
+#include <Utility.h>
+
+#include <controller/NickStrands.h>
+#include <model/Base.h>
+#include <model/StrandIndex.h>
+
+#include <maya/MSyntax.h>
+#include <maya/MArgDatabase.h>
+#include <maya/MGlobal.h>
+
+#include <algorithm>
+#include <list>
+
+#if defined(WIN32) || defined(WIN64)
+#include <unordered_set>
+#else
+#include <tr1/unordered_set>
+#endif /* N Windows */
+
+namespace Helix {
+	NickStrands::~NickStrands() {
+
+	}
+
+	MStatus NickStrands::doIt(const MArgList & args) {
+		MStatus status;
+		MArgDatabase argDatabase(syntax(), args, &status);
+		HMEVALUATE_RETURN_DESCRIPTION("MArgDatabase::#ctor", status);
+
+		int minLength = int(DNA::SHORTEST_STAPLE), maxLength = int(DNA::SHORTEST_LONGEST_STAPLE), targetLength = 0, crossoverDistance = NICK_CROSSOVER_DISTANCE;
+
+		if (argDatabase.isFlagSet("-min"))
+			HMEVALUATE_RETURN(status = argDatabase.getFlagArgument("-min", 0, minLength), status);
+
+		if (argDatabase.isFlagSet("-max"))
+			HMEVALUATE_RETURN(status = argDatabase.getFlagArgument("-max", 0, maxLength), status);
+
+		if (argDatabase.isFlagSet("-t"))
+			HMEVALUATE_RETURN(status = argDatabase.getFlagArgument("-t", 0, targetLength), status);
+
+		if (argDatabase.isFlagSet("-cd"))
+			HMEVALUATE_RETURN(status = argDatabase.getFlagArgument("-cd", 0, crossoverDistance), status);
+
+		if (minLength < 0 || maxLength <= 0 || minLength > maxLength || targetLength < 0 || crossoverDistance < 0) {
+			MGlobal::displayError("Invalid staple lengths given, 0 <= min <= max and max > 0 is required");
+			return MStatus::kInvalidParameter;
+		}
+
+		std::list<MObject> targets;
+		status = ArgList_GetModelObjects(args, syntax(), "-b", targets);
+		if (status != MStatus::kNotFound && status != MStatus::kSuccess) {
+			HMEVALUATE_RETURN_DESCRIPTION("ArgList_GetModelObjects", status);
+		}
+
+		if (targets.empty()) {
+			MObjectArray objects;
+			HMEVALUATE_RETURN(status = Model::Base::AllSelected(objects), status);
+
+			for (unsigned int i = 0; i < objects.length(); ++i)
+				targets.push_back(objects[i]);
+		}
+
+		if (targets.empty()) {
+			MGlobal::displayError("No bases given or selected");
+			return MStatus::kInvalidParameter;
+		}
+
+		/*
+		 * Describe every strand once, even if several of its bases are selected
+		 */
+
+#if defined(WIN32) || defined(WIN64)
+		typedef std::unordered_set<unsigned int> strand_set_t;
+#else
+		typedef std::tr1::unordered_set<unsigned int> strand_set_t;
+#endif /* N Windows */
+
+		Model::StrandIndex & strandIndex(Model::StrandIndex::Instance());
+		Controller::NickStrands nickStrands(NickOptimizer::Options(minLength, maxLength, targetLength, crossoverDistance));
+		strand_set_t strands;
+
+		for (std::list<MObject>::iterator it(targets.begin()); it != targets.end(); ++it) {
+			Model::StrandIndex::Entry entry;
+			HMEVALUATE_RETURN(status = strandIndex.find(Model::Base(*it), entry), status);
+
+			if (strands.insert(entry.strand).second)
+				HMEVALUATE_RETURN(status = nickStrands.add(strandIndex.strand(entry.strand)), status);
+		}
+
+		std::vector<Model::Base> nickBases;
+		nickStrands.optimize(nickBases);
+
+		if (nickStrands.infeasible() > 0)
+			MGlobal::displayWarning(MString("") + int(nickStrands.infeasible()) + " strands could not be nicked into staples of " + minLength + " to " + maxLength + " bases, they were cut into equally long pieces instead");
+
+		/*
+		 * A nick before a base is a disconnect of the forward connection of the base before it, which the undoable Disconnect operation handles.
+		 * Nothing is disconnected until all strands have been described as the strand index is invalidated by the first disconnect
+		 */
+
+		std::list<Model::Base> disconnectBases, paintBases;
+
+		for (std::vector<Model::Base>::iterator it(nickBases.begin()); it != nickBases.end(); ++it) {
+			Model::Base backward(it->backward(status));
+
+			if (status) {
+				disconnectBases.push_back(backward);
+				paintBases.push_back(*it);
+			}
+			else if (status != MStatus::kNotFound)
+				HMEVALUATE_RETURN_DESCRIPTION("Base::backward", status);
+		}
+
+		std::for_each(disconnectBases.begin(), disconnectBases.end(), m_operation.execute());
+		HMEVALUATE_RETURN(status = m_operation.status(), status);
+
+		HMEVALUATE_RETURN(status = m_functor.loadMaterials(), status);
+		for_each_ref(paintBases.begin(), paintBases.end(), m_functor);
+
+		MGlobal::displayInfo(MString("Nicked ") + int(nickStrands.size()) + " strands at " + int(disconnectBases.size()) + " sites");
+		setResult(int(disconnectBases.size()));
+
+		return m_functor.status();
+	}
+
+	MStatus NickStrands::undoIt() {
+		MStatus status;
+		HMEVALUATE_RETURN(status = m_operation.undo(), status);
+
+		return m_functor.undo();
+	}
+
+	MStatus NickStrands::redoIt() {
+		MStatus status;
+		HMEVALUATE_RETURN(status = m_operation.redo(), status);
+
+		return m_functor.redo();
+	}
+
+	bool NickStrands::isUndoable() const {
+		return true;
+	}
+
+	bool NickStrands::hasSyntax() const {
+		return true;
+	}
+
+	MSyntax NickStrands::newSyntax() {
+		MSyntax syntax;
+
+		syntax.addFlag("-b", "-base", MSyntax::kString);
+		syntax.makeFlagMultiUse("-b");
+		syntax.addFlag("-min", "-minLength", MSyntax::kLong);
+		syntax.addFlag("-max", "-maxLength", MSyntax::kLong);
+		syntax.addFlag("-t", "-targetLength", MSyntax::kLong);
+		syntax.addFlag("-cd", "-crossoverDistance", MSyntax::kLong);
+
+		return syntax;
+	}
+
+	void *NickStrands::creator() {
+		return new NickStrands();
+	}
+}
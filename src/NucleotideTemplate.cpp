@@ -0,0 +1,157 @@
+/*
+ * NucleotideTemplate.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <NucleotideTemplate.h>
+
+#include <cmath>
+
+namespace Helix {
+	/*
+	 * Coordinates in the standard reference frame of the base pair: x points towards the major groove, y towards the backbone
+	 * of this strand and z along it in the 5' to 3' direction. The helix axis of ideal B-DNA passes through the origin
+	 */
+
+	struct TemplateAtom {
+		const char *name;
+		double x, y, z;
+	};
+
+	static const TemplateAtom Backbone[] = {
+		{ "P", 0.261, 9.287, -1.246 },
+		{ "OP1", 0.131, 10.751, -1.414 },
+		{ "OP2", 1.297, 8.735, -0.345 },
+		{ "O5'", -1.148, 8.720, -0.778 },
+		{ "C5'", -2.109, 8.284, -1.758 },
+		{ "C4'", -3.085, 7.319, -1.129 },
+		{ "O4'", -2.576, 5.968, -1.272 },
+		{ "C3'", -3.324, 7.526, 0.360 },
+		{ "O3'", -4.693, 7.266, 0.677 },
+		{ "C2'", -2.431, 6.480, 1.008 }
+	};
+
+	static const TemplateAtom Adenine[] = {
+		{ "C1'", -2.479, 5.346, 0.000 },
+		{ "N9", -1.291, 4.498, 0.000 },
+		{ "C8", 0.024, 4.897, 0.000 },
+		{ "N7", 0.877, 3.902, 0.000 },
+		{ "C5", 0.071, 2.771, 0.000 },
+		{ "C6", 0.369, 1.398, 0.000 },
+		{ "N6", 1.611, 0.909, 0.000 },
+		{ "N1", -0.668, 0.532, 0.000 },
+		{ "C2", -1.912, 1.023, 0.000 },
+		{ "N3", -2.320, 2.290, 0.000 },
+		{ "C4", -1.267, 3.124, 0.000 }
+	};
+
+	static const TemplateAtom Thymine[] = {
+		{ "C1'", -2.481, 5.354, 0.000 },
+		{ "N1", -1.284, 4.500, 0.000 },
+		{ "C2", -1.462, 3.135, 0.000 },
+		{ "O2", -2.562, 2.608, 0.000 },
+		{ "N3", -0.298, 2.407, 0.000 },
+		{ "C4", 0.994, 2.897, 0.000 },
+		{ "O4", 1.944, 2.119, 0.000 },
+		{ "C5", 1.106, 4.338, 0.000 },
+		{ "C7", 2.466, 4.961, 0.001 },
+		{ "C6", -0.024, 5.057, 0.000 }
+	};
+
+	static const TemplateAtom Guanine[] = {
+		{ "C1'", -2.477, 5.399, 0.000 },
+		{ "N9", -1.289, 4.551, 0.000 },
+		{ "C8", 0.023, 4.962, 0.000 },
+		{ "N7", 0.870, 3.969, 0.000 },
+		{ "C5", 0.071, 2.833, 0.000 },
+		{ "C6", 0.424, 1.460, 0.000 },
+		{ "O6", 1.554, 0.955, 0.000 },
+		{ "N1", -0.700, 0.641, 0.000 },
+		{ "C2", -1.999, 1.087, 0.000 },
+		{ "N2", -2.949, 0.139, -0.001 },
+		{ "N3", -2.342, 2.364, 0.001 },
+		{ "C4", -1.265, 3.177, 0.000 }
+	};
+
+	static const TemplateAtom Cytosine[] = {
+		{ "C1'", -2.477, 5.402, 0.000 },
+		{ "N1", -1.285, 4.542, 0.000 },
+		{ "C2", -1.472, 3.158, 0.000 },
+		{ "O2", -2.628, 2.709, 0.001 },
+		{ "N3", -0.391, 2.344, 0.000 },
+		{ "C4", 0.837, 2.868, 0.000 },
+		{ "N4", 1.875, 2.027, 0.001 },
+		{ "C5", 1.056, 4.275, 0.000 },
+		{ "C6", -0.023, 5.068, 0.000 }
+	};
+
+	NucleotideTemplate::NucleotideTemplate(char base, double baseAngle) : m_size(0) {
+		const TemplateAtom *atoms;
+		size_t count;
+
+		switch (base) {
+		case 'A':
+		case 'a':
+			atoms = Adenine;
+			count = sizeof(Adenine) / sizeof(TemplateAtom);
+			m_residueName = "DA";
+			break;
+		case 'G':
+		case 'g':
+			atoms = Guanine;
+			count = sizeof(Guanine) / sizeof(TemplateAtom);
+			m_residueName = "DG";
+			break;
+		case 'C':
+		case 'c':
+			atoms = Cytosine;
+			count = sizeof(Cytosine) / sizeof(TemplateAtom);
+			m_residueName = "DC";
+			break;
+		default:
+			atoms = Thymine;
+			count = sizeof(Thymine) / sizeof(TemplateAtom);
+			m_residueName = "DT";
+			break;
+		}
+
+		/*
+		 * Rotate the frame so that the radial axis is at baseAngle from the dyad
+		 */
+
+		const double angle = baseAngle * M_PI / 180.0, cos_angle = std::cos(angle), sin_angle = std::sin(angle);
+
+		for (size_t i = 0; i < sizeof(Backbone) / sizeof(TemplateAtom) + count; ++i) {
+			const TemplateAtom & atom = i < sizeof(Backbone) / sizeof(TemplateAtom) ? Backbone[i] : atoms[i - sizeof(Backbone) / sizeof(TemplateAtom)];
+
+			m_names[m_size] = atom.name;
+			m_radial[m_size] = atom.x * cos_angle + atom.y * sin_angle;
+			m_tangential[m_size] = -atom.x * sin_angle + atom.y * cos_angle;
+			m_axial[m_size] = atom.z;
+			++m_size;
+		}
+	}
+
+	void NucleotideTemplate::transform(const double origin[3], const double radial[3], const double axial[3], double *x, double *y, double *z) const {
+		const double tangential[3] = {
+			axial[1] * radial[2] - axial[2] * radial[1],
+			axial[2] * radial[0] - axial[0] * radial[2],
+			axial[0] * radial[1] - axial[1] * radial[0]
+		};
+
+		/*
+		 * One loop per coordinate over the arrays of the template
+		 */
+
+		for (size_t i = 0; i < m_size; ++i)
+			x[i] = origin[0] + m_radial[i] * radial[0] + m_tangential[i] * tangential[0] + m_axial[i] * axial[0];
+
+		for (size_t i = 0; i < m_size; ++i)
+			y[i] = origin[1] + m_radial[i] * radial[1] + m_tangential[i] * tangential[1] + m_axial[i] * axial[1];
+
+		for (size_t i = 0; i < m_size; ++i)
+			z[i] = origin[2] + m_radial[i] * radial[2] + m_tangential[i] * tangential[2] + m_axial[i] * axial[2];
+	}
+}
@@ -0,0 +1,476 @@
+/*
+ * OxDnaTrajectory.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <OxDnaTrajectory.h>
+#include <Utility.h>
+
+#include <model/Helix.h>
+
+#include <maya/MSyntax.h>
+#include <maya/MArgDatabase.h>
+#include <maya/MGlobal.h>
+#include <maya/MFnTransform.h>
+#include <maya/MFnDependencyNode.h>
+#include <maya/MFnAnimCurve.h>
+#include <maya/MPoint.h>
+#include <maya/MPlug.h>
+#include <maya/MPlugArray.h>
+#include <maya/MProgressWindow.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(WIN32) || defined(WIN64)
+#include <unordered_map>
+#else
+#include <tr1/unordered_map>
+#endif /* N Windows */
+
+namespace Helix {
+	Controller::OxDnaTrajectory *OxDnaTrajectory::s_trajectory = NULL;
+	std::vector<MDagPath> OxDnaTrajectory::s_bases;
+	std::vector<unsigned int> OxDnaTrajectory::s_parents;
+	std::vector<MMatrix> OxDnaTrajectory::s_parentInverseMatrices;
+	std::vector<double> OxDnaTrajectory::s_translations;
+	int OxDnaTrajectory::s_startFrame = 1;
+	long OxDnaTrajectory::s_currentFrame = -1;
+	bool OxDnaTrajectory::s_followTime = true;
+
+	OxDnaTrajectory::OxDnaTrajectory() : m_previousFrame(-1), m_frame(-1), m_previousFollowTime(true), m_moved(false), m_keyframed(false) {
+
+	}
+
+	OxDnaTrajectory::~OxDnaTrajectory() {
+
+	}
+
+	MStatus OxDnaTrajectory::doIt(const MArgList & args) {
+		MStatus status;
+		MArgDatabase argDatabase(syntax(), args, &status);
+		HMEVALUATE_RETURN_DESCRIPTION("MArgDatabase::#ctor", status);
+
+		if (argDatabase.isFlagSet("-u")) {
+			Unload();
+			setResult(0);
+			return MStatus::kSuccess;
+		}
+
+		if (argDatabase.isFlagSet("-sf"))
+			HMEVALUATE_RETURN(status = argDatabase.getFlagArgument("-sf", 0, s_startFrame), status);
+
+		if (argDatabase.isFlagSet("-ft"))
+			HMEVALUATE_RETURN(status = argDatabase.getFlagArgument("-ft", 0, s_followTime), status);
+
+		if (argDatabase.isFlagSet("-f")) {
+			MString filename;
+			HMEVALUATE_RETURN(status = argDatabase.getFlagArgument("-f", 0, filename), status);
+
+			if (s_bases.empty()) {
+				MGlobal::displayError("No oxDNA structure to attach the trajectory to, import its topology and configuration first");
+				return MStatus::kFailure;
+			}
+
+			std::vector<Model::Base> bases;
+			bases.reserve(s_bases.size());
+
+			for (std::vector<MDagPath>::iterator it(s_bases.begin()); it != s_bases.end(); ++it)
+				bases.push_back(Model::Base(*it));
+
+			HMEVALUATE_RETURN(status = Load(filename.asChar(), bases), status);
+		}
+
+		if (!s_trajectory) {
+			MGlobal::displayError("No oxDNA trajectory attached");
+			return MStatus::kFailure;
+		}
+
+		if (argDatabase.isFlagSet("-fr")) {
+			int frame;
+			HMEVALUATE_RETURN(status = argDatabase.getFlagArgument("-fr", 0, frame), status);
+
+			if (frame < 0 || size_t(frame) >= s_trajectory->frames()) {
+				MGlobal::displayError(MString("Frame ") + frame + " is out of range, the trajectory has " + int(s_trajectory->frames()) + " frames");
+				return MStatus::kInvalidParameter;
+			}
+
+			m_bases = s_bases;
+			m_previousFrame = s_currentFrame;
+			HMEVALUATE_RETURN(status = GetTranslations(m_bases, m_previousTranslations), status);
+
+			if (!(status = ShowFrame(size_t(frame)))) {
+				SetTranslations(m_bases, m_previousTranslations);
+				status.perror("OxDnaTrajectory::ShowFrame");
+				return status;
+			}
+
+			m_moved = true;
+
+			m_frame = s_currentFrame;
+			HMEVALUATE_RETURN(status = GetTranslations(m_bases, m_translations), status);
+		}
+
+		if (argDatabase.isFlagSet("-k")) {
+			m_previousFollowTime = s_followTime;
+			m_keyframed = true;
+
+			if (!(status = Keyframe(m_curveModifier, m_curveChange))) {
+				/*
+				 * Failed commands aren't put on the undo queue, remove the curves and keys added so far
+				 */
+
+				m_curveChange.undoIt();
+				m_curveModifier.undoIt();
+				status.perror("OxDnaTrajectory::Keyframe");
+				return status;
+			}
+		}
+
+		setResult(int(s_trajectory->frames()));
+
+		return MStatus::kSuccess;
+	}
+
+	MStatus OxDnaTrajectory::Load(const char *filename, const std::vector<Model::Base> & bases) {
+		MStatus status;
+
+		/*
+		 * Open and resolve everything into temporaries first, a file that can't be read or bases that are gone leave the current trajectory attached
+		 */
+
+		Controller::OxDnaTrajectory *trajectory(new Controller::OxDnaTrajectory());
+
+		if (!trajectory->open(filename, bases.size())) {
+			delete trajectory;
+			MGlobal::displayError(MString("Unable to open file \"") + filename + "\" for reading.");
+			return MStatus::kFailure;
+		}
+
+		/*
+		 * Frames are given in world space, cache the inverse transform of every helix so that they can be set as local translations and keyframed
+		 */
+
+#if defined(WIN32) || defined(WIN64)
+		typedef std::unordered_map<Model::Helix, unsigned int> helix_index_map_t;
+#else
+		typedef std::tr1::unordered_map<Model::Helix, unsigned int> helix_index_map_t;
+#endif /* N Windows */
+
+		helix_index_map_t helixIndices;
+		std::vector<MDagPath> dagPaths;
+		std::vector<unsigned int> parents;
+		std::vector<MMatrix> parentInverseMatrices;
+		dagPaths.reserve(bases.size());
+		parents.reserve(bases.size());
+
+		for (std::vector<Model::Base>::const_iterator it(bases.begin()); it != bases.end(); ++it) {
+			Model::Base base(*it);
+			MDagPath dagPath(base.getDagPath(status));
+
+			if (!status) {
+				delete trajectory;
+				status.perror("Base::getDagPath");
+				return status;
+			}
+
+			Model::Helix helix(base.getParent(status));
+
+			if (!status) {
+				delete trajectory;
+				status.perror("Base::getParent");
+				return status;
+			}
+
+			helix_index_map_t::iterator helix_it(helixIndices.find(helix));
+
+			if (helix_it == helixIndices.end()) {
+				MDagPath helixDagPath(helix.getDagPath(status));
+
+				if (!status) {
+					delete trajectory;
+					status.perror("Helix::getDagPath");
+					return status;
+				}
+
+				helix_it = helixIndices.insert(std::make_pair(helix, (unsigned int) parentInverseMatrices.size())).first;
+				parentInverseMatrices.push_back(helixDagPath.inclusiveMatrixInverse());
+			}
+
+			dagPaths.push_back(dagPath);
+			parents.push_back(helix_it->second);
+		}
+
+		Unload();
+
+		s_trajectory = trajectory;
+		s_bases.swap(dagPaths);
+		s_parents.swap(parents);
+		s_parentInverseMatrices.swap(parentInverseMatrices);
+
+		MGlobal::displayInfo(MString("Attached the oxDNA trajectory \"") + filename + "\" with " + int(s_trajectory->frames()) + " frames to " + int(s_bases.size()) + " bases");
+
+		return MStatus::kSuccess;
+	}
+
+	void OxDnaTrajectory::Unload() {
+		delete s_trajectory;
+		s_trajectory = NULL;
+		s_bases.clear();
+		s_parents.clear();
+		s_parentInverseMatrices.clear();
+		s_translations.clear();
+		s_currentFrame = -1;
+	}
+
+	MStatus OxDnaTrajectory::ShowFrame(size_t frame) {
+		MStatus status;
+
+		if (!s_trajectory->readFrame(frame, s_translations)) {
+			MGlobal::displayError(MString("Failed to read frame ") + int(frame) + " of \"" + s_trajectory->filename().c_str() + "\", it is malformed or doesn't have " + int(s_bases.size()) + " nucleotides");
+			return MStatus::kFailure;
+		}
+
+		if (s_translations.size() != s_bases.size() * 3) {
+			MGlobal::displayError(MString("Frame ") + int(frame) + " of \"" + s_trajectory->filename().c_str() + "\" has " + int(s_translations.size() / 3) + " nucleotides, the structure has " + int(s_bases.size()));
+			return MStatus::kFailure;
+		}
+
+		for (size_t i = 0; i < s_bases.size(); ++i) {
+			const MPoint translation(MPoint(s_translations[i * 3], s_translations[i * 3 + 1], s_translations[i * 3 + 2]) * s_parentInverseMatrices[s_parents[i]]);
+			MFnTransform transform(s_bases[i], &status);
+			HMEVALUATE_RETURN_DESCRIPTION("MFnTransform::#ctor", status);
+
+			HMEVALUATE_RETURN(status = transform.setTranslation(MVector(translation), MSpace::kTransform), status);
+		}
+
+		s_currentFrame = long(frame);
+
+		return MStatus::kSuccess;
+	}
+
+	MStatus OxDnaTrajectory::GetTranslations(const std::vector<MDagPath> & bases, std::vector<MVector> & translations) {
+		MStatus status;
+
+		translations.resize(bases.size());
+
+		for (size_t i = 0; i < bases.size(); ++i) {
+			MFnTransform transform(bases[i], &status);
+			HMEVALUATE_RETURN_DESCRIPTION("MFnTransform::#ctor", status);
+
+			HMEVALUATE_RETURN(translations[i] = transform.getTranslation(MSpace::kTransform, &status), status);
+		}
+
+		return MStatus::kSuccess;
+	}
+
+	MStatus OxDnaTrajectory::SetTranslations(const std::vector<MDagPath> & bases, const std::vector<MVector> & translations) {
+		MStatus status;
+
+		for (size_t i = 0; i < bases.size(); ++i) {
+			MFnTransform transform(bases[i], &status);
+			HMEVALUATE_RETURN_DESCRIPTION("MFnTransform::#ctor", status);
+
+			HMEVALUATE_RETURN(status = transform.setTranslation(translations[i], MSpace::kTransform), status);
+		}
+
+		return MStatus::kSuccess;
+	}
+
+	MStatus OxDnaTrajectory::Keyframe(MDGModifier & modifier, MAnimCurveChange & change) {
+		if (!MProgressWindow::reserve())
+			MGlobal::displayWarning("Failed to reserve the progress window");
+
+		MProgressWindow::setTitle("oxDNA trajectory");
+		MProgressWindow::setProgressStatus("Setting keyframes...");
+		MProgressWindow::setProgressRange(0, int(s_trajectory->frames()));
+		MProgressWindow::setInterruptable(true);
+		MProgressWindow::startProgress();
+
+		const MStatus status = CreateKeys(modifier, change);
+
+		MProgressWindow::endProgress();
+
+		/*
+		 * The keyframes now drive the bases, don't move them on time changes as well
+		 */
+
+		if (status)
+			s_followTime = false;
+
+		return status;
+	}
+
+	MStatus OxDnaTrajectory::CreateKeys(MDGModifier & modifier, MAnimCurveChange & change) {
+		MStatus status;
+		static const char *attributes[] = { "translateX", "translateY", "translateZ" };
+
+		/*
+		 * Find or create all curves first, then read the frames one at a time so that only a single frame is kept in memory
+		 */
+
+		std::vector<MObject> curves(s_bases.size() * 3);
+		bool created = false;
+
+		for (size_t i = 0; i < s_bases.size(); ++i) {
+			MFnDependencyNode node(s_bases[i].node(), &status);
+			HMEVALUATE_RETURN_DESCRIPTION("MFnDependencyNode::#ctor", status);
+
+			for (size_t j = 0; j < 3; ++j) {
+				MPlug plug(node.findPlug(attributes[j], &status));
+				HMEVALUATE_RETURN_DESCRIPTION("MFnDependencyNode::findPlug", status);
+
+				/*
+				 * Reuse the curves of a previous -keyframe
+				 */
+
+				MPlugArray sources;
+
+				if (plug.connectedTo(sources, true, false) && sources.length() > 0 && sources[0].node().hasFn(MFn::kAnimCurve)) {
+					curves[i * 3 + j] = sources[0].node();
+					continue;
+				}
+
+				MFnAnimCurve curve;
+				curves[i * 3 + j] = curve.create(plug, &modifier, &status);
+				HMEVALUATE_RETURN_DESCRIPTION("MFnAnimCurve::create", status);
+				created = true;
+			}
+		}
+
+		if (created)
+			HMEVALUATE_RETURN(status = modifier.doIt(), status);
+
+		for (size_t frame = 0; frame < s_trajectory->frames(); ++frame) {
+			if (MProgressWindow::isCancelled()) {
+				MGlobal::displayWarning(MString("Keyframing was cancelled after ") + int(frame) + " frames");
+				break;
+			}
+
+			if (!s_trajectory->readFrame(frame, s_translations)) {
+				MGlobal::displayError(MString("Failed to read frame ") + int(frame) + " of \"" + s_trajectory->filename().c_str() + "\", it is malformed or doesn't have " + int(s_bases.size()) + " nucleotides");
+				return MStatus::kFailure;
+			}
+
+			if (s_translations.size() != s_bases.size() * 3) {
+				MGlobal::displayError(MString("Frame ") + int(frame) + " of \"" + s_trajectory->filename().c_str() + "\" has " + int(s_translations.size() / 3) + " nucleotides, the structure has " + int(s_bases.size()));
+				return MStatus::kFailure;
+			}
+
+			const MTime time(double(s_startFrame + int(frame)), MTime::uiUnit());
+
+			for (size_t i = 0; i < s_bases.size(); ++i) {
+				const MPoint translation(MPoint(s_translations[i * 3], s_translations[i * 3 + 1], s_translations[i * 3 + 2]) * s_parentInverseMatrices[s_parents[i]]);
+
+				for (size_t j = 0; j < 3; ++j) {
+					MFnAnimCurve curve(curves[i * 3 + j], &status);
+					HMEVALUATE_RETURN_DESCRIPTION("MFnAnimCurve::#ctor", status);
+
+					unsigned int index;
+
+					if (curve.find(time, index, &status)) {
+						HMEVALUATE_RETURN(status = curve.setValue(index, translation[unsigned(j)], &change), status);
+					}
+					else {
+						curve.addKey(time, translation[unsigned(j)], MFnAnimCurve::kTangentLinear, MFnAnimCurve::kTangentLinear, &change, &status);
+						HMEVALUATE_RETURN_DESCRIPTION("MFnAnimCurve::addKey", status);
+					}
+				}
+			}
+
+			MProgressWindow::advanceProgress(1);
+		}
+
+		return MStatus::kSuccess;
+	}
+
+	void OxDnaTrajectory::MDGMessage_TimeChange_CallbackFunc(MTime & time, void *clientData) {
+		if (!s_followTime || !s_trajectory)
+			return;
+
+		const long frame = std::max(0L, std::min(long(s_trajectory->frames()) - 1, long(std::floor(time.as(MTime::uiUnit()) + 0.5)) - s_startFrame));
+
+		if (frame == s_currentFrame)
+			return;
+
+		MStatus status;
+
+		if (!(status = ShowFrame(size_t(frame)))) {
+			/*
+			 * Most likely the bases were deleted
+			 */
+
+			MGlobal::displayWarning("Failed to show the oxDNA trajectory frame, detaching the trajectory");
+			Unload();
+		}
+	}
+
+	void OxDnaTrajectory::MSceneMessage_Unload_CallbackFunc(void *clientData) {
+		Unload();
+	}
+
+	MStatus OxDnaTrajectory::undoIt() {
+		MStatus status;
+
+		if (m_keyframed) {
+			HMEVALUATE_RETURN(status = m_curveChange.undoIt(), status);
+			HMEVALUATE_RETURN(status = m_curveModifier.undoIt(), status);
+			s_followTime = m_previousFollowTime;
+		}
+
+		if (m_moved) {
+			HMEVALUATE_RETURN(status = SetTranslations(m_bases, m_previousTranslations), status);
+			s_currentFrame = m_previousFrame;
+		}
+
+		return MStatus::kSuccess;
+	}
+
+	MStatus OxDnaTrajectory::redoIt() {
+		MStatus status;
+
+		if (m_moved) {
+			HMEVALUATE_RETURN(status = SetTranslations(m_bases, m_translations), status);
+			s_currentFrame = m_frame;
+		}
+
+		if (m_keyframed) {
+			HMEVALUATE_RETURN(status = m_curveModifier.doIt(), status);
+			HMEVALUATE_RETURN(status = m_curveChange.redoIt(), status);
+			s_followTime = false;
+		}
+
+		return MStatus::kSuccess;
+	}
+
+	/*
+	 * Attaching and detaching trajectories doesn't change the scene
+	 */
+
+	bool OxDnaTrajectory::isUndoable() const {
+		return m_moved || m_keyframed;
+	}
+
+	bool OxDnaTrajectory::hasSyntax() const {
+		return true;
+	}
+
+	MSyntax OxDnaTrajectory::newSyntax() {
+		MSyntax syntax;
+
+		syntax.addFlag("-f", "-file", MSyntax::kString);
+		syntax.addFlag("-fr", "-frame", MSyntax::kLong);
+		syntax.addFlag("-k", "-keyframe", MSyntax::kNoArg);
+		syntax.addFlag("-sf", "-startFrame", MSyntax::kLong);
+		syntax.addFlag("-ft", "-followTime", MSyntax::kBoolean);
+		syntax.addFlag("-u", "-unload", MSyntax::kNoArg);
+
+		return syntax;
+	}
+
+	void *OxDnaTrajectory::creator() {
+		return new OxDnaTrajectory();
+	}
+}
@@ -7,24 +7,49 @@
 
 #include <Utility.h>
 #include <OxDnaTranslator.h>
+#include <OxDnaTrajectory.h>
 
 #include <model/Base.h>
 #include <model/Helix.h>
+#include <model/StrandIndex.h>
 #include <controller/OxDnaExporter.h>
 #include <controller/OxDnaImporter.h>
 
 #include <algorithm>
+#include <cstdio>
 #include <functional>
 #include <limits>
+#include <vector>
 
 #include <maya/MProgressWindow.h>
+#include <maya/MStringArray.h>
+#include <maya/MTimer.h>
 
 namespace Helix {
 	/*
-	 * Helper method for obtaining the two filenames.
+	 * Length of a trailing ".gz" or ".zst" of filename, 0 if it has none
+	 */
+	int compression_suffix_length(const MString & filename) {
+		const char *suffixes[] = { ".gz", ".zst" };
+
+		for (int i = 0; i < 2; ++i) {
+			const int length = int(strlen(suffixes[i]));
+
+			if (int(filename.length()) > length && filename.rindexW(suffixes[i]) == int(filename.length()) - length)
+				return length;
+		}
+
+		return 0;
+	}
+
+	/*
+	 * Helper method for obtaining the two filenames. A compression suffix (.gz or .zst) is kept on all of them
 	 */
 	void get_filenames(const MFileObject& file, MString & topology_filename, MString & configuration_filename, MString & vhelix_filename) {
-		const MString filename(file.fullName());
+		const MString full_filename(file.fullName());
+		const int suffix_length = compression_suffix_length(full_filename);
+		const MString filename(full_filename.asChar(), full_filename.length() - suffix_length);
+		const MString suffix(full_filename.asChar() + (full_filename.length() - suffix_length));
 
 		int extension = filename.rindexW("." HELIX_OXDNA_CONF_FILE_TYPE);
 
@@ -36,20 +61,11 @@ namespace Helix {
 		}
 
 		const MString stripped_filename(filename.asChar(), extension != -1 ? extension : filename.length());
-		configuration_filename = stripped_filename + "." HELIX_OXDNA_CONF_FILE_TYPE;
-		topology_filename = stripped_filename + "." HELIX_OXDNA_TOP_FILE_TYPE;
-		vhelix_filename = stripped_filename + "." HELIX_OXDNA_VHELIX_FILE_TYPE;
+		configuration_filename = stripped_filename + "." HELIX_OXDNA_CONF_FILE_TYPE + suffix;
+		topology_filename = stripped_filename + "." HELIX_OXDNA_TOP_FILE_TYPE + suffix;
+		vhelix_filename = stripped_filename + "." HELIX_OXDNA_VHELIX_FILE_TYPE + suffix;
 	}
 
-	class OxDnaExporterWithAdvanceProgress : public Controller::OxDnaExporter {
-	protected:
-
-		MStatus doExecute(Model::Strand & element) {
-			MProgressWindow::advanceProgress(1);
-			return Controller::OxDnaExporter::doExecute(element);
-		}
-	};
-
 	class OxDnaImportWithAdvanceProgress : public Controller::OxDnaImporter {
 	protected:
 		void onProcessStart(int count) {
@@ -85,45 +101,53 @@ namespace Helix {
 			return MStatus::kSuccess;
 		}
 
-		if (!MProgressWindow::reserve())
-			MGlobal::displayWarning("Failed to reserve the progress window");
+		/*
+		 * Options: oxdna_float=default|shortest|fixed selects how coordinates are formatted, oxdna_precision=<n> the significant digits
+		 * or decimals of the default and fixed formats. oxdna_benchmark=<n> writes the files n times with both the buffered writer and
+		 * the original iostream implementation and reports the times and whether the output is identical. oxdna_vhelix=0 skips the .vhelix
+		 * glue file, which also skips looking up the names and materials of all bases. oxdna_compression_benchmark=<n> writes the files n times
+		 * uncompressed, with gzip and with zstd and reports the time and size of each. The files are compressed if the filename ends with .gz or .zst.
+		 * oxdna_incremental=0 captures every strand again instead of reusing the strands that haven't changed since the previous export.
+		 * oxdna_stats=1 reports the time of every phase of the export, oxdna_report=<file> writes the same as JSON, see ExportStatistics
+		 */
+
+		unsigned int precision = 6, benchmark = 0, compression_benchmark = 0, vhelix = 1, incremental = 1, stats = 0;
+		TextWriter::Format format = TextWriter::kDefault;
+		MString report_filename;
+		MStringArray options_array;
+		optionsString.split(';', options_array);
+		for (unsigned int i = 0; i < options_array.length(); ++i) {
+			sscanf(options_array[i].asChar(), "oxdna_precision=%u", &precision);
+			sscanf(options_array[i].asChar(), "oxdna_benchmark=%u", &benchmark);
+			sscanf(options_array[i].asChar(), "oxdna_compression_benchmark=%u", &compression_benchmark);
+			sscanf(options_array[i].asChar(), "oxdna_vhelix=%u", &vhelix);
+			sscanf(options_array[i].asChar(), "oxdna_incremental=%u", &incremental);
+			sscanf(options_array[i].asChar(), "oxdna_stats=%u", &stats);
+
+			if (options_array[i].indexW("oxdna_report=") == 0 && options_array[i].length() > strlen("oxdna_report="))
+				report_filename = options_array[i].substringW(int(strlen("oxdna_report=")), int(options_array[i].length()) - 1);
+
+			if (options_array[i] == "oxdna_float=shortest")
+				format = TextWriter::kShortest;
+			else if (options_array[i] == "oxdna_float=fixed")
+				format = TextWriter::kFixed;
+		}
 
-		MProgressWindow::setTitle("oxDNA Exporter");
-		MProgressWindow::setProgressStatus("Identifying strands...");
-		MProgressWindow::setProgressRange(0, helices.length());
-		MProgressWindow::startProgress();
+		/*
+		 * The benchmarks time the writes themselves
+		 */
 
-		MVector minTranslation(std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()),
-				maxTranslation(-std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity());
+		ExportStatistics statistics("oxDNA");
+		const bool timed = (stats != 0 || report_filename.length() > 0) && benchmark == 0 && compression_benchmark == 0;
 
-		// Since a strand is defined by any base along it, the same strand will be obtained multiple times if we don't track them.
-		// This is pretty slow but, since it is only run once it should be ok.
+		MVector minTranslation, maxTranslation;
 		std::list<Model::Strand> strands;
 
-		for (unsigned int i = 0; i < helices.length(); ++i) {
-			Model::Helix helix(helices[i]);
-
-			for (Model::Helix::BaseIterator it = helix.begin(); it != helix.end(); ++it) {
-				MVector translation;
-				HMEVALUATE_RETURN(status = it->getTranslation(translation, MSpace::kWorld), status);
-
-				minTranslation.x = std::min(minTranslation.x, translation.x);
-				minTranslation.y = std::min(minTranslation.y, translation.y);
-				minTranslation.z = std::min(minTranslation.z, translation.z);
-
-				maxTranslation.x = std::max(maxTranslation.x, translation.x);
-				maxTranslation.y = std::max(maxTranslation.y, translation.y);
-				maxTranslation.z = std::max(maxTranslation.z, translation.z);
-
-				if (std::find_if(strands.begin(), strands.end(), std::bind2nd(std::ptr_fun(&Model::Strand::Contains_base), *it)) == strands.end())
-					strands.push_back(*it);
-			}
-
-			MProgressWindow::advanceProgress(1);
+		{
+			ExportPhaseTimer traversalTimer(timed ? &statistics : NULL, ExportStatistics::kTraversal);
+			HMEVALUATE_RETURN(status = CollectStrands(helices, "oxDNA Exporter", strands, &minTranslation, &maxTranslation), status);
 		}
 
-		MProgressWindow::endProgress();
-
 		if (!MProgressWindow::reserve())
 			MGlobal::displayWarning("Failed to reserve the progress window");
 
@@ -132,7 +156,14 @@ namespace Helix {
 		MProgressWindow::setProgressRange(0, helices.length());
 		MProgressWindow::startProgress();
 
-		OxDnaExporterWithAdvanceProgress exporter;
+		ExporterWithAdvanceProgress<Controller::OxDnaExporter> exporter;
+		exporter.setFormat(format, int(precision));
+		exporter.setVhelix(vhelix != 0);
+		exporter.setIncremental(incremental != 0);
+
+		if (timed)
+			exporter.setStatistics(&statistics);
+
 		HMEVALUATE(std::for_each(strands.begin(), strands.end(), exporter.execute()), exporter.status());
 
 		MProgressWindow::endProgress();
@@ -143,9 +174,34 @@ namespace Helix {
 		MString top_filename, conf_filename, vhelix_filename;
 		get_filenames(file, top_filename, conf_filename, vhelix_filename);
 
+		if (benchmark > 0) {
+			double writerSeconds, streamSeconds;
+			status = exporter.benchmark(top_filename.asChar(), conf_filename.asChar(), vhelix_filename.asChar(), minTranslation, maxTranslation, benchmark, writerSeconds, streamSeconds);
+
+			MGlobal::displayInfo(MString("oxDNA export benchmark, ") + benchmark + " iterations: buffered writer " + writerSeconds + " s, iostreams " + streamSeconds + " s, output " + (status ? "identical" : "differs"));
+			return status;
+		}
+
+		if (compression_benchmark > 0) {
+			HMEVALUATE_RETURN(status = exporter.benchmarkCompression(top_filename.asChar(), conf_filename.asChar(), vhelix_filename.asChar(), minTranslation, maxTranslation, compression_benchmark), status);
+			return status;
+		}
+
 		HMEVALUATE_RETURN(status = exporter.write(
 				top_filename.asChar(), conf_filename.asChar(), vhelix_filename.asChar(), minTranslation, maxTranslation), status);
 
+		MGlobal::displayInfo(MString("Exported ") + (unsigned int) strands.size() + " strands to \"" + top_filename + "\", " + (unsigned int) exporter.reused() + " unchanged since the previous export");
+
+		if (timed) {
+			statistics.filename = top_filename.asChar();
+
+			if (stats != 0)
+				MGlobal::displayInfo(statistics.str().c_str());
+
+			if (report_filename.length() > 0 && !statistics.writeReport(report_filename.asChar()))
+				MGlobal::displayWarning(MString("Failed to write the export report \"") + report_filename + "\"");
+		}
+
 		return status;
 	}
 
@@ -155,12 +211,54 @@ namespace Helix {
 		MString top_filename, conf_filename, vhelix_filename;
 		get_filenames(file, top_filename, conf_filename, vhelix_filename);
 
+		/*
+		 * Options: dry_run=1 parses the files and reports what would be created and how long parsing took, without creating anything.
+		 * oxdna_parse_only=1 is the same. oxdna_trajectory=<file> attaches a trajectory to the imported bases, see the oxDnaTrajectory command
+		 */
+
+		unsigned int dry_run = 0;
+		MString trajectory_filename;
+		MStringArray options_array;
+		options.split(';', options_array);
+		for (unsigned int i = 0; i < options_array.length(); ++i) {
+			sscanf(options_array[i].asChar(), "oxdna_parse_only=%u", &dry_run);
+			sscanf(options_array[i].asChar(), "dry_run=%u", &dry_run);
+
+			if (options_array[i].indexW("oxdna_trajectory=") == 0 && options_array[i].length() > strlen("oxdna_trajectory="))
+				trajectory_filename = options_array[i].substringW(int(strlen("oxdna_trajectory=")), int(options_array[i].length()) - 1);
+		}
+
+		if (dry_run) {
+			ImportStatistics statistics;
+			MTimer timer;
+
+			timer.beginTimer();
+			status = Controller::OxDnaImporter::DryRun(top_filename.asChar(), conf_filename.asChar(), vhelix_filename.asChar(), statistics);
+			timer.endTimer();
+
+			HMEVALUATE_RETURN_DESCRIPTION("OxDnaImporter::DryRun", status);
+
+			MGlobal::displayInfo(MString("Dry run of \"") + top_filename + "\" in " + timer.elapsedTime() + " s, nothing was created\n" + statistics.str().c_str());
+
+			return MStatus::kSuccess;
+		}
+
 		OxDnaImportWithAdvanceProgress importer;
 
 		HMEVALUATE(status = importer.read(top_filename.asChar(), conf_filename.asChar(), vhelix_filename.asChar()), status);
 
 		MProgressWindow::endProgress();
 
+		/*
+		 * A configuration file with several frames is a trajectory, make it possible to play it back
+		 */
+
+		if (status && trajectory_filename.length() == 0 && importer.frames() > 1)
+			trajectory_filename = conf_filename;
+
+		if (status && trajectory_filename.length() > 0)
+			HMEVALUATE(status = OxDnaTrajectory::Load(trajectory_filename.asChar(), importer.bases()), status);
+
 		return status;
 	}
 
@@ -181,7 +279,8 @@ namespace Helix {
 	}
 
 	MPxFileTranslator::MFileKind OxDnaTranslator::identifyFile (const MFileObject& file, const char *buffer, short size) const {
-		const MString filename(file.resolvedFullName().toLowerCase());
+		const MString full_filename(file.resolvedFullName().toLowerCase());
+		const MString filename(full_filename.asChar(), full_filename.length() - compression_suffix_length(full_filename));
 
 		if (filename.rindexW("." HELIX_OXDNA_CONF_FILE_TYPE) == int(filename.length()) - int(strlen(HELIX_OXDNA_CONF_FILE_TYPE)) - 1 ||
 			filename.rindexW("." HELIX_OXDNA_TOP_FILE_TYPE) == int(filename.length()) - int(strlen(HELIX_OXDNA_TOP_FILE_TYPE)) - 1)
@@ -190,6 +289,74 @@ namespace Helix {
 			return MPxFileTranslator::kNotMyFileType;
 	}
 
+	MStatus OxDnaTranslator::CollectStrands(const MObjectArray & helices, const MString & title, std::list<Model::Strand> & strands, MVector *minTranslation, MVector *maxTranslation) {
+		MStatus status;
+
+		if (!MProgressWindow::reserve())
+			MGlobal::displayWarning("Failed to reserve the progress window");
+
+		MProgressWindow::setTitle(title);
+		MProgressWindow::setProgressStatus("Identifying strands...");
+		MProgressWindow::setProgressRange(0, helices.length());
+		MProgressWindow::startProgress();
+
+		if (minTranslation && maxTranslation) {
+			*minTranslation = MVector(std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+			*maxTranslation = -*minTranslation;
+		}
+
+		// Since a strand is defined by any base along it, the same strand will be obtained multiple times if we don't track them.
+		// The strand index gives every base a strand id so this is just a lookup.
+		Model::StrandIndex & strandIndex(Model::StrandIndex::Instance());
+		std::vector<bool> visitedStrands(strandIndex.size(), false);
+
+		for (unsigned int i = 0; i < helices.length(); ++i) {
+			Model::Helix helix(helices[i]);
+
+			for (Model::Helix::BaseIterator it = helix.begin(); it != helix.end(); ++it) {
+				if (minTranslation && maxTranslation) {
+					MVector translation;
+					HMEVALUATE(status = it->getTranslation(translation, MSpace::kWorld), status);
+
+					if (!status) {
+						MProgressWindow::endProgress();
+						return status;
+					}
+
+					minTranslation->x = std::min(minTranslation->x, translation.x);
+					minTranslation->y = std::min(minTranslation->y, translation.y);
+					minTranslation->z = std::min(minTranslation->z, translation.z);
+
+					maxTranslation->x = std::max(maxTranslation->x, translation.x);
+					maxTranslation->y = std::max(maxTranslation->y, translation.y);
+					maxTranslation->z = std::max(maxTranslation->z, translation.z);
+				}
+
+				Model::StrandIndex::Entry entry;
+				HMEVALUATE(status = strandIndex.find(*it, entry), status);
+
+				if (!status) {
+					MProgressWindow::endProgress();
+					return status;
+				}
+
+				if (entry.strand >= visitedStrands.size())
+					visitedStrands.resize(strandIndex.size(), false);
+
+				if (!visitedStrands[entry.strand]) {
+					visitedStrands[entry.strand] = true;
+					strands.push_back(strandIndex.strand(entry.strand).front());
+				}
+			}
+
+			MProgressWindow::advanceProgress(1);
+		}
+
+		MProgressWindow::endProgress();
+
+		return MStatus::kSuccess;
+	}
+
 	void *OxDnaTranslator::creator() {
 		return new OxDnaTranslator();
 	}
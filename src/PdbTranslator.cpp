@@ -0,0 +1,147 @@
+/*
+ * PdbTranslator.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <Utility.h>
+#include <PdbTranslator.h>
+#include <OxDnaTranslator.h>
+
+#include <model/Helix.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <list>
+
+#include <maya/MProgressWindow.h>
+#include <maya/MStringArray.h>
+#include <maya/MTimer.h>
+
+namespace Helix {
+	MStatus PdbTranslator::writer (const MFileObject& file, const MString& optionsString, MPxFileTranslator::FileAccessMode mode) {
+		MStatus status;
+		MObjectArray helices;
+		HMEVALUATE_RETURN(status = Model::Helix::AllSelected(helices), status);
+
+		if (helices.length() == 0) {
+			HMEVALUATE_RETURN(status = Model::Helix::All(helices), status);
+		}
+
+		if (helices.length() == 0) {
+			MGlobal::displayError("Nothing to export. Aborting...");
+			return MStatus::kSuccess;
+		}
+
+		/*
+		 * Options: pdb_incremental=0 captures every strand again instead of reusing the strands that haven't changed since the previous
+		 * oxDNA or PDB export. The file is written as mmCIF if the filename ends with .cif, and compressed if it ends with .gz or .zst.
+		 * pdb_stats=1 reports the time of every phase of the export, pdb_report=<file> writes the same as JSON, see ExportStatistics
+		 */
+
+		unsigned int incremental = 1, stats = 0;
+		MString report_filename;
+		MStringArray options_array;
+		optionsString.split(';', options_array);
+		for (unsigned int i = 0; i < options_array.length(); ++i) {
+			sscanf(options_array[i].asChar(), "pdb_incremental=%u", &incremental);
+			sscanf(options_array[i].asChar(), "pdb_stats=%u", &stats);
+
+			if (options_array[i].indexW("pdb_report=") == 0 && options_array[i].length() > strlen("pdb_report="))
+				report_filename = options_array[i].substringW(int(strlen("pdb_report=")), int(options_array[i].length()) - 1);
+		}
+
+		ExportStatistics statistics("PDB");
+		const bool timed = stats != 0 || report_filename.length() > 0;
+
+		std::list<Model::Strand> strands;
+
+		{
+			ExportPhaseTimer traversalTimer(timed ? &statistics : NULL, ExportStatistics::kTraversal);
+			HMEVALUATE_RETURN(status = OxDnaTranslator::CollectStrands(helices, "PDB Exporter", strands), status);
+		}
+
+		if (!MProgressWindow::reserve())
+			MGlobal::displayWarning("Failed to reserve the progress window");
+
+		MProgressWindow::setTitle("PDB Exporter");
+		MProgressWindow::setProgressStatus("Capturing strands...");
+		MProgressWindow::setProgressRange(0, int(strands.size()));
+		MProgressWindow::startProgress();
+
+		ExporterWithAdvanceProgress<Controller::PdbExporter> exporter;
+		exporter.setIncremental(incremental != 0);
+
+		if (timed)
+			exporter.setStatistics(&statistics);
+
+		MTimer timer;
+		timer.beginTimer();
+
+		HMEVALUATE(std::for_each(strands.begin(), strands.end(), exporter.execute()), exporter.status());
+
+		MProgressWindow::endProgress();
+
+		if (!exporter.status())
+			return exporter.status();
+
+		const MString filename(file.fullName());
+		unsigned long long numAtoms;
+		HMEVALUATE_RETURN(status = exporter.writeAtoms(filename.asChar(), numAtoms), status);
+
+		timer.endTimer();
+
+		MGlobal::displayInfo(MString("Exported ") + (unsigned int) strands.size() + " strands, " + (unsigned int) numAtoms + " atoms to \"" + filename + "\" in " + timer.elapsedTime() + " s");
+
+		if (timed) {
+			statistics.filename = filename.asChar();
+
+			if (stats != 0)
+				MGlobal::displayInfo(statistics.str().c_str());
+
+			if (report_filename.length() > 0 && !statistics.writeReport(report_filename.asChar()))
+				MGlobal::displayWarning(MString("Failed to write the export report \"") + report_filename + "\"");
+		}
+
+		return status;
+	}
+
+	bool PdbTranslator::haveWriteMethod () const {
+		return true;
+	}
+
+	bool PdbTranslator::haveReadMethod () const {
+		return false;
+	}
+
+	bool PdbTranslator::canBeOpened () const {
+		return false;
+	}
+
+	MString PdbTranslator::defaultExtension () const {
+		return HELIX_PDB_FILE_TYPE;
+	}
+
+	MPxFileTranslator::MFileKind PdbTranslator::identifyFile (const MFileObject& file, const char *buffer, short size) const {
+		const MString filename(file.resolvedFullName().toLowerCase());
+
+		if (Controller::PdbExporter::FormatFromFilename(filename.asChar()) == Controller::PdbExporter::kMmCif)
+			return MPxFileTranslator::kIsMyFileType;
+
+		const char *suffixes[] = { "." HELIX_PDB_FILE_TYPE, "." HELIX_PDB_FILE_TYPE ".gz", "." HELIX_PDB_FILE_TYPE ".zst" };
+
+		for (int i = 0; i < 3; ++i) {
+			const int length = int(strlen(suffixes[i]));
+
+			if (int(filename.length()) > length && filename.rindexW(suffixes[i]) == int(filename.length()) - length)
+				return MPxFileTranslator::kIsMyFileType;
+		}
+
+		return MPxFileTranslator::kNotMyFileType;
+	}
+
+	void *PdbTranslator::creator() {
+		return new PdbTranslator();
+	}
+}
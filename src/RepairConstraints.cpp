@@ -0,0 +1,393 @@
+/*
+ * RepairConstraints.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <RepairConstraints.h>
+#include <HelixBase.h>
+
+#include <model/Base.h>
+
+#include <maya/MSyntax.h>
+#include <maya/MArgDatabase.h>
+#include <maya/MFnDependencyNode.h>
+#include <maya/MFnTransform.h>
+#include <maya/MGlobal.h>
+#include <maya/MDagPath.h>
+#include <maya/MMatrix.h>
+#include <maya/MPoint.h>
+#include <maya/MVector.h>
+#include <maya/MPlug.h>
+#include <maya/MPlugArray.h>
+#include <maya/MObjectArray.h>
+
+#include <limits>
+
+/*
+ * Maximum angle in radians between the aim vector of the base and the direction to its target before it is considered stale
+ */
+
+#define STALE_CONSTRAINT_TOLERANCE 0.01
+
+namespace Helix {
+	std::vector<MObjectHandle> RepairConstraints::s_pending;
+	bool RepairConstraints::s_scheduled = false;
+	MTimer RepairConstraints::s_readTimer;
+	double RepairConstraints::s_readSeconds = 0.0, RepairConstraints::s_repairSeconds = 0.0;
+	unsigned int RepairConstraints::s_numQueued = 0;
+
+	RepairConstraints::RepairConstraints() {
+
+	}
+
+	RepairConstraints::~RepairConstraints() {
+
+	}
+
+	MStatus RepairConstraints::doIt(const MArgList & args) {
+		MStatus status;
+		MArgDatabase argDatabase(syntax(), args, &status);
+
+		if (!status) {
+			status.perror("MArgDatabase::#ctor");
+			return status;
+		}
+
+		s_scheduled = false;
+
+		unsigned int numChecked, numRepaired;
+
+		if (!(status = Repair(numChecked, numRepaired))) {
+			status.perror("RepairConstraints::Repair");
+			return status;
+		}
+
+		if (numRepaired > 0)
+			MGlobal::displayInfo(MString("Repaired ") + numRepaired + " of " + numChecked + " bases with stale aimConstraints");
+
+		if (argDatabase.isFlagSet("-bm")) {
+			if (!(status = Benchmark())) {
+				status.perror("RepairConstraints::Benchmark");
+				return status;
+			}
+		}
+
+		setResult(numRepaired);
+
+		return MStatus::kSuccess;
+	}
+
+	MStatus RepairConstraints::undoIt () {
+		return MStatus::kSuccess;
+	}
+
+	MStatus RepairConstraints::redoIt () {
+		return MStatus::kSuccess;
+	}
+
+	bool RepairConstraints::isUndoable () const {
+		return false;
+	}
+
+	bool RepairConstraints::hasSyntax () const {
+		return true;
+	}
+
+	MSyntax RepairConstraints::newSyntax () {
+		MSyntax syntax;
+
+		syntax.addFlag("-bm", "-benchmark");
+
+		return syntax;
+	}
+
+	void *RepairConstraints::creator() {
+		return new RepairConstraints();
+	}
+
+	void RepairConstraints::Enqueue(const MObject & base) {
+		s_pending.push_back(MObjectHandle(base));
+	}
+
+	MStatus RepairConstraints::Repair(unsigned int & numChecked, unsigned int & numRepaired) {
+		MStatus status;
+		MTimer timer;
+
+		numChecked = numRepaired = 0;
+
+		if (s_pending.empty())
+			return MStatus::kSuccess;
+
+		timer.beginTimer();
+
+		std::vector<MObjectHandle> pending;
+		pending.swap(s_pending);
+
+		for (std::vector<MObjectHandle>::const_iterator it = pending.begin(); it != pending.end(); ++it) {
+			if (!it->isValid())
+				continue;
+
+			MObject object(it->object());
+			MFnDependencyNode base_node(object, &status);
+
+			if (!status) {
+				status.perror("MFnDependencyNode::#ctor");
+				return status;
+			}
+
+			HelixBase *base = static_cast<HelixBase *>(base_node.userNode());
+
+			/*
+			 * Bases that have been moved since have had their constraints reevaluated
+			 */
+
+			if (base == NULL || !base->m_constraintsPending)
+				continue;
+
+			base->m_constraintsPending = false;
+			++numChecked;
+
+			if (!IsStale(object, status)) {
+				if (!status) {
+					status.perror("RepairConstraints::IsStale");
+					return status;
+				}
+
+				continue;
+			}
+
+			/*
+			 * Setting the translation forces the aimConstraint to be reevaluated
+			 */
+
+			MFnTransform base_transform(object, &status);
+
+			if (!status) {
+				status.perror("MFnTransform::#ctor");
+				return status;
+			}
+
+			MVector translation = base_transform.getTranslation(MSpace::kTransform, &status);
+
+			if (!status) {
+				status.perror("MFnTransform::getTranslation");
+				return status;
+			}
+
+			if (!(status = base_transform.setTranslation(translation, MSpace::kTransform))) {
+				status.perror("MFnTransform::setTranslation");
+				return status;
+			}
+
+			++numRepaired;
+		}
+
+		timer.endTimer();
+		s_repairSeconds += timer.elapsedTime();
+
+		return MStatus::kSuccess;
+	}
+
+	bool RepairConstraints::IsStale(const MObject & base, MStatus & status) {
+		/*
+		 * The aimConstraint drives the rotation of the base, so it is found through that connection instead of by searching the children of the base.
+		 * The attributes are the same for every aimConstraint node and are only looked up by name once
+		 */
+
+		static MObject aTarget, aTargetTranslate, aAimVector;
+		MPlugArray plugArray;
+
+		status = MStatus::kSuccess;
+
+		if (!MPlug(base, MPxTransform::rotateX).connectedTo(plugArray, true, false) || plugArray.length() == 0)
+			return false;
+
+		MObject constraint(plugArray[0].node());
+
+		if (!constraint.hasFn(MFn::kAimConstraint))
+			return false;
+
+		if (aTarget.isNull()) {
+			MFnDependencyNode constraint_node(constraint, &status);
+
+			if (!status) {
+				status.perror("MFnDependencyNode::#ctor");
+				return false;
+			}
+
+			aTarget = constraint_node.attribute("target");
+			aTargetTranslate = constraint_node.attribute("targetTranslate");
+			aAimVector = constraint_node.attribute("aimVector");
+		}
+
+		/*
+		 * Find the target of the constraint through the connection to its first targetTranslate attribute
+		 */
+
+		MPlug target_plug(constraint, aTarget);
+
+		if (target_plug.numElements() == 0)
+			return false;
+
+		MPlug targetTranslate_plug = target_plug.elementByPhysicalIndex(0).child(aTargetTranslate, &status);
+
+		if (!status) {
+			status.perror("MPlug::child targetTranslate");
+			return false;
+		}
+
+		if (!targetTranslate_plug.connectedTo(plugArray, true, false) || plugArray.length() == 0)
+			return false;
+
+		MVector aimVector;
+		MPlug aimVector_plug(constraint, aAimVector);
+
+		for (unsigned int j = 0; j < 3; ++j) {
+			if (!(status = aimVector_plug.child(j).getValue(aimVector[j]))) {
+				status.perror("MPlug::getValue aimVector");
+				return false;
+			}
+		}
+
+		MDagPath base_dagPath, target_dagPath;
+
+		if (!(status = MDagPath::getAPathTo(base, base_dagPath)) || !(status = MDagPath::getAPathTo(plugArray[0].node(), target_dagPath))) {
+			status.perror("MDagPath::getAPathTo");
+			return false;
+		}
+
+		MMatrix base_matrix = base_dagPath.inclusiveMatrix(&status);
+
+		if (!status) {
+			status.perror("MDagPath::inclusiveMatrix");
+			return false;
+		}
+
+		MMatrix target_matrix = target_dagPath.inclusiveMatrix(&status);
+
+		if (!status) {
+			status.perror("MDagPath::inclusiveMatrix");
+			return false;
+		}
+
+		const MVector worldAim = aimVector * base_matrix, direction = (MPoint() * target_matrix) - (MPoint() * base_matrix);
+
+		if (worldAim.length() < std::numeric_limits<double>::epsilon() || direction.length() < std::numeric_limits<double>::epsilon())
+			return false;
+
+		return worldAim.angle(direction) > STALE_CONSTRAINT_TOLERANCE;
+	}
+
+	MStatus RepairConstraints::FileRead() {
+		MStatus status;
+
+		s_readTimer.endTimer();
+		s_readSeconds = s_readTimer.elapsedTime();
+		s_numQueued = (unsigned int) s_pending.size();
+
+		if (s_pending.empty() || s_scheduled)
+			return MStatus::kSuccess;
+
+		if (MGlobal::mayaState() != MGlobal::kInteractive) {
+			/*
+			 * Idle never comes before the next command of a script, repair the bases before it
+			 */
+
+			unsigned int numChecked, numRepaired;
+
+			if (!(status = Repair(numChecked, numRepaired))) {
+				status.perror("RepairConstraints::Repair");
+				return status;
+			}
+
+			if (numRepaired > 0)
+				MGlobal::displayInfo(MString("Repaired ") + numRepaired + " of " + numChecked + " bases with stale aimConstraints");
+
+			return MStatus::kSuccess;
+		}
+
+		if (!(status = MGlobal::executeCommandOnIdle(MEL_REPAIRCONSTRAINTS_COMMAND, false))) {
+			status.perror("MGlobal::executeCommandOnIdle");
+			return status;
+		}
+
+		s_scheduled = true;
+
+		return MStatus::kSuccess;
+	}
+
+	void RepairConstraints::MSceneMessage_BeforeRead_CallbackFunc(void *clientData) {
+		s_readSeconds = s_repairSeconds = 0.0;
+		s_readTimer.beginTimer();
+	}
+
+	MStatus RepairConstraints::Benchmark() {
+		MStatus status;
+		MObjectArray bases;
+		MTimer timer;
+
+		if (!(status = Model::Base::All(bases))) {
+			status.perror("Base::All");
+			return status;
+		}
+
+		/*
+		 * Checking every base is what repairing a file where every base was queued costs
+		 */
+
+		unsigned int numStale = 0;
+		timer.beginTimer();
+
+		for (unsigned int i = 0; i < bases.length(); ++i) {
+			if (IsStale(bases[i], status))
+				++numStale;
+
+			if (!status) {
+				status.perror("RepairConstraints::IsStale");
+				return status;
+			}
+		}
+
+		timer.endTimer();
+		const double checkSeconds = timer.elapsedTime();
+
+		/*
+		 * The previous behavior: Reapply the translation of every base after every open and import
+		 */
+
+		timer.beginTimer();
+
+		for (unsigned int i = 0; i < bases.length(); ++i) {
+			MFnTransform base_transform(bases[i], &status);
+
+			if (!status) {
+				status.perror("MFnTransform::#ctor");
+				return status;
+			}
+
+			MVector translation = base_transform.getTranslation(MSpace::kTransform, &status);
+
+			if (!status) {
+				status.perror("MFnTransform::getTranslation");
+				return status;
+			}
+
+			if (!(status = base_transform.setTranslation(translation, MSpace::kTransform))) {
+				status.perror("MFnTransform::setTranslation");
+				return status;
+			}
+		}
+
+		timer.endTimer();
+		const double resetSeconds = timer.elapsedTime();
+
+		if (s_readSeconds > 0.0)
+			MGlobal::displayInfo(MString("Reading the last file took ") + s_readSeconds + " s and queued " + s_numQueued + " bases. Repairing them took " + s_repairSeconds + " s, " + (100.0 * s_repairSeconds / s_readSeconds) + " % of reading the file");
+
+		MGlobal::displayInfo(MString("Checking all ") + bases.length() + " bases took " + checkSeconds + " s, " + numStale + " were stale. Reapplying the translation of every base took " + resetSeconds + " s");
+
+		return MStatus::kSuccess;
+	}
+}
@@ -8,17 +8,46 @@
 #include <RoutedMeshTranslator.h>
 #include <controller/RoutedMeshImporter.h>
 
+#include <cstdio>
 #include <cstring>
 
 #include <maya/MPxFileTranslator.h>
+#include <maya/MStringArray.h>
+#include <maya/MTimer.h>
 
 namespace Helix {
 	MStatus RoutedMeshTranslator::reader (const MFileObject& file, const MString & options, MPxFileTranslator::FileAccessMode mode) {
 		const MString filepath(file.fullName());
 		HPRINT("Parsing file \"%s\"", filepath.asChar());
 
-		Controller::RoutedMeshImporter importer;
 		MStatus status;
+
+		/*
+		 * Options: dry_run=1 parses and plans the file and reports what would be created, without creating anything
+		 */
+
+		unsigned int dry_run = 0;
+		MStringArray options_array;
+		options.split(';', options_array);
+		for (unsigned int i = 0; i < options_array.length(); ++i)
+			sscanf(options_array[i].asChar(), "dry_run=%u", &dry_run);
+
+		if (dry_run) {
+			ImportStatistics statistics;
+			MTimer timer;
+
+			timer.beginTimer();
+			status = Controller::RoutedMeshImporter::DryRun(filepath.asChar(), statistics);
+			timer.endTimer();
+
+			HMEVALUATE_RETURN_DESCRIPTION("RoutedMeshImporter::DryRun", status);
+
+			MGlobal::displayInfo(MString("Dry run of \"") + filepath + "\" in " + timer.elapsedTime() + " s, nothing was created\n" + statistics.str().c_str());
+
+			return MStatus::kSuccess;
+		}
+
+		Controller::RoutedMeshImporter importer;
 		HMEVALUATE_RETURN(status = importer.read(filepath.asChar()), status);
 		return MStatus::kSuccess;
 	}
@@ -37,8 +66,6 @@ namespace Helix {
 
 	MPxFileTranslator::MFileKind RoutedMeshTranslator::identifyFile(const MFileObject& file, const char *buffer, short size) const {
 		const MString filepath(file.fullName());
-		std::cerr << "Is my filetype: " << (filepath.rindexW("." HELIX_ROUTED_MESH_FILE_TYPE) == int(filepath.length()) - int(strlen(HELIX_ROUTED_MESH_FILE_TYPE)) - 1) << std::endl;
-
 		return filepath.rindexW("." HELIX_ROUTED_MESH_FILE_TYPE) == int(filepath.length()) - int(strlen(HELIX_ROUTED_MESH_FILE_TYPE)) - 1 ? MPxFileTranslator::kIsMyFileType : MPxFileTranslator::kNotMyFileType;
 	}
 
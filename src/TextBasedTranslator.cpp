@@ -2,18 +2,42 @@
 
 #include <controller/TextBasedImporter.h>
 
+#include <maya/MTimer.h>
+
 namespace Helix {
 	MStatus TextBasedTranslator::reader(const MFileObject& file, const MString & options, MPxFileTranslator::FileAccessMode mode) {
 		MStatus status;
 		Controller::TextBasedImporter importer;
 
+		/*
+		 * Options: nicking_min_length=N and nicking_max_length=N control the autostaple nicking.
+		 * dry_run=1 parses the file and reports what would be created, without creating anything
+		 */
+
 		int nicking_min_length = 0, nicking_max_length = 0;
+		unsigned int dry_run = 0;
 		MStringArray options_array;
 		options.split(';', options_array);
 		for (unsigned int i = 0; i < options_array.length(); ++i) {
 			const char *line = options_array[i].asChar(); // for debugging only!
 			sscanf(options_array[i].asChar(), "nicking_min_length=%u", &nicking_min_length);
 			sscanf(options_array[i].asChar(), "nicking_max_length=%u", &nicking_max_length);
+			sscanf(options_array[i].asChar(), "dry_run=%u", &dry_run);
+		}
+
+		if (dry_run) {
+			ImportStatistics statistics;
+			MTimer timer;
+
+			timer.beginTimer();
+			status = Controller::TextBasedImporter::DryRun(file.fullName().asChar(), statistics);
+			timer.endTimer();
+
+			HMEVALUATE_RETURN_DESCRIPTION("TextBasedImporter::DryRun", status);
+
+			MGlobal::displayInfo(MString("Dry run of \"") + file.fullName() + "\" in " + timer.elapsedTime() + " s, nothing was created\n" + statistics.str().c_str());
+
+			return MStatus::kSuccess;
 		}
 
 		HPRINT("Reading text based file \"%s\". Options: %s parsed to min_length: %u, max_length: %u", file.fullName().asChar(), options.asChar(), nicking_min_length, nicking_max_length);
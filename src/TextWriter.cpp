@@ -0,0 +1,346 @@
+/*
+ * TextWriter.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <TextWriter.h>
+#include <Tokenizer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef HAVE_CXX11
+#include <chrono>
+#else
+#include <sys/time.h>
+#endif /* N HAVE_CXX11 */
+
+/*
+ * The fast path rounds a scaled double to an integer. Below this limit the error of the scaling is far smaller than TEXTWRITER_TIE_MARGIN
+ */
+
+#define TEXTWRITER_FAST_LIMIT 1e9
+
+/*
+ * Values whose scaled fraction is this close to a half might round differently than snprintf, they take the slow path
+ */
+
+#define TEXTWRITER_TIE_MARGIN 1e-5
+
+namespace Helix {
+	static const double ExactPowersOfTen[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	/*
+	 * Up to the 9 + 4 decimals of the smallest values the %g fast path writes
+	 */
+
+	static const unsigned long long IntegerPowersOfTen[] = {
+		1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+		10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull
+	};
+
+	/*
+	 * Writes the digits of value ending at end, returns the position of the first digit
+	 */
+
+	static inline char *FormatReverse(unsigned long long value, char *end) {
+		do {
+			*--end = char('0' + value % 10);
+			value /= 10;
+		} while (value != 0);
+
+		return end;
+	}
+
+	static inline size_t FormatUnsigned(unsigned long long value, char *buffer) {
+		char digits[24];
+		char *begin = FormatReverse(value, digits + sizeof(digits));
+		const size_t length = size_t(digits + sizeof(digits) - begin);
+
+		memcpy(buffer, begin, length);
+		return length;
+	}
+
+	/*
+	 * Scale value by 10^exponent with a single correctly rounded operation, exponent must be within +-22
+	 */
+
+	static inline double Scale(double value, int exponent) {
+		return exponent >= 0 ? value * ExactPowersOfTen[exponent] : value / ExactPowersOfTen[-exponent];
+	}
+
+	/*
+	 * Round a non-negative scaled value to an integer. Returns false if it's too large or too close to a tie to be trusted
+	 */
+
+	static inline bool Round(double scaled, unsigned long long & rounded) {
+		if (scaled >= TEXTWRITER_FAST_LIMIT)
+			return false;
+
+		const double integer = std::floor(scaled);
+
+		if (std::fabs(scaled - integer - 0.5) < TEXTWRITER_TIE_MARGIN)
+			return false;
+
+		rounded = (unsigned long long) integer + (scaled - integer > 0.5 ? 1 : 0);
+		return true;
+	}
+
+	/*
+	 * Writes integer.fraction with the fraction zero padded to decimals digits, trailing zeros and the dot are removed if trim is set
+	 */
+
+	static size_t FormatDecimal(bool negative, unsigned long long rounded, int decimals, bool trim, char *buffer) {
+		char *it = buffer;
+
+		if (negative)
+			*it++ = '-';
+
+		const unsigned long long divisor = IntegerPowersOfTen[decimals];
+		it += FormatUnsigned(rounded / divisor, it);
+
+		if (decimals > 0) {
+			unsigned long long fraction = rounded % divisor;
+
+			if (trim) {
+				while (decimals > 0 && fraction % 10 == 0) {
+					fraction /= 10;
+					--decimals;
+				}
+			}
+
+			if (decimals > 0) {
+				*it++ = '.';
+				memset(it, '0', size_t(decimals));
+				FormatReverse(fraction, it + decimals);
+
+				it += decimals;
+			}
+		}
+
+		return size_t(it - buffer);
+	}
+
+	static size_t FormatSlow(double value, char *buffer, const char *format, int precision) {
+		char printed[TEXTWRITER_DOUBLE_SIZE * 2];
+		int length = snprintf(printed, sizeof(printed), format, precision, value);
+
+		if (length < 0 || length >= TEXTWRITER_DOUBLE_SIZE)
+			length = snprintf(printed, sizeof(printed), "%.17g", value);
+
+		memcpy(buffer, printed, size_t(length));
+		return size_t(length);
+	}
+
+	/*
+	 * Same as printf %.{precision}g for values that would not be printed in scientific notation
+	 */
+
+	static bool FormatGeneralFast(double value, char *buffer, int precision, size_t & length) {
+		const double magnitude = std::fabs(value);
+
+		if (precision > 9 || !(magnitude >= 1e-5 && magnitude < 1e9))
+			return false;
+
+		int exponent = int(std::floor(std::log10(magnitude)));
+		double scaled = Scale(magnitude, precision - 1 - exponent);
+
+		// log10 may be off by one close to powers of ten.
+		if (scaled < double(IntegerPowersOfTen[precision - 1]))
+			scaled = Scale(magnitude, precision - 1 - --exponent);
+		else if (scaled >= double(IntegerPowersOfTen[precision]))
+			scaled = Scale(magnitude, precision - 1 - ++exponent);
+
+		unsigned long long rounded;
+
+		if (!Round(scaled, rounded))
+			return false;
+
+		if (rounded == IntegerPowersOfTen[precision]) {
+			rounded /= 10;
+			++exponent;
+		}
+
+		// %g uses scientific notation outside of this range.
+		if (exponent < -4 || exponent >= precision)
+			return false;
+
+		length = FormatDecimal(std::signbit(value), rounded, precision - 1 - exponent, true, buffer);
+		return true;
+	}
+
+	static bool FormatFixedFast(double value, char *buffer, int precision, size_t & length) {
+		if (precision > 9 || !(std::fabs(value) < TEXTWRITER_FAST_LIMIT))
+			return false;
+
+		unsigned long long rounded;
+
+		if (!Round(Scale(std::fabs(value), precision), rounded))
+			return false;
+
+		length = FormatDecimal(std::signbit(value), rounded, precision, false, buffer);
+		return true;
+	}
+
+	size_t TextWriter::FormatDouble(double value, char *buffer, Format format, int precision) {
+		size_t length;
+
+		if (precision < 0)
+			precision = 6;
+
+		switch (format) {
+		case kFixed:
+			if (FormatFixedFast(value, buffer, precision, length))
+				return length;
+
+			return FormatSlow(value, buffer, "%.*f", std::min(precision, 17));
+		case kShortest:
+			if (value == 0.0 || !(value - value == 0.0)) // zero, inf and nan.
+				return FormatSlow(value, buffer, "%.*g", 1);
+
+			/*
+			 * A value that reads back from 9 significant digits, as most typed in or snapped coordinates do, prints the same digits with 15.
+			 * Anything else is printed with 15, 16 and 17 digits until one of them reads back
+			 */
+
+			if (FormatGeneralFast(value, buffer, 9, length)) {
+				double parsed;
+				if (Tokenizer::ParseDouble(buffer, buffer + length, parsed) && parsed == value)
+					return length;
+			}
+
+			for (int digits = 15; digits < 17; ++digits) {
+				length = FormatSlow(value, buffer, "%.*g", digits);
+
+				double parsed;
+				if (Tokenizer::ParseDouble(buffer, buffer + length, parsed) && parsed == value)
+					return length;
+			}
+
+			return FormatSlow(value, buffer, "%.*g", 17);
+		default:
+			if (precision == 0)
+				precision = 1;
+
+			if (value == 0.0) {
+				if (std::signbit(value)) {
+					memcpy(buffer, "-0", 2);
+					return 2;
+				}
+
+				*buffer = '0';
+				return 1;
+			}
+
+			if (FormatGeneralFast(value, buffer, precision, length))
+				return length;
+
+			return FormatSlow(value, buffer, "%.*g", std::min(precision, 17));
+		}
+	}
+
+	double TextWriter::Now() {
+#ifdef HAVE_CXX11
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+		timeval time;
+		gettimeofday(&time, NULL);
+
+		return double(time.tv_sec) + double(time.tv_usec) * 1e-6;
+#endif /* N HAVE_CXX11 */
+	}
+
+	TextWriter::TextWriter(Format format, int precision) : m_format(format), m_precision(precision), m_writeSeconds(0.0), m_good(true) {
+
+	}
+
+	TextWriter::~TextWriter() {
+		close();
+	}
+
+	bool TextWriter::open(const char *filename) {
+		close();
+
+		if (!m_file.open(filename))
+			return false;
+
+		m_buffer.clear();
+		m_buffer.reserve(TEXTWRITER_BUFFER_SIZE + TEXTWRITER_BUFFER_SIZE / 4);
+		m_writeSeconds = 0.0;
+		m_good = true;
+
+		return true;
+	}
+
+	bool TextWriter::flush() {
+		if (!m_file.isOpen())
+			return m_good;
+
+		const double start = Now();
+
+		if (!m_buffer.empty() && !m_file.write(m_buffer.data(), m_buffer.size()))
+			m_good = false;
+
+		m_buffer.clear();
+		m_writeSeconds += Now() - start;
+		return m_good;
+	}
+
+	bool TextWriter::close() {
+		if (!m_file.isOpen())
+			return m_good;
+
+		flush();
+
+		// Compressed files write their last block when closed.
+		const double start = Now();
+
+		if (!m_file.close())
+			m_good = false;
+
+		m_writeSeconds += Now() - start;
+
+		return m_good;
+	}
+
+	TextWriter & TextWriter::operator<<(int value) {
+		char buffer[24];
+		size_t length = 0;
+
+		if (value < 0)
+			buffer[length++] = '-';
+
+		length += FormatUnsigned(value < 0 ? 0ull - (unsigned long long) value : (unsigned long long) value, buffer + length);
+		write(buffer, length);
+
+		return *this;
+	}
+
+	TextWriter & TextWriter::operator<<(unsigned int value) {
+		return *this << (unsigned long long) value;
+	}
+
+	TextWriter & TextWriter::operator<<(unsigned long value) {
+		return *this << (unsigned long long) value;
+	}
+
+	TextWriter & TextWriter::operator<<(unsigned long long value) {
+		char buffer[24];
+		write(buffer, FormatUnsigned(value, buffer));
+
+		return *this;
+	}
+
+	TextWriter & TextWriter::operator<<(double value) {
+		char buffer[TEXTWRITER_DOUBLE_SIZE];
+		write(buffer, FormatDouble(value, buffer, m_format, m_precision));
+
+		return *this;
+	}
+}
@@ -14,7 +14,6 @@
 #include <maya/MSyntax.h>
 #include <maya/MArgDatabase.h>
 #include <maya/MGlobal.h>
-#include <maya/MItDag.h>
 #include <maya/MDagPath.h>
 
 #include <algorithm>
@@ -68,20 +67,15 @@ namespace Helix {
 					return status;
 				}*/
 
-				MItDag itDag(MItDag::kDepthFirst, MFn::kPluginTransformNode, &status);
+				MObjectArray helices;
 
-				if (!status) {
-					status.perror("MItDag::#ctor");
+				if (!(status = Model::Helix::All(helices))) {
+					status.perror("Helix::All");
 					return status;
 				}
 
-				for(; !itDag.isDone(); itDag.next()) {
-					Model::Helix helix(itDag.currentItem(&status));
-
-					if (!status) {
-						status.perror("MItDag::currentItem");
-						return status;
-					}
+				for(unsigned int i = 0; i < helices.length(); ++i) {
+					Model::Helix helix(helices[i]);
 
 					if (!(status = helix.setShapesVisibility(CurrentView == 1))) {
 						status.perror("Helix::setShapesVisibility");
@@ -0,0 +1,207 @@
+/*
+ * Tokenizer.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <Tokenizer.h>
+
+#include <climits>
+#include <cstdlib>
+
+/*
+ * Longest number that is passed on to strtod, longer tokens are not numbers anyway
+ */
+
+#define STRTOD_BUFFER_SIZE 128
+
+namespace Helix {
+	/*
+	 * Powers of ten that are exactly representable as doubles
+	 */
+
+	static const double ExactPowersOfTen[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	static inline bool IsSpace(char c) {
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+	}
+
+	static inline bool IsDigit(char c) {
+		return c >= '0' && c <= '9';
+	}
+
+	static bool ParseDoubleSlow(const char *begin, const char *end, double & value) {
+		char buffer[STRTOD_BUFFER_SIZE];
+		const size_t length = size_t(end - begin);
+
+		if (length == 0 || length >= STRTOD_BUFFER_SIZE)
+			return false;
+
+		memcpy(buffer, begin, length);
+		buffer[length] = '\0';
+
+		char *buffer_end;
+		value = strtod(buffer, &buffer_end);
+
+		return buffer_end == buffer + length;
+	}
+
+	size_t Tokenizer::tokenize(const char *begin, const char *end) {
+		m_tokens.clear();
+
+		for (const char *it = begin; it != end;) {
+			while (it != end && IsSpace(*it))
+				++it;
+
+			if (it == end)
+				break;
+
+			Token token;
+			token.begin = it;
+
+			while (it != end && !IsSpace(*it))
+				++it;
+
+			token.end = it;
+			m_tokens.push_back(token);
+		}
+
+		return m_tokens.size();
+	}
+
+	bool Tokenizer::toDouble(size_t index, double & value) const {
+		return index < m_tokens.size() && ParseDouble(m_tokens[index].begin, m_tokens[index].end, value);
+	}
+
+	bool Tokenizer::toInt(size_t index, int & value) const {
+		return index < m_tokens.size() && ParseInt(m_tokens[index].begin, m_tokens[index].end, value);
+	}
+
+	bool Tokenizer::toUnsigned(size_t index, unsigned int & value) const {
+		int signed_value;
+
+		if (!toInt(index, signed_value) || signed_value < 0)
+			return false;
+
+		value = (unsigned int) signed_value;
+		return true;
+	}
+
+	bool Tokenizer::ParseDouble(const char *begin, const char *end, double & value) {
+		const char *it = begin;
+		bool negative = false;
+
+		if (it != end && (*it == '-' || *it == '+')) {
+			negative = *it == '-';
+			++it;
+		}
+
+		unsigned long long mantissa = 0;
+		int significant_digits = 0, exponent = 0;
+		bool foundDigits = false;
+
+		for (; it != end && IsDigit(*it); ++it) {
+			foundDigits = true;
+
+			if (mantissa != 0 || *it != '0')
+				++significant_digits;
+
+			if (significant_digits <= 18)
+				mantissa = mantissa * 10 + (*it - '0');
+			else
+				++exponent;
+		}
+
+		if (it != end && *it == '.') {
+			for (++it; it != end && IsDigit(*it); ++it) {
+				foundDigits = true;
+
+				if (mantissa != 0 || *it != '0')
+					++significant_digits;
+
+				if (significant_digits <= 18) {
+					mantissa = mantissa * 10 + (*it - '0');
+					--exponent;
+				}
+			}
+		}
+
+		if (!foundDigits)
+			return ParseDoubleSlow(begin, end, value); // inf, nan etc.
+
+		if (it != end && (*it == 'e' || *it == 'E')) {
+			int exponent_value;
+
+			if (!ParseInt(it + 1, end, exponent_value) || exponent_value > 1000 || exponent_value < -1000)
+				return ParseDoubleSlow(begin, end, value);
+
+			exponent += exponent_value;
+			it = end;
+		}
+
+		if (it != end)
+			return false;
+
+		/*
+		 * The mantissa and the power of ten are both exact, thus a single multiplication or division is correctly rounded
+		 */
+
+		if (significant_digits > 15 || exponent > 22 || exponent < -22)
+			return ParseDoubleSlow(begin, end, value);
+
+		value = exponent < 0 ? double(mantissa) / ExactPowersOfTen[-exponent] : double(mantissa) * ExactPowersOfTen[exponent];
+
+		if (negative)
+			value = -value;
+
+		return true;
+	}
+
+	bool Tokenizer::ParseFloat(const char *begin, const char *end, float & value) {
+		double double_value;
+
+		if (!ParseDouble(begin, end, double_value))
+			return false;
+
+		value = float(double_value);
+		return true;
+	}
+
+	bool Tokenizer::ParseInt(const char *begin, const char *end, int & value) {
+		const char *it = begin;
+		bool negative = false;
+
+		if (it != end && (*it == '-' || *it == '+')) {
+			negative = *it == '-';
+			++it;
+		}
+
+		if (it == end)
+			return false;
+
+		long long result = 0;
+
+		for (; it != end; ++it) {
+			if (!IsDigit(*it))
+				return false;
+
+			result = result * 10 + (*it - '0');
+
+			if (result > (long long) INT_MAX + 1)
+				return false;
+		}
+
+		if (negative)
+			result = -result;
+
+		if (result > INT_MAX || result < INT_MIN)
+			return false;
+
+		value = int(result);
+		return true;
+	}
+}
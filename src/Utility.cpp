@@ -18,12 +18,12 @@
 #include <maya/MCommandResult.h>
 #include <maya/MFnSet.h>
 #include <maya/MDagModifier.h>
-#include <maya/MItDag.h>
 #include <maya/MFnNurbsCurve.h>
 
 #include <HelixBase.h>
 #include <Helix.h>
 #include <DNA.h>
+#include <RepairConstraints.h>
 
 #include <limits>
 
@@ -646,56 +646,13 @@ namespace Helix {
 	void MSceneMessage_AfterImportOpen_CallbackFunc(void *callbackData) {
 		MStatus status;
 
-		MItDag it(MItDag::kBreadthFirst, MFn::kTransform, &status);
-
-		if (!status) {
-			status.perror("MItDag::#ctor");
-			return;
-		}
-
-		for(; !it.isDone(); it.next()) {
-			MObject object = it.item(&status);
-
-			if (!status) {
-				status.perror("MObject::item");
-				return;
-			}
-
-			/*
-			 * Make sure the object is a Helix
-			 */
-
-			MFnDagNode dagNode(object);
-
-			if (dagNode.typeId(&status) == ::Helix::Helix::id) {
-				/*
-				 * This object is a helix, iterate over all of its bases and set their translation
-				 */
-
-				Model::Helix helix(object);
-
-				for(Model::Helix::BaseIterator it = helix.begin(); it != helix.end(); ++it) {
-					MFnTransform base_transform(it->getDagPath(status));
-
-					if (!status) {
-						status.perror("MFnTransform::getDagPath");
-						return;
-					}
-
-					MVector translation = base_transform.getTranslation(MSpace::kTransform, &status);
-
-					if (!status) {
-						status.perror("MFnTransform::getTranslation");
-						return;
-					}
+		/*
+		 * Don't touch the bases here, the bases read from the file have been queued and are only repaired if their aimConstraints
+		 * are actually stale, see RepairConstraints.h
+		 */
 
-					if (!(status = base_transform.setTranslation(translation, MSpace::kTransform))) {
-						status.perror("MFnTransform::setTranslation");
-						return;
-					}
-				}
-			}
-		}
+		if (!(status = RepairConstraints::FileRead()))
+			status.perror("RepairConstraints::FileRead");
 	}
 
 	/*
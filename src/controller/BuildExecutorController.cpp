@@ -0,0 +1,85 @@
+/*
+ * BuildExecutorController.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <controller/BuildExecutor.h>
+#include <Utility.h>
+
+#include <maya/MGlobal.h>
+#include <maya/MProgressWindow.h>
+
+namespace Helix {
+	namespace Controller {
+		BuildExecutor::BuildExecutor(const MString & title, bool showProgress, unsigned int batchSize) : m_title(title), m_batchSize(batchSize > 0 ? batchSize : 1), m_pending(0), m_bases(0), m_seconds(0.0), m_showProgress(showProgress), m_started(false), m_cancelled(false), m_finished(false) {
+			m_timer.beginTimer();
+		}
+
+		BuildExecutor::~BuildExecutor() {
+			end();
+		}
+
+		void BuildExecutor::begin(const MString & status, unsigned int range) {
+			end();
+
+			m_pending = 0;
+
+			if (!m_showProgress)
+				return;
+
+			if (!MProgressWindow::reserve())
+				MGlobal::displayWarning("Failed to reserve the progress window");
+
+			MProgressWindow::setTitle(m_title);
+			MProgressWindow::setProgressStatus(status);
+			MProgressWindow::setProgressRange(0, int(range));
+			MProgressWindow::setInterruptable(true);
+			MProgressWindow::startProgress();
+
+			m_started = true;
+		}
+
+		void BuildExecutor::flush() {
+			if (m_started) {
+				MProgressWindow::advanceProgress(int(m_pending));
+
+				if (MProgressWindow::isCancelled())
+					m_cancelled = true;
+			}
+
+			m_pending = 0;
+		}
+
+		void BuildExecutor::end() {
+			if (!m_started)
+				return;
+
+			MProgressWindow::setInterruptable(false);
+			MProgressWindow::endProgress();
+
+			m_started = false;
+		}
+
+		MStatus BuildExecutor::finish() {
+			end();
+
+			if (!m_finished) {
+				m_timer.endTimer();
+				m_seconds = m_timer.elapsedTime();
+				m_finished = true;
+			}
+
+			if (m_cancelled) {
+				MGlobal::displayWarning(m_title + ": Cancelled, everything created has been removed");
+				return MStatus::kFailure;
+			}
+
+			if (m_showProgress && m_bases > 0)
+				MGlobal::displayInfo(m_title + ": Created " + m_bases + " bases in " + m_seconds + " s (" + basesPerSecond() + " bases/s)");
+
+			return MStatus::kSuccess;
+		}
+	}
+}
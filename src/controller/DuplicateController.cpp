@@ -1,5 +1,6 @@
 #include <controller/Duplicate.h>
 
+#include <controller/BuildExecutor.h>
 #include <model/Helix.h>
 
 #include <vector>
@@ -41,28 +42,11 @@ namespace Helix {
 		MStatus Duplicate::redo() {
 			MStatus status;
 			
-#if 1
-			// TODO: Clean this up and replace with some std::map instead that doesn't require a hash. We can't hash MObjects.
-
-			class {
-			public:
-				Model::Base & operator[](Model::Base & model) {
-					for(std::list< std::pair<Model::Base, Model::Base> >::iterator it = bases.begin(); it != bases.end(); ++it) {
-						if (it->first == model)
-							return it->second;
-					}
-
-					bases.push_back(std::make_pair(model, Model::Base()));
-					return (--bases.end())->second;
-				}
-			private:
-				std::list< std::pair<Model::Base, Model::Base> > bases;
-			} base_translation;
+#if defined(WIN32) || defined(WIN64)
+			std::unordered_map<Model::Base, Model::Base> base_translation;
 #else
 			std::tr1::unordered_map<Model::Base, Model::Base> base_translation;
-#endif
-			
-			std::cerr << "Got " << m_helices.length() << " helices to copy" << std::endl;
+#endif /* N Windows */
 
 			/*
 			 * Count the total number of bases we're going to create. This is just for the progress bar
@@ -78,7 +62,8 @@ namespace Helix {
 					++totalNumBases;
 			}
 
-			onProgressStart(0, totalNumBases);
+			BuildExecutor executor("Duplicate helices");
+			executor.begin("Generating new helices and bases...", totalNumBases);
 
 			/*
 			 * First step: Create all the helices by copying rotation, translation and cylinder data from the old ones
@@ -122,7 +107,11 @@ namespace Helix {
 					return status;
 				}
 
-				std::cerr << "Done creating helix" << std::endl;
+				/*
+				 * Added right away so that it is removed by undo if the operation is cancelled
+				 */
+
+				m_new_helices.push_back(new_helix);
 
 				/*
 				 * Setup the cylinder
@@ -140,8 +129,6 @@ namespace Helix {
 					return status;
 				}
 
-				std::cerr << "Done setting up cylinder" << std::endl;
-
 				/*
 				 * Create bases
 				 */
@@ -170,8 +157,6 @@ namespace Helix {
 						return status;
 					}
 
-					std::cerr << "Done creating the base: " << new_base.getDagPath(status).fullPathName().asChar() << std::endl;
-
 					/*
 					 * Color the new base using the same material as the old one
 					 */
@@ -185,43 +170,33 @@ namespace Helix {
 							status.perror("Base::setMaterial");
 					}
 
-					std::cerr << "Done setting the base material" << std::endl;
-
 					/*
 					 * Add the newly created base paired with the old one in our lookup table for later referencing
 					 */
 
 					base_translation[base] = new_base;
 
-					std::cerr << "new_base in translation: " << base_translation[base].getDagPath(status).fullPathName().asChar() << std::endl;
-
-					onProgressStep();
+					if (!executor.step()) {
+						undo();
+						return executor.finish();
+					}
 				}
-
-				m_new_helices.push_back(new_helix);
 			}
 
-			std::cerr << "Done step 1" << std::endl;
-
 			/*
 			 * Yet again, loop over all helices and all bases, find out what other bases the current base is connected to
 			 * (forward and opposite) then translate them all using the m_base_translation table and create similar connections
 			 */
 
-			onProgressDone();
-			onProgressStart(1, totalNumBases);
+			executor.begin("Connecting bases...", totalNumBases);
 
 			for(unsigned int i = 0; i < m_helices.length(); ++i) {
-				std::cerr << "Helix it index " << i << std::endl;
 				Model::Helix helix(m_helices[i]);
 
 				for(Model::Helix::BaseIterator it = helix.begin(); it != helix.end(); ++it) {
-					std::cerr << "Base it" << std::endl;
 					Model::Base base(*it);
 					Model::Base & new_base(base_translation[base]);
 
-					std::cerr << "base: " << base.getDagPath(status).fullPathName().asChar() << ", new_base: " << new_base.getDagPath(status).fullPathName().asChar() << std::endl;
-
 					Model::Base forward_base = base.forward(status);
 
 					if (!status && status != MStatus::kNotFound) {
@@ -237,22 +212,13 @@ namespace Helix {
 						Model::Base & new_forward_base(base_translation[forward_base]);
 
 						if (new_forward_base) {
-
-							std::cerr << "Connect forward" << std::endl;
-
 							if (!(status = new_base.connect_forward(new_forward_base))) {
 								status.perror("Base::connect_forward");
 								return status;
 							}
 						}
-						else {
-							std::cerr << "new_forward_base false" << std::endl;
-							std::cerr << "new_forward_base: " << new_forward_base.getDagPath(status).fullPathName().asChar() << std::endl;
-						}
 					}
 
-					std::cerr << "Looking for opposite connection" << std::endl;
-
 					Model::Base opposite_base = base.opposite(status);
 
 					if (!status && status != MStatus::kNotFound) {
@@ -265,8 +231,6 @@ namespace Helix {
 						 * This base has an opposite connection
 						 */
 
-						std::cerr << "Got opposite connection" << std::endl;
-
 						bool isDestination = base.opposite_isDestination(status);
 
 						if (!status) {
@@ -274,73 +238,52 @@ namespace Helix {
 							return status;
 						}
 
-						std::cerr << "isDestination: " << (isDestination ? "true" : "false") << std::endl;
-
 						Model::Base & new_opposite_base(base_translation[opposite_base]);
 
-						std::cerr << "Copied new_opposite_base" << std::endl;
-
 						if (new_opposite_base) {
 							/*
 							 * The order of the setup is important
 							 */
 
-							std::cerr << "Got new_opposite_base" << std::endl;
-
-							std::cerr << "new_base: " << new_base.getDagPath(status).fullPathName().asChar() << ", new_opposite_base: " << new_opposite_base.getDagPath(status).fullPathName().asChar() << std::endl;
-
 							if (isDestination) {
 								if (!(status = new_opposite_base.connect_opposite(new_base))) {
 									status.perror("Base::connect_opposite");
 									return status;
 								}
-
-								/*
-								 * Set the label of the base
-								 */
-
-								DNA::Name label;
-
-								if (!(status = opposite_base.getLabel(label))) {
-									status.perror("Base::getLabel");
-									return status;
-								}
-
-								if (!(status = new_opposite_base.setLabel(label))) {
-									status.perror("Base::setLabel");
-									return status;
-								}
 							}
 							else {
 								if (!(status = new_base.connect_opposite(new_opposite_base))) {
 									status.perror("Base::connect_opposite");
 									return status;
 								}
+							}
 
-								/*
-								 * Set the label of the base
-								 */
+							/*
+							 * Set the label of the base
+							 */
 
-								DNA::Name label;
+							DNA::Name label;
 
-								if (!(status = opposite_base.getLabel(label))) {
-									status.perror("Base::getLabel");
-									return status;
-								}
+							if (!(status = opposite_base.getLabel(label))) {
+								status.perror("Base::getLabel");
+								return status;
+							}
 
-								if (!(status = new_opposite_base.setLabel(label))) {
-									status.perror("Base::setLabel");
-									return status;
-								}
+							if (!(status = new_opposite_base.setLabel(label))) {
+								status.perror("Base::setLabel");
+								return status;
 							}
 						}
 					}
 
-					onProgressStep();
+					if (!executor.advance()) {
+						undo();
+						return executor.finish();
+					}
 				}
 			}
 
-			onProgressDone();
+			HMEVALUATE_RETURN(status = executor.finish(), status);
 
 			/*
 			* Select all the newly created helices
@@ -360,17 +303,5 @@ namespace Helix {
 
 			return MStatus::kSuccess;
 		}
-
-		void Duplicate::onProgressStart(unsigned int process, unsigned int range) {
-
-		}
-
-		void Duplicate::onProgressStep() {
-
-		}
-
-		void Duplicate::onProgressDone() {
-
-		}
 	}
 }
@@ -1,118 +1,209 @@
 #include <controller/ExportStrands.h>
+#include <Compression.h>
+#include <ExportPipeline.h>
+#include <Utility.h>
 
-#include <fstream>
-#include <iterator>
+#include <vector>
+
+#include <maya/MGlobal.h>
 
 namespace Helix {
 	namespace Controller {
-		char g_separator;
+		class ExportStrands::DataFormatter {
+		public:
+			inline DataFormatter(const std::list<Data> & data, Mode mode) : m_mode(mode) {
+				m_data.reserve(data.size());
 
-		/*
-		 * Makes the export method really clean
-		 */
+				for (std::list<Data>::const_iterator it = data.begin(); it != data.end(); ++it)
+					m_data.push_back(&*it);
+			}
 
-		std::ostream & operator<<(std::ostream & stream, const ExportStrands::Data & data) {
-			stream << data.strand_name.asChar() << g_separator << data.sequence.asChar();
+			inline size_t size() const {
+				return m_data.size();
+			}
 
-			return stream;
-		}
+			void operator() (size_t index, TextWriter & output) const {
+				const Data & data = *m_data[index];
+
+				switch (m_mode) {
+				case CSV:
+					output << data.strand_name << ',' << data.sequence << ',' << data.length << ',' << data.five_prime << ',' << data.three_prime << '\n';
+					break;
+				case PLATE_LAYOUT:
+					{
+						const size_t well = index % (EXPORT_PLATE_ROWS * EXPORT_PLATE_COLUMNS);
+
+						output << (index / (EXPORT_PLATE_ROWS * EXPORT_PLATE_COLUMNS) + 1) << ',' << char('A' + well / EXPORT_PLATE_COLUMNS) << (well % EXPORT_PLATE_COLUMNS + 1) << ','
+							<< data.strand_name << ',' << data.sequence << '\n';
+					}
+					break;
+				default:
+					output << data.strand_name << (m_mode == COMMA_SEPARATED ? ',' : ';') << data.sequence << '\n';
+					break;
+				}
+			}
+
+		private:
+			std::vector<const Data *> m_data;
+			Mode m_mode;
+		};
 
 		MStatus ExportStrands::write(const MString & filename, ExportStrands::Mode mode) {
-			g_separator = mode == COMMA_SEPARATED ? ',' : ';';
+			const Compression::Format compression = Compression::FromFilename(filename.asChar());
+
+			if (!Compression::IsSupported(compression)) {
+				MGlobal::displayError(MString("vHelix was built without ") + Compression::Name(compression) + " support, can't write \"" + filename + "\".");
+				return MStatus::kFailure;
+			}
+
+			ExportPhaseTimer timer(m_statistics, ExportStatistics::kFormat);
+
+			// Compressed if the filename ends with .gz or .zst.
+			TextWriter file;
+
+			if (!file.open(filename.asChar()))
+				return MStatus::kFailure;
+
+			if (mode == CSV)
+				file << "Name,Sequence,Length,5' end,3' end\n";
+			else if (mode == PLATE_LAYOUT)
+				file << "Plate,Well,Name,Sequence\n";
 
-			std::ofstream file(filename.asChar(), std::ios_base::out);
+			DataFormatter formatter(m_export_data, mode);
+			ParallelFormat(file, formatter.size(), formatter);
 
-			if (!file.good())
+			// Strands that were merged or split since they were cached would never be found again.
+			if (m_incremental)
+				Cache().prune();
+
+			if (!file.close())
 				return MStatus::kFailure;
 
-			std::copy(m_export_data.begin(), m_export_data.end(), std::ostream_iterator<ExportStrands::Data>(file, "\n"));
+			if (m_statistics) {
+				m_statistics->addFile(file, ExportStatistics::kFormat);
+				m_statistics->strands = m_export_data.size();
+				m_statistics->reused = m_reused;
 
-			file.close();
+				for (std::list<Data>::const_iterator it = m_export_data.begin(); it != m_export_data.end(); ++it)
+					m_statistics->bases += it->length;
+			}
 
 			return MStatus::kSuccess;
 		}
 
-		MStatus ExportStrands::doExecute(Model::Strand & element) {
-			/*
-			 * Figure out if this strand is a loop or not by iterating backwards to the end.
-			 * If that is a loop just name it the name of the base, if not use the end bases
-			 */
-			
+		MStatus ExportStrands::collect(const MObjectArray & bases) {
+			ExportPhaseTimer timer(m_statistics, ExportStatistics::kTraversal);
 			MStatus status;
-			Data data;
+			Model::StrandIndex & strandIndex(Model::StrandIndex::Instance());
+
+			for (unsigned int i = 0; i < bases.length(); ++i) {
+				Model::StrandIndex::Entry entry;
+				HMEVALUATE_RETURN(status = strandIndex.find(Model::Base(bases[i]), entry), status);
+
+				if (entry.strand >= m_visited.size())
+					m_visited.resize(strandIndex.size(), false);
 
-			std::cerr << "Working on Strand defined by base: " << element.getDefiningBase().getDagPath(status).fullPathName().asChar() << std::endl;
+				if (m_visited[entry.strand])
+					continue;
 
-			Model::Strand::BackwardIterator it = element.reverse_begin(), last_it = it;
-			for(; it != element.reverse_end(); ++it) {
-				last_it = it;
+				m_visited[entry.strand] = true;
+				HMEVALUATE_RETURN(status = collectStrand(strandIndex.strand(entry.strand)), status);
 			}
 
-			if (it.loop()) {
-				std::cerr << "This strand has a loop" << std::endl;
+			return MStatus::kSuccess;
+		}
+
+		MStatus ExportStrands::collectStrand(Model::StrandIndex::Strand & strand) {
+			MStatus status;
 
-				MDagPath base_dagPath = element.getDefiningBase().getDagPath(status);
+			if (m_maxLength > 0 && strand.size() > m_maxLength)
+				return MStatus::kSuccess;
 
-				if (!status) {
-					status.perror("Base::getDagPath");
-					return status;
-				}
+			if (m_incremental) {
+				const Data *cached = Cache().find(strand);
+
+				if (cached) {
+					m_export_data.push_back(*cached);
+					++m_reused;
+
+					onProgressStep();
 
-				data.strand_name = base_dagPath.fullPathName();
+					return MStatus::kSuccess;
+				}
 			}
 
-			std::cerr << "After reverse iterating, the first base is: " << last_it->getDagPath(status).fullPathName().asChar() << std::endl;
+			ExportPhaseTimer timer(m_statistics, ExportStatistics::kCapture);
+			const Model::ChangeTracker::revision_t revision = Model::ChangeTracker::Instance().revision();
+			std::vector<MObjectHandle> bases;
+			Data data;
+			data.length = strand.size();
+			data.sequence.reserve(strand.size());
+
+			if (m_incremental)
+				bases.reserve(strand.size());
 
 			/*
-			 * Iterate forward and collect all the base labels
+			 * Indexed strands start at their 5' end, or at an arbitrary base if they're a loop
 			 */
 
-			Model::Strand::ForwardIterator f_it = Model::Strand(*last_it).forward_begin(), last_f_it = f_it;
-			for(; f_it != element.forward_end(); ++f_it) {
+			for (Model::StrandIndex::Strand::iterator it = strand.begin(); it != strand.end(); ++it) {
 				DNA::Name label;
+				HMEVALUATE_RETURN(status = it->getLabel(label), status);
 
-				if (!(status = f_it->getLabel(label))) {
-					status.perror("Base::getLabel 1");
-					return status;
+				data.sequence += label.toChar();
+
+				if (m_incremental) {
+					MObject object;
+					HMEVALUATE_RETURN(object = it->getObject(status), status);
+					bases.push_back(MObjectHandle(object));
 				}
+			}
+
+			MDagPath first_base_dagPath;
+			HMEVALUATE_RETURN(first_base_dagPath = strand.bases.front().getDagPath(status), status);
 
-				char char_label = label.toChar();
-				data.sequence += MString(&char_label, 1);
+			if (strand.circular)
+				data.strand_name = first_base_dagPath.fullPathName().asChar();
+			else {
+				MDagPath last_base_dagPath;
+				HMEVALUATE_RETURN(last_base_dagPath = strand.bases.back().getDagPath(status), status);
 
-				last_f_it = f_it;
+				data.five_prime = first_base_dagPath.fullPathName().asChar();
+				data.three_prime = last_base_dagPath.fullPathName().asChar();
+				data.strand_name = data.five_prime + " -> " + data.three_prime;
 			}
 
-			std::cerr << "After forward iteration, f_it references: " << last_f_it->getDagPath(status).fullPathName().asChar() << std::endl;
+			m_export_data.push_back(data);
 
-			if (!f_it.loop()) {
-				/*
-				 * Since it wasn't a loop, it points to the first element in the strand while f_it should point to the last
-				 */
+			if (m_incremental)
+				HMEVALUATE_RETURN(status = Cache().insert(strand, bases, data, revision), status);
 
-				std::cerr << "Forward isn't a loop either" << std::endl;
+			onProgressStep();
 
-				MDagPath first_base_dagPath = last_it->getDagPath(status);
+			return MStatus::kSuccess;
+		}
 
-				if (!status) {
-					status.perror("Base::getDagPath 1");
-					return status;
-				}
+		MStatus ExportStrands::doExecute(Model::Strand & element) {
+			/*
+			 * The strand is looked up in the strand index instead of rewinding it to its 5' end. Strands that have already been collected are skipped
+			 */
 
-				MDagPath last_base_dagPath = last_f_it->getDagPath(status);
+			ExportPhaseTimer timer(m_statistics, ExportStatistics::kTraversal);
+			MStatus status;
+			Model::StrandIndex & strandIndex(Model::StrandIndex::Instance());
+			Model::StrandIndex::Entry entry;
 
-				if (!status) {
-					status.perror("Base::getDagPath 2");
-					return status;
-				}
+			HMEVALUATE_RETURN(status = strandIndex.find(element.getDefiningBase(), entry), status);
 
-				data.strand_name = first_base_dagPath.fullPathName() + " -> " + last_base_dagPath.fullPathName();
-			}
+			if (entry.strand >= m_visited.size())
+				m_visited.resize(strandIndex.size(), false);
 
-			m_export_data.push_back(data);
+			if (m_visited[entry.strand])
+				return MStatus::kSuccess;
 
-			onProgressStep();
+			m_visited[entry.strand] = true;
 
-			return MStatus::kSuccess;
+			return collectStrand(strandIndex.strand(entry.strand));
 		}
 
 		MStatus ExportStrands::doUndo(Model::Strand & element, Empty & undoData) {
@@ -123,6 +214,11 @@ namespace Helix {
 			return MStatus::kSuccess;
 		}
 
+		Model::StrandCache<ExportStrands::Data> & ExportStrands::Cache() {
+			static Model::StrandCache<Data> cache;
+			return cache;
+		}
+
 		void ExportStrands::onProgressStep() {
 
 		}
@@ -7,7 +7,9 @@
 #include <Helix.h>
 #include <HelixBase.h>
 
-#include <maya/MProgressWindow.h>
+#include <controller/BuildExecutor.h>
+
+#include <algorithm>
 
 namespace Helix {
 	namespace Controller {
@@ -15,13 +17,8 @@ namespace Helix {
 			unsigned int num_added_bases(0);
 			MStatus status;
 
-			if (!MProgressWindow::reserve())
-				MGlobal::displayWarning("Failed to reserve the progress window");
-
-			MProgressWindow::setTitle("Auto fill strand gaps");
-			MProgressWindow::setProgressStatus("Filling strand gaps by linear interpolation...");
-			MProgressWindow::setProgressRange(0, int(redoable.size()));
-			MProgressWindow::startProgress();
+			BuildExecutor executor("Auto fill strand gaps");
+			executor.begin("Filling strand gaps by linear interpolation...", (unsigned int) redoable.size());
 
 			for (std::vector<Redoable>::iterator it(redoable.begin()); it != redoable.end(); ++it) {
 
@@ -59,14 +56,19 @@ namespace Helix {
 					HMEVALUATE_RETURN(status = previous.connect_forward(it->end), status);
 				}
 
-				MProgressWindow::advanceProgress(1);
-			}
+				/*
+				 * A gap is the unit of work, undo removes the new bases and reconnects the gaps filled so far
+				 */
 
-			MProgressWindow::endProgress();
+				if (!executor.step((unsigned int) std::max(num_additional_bases, 0))) {
+					undo();
+					return executor.finish();
+				}
+			}
 
 			HPRINT("Added %u bases.", num_added_bases);
 
-			return MStatus::kSuccess;
+			return executor.finish();
 		}
 
 		MStatus FillStrandGaps::fill_object(const MObject & object) {
@@ -96,6 +98,10 @@ namespace Helix {
 
 		MStatus FillStrandGaps::fill_base(Model::Base & base) {
 			MStatus status;
+
+			if (!visited.insert(base).second)
+				return MStatus::kSuccess;
+
 			Model::Helix helix(base.getParent(status));
 			HMEVALUATE_RETURN_DESCRIPTION("Model::Base::getParent", status);
 			
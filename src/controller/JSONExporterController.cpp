@@ -0,0 +1,848 @@
+/*
+ * JSONExporterController.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <controller/JSONExporter.h>
+#include <model/Base.h>
+#include <model/Helix.h>
+#include <model/Object.h>
+#include <model/StrandIndex.h>
+
+#include <Compression.h>
+#include <DNA.h>
+#include <ExportPipeline.h>
+#include <TextWriter.h>
+#include <Utility.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+
+#include <maya/MFnTransform.h>
+#include <maya/MMatrix.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MPoint.h>
+#include <maya/MTimer.h>
+
+#if defined(WIN32) || defined(WIN64)
+#include <unordered_map>
+#else
+#include <tr1/unordered_map>
+#endif /* N Windows */
+
+namespace Helix {
+	namespace Controller {
+		static const char *str_strands[] = { "scaf", "stap" };
+
+		void JSONExporter::LatticePosition(int row, int col, double & x, double & y) {
+			/*
+			 * Same shuffle as the importer, but also valid for negative rows and columns
+			 */
+
+			const double shuffle = ((row & 1) * 2 - 1) * (((col + 1) & 1) * 2 - 1);
+
+			x = DNA::HONEYCOMB_X_STRIDE * col;
+			y = DNA::HONEYCOMB_Y_STRIDE * row + DNA::HONEYCOMB_Y_OFFSET * shuffle;
+		}
+
+		/*
+		 * The cell closest to (x, y), the offset of every other cell makes rounding alone insufficient
+		 */
+
+		static double NearestLatticeCell(double x, double y, int & row, int & col) {
+			const int row_guess = int(floor(y / DNA::HONEYCOMB_Y_STRIDE + 0.5)), col_guess = int(floor(x / DNA::HONEYCOMB_X_STRIDE + 0.5));
+			double closest = std::numeric_limits<double>::infinity();
+
+			for (int i = row_guess - 1; i <= row_guess + 1; ++i) {
+				for (int j = col_guess - 1; j <= col_guess + 1; ++j) {
+					double cell_x, cell_y;
+					JSONExporter::LatticePosition(i, j, cell_x, cell_y);
+
+					const double distance = (cell_x - x) * (cell_x - x) + (cell_y - y) * (cell_y - y);
+
+					if (distance < closest) {
+						closest = distance;
+						row = i;
+						col = j;
+					}
+				}
+			}
+
+			return closest;
+		}
+
+		/*
+		 * Minimum cost assignment of points to lattice cells by successive shortest augmenting paths (the Hungarian method) on a sparse graph:
+		 * Every point is only connected to the cells in a square around its nearest cell. Cells are created when they first become a candidate.
+		 * For a scene that is already on the lattice every search ends at the nearest cell, thus the assignment is close to linear in time.
+		 * Does not use the Maya API.
+		 */
+
+		class JSONExporter::Assignment {
+		public:
+			Assignment(const std::vector< std::pair<double, double> > & points) : m_points(points), m_candidates(points.size()), m_potentials(points.size(), 0.0), m_matches(points.size(), -1), m_distances(points.size()), m_search(0) {
+
+			}
+
+			/*
+			 * Returns the sum of the squared distances
+			 */
+
+			double run(std::vector< std::pair<int, int> > & cells) {
+				for (size_t i = 0; i < m_points.size(); ++i) {
+					int radius = JSON_EXPORT_LATTICE_RADIUS;
+					addCandidates(i, radius);
+
+					while (!augment(i))
+						addCandidates(i, radius *= 2);
+				}
+
+				double cost = 0.0;
+				cells.resize(m_points.size());
+
+				for (size_t i = 0; i < m_points.size(); ++i) {
+					const Cell & cell = m_cells[m_matches[i]];
+					double x, y;
+					LatticePosition(cell.row, cell.col, x, y);
+
+					cells[i] = std::make_pair(cell.row, cell.col);
+					cost += (x - m_points[i].first) * (x - m_points[i].first) + (y - m_points[i].second) * (y - m_points[i].second);
+				}
+
+				return cost;
+			}
+
+		private:
+			struct Cell {
+				int row, col, match;
+				double potential, distance;
+				unsigned int search, done;
+				size_t from;
+			};
+
+			struct Candidate {
+				unsigned int cell;
+				double cost;
+			};
+
+			void addCandidates(size_t point, int radius) {
+				int row, col;
+				NearestLatticeCell(m_points[point].first, m_points[point].second, row, col);
+
+				std::vector<Candidate> & candidates = m_candidates[point];
+				candidates.clear();
+
+				for (int i = row - radius; i <= row + radius; ++i) {
+					for (int j = col - radius; j <= col + radius; ++j) {
+						std::map<std::pair<int, int>, unsigned int>::iterator it = m_cellIndices.find(std::make_pair(i, j));
+
+						if (it == m_cellIndices.end()) {
+							const Cell cell = { i, j, -1, 0.0, 0.0, 0, 0, 0 };
+							it = m_cellIndices.insert(std::make_pair(std::make_pair(i, j), (unsigned int) m_cells.size())).first;
+							m_cells.push_back(cell);
+						}
+
+						double x, y;
+						LatticePosition(i, j, x, y);
+
+						const Candidate candidate = { it->second, (x - m_points[point].first) * (x - m_points[point].first) + (y - m_points[point].second) * (y - m_points[point].second) };
+						candidates.push_back(candidate);
+					}
+				}
+			}
+
+			void relax(size_t point) {
+				const double distance = m_distances[point];
+
+				for (std::vector<Candidate>::const_iterator it = m_candidates[point].begin(); it != m_candidates[point].end(); ++it) {
+					Cell & cell = m_cells[it->cell];
+					const double reduced = distance + std::max(0.0, it->cost - m_potentials[point] - cell.potential);
+
+					if (cell.done == m_search)
+						continue;
+
+					if (cell.search != m_search || reduced < cell.distance) {
+						cell.search = m_search;
+						cell.distance = reduced;
+						cell.from = point;
+						m_queue.push(std::make_pair(reduced, it->cell));
+					}
+				}
+			}
+
+			/*
+			 * Find the shortest path of alternating candidate and matched edges from the point to a free cell and flip it.
+			 * Returns false, leaving everything unchanged, if no free cell can be reached
+			 */
+
+			bool augment(size_t point) {
+				++m_search;
+				m_queue = queue_t();
+				m_reached.clear();
+				m_finished.clear();
+
+				m_distances[point] = 0.0;
+				m_reached.push_back(point);
+				relax(point);
+
+				int free_cell = -1;
+
+				while (!m_queue.empty()) {
+					const std::pair<double, unsigned int> top = m_queue.top();
+					m_queue.pop();
+
+					Cell & cell = m_cells[top.second];
+
+					if (cell.done == m_search || top.first > cell.distance)
+						continue;
+
+					cell.done = m_search;
+					m_finished.push_back(top.second);
+
+					if (cell.match == -1) {
+						free_cell = int(top.second);
+						break;
+					}
+
+					m_distances[cell.match] = cell.distance;
+					m_reached.push_back(size_t(cell.match));
+					relax(size_t(cell.match));
+				}
+
+				if (free_cell == -1)
+					return false;
+
+				/*
+				 * Keep the reduced costs non-negative, and zero along the path
+				 */
+
+				const double length = m_cells[free_cell].distance;
+
+				for (std::vector<size_t>::const_iterator it = m_reached.begin(); it != m_reached.end(); ++it)
+					m_potentials[*it] += length - m_distances[*it];
+
+				for (std::vector<unsigned int>::const_iterator it = m_finished.begin(); it != m_finished.end(); ++it)
+					m_cells[*it].potential -= length - m_cells[*it].distance;
+
+				for (unsigned int cell = (unsigned int) free_cell;;) {
+					const size_t from = m_cells[cell].from;
+					const int previous = m_matches[from];
+
+					m_matches[from] = int(cell);
+					m_cells[cell].match = int(from);
+
+					if (from == point)
+						break;
+
+					cell = (unsigned int) previous;
+				}
+
+				return true;
+			}
+
+			typedef std::priority_queue< std::pair<double, unsigned int>, std::vector< std::pair<double, unsigned int> >, std::greater< std::pair<double, unsigned int> > > queue_t;
+
+			const std::vector< std::pair<double, double> > & m_points;
+			std::vector< std::vector<Candidate> > m_candidates;
+			std::vector<double> m_potentials;
+			std::vector<int> m_matches;
+			std::vector<double> m_distances;
+			std::vector<Cell> m_cells;
+			std::map<std::pair<int, int>, unsigned int> m_cellIndices;
+			std::vector<size_t> m_reached;
+			std::vector<unsigned int> m_finished;
+			queue_t m_queue;
+			unsigned int m_search;
+		};
+
+		double JSONExporter::AssignLatticeCells(const std::vector< std::pair<double, double> > & points, std::vector< std::pair<int, int> > & cells) {
+			cells.clear();
+
+			if (points.empty())
+				return 0.0;
+
+			/*
+			 * The lattice is only symmetric under translations of an even number of rows and columns combined. Try to put the first point on a cell
+			 * of either parity, move the origin by the mean distance to the nearest cells and keep the one that fits the points best
+			 */
+
+			double origin[2] = { 0.0, 0.0 }, best_error = std::numeric_limits<double>::infinity();
+
+			for (int parity = 0; parity < 2; ++parity) {
+				double x, y, offset[2] = { 0.0, 0.0 };
+				LatticePosition(0, parity, x, y);
+
+				double candidate[2] = { points.front().first - x, points.front().second - y };
+
+				for (std::vector< std::pair<double, double> >::const_iterator it = points.begin(); it != points.end(); ++it) {
+					int row, col;
+					NearestLatticeCell(it->first - candidate[0], it->second - candidate[1], row, col);
+					LatticePosition(row, col, x, y);
+
+					offset[0] += it->first - candidate[0] - x;
+					offset[1] += it->second - candidate[1] - y;
+				}
+
+				candidate[0] += offset[0] / points.size();
+				candidate[1] += offset[1] / points.size();
+
+				double error = 0.0;
+
+				for (std::vector< std::pair<double, double> >::const_iterator it = points.begin(); it != points.end(); ++it) {
+					int row, col;
+					error += NearestLatticeCell(it->first - candidate[0], it->second - candidate[1], row, col);
+				}
+
+				if (error < best_error) {
+					best_error = error;
+					std::copy(candidate, candidate + 2, origin);
+				}
+			}
+
+			std::vector< std::pair<double, double> > relative(points.size());
+
+			for (size_t i = 0; i < points.size(); ++i)
+				relative[i] = std::make_pair(points[i].first - origin[0], points[i].second - origin[1]);
+
+			Assignment assignment(relative);
+			return std::sqrt(assignment.run(cells) / points.size());
+		}
+
+		/*
+		 * Orderings used by CreateLayout
+		 */
+
+		class CellLess {
+		public:
+			inline CellLess(const std::vector<JSONExporter::Layout::Helix> & helices) : m_helices(helices) {
+
+			}
+
+			inline bool operator() (size_t a, size_t b) const {
+				return m_helices[a].row != m_helices[b].row ? m_helices[a].row < m_helices[b].row : m_helices[a].col < m_helices[b].col;
+			}
+
+		private:
+			const std::vector<JSONExporter::Layout::Helix> & m_helices;
+		};
+
+		class AxialLess {
+		public:
+			inline AxialLess(const std::vector<double> & axial) : m_axial(axial) {
+
+			}
+
+			inline bool operator() (unsigned int a, unsigned int b) const {
+				return m_axial[a] != m_axial[b] ? m_axial[a] < m_axial[b] : a < b;
+			}
+
+		private:
+			const std::vector<double> & m_axial;
+		};
+
+		static bool NumLess(const JSONExporter::Layout::Helix & a, const JSONExporter::Layout::Helix & b) {
+			return a.num < b.num;
+		}
+
+		void JSONExporter::CreateLayout(const Scene & scene, Layout & layout) {
+			layout.helices.clear();
+			layout.length = 0;
+			layout.latticeError = 0.0;
+			layout.displacedBases = 0;
+			layout.misdirectedBases = 0;
+
+			if (scene.helices.empty())
+				return;
+
+			/*
+			 * The common axis of the helices gives the direction of increasing indices. It's oriented so that the importer's +Z is kept
+			 */
+
+			double axis[3] = { 0.0, 0.0, 0.0 };
+
+			for (std::vector<Scene::Helix>::const_iterator it = scene.helices.begin(); it != scene.helices.end(); ++it) {
+				const double *first = scene.helices.front().axis;
+				const double sign = it->axis[0] * first[0] + it->axis[1] * first[1] + it->axis[2] * first[2] < 0.0 ? -1.0 : 1.0;
+
+				for (int i = 0; i < 3; ++i)
+					axis[i] += sign * it->axis[i];
+			}
+
+			MVector normal(axis[0], axis[1], axis[2]);
+
+			if (normal.length() < 1e-9)
+				normal = MVector::zAxis;
+
+			normal.normalize();
+
+			int largest = 0;
+
+			for (int i = 1; i < 3; ++i) {
+				if (std::fabs(normal[i]) > std::fabs(normal[largest]))
+					largest = i;
+			}
+
+			if (normal[largest] < 0.0)
+				normal = -normal;
+
+			MVector u(MVector::xAxis - (MVector::xAxis * normal) * normal);
+
+			if (u.length() < 0.5)
+				u = MVector::yAxis - (MVector::yAxis * normal) * normal;
+
+			u.normalize();
+			const MVector v(normal ^ u);
+
+			/*
+			 * Lattice cells. Rows and columns are moved to start at zero, only by amounts that keep the parity of their sum
+			 */
+
+			std::vector< std::pair<double, double> > points(scene.helices.size());
+
+			for (size_t i = 0; i < scene.helices.size(); ++i) {
+				const MVector translation(scene.helices[i].translation);
+				points[i] = std::make_pair(translation * u, translation * v);
+			}
+
+			std::vector< std::pair<int, int> > cells;
+			layout.latticeError = AssignLatticeCells(points, cells);
+
+			int min_row = std::numeric_limits<int>::max(), min_col = std::numeric_limits<int>::max();
+
+			for (std::vector< std::pair<int, int> >::const_iterator it = cells.begin(); it != cells.end(); ++it) {
+				min_row = std::min(min_row, it->first);
+				min_col = std::min(min_col, it->second);
+			}
+
+			const int row_offset = -min_row, col_offset = -min_col + ((min_row + min_col) & 1);
+
+			/*
+			 * caDNAno requires even numbers on even parity cells. Numbers are given in row major order
+			 */
+
+			std::vector<size_t> order(scene.helices.size());
+			std::vector<Layout::Helix> helices(scene.helices.size());
+
+			for (size_t i = 0; i < scene.helices.size(); ++i) {
+				helices[i].row = cells[i].first + row_offset;
+				helices[i].col = cells[i].second + col_offset;
+				order[i] = i;
+			}
+
+			std::sort(order.begin(), order.end(), CellLess(helices));
+
+			int next_num[] = { 0, 1 };
+
+			for (std::vector<size_t>::const_iterator it = order.begin(); it != order.end(); ++it) {
+				Layout::Helix & helix = helices[*it];
+				const int parity = (helix.row + helix.col) & 1;
+
+				helix.num = next_num[parity];
+				next_num[parity] += 2;
+			}
+
+			/*
+			 * Indices along the axis. The direction of a base is given by its neighbours on the same helix, or otherwise by its opposite
+			 */
+
+			const size_t numBases = scene.bases.size();
+			std::vector<double> axial(numBases);
+			std::vector<int> directions(numBases, 0), indices(numBases, 0);
+			double min_axial = std::numeric_limits<double>::infinity();
+
+			for (size_t i = 0; i < numBases; ++i) {
+				axial[i] = MVector(scene.bases[i].translation) * normal;
+				min_axial = std::min(min_axial, axial[i]);
+			}
+
+			for (size_t i = 0; i < numBases; ++i) {
+				const Scene::Base & base = scene.bases[i];
+
+				if (base.forward != -1 && scene.bases[base.forward].helix == base.helix && axial[base.forward] != axial[i])
+					directions[i] = axial[base.forward] > axial[i] ? 1 : -1;
+				else if (base.backward != -1 && scene.bases[base.backward].helix == base.helix && axial[base.backward] != axial[i])
+					directions[i] = axial[base.backward] < axial[i] ? 1 : -1;
+			}
+
+			for (size_t i = 0; i < numBases; ++i) {
+				if (directions[i] == 0)
+					directions[i] = scene.bases[i].opposite != -1 && directions[scene.bases[i].opposite] != 0 ? -directions[scene.bases[i].opposite] : 1;
+			}
+
+			/*
+			 * The longest strand is the scaffold, every other strand is a staple. caDNAno expects the scaffold to run towards increasing indices
+			 * on even helices and towards decreasing on odd, and the staples the other way
+			 */
+
+			std::vector<size_t> strandLengths(scene.colors.size(), 0);
+
+			for (size_t i = 0; i < numBases; ++i) {
+				if (scene.bases[i].strand < strandLengths.size())
+					++strandLengths[scene.bases[i].strand];
+			}
+
+			const unsigned int scaffold = (unsigned int) (std::max_element(strandLengths.begin(), strandLengths.end()) - strandLengths.begin());
+
+			/*
+			 * Every strand of a helix can only hold one base per index. Bases are sorted along the axis and pushed forward if their index is taken
+			 */
+
+			std::vector< std::vector<unsigned int> > strands(scene.helices.size() * 2);
+
+			for (size_t i = 0; i < numBases; ++i) {
+				const unsigned int helix = scene.bases[i].helix;
+				const int strand = scene.bases[i].strand == scaffold ? 0 : 1;
+
+				if (((directions[i] == 1) == ((helices[helix].num & 1) == 0) ? 0 : 1) != strand)
+					++layout.misdirectedBases;
+
+				strands[helix * 2 + strand].push_back((unsigned int) i);
+			}
+
+			int max_index = 0;
+
+			for (std::vector< std::vector<unsigned int> >::iterator it = strands.begin(); it != strands.end(); ++it) {
+				std::sort(it->begin(), it->end(), AxialLess(axial));
+
+				int previous = -1;
+
+				for (std::vector<unsigned int>::const_iterator base_it = it->begin(); base_it != it->end(); ++base_it) {
+					const int index = int(floor((axial[*base_it] - min_axial) / DNA::STEP + 0.5));
+
+					indices[*base_it] = std::max(index, previous + 1);
+					previous = indices[*base_it];
+
+					if (indices[*base_it] != index)
+						++layout.displacedBases;
+				}
+
+				max_index = std::max(max_index, previous);
+			}
+
+			layout.length = (max_index / JSON_EXPORT_LENGTH_STEP + 1) * JSON_EXPORT_LENGTH_STEP;
+
+			/*
+			 * Fill the slots
+			 */
+
+			for (size_t i = 0; i < strands.size(); ++i) {
+				Layout::Helix & helix = helices[i / 2];
+				const int strand = int(i % 2);
+
+				helix.strands[strand].reserve(strands[i].size());
+
+				for (std::vector<unsigned int>::const_iterator it = strands[i].begin(); it != strands[i].end(); ++it) {
+					const Scene::Base & base = scene.bases[*it];
+					Layout::Slot slot = { indices[*it], { -1, -1, -1, -1 } };
+
+					if (base.backward != -1) {
+						slot.connections[0] = helices[scene.bases[base.backward].helix].num;
+						slot.connections[1] = indices[base.backward];
+					}
+					else if (strand == 1 && scene.colors[base.strand] != -1)
+						helix.stap_colors.push_back(std::make_pair(indices[*it], scene.colors[base.strand]));
+
+					if (base.forward != -1) {
+						slot.connections[2] = helices[scene.bases[base.forward].helix].num;
+						slot.connections[3] = indices[base.forward];
+					}
+
+					helix.strands[strand].push_back(slot);
+				}
+			}
+
+			for (std::vector<size_t>::const_iterator it = order.begin(); it != order.end(); ++it)
+				std::sort(helices[*it].stap_colors.begin(), helices[*it].stap_colors.end());
+
+			std::sort(helices.begin(), helices.end(), NumLess);
+			layout.helices.swap(helices);
+		}
+
+		/*
+		 * Formats one vstrands object. Must not use the Maya API, as it is executed in parallel
+		 */
+
+		class JSONExporter::HelixFormatter {
+		public:
+			HelixFormatter(const Layout & layout) : m_layout(layout) {
+				for (int i = 0; i < layout.length; ++i)
+					m_zeros += i == 0 ? "0" : ",0";
+			}
+
+			void operator() (size_t index, TextWriter & output) {
+				const Layout::Helix & helix = m_layout.helices[index];
+
+				if (index > 0)
+					output << ",\n";
+
+				output << "{\"row\":" << helix.row << ",\"col\":" << helix.col << ",\"num\":" << helix.num;
+
+				for (int i = 0; i < 2; ++i) {
+					std::vector<Layout::Slot>::const_iterator it = helix.strands[i].begin();
+
+					output << ",\"" << str_strands[i] << "\":[";
+
+					for (int j = 0; j < m_layout.length; ++j) {
+						if (j > 0)
+							output << ',';
+
+						if (it != helix.strands[i].end() && it->index == j) {
+							output << '[' << it->connections[0] << ',' << it->connections[1] << ',' << it->connections[2] << ',' << it->connections[3] << ']';
+							++it;
+						}
+						else
+							output << "[-1,-1,-1,-1]";
+					}
+
+					output << ']';
+				}
+
+				output << ",\"loop\":[" << m_zeros << "],\"skip\":[" << m_zeros << "],\"scafLoop\":[],\"stapLoop\":[],\"stap_colors\":[";
+
+				for (std::vector< std::pair<int, int> >::const_iterator it = helix.stap_colors.begin(); it != helix.stap_colors.end(); ++it)
+					output << (it == helix.stap_colors.begin() ? "[" : ",[") << it->first << ',' << it->second << ']';
+
+				output << "]}";
+			}
+
+		private:
+			const Layout & m_layout;
+			std::string m_zeros;
+		};
+
+		/*
+		 * Quote a string for json
+		 */
+
+		static void WriteJSONString(TextWriter & output, const std::string & str) {
+			output << '"';
+
+			for (std::string::const_iterator it = str.begin(); it != str.end(); ++it) {
+				if (*it == '"' || *it == '\\')
+					output << '\\' << *it;
+				else if ((unsigned char) *it < 0x20) {
+					char escaped[8];
+					sprintf(escaped, "\\u%04x", (unsigned int) (unsigned char) *it);
+					output << escaped;
+				}
+				else
+					output << *it;
+			}
+
+			output << '"';
+		}
+
+		bool JSONExporter::Write(const char *filename, const Layout & layout, ExportStatistics *statistics) {
+			ExportPhaseTimer timer(statistics, ExportStatistics::kFormat);
+			TextWriter output;
+
+			if (!output.open(filename))
+				return false;
+
+			output << "{\"name\":";
+			WriteJSONString(output, layout.name);
+			output << ",\"vstrands\":[\n";
+
+			HelixFormatter formatter(layout);
+			ParallelFormat(output, layout.helices.size(), formatter, 1);
+
+			output << "\n]}\n";
+
+			if (!output.close())
+				return false;
+
+			if (statistics)
+				statistics->addFile(output, ExportStatistics::kFormat);
+
+			return true;
+		}
+
+#if defined(WIN32) || defined(WIN64)
+		typedef std::unordered_map<MObjectHandle, unsigned int, Model::ObjectHandleHash> object_index_map_t;
+#else
+		typedef std::tr1::unordered_map<MObjectHandle, unsigned int, Model::ObjectHandleHash> object_index_map_t;
+#endif /* N Windows */
+
+		MStatus JSONExporter::Capture(const MObjectArray & helices, Scene & scene, ExportStatistics *statistics) {
+			ExportPhaseTimer timer(statistics, ExportStatistics::kCapture);
+			MStatus status;
+			object_index_map_t baseIndices;
+			std::vector<MObject> baseObjects;
+
+			scene.helices.resize(helices.length());
+
+			for (unsigned int i = 0; i < helices.length(); ++i) {
+				Model::Helix helix(helices[i]);
+				MDagPath helixDagPath;
+				MMatrix matrix;
+
+				HMEVALUATE_RETURN(helixDagPath = helix.getDagPath(status), status);
+				HMEVALUATE_RETURN(matrix = helixDagPath.inclusiveMatrix(&status), status);
+
+				const MPoint translation(MPoint::origin * matrix);
+				const MVector axis((MVector::zAxis * matrix).normal());
+
+				for (int j = 0; j < 3; ++j) {
+					scene.helices[i].translation[j] = translation[j];
+					scene.helices[i].axis[j] = axis[j];
+				}
+
+				for (Model::Helix::BaseIterator it = helix.begin(); it != helix.end(); ++it) {
+					MObject baseObject;
+					HMEVALUATE_RETURN(baseObject = it->getObject(status), status);
+
+					MFnTransform baseTransform(baseObject);
+					MVector baseTranslation;
+					HMEVALUATE_RETURN(baseTranslation = baseTransform.getTranslation(MSpace::kTransform, &status), status);
+
+					const MPoint worldTranslation(MPoint(baseTranslation) * matrix);
+					Scene::Base base = { i, 0, { worldTranslation.x, worldTranslation.y, worldTranslation.z }, -1, -1, -1 };
+
+					baseIndices.insert(std::make_pair(MObjectHandle(baseObject), (unsigned int) scene.bases.size()));
+					baseObjects.push_back(baseObject);
+					scene.bases.push_back(base);
+				}
+			}
+
+			/*
+			 * Connections are taken from the strand index, every strand that passes through the exported helices gets a color
+			 */
+
+			Model::StrandIndex & strandIndex(Model::StrandIndex::Instance());
+
+			for (Model::StrandIndex::iterator it = strandIndex.begin(); it != strandIndex.end(); ++it) {
+				ExportPhaseTimer traversalTimer(statistics, ExportStatistics::kTraversal);
+				int previous = -1, first = -1;
+				bool captured = false;
+				const unsigned int strand = (unsigned int) scene.colors.size();
+
+				for (Model::StrandIndex::Strand::iterator base_it = it->begin(); base_it != it->end(); ++base_it) {
+					MObject baseObject;
+					HMEVALUATE_RETURN(baseObject = base_it->getObject(status), status);
+
+					object_index_map_t::const_iterator index_it(baseIndices.find(MObjectHandle(baseObject)));
+
+					if (index_it == baseIndices.end()) {
+						previous = -1;
+						continue;
+					}
+
+					const int index = int(index_it->second);
+					scene.bases[index].strand = strand;
+					captured = true;
+
+					if (previous != -1) {
+						scene.bases[previous].forward = index;
+						scene.bases[index].backward = previous;
+					}
+					else if (first == -1 && base_it == it->begin())
+						first = index;
+
+					previous = index;
+				}
+
+				if (it->circular && first != -1 && previous != -1 && previous != first) {
+					scene.bases[previous].forward = first;
+					scene.bases[first].backward = previous;
+				}
+
+				if (!captured)
+					continue;
+
+				ExportPhaseTimer materialsTimer(statistics, ExportStatistics::kMaterials);
+				float r, g, b, a;
+				scene.colors.push_back(!it->circular && it->front().getMaterialColor(r, g, b, a) ?
+					(std::min(int(r * 0x100 + 0.5f), 0xFF) << 16) | (std::min(int(g * 0x100 + 0.5f), 0xFF) << 8) | std::min(int(b * 0x100 + 0.5f), 0xFF) : -1);
+			}
+
+			/*
+			 * The opposite is only needed for the direction of bases without neighbours on their own helix
+			 */
+
+			for (size_t i = 0; i < scene.bases.size(); ++i) {
+				Scene::Base & base = scene.bases[i];
+
+				if ((base.forward != -1 && scene.bases[base.forward].helix == base.helix) || (base.backward != -1 && scene.bases[base.backward].helix == base.helix))
+					continue;
+
+				Model::Base opposite(Model::Base(baseObjects[i]).opposite(status));
+
+				if (!status)
+					continue;
+
+				MObject oppositeObject(opposite.getObject(status));
+
+				if (!status)
+					continue;
+
+				object_index_map_t::const_iterator index_it(baseIndices.find(MObjectHandle(oppositeObject)));
+
+				if (index_it != baseIndices.end())
+					base.opposite = int(index_it->second);
+			}
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus JSONExporter::Export(const char *filename, const MObjectArray & helices, ExportStatistics *statistics) {
+			MStatus status;
+			Scene scene;
+			Layout layout;
+			MTimer timer;
+
+			const Compression::Format compression = Compression::FromFilename(filename);
+
+			if (!Compression::IsSupported(compression)) {
+				MGlobal::displayError(MString("vHelix was built without ") + Compression::Name(compression) + " support, can't write \"" + filename + "\".");
+				return MStatus::kFailure;
+			}
+
+			timer.beginTimer();
+
+			HMEVALUATE_RETURN(status = Capture(helices, scene, statistics), status);
+
+			{
+				ExportPhaseTimer layoutTimer(statistics, ExportStatistics::kLayout);
+				CreateLayout(scene, layout);
+			}
+
+			const char *last_separator = NULL;
+
+			for (const char *separator = strpbrk(filename, "/\\"); separator; separator = strpbrk(separator + 1, "/\\"))
+				last_separator = separator;
+
+			layout.name = last_separator ? last_separator + 1 : filename;
+
+			if (!Write(filename, layout, statistics)) {
+				MGlobal::displayError(MString("Failed to write file \"") + filename + "\"");
+				return MStatus::kFailure;
+			}
+
+			timer.endTimer();
+
+			if (statistics) {
+				statistics->helices = layout.helices.size();
+				statistics->strands = scene.colors.size();
+				statistics->bases = scene.bases.size();
+			}
+
+			MGlobal::displayInfo(MString("Exported ") + (unsigned int) layout.helices.size() + " helices and " + (unsigned int) scene.bases.size() + " bases to \"" + filename + "\" in " + timer.elapsedTime() + " s. RMS distance to the honeycomb lattice: " + layout.latticeError + " nm");
+
+			if (layout.displacedBases > 0)
+				MGlobal::displayWarning(MString() + layout.displacedBases + " bases share their position along the helix axis with another base and were moved to the next free index");
+
+			if (layout.misdirectedBases > 0)
+				MGlobal::displayWarning(MString() + layout.misdirectedBases + " bases run in the opposite direction of what caDNAno expects of their strand on their helix and will not be read correctly by caDNAno");
+
+			return MStatus::kSuccess;
+		}
+	}
+}
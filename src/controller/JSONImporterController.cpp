@@ -1,13 +1,27 @@
+#include <controller/BuildExecutor.h>
 #include <controller/JSONImporter.h>
 #include <controller/PaintStrand.h>
 
+#include <HelixBase.h>
+#include <Parallel.h>
+
 #include <maya/MProgressWindow.h>
+#include <maya/MTimer.h>
+#include <maya/MDGModifier.h>
 
 #include <fstream>
 #include <algorithm>
 #include <list>
 #include <iterator>
 #include <climits>
+#include <sstream>
+#include <string>
+
+/*
+ * Number of aimConstraint commands executed at once when building the plan
+ */
+
+#define AIMCONSTRAINT_BATCH_SIZE 1000
 
 namespace Helix {
 	namespace Controller {
@@ -25,103 +39,259 @@ namespace Helix {
 
 		static const char* str_strands[] = { "scaf", "stap" };
 
-		MStatus JSONImporter::parseFile(const char* filename) {
+		MStatus JSONImporter::parseFile(const char* filename, Reader reader) {
 			MStatus status;
+			Plan plan;
 
-			std::fstream file(filename, std::ios_base::in);
+			HMEVALUATE_RETURN(status = CreatePlan(filename, plan, reader), status);
 
-			if (!file) {
-				MGlobal::displayError(MString("Failed to open file \"") + filename + "\" for reading");
+			return build(plan);
+		}
+
+		MStatus JSONImporter::CreatePlan(const char *filename, Plan & plan, Reader reader) {
+			MStatus status;
+			file f;
+
+			status = reader == kReaderDOM ? ReadDOM(filename, f) : ReadStream(filename, f);
+			HMEVALUATE_RETURN_DESCRIPTION("JSONImporter::Read", status);
+
+			CreatePlan(f, plan);
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus JSONImporter::DryRun(const char *filename, ImportStatistics & statistics, Reader reader) {
+			MStatus status;
+			Plan plan;
+
+			HMEVALUATE_RETURN(status = CreatePlan(filename, plan, reader), status);
+
+			statistics.helices = plan.helices.size();
+			statistics.bases = plan.bases.size();
+			statistics.strands = ImportStatistics::CountStrands(plan.bases.size(), plan.forwardConnections);
+			statistics.crossovers = plan.crossovers;
+
+			for (std::vector< std::pair<int, int> >::const_iterator it = plan.dangling.begin(); it != plan.dangling.end(); ++it) {
+				std::ostringstream description;
+				description << "helix " << it->first << " index " << it->second << " connects to a missing base";
+				statistics.addDangling(description.str());
+			}
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus JSONImporter::Benchmark(const char *filename, unsigned int iterations, double & streamSeconds, double & domSeconds) {
+			MStatus status;
+			MTimer timer;
+			file stream_file, dom_file;
+
+			streamSeconds = 0.0;
+			domSeconds = 0.0;
+
+			for (unsigned int i = 0; i < iterations; ++i) {
+				stream_file = file();
+
+				timer.beginTimer();
+				status = ReadStream(filename, stream_file);
+				timer.endTimer();
+
+				HMEVALUATE_RETURN_DESCRIPTION("JSONImporter::ReadStream", status);
+				streamSeconds += timer.elapsedTime();
+
+				dom_file = file();
+
+				timer.beginTimer();
+				status = ReadDOM(filename, dom_file);
+				timer.endTimer();
+
+				HMEVALUATE_RETURN_DESCRIPTION("JSONImporter::ReadDOM", status);
+				domSeconds += timer.elapsedTime();
+			}
+
+			if (stream_file.name != dom_file.name || stream_file.order != dom_file.order || stream_file.helices != dom_file.helices) {
+				MGlobal::displayError(MString("The streaming and DOM parsers disagree on the contents of \"") + filename + "\"");
 				return MStatus::kFailure;
 			}
 
-			Json::Reader reader;
-			Json::Value root;
+			return MStatus::kSuccess;
+		}
 
-			if (!reader.parse(file, root, false)) {
-				MGlobal::displayError(MString("Failed to parse file \"") + filename);
+		MStatus JSONImporter::ReadStream(const char *filename, file & f) {
+			std::vector<char> buffer;
+
+			if (!JSONReader::ReadFile(filename, buffer)) {
+				MGlobal::displayError(MString("Failed to open file \"") + filename + "\" for reading");
 				return MStatus::kFailure;
 			}
 
-			if (!root.isObject()) {
-				MGlobal::displayError(MString("Failed to parse file \"") + filename);
+			JSONReader reader(buffer.empty() ? NULL : &buffer[0], buffer.empty() ? NULL : &buffer[0] + buffer.size());
+			bool foundVStrands = false;
+
+			f.filename = filename;
+
+			if (reader.next() != JSONReader::kObjectBegin) {
+				MGlobal::displayError(MString("Failed to parse file \"") + filename + "\"");
 				return MStatus::kFailure;
 			}
 
-			m_file.filename = filename;
-			Json::Value vstrands = root["vstrands"], name = root["name"];
+			for (JSONReader::Token token = reader.next(); token != JSONReader::kObjectEnd; token = reader.next()) {
+				if (token != JSONReader::kString) {
+					MGlobal::displayError(MString("Failed to parse file \"") + filename + "\" at offset " + (unsigned int) reader.offset());
+					return MStatus::kFailure;
+				}
 
-			if (name.isString())
-				m_file.name = name.asCString();
+				if (reader.string() == "name") {
+					token = reader.next();
 
-			if (!vstrands.isArray()) {
+					if (token == JSONReader::kString)
+						f.name = reader.string();
+					else if (!reader.skip(token)) {
+						MGlobal::displayError(MString("Failed to parse file \"") + filename + "\" at offset " + (unsigned int) reader.offset());
+						return MStatus::kFailure;
+					}
+				}
+				else if (reader.string() == "vstrands") {
+					if (reader.next() != JSONReader::kArrayBegin) {
+						MGlobal::displayError(MString("Failed to parse file \"") + filename + "\" for reading");
+						return MStatus::kFailure;
+					}
+
+					for (token = reader.next(); token != JSONReader::kArrayEnd; token = reader.next()) {
+						Helix helix;
+						int num;
+
+						if (token != JSONReader::kObjectBegin || !ReadVStrand(reader, helix, num)) {
+							MGlobal::displayError(MString("Syntax error in file \"") + filename + "\" at offset " + (unsigned int) reader.offset());
+							return MStatus::kFailure;
+						}
+
+						if (f.helices.find(num) == f.helices.end())
+							f.order.push_back(num);
+
+						f.helices[num] = helix;
+					}
+
+					foundVStrands = true;
+				}
+				else if (!reader.skip(reader.next())) {
+					MGlobal::displayError(MString("Failed to parse file \"") + filename + "\" at offset " + (unsigned int) reader.offset());
+					return MStatus::kFailure;
+				}
+			}
+
+			if (!foundVStrands) {
 				MGlobal::displayError(MString("Failed to parse file \"") + filename + "\" for reading");
 				return MStatus::kFailure;
 			}
 
-			/*
-			 * Calculate the average col and row for centering the helices. As well as a total_num for the progress bar
-			 */
+			return MStatus::kSuccess;
+		}
 
-			int average_col = 0, average_row = 0, total_num_operations = 0, longest_strand = 0;
+		bool JSONImporter::ReadVStrand(JSONReader & reader, Helix & helix, int & num) {
+			std::vector<int> strands[2], stap_colors;
+			bool foundNum = false, foundCol = false, foundRow = false;
 
-			for (Json::Value::iterator it = vstrands.begin(); it != vstrands.end(); ++it) {
-				average_col += (*it)["col"].asInt();
-				average_row += (*it)["row"].asInt();
+			for (JSONReader::Token token = reader.next(); token != JSONReader::kObjectEnd; token = reader.next()) {
+				if (token != JSONReader::kString)
+					return false;
 
-				int size = (*it)["loop"].size();
-				total_num_operations += size;
+				if (reader.string() == str_strands[0]) {
+					if (!reader.readIntegerTuples(strands[0], 4))
+						return false;
+				}
+				else if (reader.string() == str_strands[1]) {
+					if (!reader.readIntegerTuples(strands[1], 4))
+						return false;
+				}
+				else if (reader.string() == "loop") {
+					if (!reader.readIntegers(helix.loop))
+						return false;
+				}
+				else if (reader.string() == "skip") {
+					if (!reader.readIntegers(helix.skip))
+						return false;
+				}
+				else if (reader.string() == "stap_colors") {
+					if (!reader.readIntegerTuples(stap_colors, 2))
+						return false;
+				}
+				else if (reader.string() == "num") {
+					if (reader.next() != JSONReader::kNumber)
+						return false;
 
-				longest_strand = std::max(longest_strand, size);
+					num = reader.integer();
+					foundNum = true;
+				}
+				else if (reader.string() == "col") {
+					if (reader.next() != JSONReader::kNumber)
+						return false;
+
+					helix.col = reader.integer();
+					foundCol = true;
+				}
+				else if (reader.string() == "row") {
+					if (reader.next() != JSONReader::kNumber)
+						return false;
+
+					helix.row = reader.integer();
+					foundRow = true;
+				}
+				else if (!reader.skip(reader.next()))
+					return false;
 			}
 
-			average_col /= vstrands.size();
-			average_row /= vstrands.size();
+			if (!foundNum || !foundCol || !foundRow || strands[0].size() != strands[1].size() || helix.loop.size() * 4 != strands[0].size() || helix.skip.size() != helix.loop.size())
+				return false;
 
-			/*
-			 * These are bases building up strands that should be colored
-			 */
+			helix.direction = num % 2;
 
-			std::list< std::pair<Model::Base, Model::Material> > paintBases;
+			helix.scaf.resize(helix.loop.size());
+			helix.stap.resize(helix.loop.size());
 
-			/*
-			 * Randomize the material that will be used for the scaffold
-			 */
+			for (size_t i = 0; i < helix.loop.size(); ++i) {
+				std::copy(strands[0].begin() + i * 4, strands[0].begin() + (i + 1) * 4, helix.scaf[i].connections);
+				std::copy(strands[1].begin() + i * 4, strands[1].begin() + (i + 1) * 4, helix.stap[i].connections);
+			}
 
-			Model::Material scaf_material;
+			helix.stap_colors.reserve(stap_colors.size() / 2);
 
-			{
-				size_t numMaterials;
+			for (size_t i = 0; i < stap_colors.size(); i += 2)
+				helix.stap_colors.push_back(std::make_pair(stap_colors[i], stap_colors[i + 1]));
 
-				Model::Material::Iterator it = Model::Material::AllMaterials_begin(status, numMaterials);
+			return true;
+		}
 
-				if (!status) {
-					status.perror("Material::AllMaterials_begin");
-					return status;
-				}
+		MStatus JSONImporter::ReadDOM(const char *filename, file & f) {
+			std::fstream fileh(filename, std::ios_base::in);
 
-				if (numMaterials == 0) {
-					std::cerr << "Can't find any materials" << std::endl;
-					return MStatus::kFailure;
-				}
+			if (!fileh) {
+				MGlobal::displayError(MString("Failed to open file \"") + filename + "\" for reading");
+				return MStatus::kFailure;
+			}
 
-				scaf_material = *(it + (rand() % numMaterials));
+			Json::Reader reader;
+			Json::Value root;
+
+			if (!reader.parse(fileh, root, false)) {
+				MGlobal::displayError(MString("Failed to parse file \"") + filename);
+				return MStatus::kFailure;
 			}
 
-			MProgressWindow::endProgress();
+			if (!root.isObject()) {
+				MGlobal::displayError(MString("Failed to parse file \"") + filename);
+				return MStatus::kFailure;
+			}
 
-			if (!MProgressWindow::reserve())
-				MGlobal::displayWarning("Can't reserve progress window, no progress information will be presented");
-			MProgressWindow::setProgressRange(0, total_num_operations);
-			MProgressWindow::setTitle("Importing json (caDNAno) file...");
-			MProgressWindow::setProgressStatus(MString("Parsing file: \"") + filename + "\"");
-			MProgressWindow::setInterruptable(false);
-			MProgressWindow::startProgress();
+			f.filename = filename;
+			Json::Value vstrands = root["vstrands"], name = root["name"];
 
-			/*
-			 * Iterate over strands and generate the binary structures
-			 * We also create the bases right here, without connecting them to each other yet
-			 */
+			if (name.isString())
+				f.name = name.asCString();
+
+			if (!vstrands.isArray()) {
+				MGlobal::displayError(MString("Failed to parse file \"") + filename + "\" for reading");
+				return MStatus::kFailure;
+			}
 
 			for (Json::Value::iterator it = vstrands.begin(); it != vstrands.end(); ++it) {
 				Json::Value& scaf = (*it)[str_strands[0]],
@@ -139,51 +309,75 @@ namespace Helix {
 				}
 
 				Helix helix;
+				int num = num_value.asInt();
 
 				helix.col = col.asInt();
 				helix.row = row.asInt();
-				helix.scaf.reserve(scaf.size());
-				helix.stap.reserve(stap.size());
+				helix.direction = num % 2;
+				helix.scaf.resize(scaf.size());
+				helix.stap.resize(stap.size());
 				helix.loop.reserve(loop.size());
 				helix.skip.reserve(skip.size());
 
-				/*
-				 * We take care about the loop and skip arrays first, because they're needed below
-				 */
-
-				int total_strand_length = 0; // Unchanged for every skip and increased for every loop
-
 				for (Json::Value::ArrayIndex i = 0; i < scaf.size(); ++i) {
-					int loop_int = loop[i].asInt(), skip_int = skip[i].asInt();
-					helix.loop.push_back(loop_int);
-					helix.skip.push_back(skip_int);
+					helix.loop.push_back(loop[i].asInt());
+					helix.skip.push_back(skip[i].asInt());
 
-					total_strand_length += 1 + loop_int - skip_int;
+					for (int j = 0; j < 4; ++j) {
+						helix.scaf[i].connections[j] = scaf[i][j].asInt();
+						helix.stap[i].connections[j] = stap[i][j].asInt();
+					}
 				}
 
-				int num = num_value.asInt();
+				for (Json::Value::iterator color_it = stap_colors.begin(); color_it != stap_colors.end(); ++color_it)
+					helix.stap_colors.push_back(std::make_pair((*color_it)[0].asInt(), (*color_it)[1].asInt()));
+
+				if (f.helices.find(num) == f.helices.end())
+					f.order.push_back(num);
+
+				f.helices[num] = helix;
+			}
+
+			return MStatus::kSuccess;
+		}
+
+		/*
+		 * Plans the bases of a single helix and the connections within it. Must not use the Maya API, as it is executed in parallel
+		 */
+
+		class JSONImporter::PlanHelix {
+		public:
+			inline PlanHelix(const file & f, std::vector<HelixPlan> & plans, int average_col, int average_row, int longest_strand) : m_file(f), m_plans(plans), m_average_col(average_col), m_average_row(average_row), m_longest_strand(longest_strand) {
+
+			}
+
+			void operator() (size_t index) {
+				const int num = m_file.order[index];
+				const Helix & helix = m_file.helices.find(num)->second;
+				HelixPlan & plan = m_plans[index];
+
+				int total_strand_length = 0; // Unchanged for every skip and increased for every loop
+
+				for (size_t i = 0; i < helix.loop.size(); ++i)
+					total_strand_length += 1 + helix.loop[i] - helix.skip[i];
 
 				/*
 				 * Scaf_direction: If the direction is inversed, the helix will be rotated 180 degrees along the X-axis.
 				 * this requires us to compensate on the Z coordinate of the bases
 				 */
 
-				int scaf_direction = num % 2; // 0 = left to right, 1 = right to left
-
-				helix.direction = scaf_direction; /*Erik store the scaffold direction to use for later connection of deletions */
+				const int scaf_direction = helix.direction; // 0 = left to right, 1 = right to left
 
 				/*
 				 * For creating the honeycomb lattice
 				 */
 
-				double shuffle = ((helix.row % 2) * 2 - 1) * (((helix.col + 1) % 2) * 2 - 1);
-
-				MVector honeycomb_translation(
-					DNA::HONEYCOMB_X_STRIDE * (double(helix.col) - average_col),
-					DNA::HONEYCOMB_Y_STRIDE * (double(helix.row) - average_row) + DNA::HONEYCOMB_Y_OFFSET * shuffle
-				);
+				const double shuffle = ((helix.row % 2) * 2 - 1) * (((helix.col + 1) % 2) * 2 - 1);
 
-				double honeycomb_rotation_offset = M_PI + 2.0 * toRadians(DNA::PITCH);
+				plan.helix.num = num;
+				plan.helix.translation[0] = DNA::HONEYCOMB_X_STRIDE * (double(helix.col) - m_average_col);
+				plan.helix.translation[1] = DNA::HONEYCOMB_Y_STRIDE * (double(helix.row) - m_average_row) + DNA::HONEYCOMB_Y_OFFSET * shuffle;
+				plan.helix.translation[2] = 0.0;
 
 				/*
 				 * Transformation of the helix. Note that we flip every odd helix by 180 degrees.
@@ -191,372 +385,474 @@ namespace Helix {
 				 * so we will have to flip back the bases.
 				 */
 
-				MTransformationMatrix helix_transform;
-
-				if (!(status = helix_transform.setTranslation(honeycomb_translation, MSpace::kTransform))) {
-					status.perror("MFnTransform::setTranslation");
-					return status;
-				}
-
-				double rotation[] = {  M_PI * scaf_direction, 0.0, M_PI / 2.0 /*honeycomb_rotation_offset*/ };
-
-				if (!(status = helix_transform.setRotation(rotation, MTransformationMatrix::kXYZ, MSpace::kTransform))) {
-					status.perror("MTransformationMatrix::setRotation");
-					return status;
-				}
-
-				/*
-				 * Create the helix
-				 */
-
-				if (!(status = Model::Helix::Create("helix1", helix_transform, helix.helix))) {
-					status.perror("Helix::Create");
-					return status;
-				}
+				plan.helix.rotation[0] = M_PI * scaf_direction;
+				plan.helix.rotation[1] = 0.0;
+				plan.helix.rotation[2] = M_PI / 2.0;
 
 				/*
 				 * Data for cylinder generation
 				 */
 
 				int lowest_valid_base_index = INT_MAX, highest_valid_base_index = 0;
+				int translation_index = 0;
 
-				/*
-				 * Iterate over bases, collect their connection data and generate the bases without connecting them
-				 */
+				plan.slots[0].resize(helix.loop.size(), std::make_pair(0u, 0u));
+				plan.slots[1].resize(helix.loop.size(), std::make_pair(0u, 0u));
 
-				int translation_index = 0;
+				for (size_t i = 0; i < helix.loop.size(); ++i) {
+					const Base *strand_bases[] = { &helix.scaf[i], &helix.stap[i] };
+					const int loop_int = helix.loop[i], skip_int = helix.skip[i];
 
-				for (Json::Value::ArrayIndex i = 0; i < scaf.size(); ++i) {
-					Base scaf_base, stap_base;
-					Json::Value& scaf_indices = scaf[i], & stap_indices = stap[i];
-					int& loop_int = helix.loop[i], & skip_int = helix.skip[i];
+					if (skip_int != 0)
+						continue;
 
-					for (int j = 0; j < 4; ++j) {
-						scaf_base.connections[j] = scaf_indices[j].asInt();
-						stap_base.connections[j] = stap_indices[j].asInt();
-					}
+					/*
+					 * The bases of a slot (more than one if there's a loop) are stored consecutively, first the scaffold then the staple bases
+					 */
+
+					for (int k = 0; k < 2; ++k) {
+						if (!strand_bases[k]->isValid())
+							continue;
 
-					if (skip_int == 0) {
-						scaf_base.bases.reserve(loop_int + 1);
-						stap_base.bases.reserve(loop_int + 1);
+						plan.slots[k][i] = std::make_pair((unsigned int) plan.bases.size(), (unsigned int) loop_int + 1);
 
 						for (int j = 0; j < loop_int + 1; ++j) {
-							//int index = scaf_direction == 1 ? (- translation_index - 1) : translation_index;
-							//int index = translation_index * (-scaf_direction + ((scaf_direction + 1) % 2)) - scaf_direction;
-							int index = (scaf_direction * 2 - 1) * -translation_index - scaf_direction;
+							const int base_index = (scaf_direction * 2 - 1) * -(translation_index + j) - scaf_direction;
+							double forward[3], backward[3];
 
-							MVector forward_vector, backward_vector;
+							DNA::CalculateBasePairPositions((double) base_index, forward, backward, 0.0, scaf_direction == 0 ? m_longest_strand : -m_longest_strand);
 
-							DNA::CalculateBasePairPositions((double)index, forward_vector, backward_vector, 0.0, scaf_direction == 0 ? longest_strand : -longest_strand);
+							Plan::Base base;
+							base.helix = (unsigned int) index;
+							std::copy(k == 0 ? forward : backward, (k == 0 ? forward : backward) + 3, base.translation);
 
-							if (scaf_base.isValid()) {
-								// Create the base for the loop index j at index
+							if (k == 0) {
+								base.name = str_strands[0] + std::to_string((long long) i);
 
-								Model::Base base;
-								MString name = MString(str_strands[0]) + (int)i;
+								if (j > 0)
+									base.name += "_loop" + std::to_string((long long) j);
+							}
+							else {
+								base.name = std::string(str_strands[1]) + "_" + std::to_string((long long) i);
 
 								if (j > 0)
-									name += "_loop" + j;
+									base.name += "_loop_" + std::to_string((long long) j);
+							}
 
-								if (!(status = Model::Base::Create(helix.helix, name, forward_vector, base))) {
-									status.perror("Base::Create 1");
-									return status;
-								}
+							plan.bases.push_back(base);
+						}
+					}
 
-								scaf_base.bases.push_back(base);
-							}
+					const std::pair<unsigned int, unsigned int> & scaf_slot = plan.slots[0][i], & stap_slot = plan.slots[1][i];
 
-							if (stap_base.isValid()) {
-								// Create the base for the loop index j at index
+					/*
+					 * Connect the labels
+					 */
 
-								Model::Base base;
-								MString name = MString(str_strands[1]) + "_" + (int)i;
+					if (scaf_slot.second > 0 && stap_slot.second > 0) {
+						for (int j = 0; j < loop_int + 1; ++j)
+							plan.oppositeConnections.push_back(std::make_pair(scaf_slot.first + j, stap_slot.first + j));
+					}
 
-								if (j > 0)
-									name += "_loop_" + j;
+					/*
+					 * If there was a loop (loop_int > 0), connect the bases of the loop to each other.
+					 * If scaf_direction is 0 connect the scaffold forward and staples backward, otherwise the opposite
+					 */
 
-								if (!(status = Model::Base::Create(helix.helix, name, backward_vector, base))) {
-									status.perror("Base::Create 2");
-									return status;
-								}
+					for (int j = 0; j < loop_int; ++j) {
+						if (scaf_slot.second > 0)
+							plan.forwardConnections.push_back(scaf_direction == 0 ? std::make_pair(scaf_slot.first + j, scaf_slot.first + j + 1) : std::make_pair(scaf_slot.first + j + 1, scaf_slot.first + j));
 
-								stap_base.bases.push_back(base);
-							}
+						if (stap_slot.second > 0)
+							plan.forwardConnections.push_back(scaf_direction == 0 ? std::make_pair(stap_slot.first + j + 1, stap_slot.first + j) : std::make_pair(stap_slot.first + j, stap_slot.first + j + 1));
+					}
 
-							if (scaf_base.isValid() && stap_base.isValid()) {
-								/*
-								 * Connect the labels
-								 */
+					translation_index += loop_int + 1;
 
-								if (!(status = scaf_base.bases[scaf_base.bases.size() - 1].connect_opposite(stap_base.bases[stap_base.bases.size() - 1], true))) {
-									status.perror("Base::connect_opposite");
-									return status;
-								}
-							}
-							else {
-								//std::cerr << "Single stranded at helix: " << num << ", base index: " << i << " loop: " << j << std::endl;
-							}
+					/*
+					 * Collect data for cylinder generation
+					 */
 
-							++translation_index;
-						}
+					if (scaf_slot.second > 0 || stap_slot.second > 0) {
+						lowest_valid_base_index = std::min(lowest_valid_base_index, translation_index);
+						highest_valid_base_index = std::max(highest_valid_base_index, translation_index);
+					}
+				}
+
+				if (lowest_valid_base_index <= highest_valid_base_index) {
+					plan.helix.cylinderOrigin = (double(-total_strand_length + (lowest_valid_base_index + highest_valid_base_index)) / 2.0 * DNA::STEP - DNA::Z_SHIFT) * (1 - scaf_direction * 2);
+					plan.helix.cylinderHeight = (highest_valid_base_index - lowest_valid_base_index) * DNA::STEP;
+				}
+				else {
+					plan.helix.cylinderOrigin = 0.0;
+					plan.helix.cylinderHeight = 0.0;
+				}
+
+				/*
+				 * Staple colors are applied to the first base at the given index
+				 */
+
+				for (std::vector< std::pair<int, int> >::const_iterator it = helix.stap_colors.begin(); it != helix.stap_colors.end(); ++it) {
+					if (it->first < 0 || size_t(it->first) >= helix.stap.size() || plan.slots[1][it->first].second == 0)
+						continue;
+
+					Plan::Paint paint = { plan.slots[1][it->first].first, it->second };
+					plan.colors.push_back(paint);
+				}
+			}
+
+		private:
+			const file & m_file;
+			std::vector<HelixPlan> & m_plans;
+			int m_average_col, m_average_row, m_longest_strand;
+		};
+
+		/*
+		 * Plans the connections between helices. Requires the offsets of all the helix plans to be known. Must not use the Maya API
+		 */
+
+		class JSONImporter::PlanCrossConnections {
+		public:
+			inline PlanCrossConnections(const file & f, std::vector<HelixPlan> & plans, const std::map<int, size_t> & indices) : m_file(f), m_plans(plans), m_indices(indices) {
+
+			}
+
+			void operator() (size_t index) {
+				const int num = m_file.order[index];
+				const Helix & helix = m_file.helices.find(num)->second;
+				HelixPlan & plan = m_plans[index];
+				plan.crossovers = 0;
+
+				for (size_t i = 0; i < helix.loop.size(); ++i) {
+					/*
+					 * Remember that there can be several bases at each index if there's a loop, only the first and last should be connected
+					 * the ones inbetween have already been linked
+					 */
+
+					const std::pair<unsigned int, unsigned int> & scaf_slot = plan.slots[0][i], & stap_slot = plan.slots[1][i];
+
+					if (scaf_slot.second > 0) {
+						const HelixPlan *target;
+						const std::pair<unsigned int, unsigned int> *target_slot;
 
 						/*
-						 * If there was a loop (loop_int > 0), iterate over the loop and connect them to each other
+						 * If the forward base is a deletion, the next base in the direction of the helix is used instead
 						 */
 
-						if (scaf_direction == 0) {
-							/*
-							 * Connect scaffold forward and staples backward
-							 */
-
-							for (int j = 0; j < loop_int; ++j) {
-								if (scaf_base.isValid()) {
-									if (!(status = scaf_base.bases[j].connect_forward(scaf_base.bases[j + 1], true))) {
-										status.perror("Model::Base::connect_forward 1 1");
-										return status;
-									}
-								}
-
-								if (stap_base.isValid()) {
-									if (!(status = stap_base.bases[j + 1].connect_forward(stap_base.bases[j], true))) {
-										status.perror("Model::Base::connect_forward 1 2");
-										return status;
-									}
-								}
-							}
-						}
-						else {
-							/*
-							 * Connect scaffold backward and staples forward
-							 */
-
-							for (int j = 0; j < loop_int; ++j) {
-								if (scaf_base.isValid()) {
-									if (!(status = scaf_base.bases[j + 1].connect_forward(scaf_base.bases[j], true))) {
-										status.perror("Model::Base::connect_forward 2 1");
-										return status;
-									}
-								}
-
-								if (stap_base.isValid()) {
-									if (!(status = stap_base.bases[j].connect_forward(stap_base.bases[j + 1], true))) {
-										status.perror("Model::Base::connect_forward 2 2");
-										return status;
-									}
-								}
+						if (helix.scaf[i].hasNextConnection()) {
+							if (findTarget(0, helix.scaf[i], helix.direction == 0 ? 1 : -1, target, target_slot)) {
+								if (helix.direction == 0)
+									plan.crossConnections.push_back(std::make_pair(plan.offset + scaf_slot.first + scaf_slot.second - 1, target->offset + target_slot->first));
+								else
+									plan.crossConnections.push_back(std::make_pair(plan.offset + scaf_slot.first, target->offset + target_slot->first + target_slot->second - 1));
+
+								if (target != &plan)
+									++plan.crossovers;
 							}
+							else
+								plan.dangling.push_back(std::make_pair(num, int(i)));
 						}
 
 						/*
-						 * Collect data for cylinder generation
+						 * If there's a circular strand, it wont be colored, as we're only coloring strands where we find a 5' end
+						 * thus, add all scaffold bases that have a previous from another strand than itself.
+						 * We will have to color the same strand several times, but as the functor we're using does not apply color to bases
+						 * that already have a color assigned, the performance penalty should be minimal
 						 */
 
-						if (scaf_base.isValid() || stap_base.isValid()) {
-							lowest_valid_base_index = std::min(lowest_valid_base_index, translation_index);
-							highest_valid_base_index = std::max(highest_valid_base_index, translation_index);
+						if (helix.scaf[i].connections[0] != num) {
+							Plan::Paint paint = { plan.offset + scaf_slot.first, Plan::kScaffoldColor };
+							plan.scaffold.push_back(paint);
 						}
 					}
 
-					helix.scaf.push_back(scaf_base);
-					helix.stap.push_back(stap_base);
+					if (stap_slot.second > 0) {
+						const HelixPlan *target;
+						const std::pair<unsigned int, unsigned int> *target_slot;
+
+						if (helix.stap[i].hasNextConnection()) {
+							if (findTarget(1, helix.stap[i], helix.direction == 0 ? -1 : 1, target, target_slot)) {
+								if (helix.direction == 0)
+									plan.crossConnections.push_back(std::make_pair(plan.offset + stap_slot.first, target->offset + target_slot->first + target_slot->second - 1));
+								else
+									plan.crossConnections.push_back(std::make_pair(plan.offset + stap_slot.first + stap_slot.second - 1, target->offset + target_slot->first));
 
-					MProgressWindow::advanceProgress(1);
+								if (target != &plan)
+									++plan.crossovers;
+							}
+							else
+								plan.dangling.push_back(std::make_pair(num, int(i)));
+						}
+					}
 				}
+			}
 
-				/*
-				 * Create the helix cylinder using the collected range
-				 */
+		private:
+			bool findTarget(int strand, const Base & base, int deletionStep, const HelixPlan * & target, const std::pair<unsigned int, unsigned int> * & target_slot) const {
+				std::map<int, size_t>::const_iterator it = m_indices.find(base.connections[2]);
 
-				if (!(status = helix.helix.setCylinderRange(
-					(double(-total_strand_length + (lowest_valid_base_index + highest_valid_base_index)) / 2.0 * DNA::STEP - DNA::Z_SHIFT) * (1 - scaf_direction * 2),
-					(highest_valid_base_index - lowest_valid_base_index) * DNA::STEP
-				))) {
-					status.perror("Helix::setCylinderRange");
-					return status;
+				if (it == m_indices.end())
+					return false;
+
+				target = &m_plans[it->second];
+
+				const std::vector< std::pair<unsigned int, unsigned int> > & slots = target->slots[strand];
+				int target_index = base.connections[3];
+
+				if (target_index >= 0 && size_t(target_index) < slots.size() && slots[target_index].second == 0)
+					target_index += deletionStep;
+
+				if (target_index < 0 || size_t(target_index) >= slots.size() || slots[target_index].second == 0)
+					return false;
+
+				target_slot = &slots[target_index];
+
+				return true;
+			}
+
+			const file & m_file;
+			std::vector<HelixPlan> & m_plans;
+			const std::map<int, size_t> & m_indices;
+		};
+
+		void JSONImporter::CreatePlan(const file & f, Plan & plan) {
+			plan.name = f.name;
+			plan.filename = f.filename;
+
+			if (f.order.empty())
+				return;
+
+			/*
+			 * Calculate the average col and row for centering the helices
+			 */
+
+			int average_col = 0, average_row = 0, longest_strand = 0;
+
+			for (std::map<int, Helix>::const_iterator it = f.helices.begin(); it != f.helices.end(); ++it) {
+				average_col += it->second.col;
+				average_row += it->second.row;
+
+				longest_strand = std::max(longest_strand, int(it->second.loop.size()));
+			}
+
+			average_col /= int(f.helices.size());
+			average_row /= int(f.helices.size());
+
+			/*
+			 * Plan every helix on its own, then calculate where their bases end up in the final arrays and plan the connections between them
+			 */
+
+			std::vector<HelixPlan> plans(f.order.size());
+
+			{
+				PlanHelix functor(f, plans, average_col, average_row, longest_strand);
+				ParallelFor(plans.size(), functor);
+			}
+
+			std::map<int, size_t> indices;
+			unsigned int offset = 0;
+
+			for (size_t i = 0; i < plans.size(); ++i) {
+				plans[i].offset = offset;
+				offset += (unsigned int) plans[i].bases.size();
+
+				indices.insert(std::make_pair(plans[i].helix.num, i));
+			}
+
+			{
+				PlanCrossConnections functor(f, plans, indices);
+				ParallelFor(plans.size(), functor);
+			}
+
+			/*
+			 * Concatenate. Staple colors are applied before the scaffold color
+			 */
+
+			plan.helices.reserve(plans.size());
+			plan.bases.reserve(offset);
+
+			for (std::vector<HelixPlan>::iterator it = plans.begin(); it != plans.end(); ++it) {
+				plan.helices.push_back(it->helix);
+				plan.bases.insert(plan.bases.end(), it->bases.begin(), it->bases.end());
+
+				for (std::vector< std::pair<unsigned int, unsigned int> >::iterator connection_it = it->forwardConnections.begin(); connection_it != it->forwardConnections.end(); ++connection_it)
+					plan.forwardConnections.push_back(std::make_pair(it->offset + connection_it->first, it->offset + connection_it->second));
+
+				for (std::vector< std::pair<unsigned int, unsigned int> >::iterator connection_it = it->oppositeConnections.begin(); connection_it != it->oppositeConnections.end(); ++connection_it)
+					plan.oppositeConnections.push_back(std::make_pair(it->offset + connection_it->first, it->offset + connection_it->second));
+
+				for (std::vector<Plan::Paint>::iterator paint_it = it->colors.begin(); paint_it != it->colors.end(); ++paint_it) {
+					Plan::Paint paint = { it->offset + paint_it->base, paint_it->color };
+					plan.paint.push_back(paint);
 				}
+			}
 
-				/*
-				 * Now iterate over stap_colors and extract the base and its material
-				 */
+			for (std::vector<HelixPlan>::iterator it = plans.begin(); it != plans.end(); ++it) {
+				plan.forwardConnections.insert(plan.forwardConnections.end(), it->crossConnections.begin(), it->crossConnections.end());
+				plan.paint.insert(plan.paint.end(), it->scaffold.begin(), it->scaffold.end());
+				plan.dangling.insert(plan.dangling.end(), it->dangling.begin(), it->dangling.end());
+				plan.crossovers += it->crossovers;
+			}
+		}
+
+		MStatus JSONImporter::build(const Plan & plan) {
+			MStatus status;
 
-				for (Json::Value::iterator it = stap_colors.begin(); it != stap_colors.end(); ++it) {
-					int index = (*it)[0].asInt(), color = (*it)[1].asInt();
+			if (plan.helices.empty())
+				return MStatus::kSuccess;
 
-					float c[] = { float(color >> 16) / 0x100, float((color >> 8) & 0xFF) / 0x100, float(color & 0xFF) / 0x100 };
+			/*
+			 * Randomize the material that will be used for the scaffold
+			 */
 
-					Model::Material material;
+			Model::Material scaf_material;
 
-					if (!(status = Model::Material::Create("DNA_caDNAno1", c, material))) {
-						status.perror("Material::Create");
-						return status;
-					}
+			{
+				size_t numMaterials;
+
+				Model::Material::Iterator it = Model::Material::AllMaterials_begin(status, numMaterials);
+
+				if (!status) {
+					status.perror("Material::AllMaterials_begin");
+					return status;
+				}
 
-					paintBases.push_back(std::make_pair(helix.stap[index].bases[0], material));
+				if (numMaterials == 0) {
+					std::cerr << "Can't find any materials" << std::endl;
+					return MStatus::kFailure;
 				}
 
-				m_file.helices[num] = helix;
+				scaf_material = *(it + (rand() % numMaterials));
 			}
 
 			MProgressWindow::endProgress();
 
-			if (!MProgressWindow::reserve())
-				MGlobal::displayWarning("Can't reserve progress window, no progress information will be presented");
-			MProgressWindow::setProgressRange(0, total_num_operations);
-			MProgressWindow::setTitle("Importing json (caDNAno) file...");
-			MProgressWindow::setProgressStatus(MString("Connecting bases"));
-			MProgressWindow::setInterruptable(false);
-			MProgressWindow::startProgress();
+			BuildExecutor executor("Importing json (caDNAno) file...");
+			executor.begin(MString("Creating bases from file: \"") + plan.filename.c_str() + "\"", (unsigned int) plan.bases.size());
 
 			/*
-			 * Now, using the binary structure (and the generated bases), connect them to each other
+			 * Create the helices and their bases. If the import is cancelled all helices are deleted and with them everything else created
 			 */
 
-			for (std::map<int, Helix>::iterator it = m_file.helices.begin(); it != m_file.helices.end(); ++it) {
-				//int index = 0;
+			std::vector<Model::Helix> helices(plan.helices.size());
+			std::vector<Model::Base> bases(plan.bases.size());
 
-				for (size_t i = 0; i < it->second.scaf.size(); ++i) {
-					if (it->second.scaf[i].isValid()) {
-						/*
-						 * There's a base here that's not [ -1, -1, -1, -1 ] thus look at its connections and connect it!
-						 * Remember that the object at scaf[i].bases is an array of bases, only the first and last should be connected
-						 * the ones inbetween have already been linked above
-						 */
+			for (size_t i = 0; i < plan.helices.size(); ++i) {
+				const Plan::Helix & helix = plan.helices[i];
+				MTransformationMatrix helix_transform;
 
-						//if (it->second.scaf[i].hasPreviousConnection()) {
-						//	/*
-						//	 * Has a backward connection
-						//	 */
+				HMEVALUATE_RETURN(status = helix_transform.setTranslation(MVector(helix.translation), MSpace::kTransform), status);
+				HMEVALUATE_RETURN(status = helix_transform.setRotation(helix.rotation, MTransformationMatrix::kXYZ, MSpace::kTransform), status);
+				HMEVALUATE_RETURN(status = Model::Helix::Create("helix1", helix_transform, helices[i]), status);
+				HMEVALUATE_RETURN(status = helices[i].setCylinderRange(helix.cylinderOrigin, helix.cylinderHeight), status);
+			}
 
-						//	Base& backward = m_file.helices[it->second.scaf[i].connections[0]].scaf[it->second.scaf[i].connections[1]];
+			for (size_t i = 0; i < plan.bases.size(); ++i) {
+				const Plan::Base & base = plan.bases[i];
 
-						//	if (!(status = backward.bases[backward.bases.size() - 1].connect_forward(it->second.scaf[i].bases[0], true))) {
-						//		status.perror("Model::Base::connect_forward scaf 1");
-						//		return status;
-						//	}
-						//}
+				HMEVALUATE_RETURN(status = Model::Base::Create(helices[base.helix], base.name.c_str(), MVector(base.translation), bases[i]), status);
 
-						if (it->second.scaf[i].hasNextConnection() && it->second.scaf[i].bases.size() > 0) {/*Erik, also check that you are not trying to connect from a deleted base*/
-							/*
-							 * Has a forward connection
-							 */
+				if (!executor.step()) {
+					BuildExecutor::RollBack(helices.begin(), helices.end());
+					return executor.finish();
+				}
+			}
 
-							/*Base& forward = m_file.helices[it->second.scaf[i].connections[2]].scaf[it->second.scaf[i].connections[3]];*/
+			executor.begin("Connecting bases", (unsigned int) plan.forwardConnections.size());
 
-							int forward_helix = it->second.scaf[i].connections[2];
-							int forward_base = it->second.scaf[i].connections[3];
+			/*
+			 * All connections are made with a single modifier. The new bases have no previous connections to remove
+			 */
 
-							if (m_file.helices[forward_helix].scaf[forward_base].bases.size() < 1) {
-								if (it->second.direction == 0) {
-									forward_base += 1;
-								}
-								else {
-									forward_base += -1;
-								}
-							}
+			{
+				MDGModifier dgModifier;
 
-							Base& forward = m_file.helices[forward_helix].scaf[forward_base];
+				for (std::vector< std::pair<unsigned int, unsigned int> >::const_iterator it = plan.oppositeConnections.begin(); it != plan.oppositeConnections.end(); ++it) {
+					MObject object, target;
 
+					HMEVALUATE_RETURN(object = bases[it->first].getObject(status), status);
+					HMEVALUATE_RETURN(target = bases[it->second].getObject(status), status);
+					HMEVALUATE_RETURN(status = dgModifier.connect(MPlug(object, HelixBase::aLabel), MPlug(target, HelixBase::aLabel)), status);
+				}
 
-							if (it->second.direction == 0) {
-								if (!(status = it->second.scaf[i].bases[it->second.scaf[i].bases.size() - 1].connect_forward(forward.bases[0], true))) {
-									status.perror("Model::Base::connect_forward scaf 2");
-									return status;
-								}
-							}
-							else {
-								if (!(status = it->second.scaf[i].bases[0].connect_forward(forward.bases[forward.bases.size()-1], true))) {
-									status.perror("Model::Base::connect_forward scaf 2");
-									return status;
-								}
-							}
-							
-						}
+				for (std::vector< std::pair<unsigned int, unsigned int> >::const_iterator it = plan.forwardConnections.begin(); it != plan.forwardConnections.end(); ++it) {
+					MObject object, target;
 
-						/*
-						 * If there's a circular strand, it wont be colored, as we're only coloring strands where we find a 5' end
-						 * thus, add all scaffold bases that have a previous from another strand than itself.
-						 * We will have to color the same strand several times, but as the functor we're using does not apply color to bases
-						 * that already have a color assigned, the performance penalty should be minimal
-						 */
+					HMEVALUATE_RETURN(object = bases[it->first].getObject(status), status);
+					HMEVALUATE_RETURN(target = bases[it->second].getObject(status), status);
+					HMEVALUATE_RETURN(status = dgModifier.connect(MPlug(target, HelixBase::aBackward), MPlug(object, HelixBase::aForward)), status);
+				}
 
-						 if (it->second.scaf[i].connections[0] != it->first)
-							 paintBases.push_back(std::make_pair(it->second.scaf[i].bases[0], scaf_material));
-					}
+				HMEVALUATE_RETURN(status = dgModifier.doIt(), status);
+			}
 
-					if (it->second.stap[i].isValid()) {
-						/*
-						 * Also a valid base
-						 */
+			/*
+			 * Same aimConstraints as Base::connect_forward, but executed in batches
+			 */
 
-						//if (it->second.stap[i].hasPreviousConnection()) {
-						//	/*
-						//	 * Has a backward connection
-						//	 */
-
-						//	Base& backward = m_file.helices[it->second.stap[i].connections[0]].stap[it->second.stap[i].connections[1]];
-
-						//	if (!(status = backward.bases[backward.bases.size() - 1].connect_forward(it->second.stap[i].bases[0], true))) {
-						//		status.perror("Model::Base::connect_forward stap 1");
-						//		return status;
-						//	}
-						//}
-						//TEMPDELETIONBELOW
-						if (it->second.stap[i].hasNextConnection() && it->second.stap[i].bases.size() > 0) {
-							/*
-							 * has a forward connection && is not a deletion 
-							 */
-
-							int forward_helix = it->second.stap[i].connections[2];
-							int forward_base = it->second.stap[i].connections[3];
-
-							if (m_file.helices[forward_helix].stap[forward_base].bases.size() < 1) {/*Erik check that you are not trying to connect to a deletion move on then*/
-								if (it->second.direction == 0) {
-									forward_base += -1;
-								}
-								else {
-									forward_base += 1;
-								}	
-							}
+			{
+				MString command;
 
-							Base& forward = m_file.helices[forward_helix].stap[forward_base];
+				for (size_t i = 0; i < plan.forwardConnections.size(); ++i) {
+					MDagPath object, target;
 
+					HMEVALUATE_RETURN(object = bases[plan.forwardConnections[i].first].getDagPath(status), status);
+					HMEVALUATE_RETURN(target = bases[plan.forwardConnections[i].second].getDagPath(status), status);
 
-							if (it->second.direction == 0) {/*ERik the direction of loop conections will vary with the direction of the helix*/
-								if (!(status = it->second.stap[i].bases[0].connect_forward(forward.bases[forward.bases.size() - 1], true))) {
-									status.perror("model::base::connect_forward stap 2");
-									return status;
-								}
-							}
-							else {
-								if (!(status = it->second.stap[i].bases[it->second.stap[i].bases.size() - 1].connect_forward(forward.bases[0], true))) {
-									status.perror("Model::Base::connect_forward stap 2");
-									return status;
-								}
-							}
+					command += MString("aimConstraint -aimVector 0 0 -1.0 ") + target.fullPathName() + " " + object.fullPathName() + ";\n";
+
+					if ((i + 1) % AIMCONSTRAINT_BATCH_SIZE == 0 || i + 1 == plan.forwardConnections.size()) {
+						HMEVALUATE_RETURN(status = MGlobal::executeCommand(command, false), status);
+
+						command = MString();
+
+						if (!executor.advance((unsigned int) (i % AIMCONSTRAINT_BATCH_SIZE) + 1)) {
+							BuildExecutor::RollBack(helices.begin(), helices.end());
+							return executor.finish();
 						}
 					}
-
-					MProgressWindow::advanceProgress(1);
 				}
 			}
 
-			MProgressWindow::endProgress();
+			executor.end();
 
 			if (!MProgressWindow::reserve())
 				MGlobal::displayWarning("Can't reserve progress window, no progress information will be presented");
-			MProgressWindow::setProgressRange(0, (int)paintBases.size());
+			MProgressWindow::setProgressRange(0, (int) plan.paint.size());
 			MProgressWindow::setTitle("Importing json (caDNAno) file...");
 			MProgressWindow::setProgressStatus(MString("Painting strands"));
 			MProgressWindow::setInterruptable(false);
 			MProgressWindow::startProgress();
 
 			/*
-			 * Now paint the collected 5' ends
+			 * Now paint the collected 5' ends. Only one material is created per staple color
 			 */
 
+			std::map<int, Model::Material> materials;
 			PaintMultipleStrandsWithProgressBar functor;
-			for (std::list< std::pair<Model::Base, Model::Material> >::iterator it = paintBases.begin(); it != paintBases.end(); ++it)
-				functor(it->first, it->second);
+
+			for (std::vector<Plan::Paint>::const_iterator it = plan.paint.begin(); it != plan.paint.end(); ++it) {
+				Model::Material material = scaf_material;
+
+				if (it->color != Plan::kScaffoldColor) {
+					std::map<int, Model::Material>::iterator material_it = materials.find(it->color);
+
+					if (material_it == materials.end()) {
+						float c[] = { float(it->color >> 16) / 0x100, float((it->color >> 8) & 0xFF) / 0x100, float(it->color & 0xFF) / 0x100 };
+
+						if (!(status = Model::Material::Create("DNA_caDNAno1", c, material))) {
+							status.perror("Material::Create");
+							return status;
+						}
+
+						materials.insert(std::make_pair(it->color, material));
+					}
+					else
+						material = material_it->second;
+				}
+
+				functor(bases[it->base], material);
+			}
 
 			HMEVALUATE(status = functor.status(), status);
 
@@ -568,33 +864,15 @@ namespace Helix {
 
 			/*
 			 * Select the newly created helices
-			 * FIXME: Figure out why GCC can't use the shorter and faster template version
 			 */
 
-#ifndef __GNUC__
-			class {
-			public:
-				inline Model::Helix operator() (const std::map<int, Helix>::iterator& input) const {
-					return input->second.helix;
-				}
-			} select_functor;
-
-			if (!(status = Model::Object::Select(m_file.helices.begin(), m_file.helices.end(), select_functor))) {
-				status.perror("Object::Select");
-			}
-#else
-			std::list<Model::Helix> helices;
-			for (std::map<int, Helix>::iterator it = m_file.helices.begin(); it != m_file.helices.end(); ++it)
-				helices.push_back(it->second.helix);
-
 			if (!(status = Model::Object::Select(helices.begin(), helices.end()))) {
 				status.perror("Object::Select");
 			}
-#endif /* MAC_PLUGIN */
 
 			MProgressWindow::endProgress();
 
-			return MStatus::kSuccess;
+			return executor.finish();
 		}
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,291 @@
+/*
+ * JSONReader.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <controller/JSONReader.h>
+
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+
+namespace Helix {
+	namespace Controller {
+		JSONReader::JSONReader(const char *begin, const char *end) : m_begin(begin), m_it(begin), m_end(end), m_number(0.0) {
+
+		}
+
+		bool JSONReader::ReadFile(const char *filename, std::vector<char> & buffer) {
+			std::ifstream file(filename, std::ios_base::in | std::ios_base::binary);
+
+			if (!file)
+				return false;
+
+			file.seekg(0, std::ios_base::end);
+			const std::streamoff size = file.tellg();
+			file.seekg(0, std::ios_base::beg);
+
+			if (size < 0)
+				return false;
+
+			buffer.resize(size_t(size));
+
+			if (size > 0 && !file.read(&buffer[0], size))
+				return false;
+
+			return true;
+		}
+
+		JSONReader::Token JSONReader::next() {
+			skipWhitespace();
+
+			if (m_it == m_end)
+				return kEnd;
+
+			switch (*m_it) {
+			case '{':
+				++m_it;
+				return kObjectBegin;
+			case '}':
+				++m_it;
+				return kObjectEnd;
+			case '[':
+				++m_it;
+				return kArrayBegin;
+			case ']':
+				++m_it;
+				return kArrayEnd;
+			case '"':
+				return readString() ? kString : kError;
+			case 't':
+				return readLiteral("true", 4) ? kTrue : kError;
+			case 'f':
+				return readLiteral("false", 5) ? kFalse : kError;
+			case 'n':
+				return readLiteral("null", 4) ? kNull : kError;
+			default:
+				return readNumber() ? kNumber : kError;
+			}
+		}
+
+		bool JSONReader::skip(Token token) {
+			if (token == kError || token == kEnd || token == kObjectEnd || token == kArrayEnd)
+				return false;
+
+			if (token != kObjectBegin && token != kArrayBegin)
+				return true;
+
+			size_t depth = 1;
+
+			while (depth > 0) {
+				switch (next()) {
+				case kObjectBegin:
+				case kArrayBegin:
+					++depth;
+					break;
+				case kObjectEnd:
+				case kArrayEnd:
+					--depth;
+					break;
+				case kError:
+				case kEnd:
+					return false;
+				default:
+					break;
+				}
+			}
+
+			return true;
+		}
+
+		bool JSONReader::readIntegers(std::vector<int> & values) {
+			if (next() != kArrayBegin)
+				return false;
+
+			for (;;) {
+				switch (next()) {
+				case kNumber:
+					values.push_back(integer());
+					break;
+				case kArrayEnd:
+					return true;
+				default:
+					return false;
+				}
+			}
+		}
+
+		bool JSONReader::readIntegerTuples(std::vector<int> & values, size_t width) {
+			if (next() != kArrayBegin)
+				return false;
+
+			for (;;) {
+				switch (next()) {
+				case kArrayBegin:
+					for (size_t i = 0; i < width; ++i) {
+						if (next() != kNumber)
+							return false;
+
+						values.push_back(integer());
+					}
+
+					if (next() != kArrayEnd)
+						return false;
+
+					break;
+				case kArrayEnd:
+					return true;
+				default:
+					return false;
+				}
+			}
+		}
+
+		bool JSONReader::readString() {
+			m_string.clear();
+			++m_it; // Opening quote
+
+			for (;;) {
+				/*
+				 * Copy runs of unescaped characters at once
+				 */
+
+				const char *run = m_it;
+
+				while (m_it != m_end && *m_it != '"' && *m_it != '\\')
+					++m_it;
+
+				m_string.append(run, m_it);
+
+				if (m_it == m_end)
+					return false;
+
+				if (*m_it++ == '"')
+					return true;
+
+				if (m_it == m_end)
+					return false;
+
+				switch (*m_it++) {
+				case '"':
+					m_string += '"';
+					break;
+				case '\\':
+					m_string += '\\';
+					break;
+				case '/':
+					m_string += '/';
+					break;
+				case 'b':
+					m_string += '\b';
+					break;
+				case 'f':
+					m_string += '\f';
+					break;
+				case 'n':
+					m_string += '\n';
+					break;
+				case 'r':
+					m_string += '\r';
+					break;
+				case 't':
+					m_string += '\t';
+					break;
+				case 'u':
+					{
+						if (m_end - m_it < 4)
+							return false;
+
+						char hex[5] = { m_it[0], m_it[1], m_it[2], m_it[3], '\0' };
+						char *hex_end;
+						unsigned long codepoint = strtoul(hex, &hex_end, 16);
+
+						if (hex_end != hex + 4)
+							return false;
+
+						m_it += 4;
+
+						/*
+						 * Encode as UTF-8. Surrogate pairs are not combined, caDNAno never writes them
+						 */
+
+						if (codepoint < 0x80)
+							m_string += char(codepoint);
+						else if (codepoint < 0x800) {
+							m_string += char(0xC0 | (codepoint >> 6));
+							m_string += char(0x80 | (codepoint & 0x3F));
+						}
+						else {
+							m_string += char(0xE0 | (codepoint >> 12));
+							m_string += char(0x80 | ((codepoint >> 6) & 0x3F));
+							m_string += char(0x80 | (codepoint & 0x3F));
+						}
+					}
+					break;
+				default:
+					return false;
+				}
+			}
+		}
+
+		bool JSONReader::readNumber() {
+			const char *start = m_it;
+			bool negative = false;
+
+			if (*m_it == '-') {
+				negative = true;
+				++m_it;
+			}
+
+			if (m_it == m_end || *m_it < '0' || *m_it > '9') {
+				m_it = start;
+				return false;
+			}
+
+			/*
+			 * caDNAno files are almost exclusively integers, parse them directly without going through strtod
+			 */
+
+			double value = 0.0;
+
+			while (m_it != m_end && *m_it >= '0' && *m_it <= '9')
+				value = value * 10.0 + double(*m_it++ - '0');
+
+			if (m_it == m_end || (*m_it != '.' && *m_it != 'e' && *m_it != 'E')) {
+				m_number = negative ? -value : value;
+				return true;
+			}
+
+			/*
+			 * Fractional or exponent part, let strtod handle it. The buffer is not null terminated so make a copy
+			 */
+
+			while (m_it != m_end && ((*m_it >= '0' && *m_it <= '9') || *m_it == '.' || *m_it == 'e' || *m_it == 'E' || *m_it == '+' || *m_it == '-'))
+				++m_it;
+
+			char number[64];
+			const size_t length = size_t(m_it - start);
+
+			if (length >= sizeof(number))
+				return false;
+
+			memcpy(number, start, length);
+			number[length] = '\0';
+
+			char *number_end;
+			m_number = strtod(number, &number_end);
+
+			return number_end == number + length;
+		}
+
+		bool JSONReader::readLiteral(const char *literal, size_t length) {
+			if (size_t(m_end - m_it) < length || strncmp(m_it, literal, length) != 0)
+				return false;
+
+			m_it += length;
+			return true;
+		}
+	}
+}
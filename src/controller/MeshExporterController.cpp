@@ -0,0 +1,841 @@
+/*
+ * MeshExporterController.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <controller/MeshExporter.h>
+#include <model/Base.h>
+#include <model/Helix.h>
+#include <model/Material.h>
+#include <model/Object.h>
+#include <Compression.h>
+#include <DNA.h>
+#include <ExportPipeline.h>
+#include <RepairConstraints.h>
+#include <TextWriter.h>
+#include <Utility.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <string>
+
+#include <maya/MDagPath.h>
+#include <maya/MFnSet.h>
+#include <maya/MMatrix.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MPoint.h>
+#include <maya/MQuaternion.h>
+#include <maya/MSelectionList.h>
+#include <maya/MTimer.h>
+#include <maya/MTransformationMatrix.h>
+
+#if defined(WIN32) || defined(WIN64)
+#include <unordered_map>
+#else
+#include <tr1/unordered_map>
+#endif /* N Windows */
+
+namespace Helix {
+	namespace Data {
+		/*
+		 * Defined where BaseShapeUI.cpp includes data/BackboneArrow.h, which can only be included once
+		 */
+
+		extern unsigned int BackboneArrowNumVerts;
+		extern float BackboneArrowVerts[];
+		extern float BackboneArrowNormals[];
+	}
+
+	namespace Controller {
+		/*
+		 * Index of vertex in vertices, it is appended if it's not there. The meshes are small enough for a linear search
+		 */
+
+		static unsigned int MergeVertex(std::vector<float> & vertices, const float *vertex) {
+			for (size_t i = 0; i < vertices.size(); i += 3) {
+				if (vertices[i] == vertex[0] && vertices[i + 1] == vertex[1] && vertices[i + 2] == vertex[2])
+					return (unsigned int) (i / 3);
+			}
+
+			vertices.insert(vertices.end(), vertex, vertex + 3);
+			return (unsigned int) (vertices.size() / 3 - 1);
+		}
+
+		/*
+		 * Rotate vector by the unit quaternion (x, y, z, w)
+		 */
+
+		static void Rotate(const double quaternion[4], const double vector[3], double rotated[3]) {
+			const double t[] = {
+				2.0 * (quaternion[1] * vector[2] - quaternion[2] * vector[1]),
+				2.0 * (quaternion[2] * vector[0] - quaternion[0] * vector[2]),
+				2.0 * (quaternion[0] * vector[1] - quaternion[1] * vector[0])
+			};
+
+			rotated[0] = vector[0] + quaternion[3] * t[0] + quaternion[1] * t[2] - quaternion[2] * t[1];
+			rotated[1] = vector[1] + quaternion[3] * t[1] + quaternion[2] * t[0] - quaternion[0] * t[2];
+			rotated[2] = vector[2] + quaternion[3] * t[2] + quaternion[0] * t[1] - quaternion[1] * t[0];
+		}
+
+		/*
+		 * Split a world matrix into translation, rotation as a quaternion (x, y, z, w) and scale. Shear is dropped
+		 */
+
+		static MStatus Decompose(const MMatrix & matrix, double translation[3], double rotation[4], double scale[3]) {
+			MStatus status;
+			const MTransformationMatrix transform(matrix);
+			const MPoint origin(MPoint::origin * matrix);
+			const MQuaternion quaternion(transform.rotation());
+			HMEVALUATE_RETURN(status = transform.getScale(scale, MSpace::kTransform), status);
+
+			for (int i = 0; i < 3; ++i)
+				translation[i] = origin[i];
+
+			rotation[0] = quaternion.x;
+			rotation[1] = quaternion.y;
+			rotation[2] = quaternion.z;
+			rotation[3] = quaternion.w;
+
+			return MStatus::kSuccess;
+		}
+
+		const MeshExporter::Mesh & MeshExporter::BackboneArrow() {
+			static Mesh mesh;
+
+			if (mesh.corners.empty()) {
+				for (unsigned int i = 0; i < Data::BackboneArrowNumVerts; ++i) {
+					mesh.corners.push_back(MergeVertex(mesh.positions, Data::BackboneArrowVerts + 3 * i));
+					mesh.corners.push_back(MergeVertex(mesh.normals, Data::BackboneArrowNormals + 3 * i));
+				}
+			}
+
+			return mesh;
+		}
+
+		const MeshExporter::Mesh & MeshExporter::Cylinder() {
+			static Mesh mesh;
+
+			if (mesh.corners.empty()) {
+				/*
+				 * The bottom and top rims, then the centers of the caps. The normals are the radial directions and the normals of the caps
+				 */
+
+				for (unsigned int i = 0; i < MESH_EXPORT_CYLINDER_SEGMENTS; ++i) {
+					const double angle = 2.0 * M_PI * i / MESH_EXPORT_CYLINDER_SEGMENTS;
+					const float x = float(std::cos(angle)), y = float(std::sin(angle));
+					const float rims[] = { float(DNA::RADIUS) * x, float(DNA::RADIUS) * y, -0.5f, float(DNA::RADIUS) * x, float(DNA::RADIUS) * y, 0.5f };
+					const float normal[] = { x, y, 0.0f };
+
+					mesh.positions.insert(mesh.positions.end(), rims, rims + 6);
+					mesh.normals.insert(mesh.normals.end(), normal, normal + 3);
+				}
+
+				const float caps[] = { 0.0f, 0.0f, -0.5f, 0.0f, 0.0f, 0.5f }, capNormals[] = { 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f };
+				mesh.positions.insert(mesh.positions.end(), caps, caps + 6);
+				mesh.normals.insert(mesh.normals.end(), capNormals, capNormals + 6);
+
+				const unsigned int bottomCenter = 2 * MESH_EXPORT_CYLINDER_SEGMENTS, topCenter = bottomCenter + 1;
+				const unsigned int bottomNormal = MESH_EXPORT_CYLINDER_SEGMENTS, topNormal = bottomNormal + 1;
+
+				for (unsigned int i = 0; i < MESH_EXPORT_CYLINDER_SEGMENTS; ++i) {
+					const unsigned int j = (i + 1) % MESH_EXPORT_CYLINDER_SEGMENTS;
+					const unsigned int corners[] = {
+						2 * i, i, 2 * j, j, 2 * j + 1, j,
+						2 * i, i, 2 * j + 1, j, 2 * i + 1, i,
+						bottomCenter, bottomNormal, 2 * j, bottomNormal, 2 * i, bottomNormal,
+						topCenter, topNormal, 2 * i + 1, topNormal, 2 * j + 1, topNormal
+					};
+
+					mesh.corners.insert(mesh.corners.end(), corners, corners + sizeof(corners) / sizeof(unsigned int));
+				}
+			}
+
+			return mesh;
+		}
+
+		bool MeshExporter::FormatFromFilename(const char *filename, Format & format) {
+			std::string name(filename);
+
+			switch (Compression::FromFilename(filename)) {
+			case Compression::kGzip:
+				name.resize(name.size() - 3);
+				break;
+			case Compression::kZstd:
+				name.resize(name.size() - 4);
+				break;
+			default:
+				break;
+			}
+
+			std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+			const char *suffixes[] = { "." HELIX_OBJ_FILE_TYPE, "." HELIX_PLY_FILE_TYPE, "." HELIX_GLTF_FILE_TYPE };
+			const Format formats[] = { kObj, kPly, kGltf };
+
+			for (int i = 0; i < 3; ++i) {
+				const size_t length = strlen(suffixes[i]);
+
+				if (name.size() > length && name.compare(name.size() - length, length, suffixes[i]) == 0) {
+					format = formats[i];
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		/*
+		 * The instances in the order they are written: The cylinders, then the bases grouped by color
+		 */
+
+		class MeshExporter::Instances {
+		public:
+			struct Instance {
+				float translation[3], rotation[4], scale[3];
+				int color;
+			};
+
+			struct Group {
+				size_t begin, end;
+				int color;
+				bool cylinder;
+			};
+
+			Instances(const Scene & scene, bool cylinders) : m_numCylinders(0) {
+				if (cylinders) {
+					for (std::vector<Scene::Helix>::const_iterator it = scene.helices.begin(); it != scene.helices.end(); ++it) {
+						if (it->height <= 0.0)
+							continue;
+
+						/*
+						 * The cylinder is centered on origo along the helix axis, and scaled along it to its height
+						 */
+
+						const double offset[] = { 0.0, 0.0, it->origo * it->scale[2] };
+						double center[3];
+						Rotate(it->rotation, offset, center);
+
+						Instance instance;
+						set(instance, it->translation, it->rotation, it->scale, MESH_EXPORT_CYLINDER_COLOR);
+						instance.scale[2] *= float(it->height);
+
+						for (int i = 0; i < 3; ++i)
+							instance.translation[i] += float(center[i]);
+
+						m_instances.push_back(instance);
+					}
+
+					m_numCylinders = m_instances.size();
+
+					if (m_numCylinders > 0) {
+						const Group group = { 0, m_numCylinders, MESH_EXPORT_CYLINDER_COLOR, true };
+						m_groups.push_back(group);
+					}
+				}
+
+				/*
+				 * Count the bases of every color in the order the colors first appear, then place them
+				 */
+
+				std::map<int, size_t> groupIndices;
+
+				for (std::vector<Scene::Base>::const_iterator it = scene.bases.begin(); it != scene.bases.end(); ++it) {
+					const int color = it->color == -1 ? MESH_EXPORT_DEFAULT_COLOR : it->color;
+					std::map<int, size_t>::iterator index_it(groupIndices.find(color));
+
+					if (index_it == groupIndices.end()) {
+						const Group group = { 0, 0, color, false };
+						index_it = groupIndices.insert(std::make_pair(color, m_groups.size())).first;
+						m_groups.push_back(group);
+					}
+
+					++m_groups[index_it->second].end;
+				}
+
+				size_t begin = m_numCylinders;
+
+				for (std::vector<Group>::iterator it = m_groups.begin(); it != m_groups.end(); ++it) {
+					if (it->cylinder)
+						continue;
+
+					it->begin = begin;
+					it->end += begin;
+					begin = it->end;
+				}
+
+				std::vector<size_t> next(m_groups.size());
+
+				for (size_t i = 0; i < m_groups.size(); ++i)
+					next[i] = m_groups[i].begin;
+
+				m_instances.resize(begin);
+
+				for (std::vector<Scene::Base>::const_iterator it = scene.bases.begin(); it != scene.bases.end(); ++it) {
+					const int color = it->color == -1 ? MESH_EXPORT_DEFAULT_COLOR : it->color;
+
+					set(m_instances[next[groupIndices[color]]++], it->translation, it->rotation, it->scale, color);
+				}
+			}
+
+			inline size_t size() const {
+				return m_instances.size();
+			}
+
+			inline size_t numCylinders() const {
+				return m_numCylinders;
+			}
+
+			inline size_t numBases() const {
+				return m_instances.size() - m_numCylinders;
+			}
+
+			inline const Instance & operator[](size_t index) const {
+				return m_instances[index];
+			}
+
+			inline const std::vector<Group> & groups() const {
+				return m_groups;
+			}
+
+			/*
+			 * The transform of an instance as a 3x4 matrix applied to column vectors, and the matrix for transforming its normals
+			 */
+
+			static void GetMatrices(const Instance & instance, double matrix[3][4], double normalMatrix[3][3]) {
+				const double x = instance.rotation[0], y = instance.rotation[1], z = instance.rotation[2], w = instance.rotation[3];
+				const double rotation[3][3] = {
+					{ 1.0 - 2.0 * (y * y + z * z), 2.0 * (x * y - z * w), 2.0 * (x * z + y * w) },
+					{ 2.0 * (x * y + z * w), 1.0 - 2.0 * (x * x + z * z), 2.0 * (y * z - x * w) },
+					{ 2.0 * (x * z - y * w), 2.0 * (y * z + x * w), 1.0 - 2.0 * (x * x + y * y) }
+				};
+
+				for (int i = 0; i < 3; ++i) {
+					for (int j = 0; j < 3; ++j) {
+						matrix[i][j] = rotation[i][j] * instance.scale[j];
+						normalMatrix[i][j] = instance.scale[j] != 0.0f ? rotation[i][j] / instance.scale[j] : 0.0;
+					}
+
+					matrix[i][3] = instance.translation[i];
+				}
+			}
+
+		private:
+			static void set(Instance & instance, const double translation[3], const double rotation[4], const double scale[3], int color) {
+				for (int i = 0; i < 3; ++i) {
+					instance.translation[i] = float(translation[i]);
+					instance.scale[i] = float(scale[i]);
+				}
+
+				for (int i = 0; i < 4; ++i)
+					instance.rotation[i] = float(rotation[i]);
+
+				instance.color = color;
+			}
+
+			std::vector<Instance> m_instances;
+			std::vector<Group> m_groups;
+			size_t m_numCylinders;
+		};
+
+		/*
+		 * Writes the vertices, normals and faces of one instance. OBJ indices are global and start at 1, but all instances of a mesh
+		 * have the same number of vertices so the indices of an instance are known without the ones before it
+		 */
+
+		class MeshExporter::ObjFormatter {
+		public:
+			inline ObjFormatter(const Instances & instances) : m_instances(instances), m_cylinder(Cylinder()), m_arrow(BackboneArrow()) {
+
+			}
+
+			void operator() (size_t index, TextWriter & output) const {
+				const Instances::Instance & instance(m_instances[index]);
+				const Mesh & mesh(index < m_instances.numCylinders() ? m_cylinder : m_arrow);
+				const size_t cylindersBefore = std::min(index, m_instances.numCylinders()), basesBefore = index - cylindersBefore;
+				const size_t firstPosition = 1 + cylindersBefore * m_cylinder.numPositions() + basesBefore * m_arrow.numPositions();
+				const size_t firstNormal = 1 + cylindersBefore * m_cylinder.numNormals() + basesBefore * m_arrow.numNormals();
+				const double r = ((instance.color >> 16) & 0xFF) / 255.0, g = ((instance.color >> 8) & 0xFF) / 255.0, b = (instance.color & 0xFF) / 255.0;
+
+				double matrix[3][4], normalMatrix[3][3];
+				Instances::GetMatrices(instance, matrix, normalMatrix);
+
+				for (size_t i = 0; i < mesh.positions.size(); i += 3) {
+					const float *position = &mesh.positions[i];
+
+					output << "v";
+
+					for (int j = 0; j < 3; ++j)
+						output << ' ' << matrix[j][0] * position[0] + matrix[j][1] * position[1] + matrix[j][2] * position[2] + matrix[j][3];
+
+					output << ' ' << r << ' ' << g << ' ' << b << '\n';
+				}
+
+				for (size_t i = 0; i < mesh.normals.size(); i += 3) {
+					const float *normal = &mesh.normals[i];
+					double transformed[3];
+
+					for (int j = 0; j < 3; ++j)
+						transformed[j] = normalMatrix[j][0] * normal[0] + normalMatrix[j][1] * normal[1] + normalMatrix[j][2] * normal[2];
+
+					const double length = std::sqrt(transformed[0] * transformed[0] + transformed[1] * transformed[1] + transformed[2] * transformed[2]);
+					const double scale = length > 0.0 ? 1.0 / length : 0.0;
+
+					output << "vn " << transformed[0] * scale << ' ' << transformed[1] * scale << ' ' << transformed[2] * scale << '\n';
+				}
+
+				for (size_t i = 0; i < mesh.corners.size(); i += 6) {
+					output << 'f';
+
+					for (size_t j = 0; j < 6; j += 2)
+						output << ' ' << firstPosition + mesh.corners[i + j] << "//" << firstNormal + mesh.corners[i + j + 1];
+
+					output << '\n';
+				}
+			}
+
+		private:
+			const Instances & m_instances;
+			const Mesh & m_cylinder, & m_arrow;
+		};
+
+		/*
+		 * Binary PLY has all vertices first and then all faces, the instances are formatted once for each. The records are written in the
+		 * byte order of the host, which is little endian on every platform Maya runs on
+		 */
+
+		class MeshExporter::PlyFormatter {
+		public:
+			enum Element {
+				kVertices,
+				kFaces
+			};
+
+			inline PlyFormatter(const Instances & instances) : m_instances(instances), m_cylinder(Cylinder()), m_arrow(BackboneArrow()), m_element(kVertices) {
+
+			}
+
+			inline void setElement(Element element) {
+				m_element = element;
+			}
+
+			inline size_t numVertices() const {
+				return m_instances.numCylinders() * m_cylinder.numPositions() + m_instances.numBases() * m_arrow.numPositions();
+			}
+
+			inline size_t numFaces() const {
+				return m_instances.numCylinders() * m_cylinder.numTriangles() + m_instances.numBases() * m_arrow.numTriangles();
+			}
+
+			void operator() (size_t index, TextWriter & output) const {
+				const Instances::Instance & instance(m_instances[index]);
+				const Mesh & mesh(index < m_instances.numCylinders() ? m_cylinder : m_arrow);
+
+				if (m_element == kVertices) {
+					double matrix[3][4], normalMatrix[3][3];
+					Instances::GetMatrices(instance, matrix, normalMatrix);
+
+					char record[3 * sizeof(float) + 3];
+					record[3 * sizeof(float)] = char((instance.color >> 16) & 0xFF);
+					record[3 * sizeof(float) + 1] = char((instance.color >> 8) & 0xFF);
+					record[3 * sizeof(float) + 2] = char(instance.color & 0xFF);
+
+					for (size_t i = 0; i < mesh.positions.size(); i += 3) {
+						const float *position = &mesh.positions[i];
+
+						for (int j = 0; j < 3; ++j) {
+							const float value = float(matrix[j][0] * position[0] + matrix[j][1] * position[1] + matrix[j][2] * position[2] + matrix[j][3]);
+							memcpy(record + j * sizeof(float), &value, sizeof(float));
+						}
+
+						output.write(record, sizeof(record));
+					}
+				}
+				else {
+					const size_t cylindersBefore = std::min(index, m_instances.numCylinders()), basesBefore = index - cylindersBefore;
+					const int firstPosition = int(cylindersBefore * m_cylinder.numPositions() + basesBefore * m_arrow.numPositions());
+
+					char record[1 + 3 * sizeof(int)];
+					record[0] = 3;
+
+					for (size_t i = 0; i < mesh.corners.size(); i += 6) {
+						for (int j = 0; j < 3; ++j) {
+							const int vertex = firstPosition + int(mesh.corners[i + 2 * j]);
+							memcpy(record + 1 + j * sizeof(int), &vertex, sizeof(int));
+						}
+
+						output.write(record, sizeof(record));
+					}
+				}
+			}
+
+		private:
+			const Instances & m_instances;
+			const Mesh & m_cylinder, & m_arrow;
+			Element m_element;
+		};
+
+		bool MeshExporter::WriteObj(const char *filename, const Instances & instances) {
+			TextWriter output;
+
+			if (!output.open(filename))
+				return false;
+
+			output << "# vHelix mesh export, " << Date() << "\n# " << instances.numBases() << " bases, " << instances.numCylinders() << " helix cylinders\n";
+
+			ObjFormatter formatter(instances);
+			ParallelFormat(output, instances.size(), formatter, MESH_EXPORT_CHUNK_SIZE);
+
+			return output.close();
+		}
+
+		bool MeshExporter::WritePly(const char *filename, const Instances & instances) {
+			TextWriter output;
+
+			if (!output.open(filename))
+				return false;
+
+			PlyFormatter formatter(instances);
+
+			output << "ply\nformat binary_little_endian 1.0\ncomment vHelix mesh export, " << Date() << "\nelement vertex " << formatter.numVertices() <<
+				"\nproperty float x\nproperty float y\nproperty float z\nproperty uchar red\nproperty uchar green\nproperty uchar blue\nelement face " <<
+				formatter.numFaces() << "\nproperty list uchar int vertex_indices\nend_header\n";
+
+			formatter.setElement(PlyFormatter::kVertices);
+			ParallelFormat(output, instances.size(), formatter, MESH_EXPORT_CHUNK_SIZE);
+
+			formatter.setElement(PlyFormatter::kFaces);
+			ParallelFormat(output, instances.size(), formatter, MESH_EXPORT_CHUNK_SIZE);
+
+			return output.close();
+		}
+
+		/*
+		 * Little endian like the rest of the binary formats
+		 */
+
+		static void WriteUInt32(TextWriter & output, unsigned int value) {
+			char bytes[4];
+
+			for (int i = 0; i < 4; ++i)
+				bytes[i] = char((value >> (8 * i)) & 0xFF);
+
+			output.write(bytes, sizeof(bytes));
+		}
+
+		static void WriteColor(TextWriter & output, int color, double alpha) {
+			output << '[' << ((color >> 16) & 0xFF) / 255.0 << ',' << ((color >> 8) & 0xFF) / 255.0 << ',' << (color & 0xFF) / 255.0 << ',' << alpha << ']';
+		}
+
+		bool MeshExporter::WriteGltf(const char *filename, const Instances & instances) {
+			const Mesh *meshes[] = { &Cylinder(), &BackboneArrow() };
+			const bool used[] = { instances.numCylinders() > 0, instances.numBases() > 0 };
+			const std::vector<Instances::Group> & groups(instances.groups());
+
+			/*
+			 * The binary chunk: The positions and normals of the used meshes, expanded to a vertex per corner, followed by the translations,
+			 * rotations and scales of all instances. Everything is floats, so every view is aligned
+			 */
+
+			std::vector< std::pair<size_t, size_t> > views; // byteOffset, byteLength.
+			size_t meshAccessors[2] = { 0, 0 }, numMeshAccessors = 0, offset = 0;
+
+			for (int i = 0; i < 2; ++i) {
+				if (!used[i])
+					continue;
+
+				const size_t length = meshes[i]->corners.size() / 2 * 3 * sizeof(float);
+
+				meshAccessors[i] = numMeshAccessors;
+				numMeshAccessors += 2;
+
+				for (int j = 0; j < 2; ++j) {
+					views.push_back(std::make_pair(offset, length));
+					offset += length;
+				}
+			}
+
+			const size_t instanceView = views.size();
+			const size_t instanceSizes[] = { 3 * sizeof(float), 4 * sizeof(float), 3 * sizeof(float) };
+
+			for (int i = 0; i < 3; ++i) {
+				views.push_back(std::make_pair(offset, instances.size() * instanceSizes[i]));
+				offset += instances.size() * instanceSizes[i];
+			}
+
+			const size_t binaryLength = offset;
+
+			/*
+			 * Every group of instances is a node with its own mesh and material, as the material belongs to the mesh in glTF.
+			 * The meshes of a group share the vertex accessors
+			 */
+
+			TextWriter json(TextWriter::kShortest);
+
+			json << "{\"asset\":{\"version\":\"2.0\",\"generator\":\"vHelix\"},\"extensionsUsed\":[\"EXT_mesh_gpu_instancing\"],\"extensionsRequired\":[\"EXT_mesh_gpu_instancing\"],"
+				"\"scene\":0,\"scenes\":[{\"nodes\":[";
+
+			for (size_t i = 0; i < groups.size(); ++i)
+				json << (i > 0 ? "," : "") << i;
+
+			json << "]}],\"nodes\":[";
+
+			for (size_t i = 0; i < groups.size(); ++i) {
+				const size_t accessor = numMeshAccessors + 3 * i;
+
+				json << (i > 0 ? "," : "") << "{\"mesh\":" << i << ",\"extensions\":{\"EXT_mesh_gpu_instancing\":{\"attributes\":{\"TRANSLATION\":" << accessor <<
+					",\"ROTATION\":" << accessor + 1 << ",\"SCALE\":" << accessor + 2 << "}}}}";
+			}
+
+			json << "],\"meshes\":[";
+
+			for (size_t i = 0; i < groups.size(); ++i) {
+				const size_t accessor = meshAccessors[groups[i].cylinder ? 0 : 1];
+
+				json << (i > 0 ? "," : "") << "{\"primitives\":[{\"attributes\":{\"POSITION\":" << accessor << ",\"NORMAL\":" << accessor + 1 << "},\"material\":" << i << "}]}";
+			}
+
+			json << "],\"materials\":[";
+
+			for (size_t i = 0; i < groups.size(); ++i) {
+				json << (i > 0 ? "," : "") << "{\"pbrMetallicRoughness\":{\"baseColorFactor\":";
+				WriteColor(json, groups[i].color, groups[i].cylinder ? MESH_EXPORT_CYLINDER_ALPHA : 1.0);
+				json << ",\"metallicFactor\":0,\"roughnessFactor\":0.5}" << (groups[i].cylinder ? ",\"alphaMode\":\"BLEND\"}" : "}");
+			}
+
+			json << "],\"accessors\":[";
+
+			for (int i = 0, view = 0; i < 2; ++i) {
+				if (!used[i])
+					continue;
+
+				const Mesh & mesh(*meshes[i]);
+				float min[] = { mesh.positions[0], mesh.positions[1], mesh.positions[2] }, max[] = { min[0], min[1], min[2] };
+
+				for (size_t j = 0; j < mesh.positions.size(); ++j) {
+					min[j % 3] = std::min(min[j % 3], mesh.positions[j]);
+					max[j % 3] = std::max(max[j % 3], mesh.positions[j]);
+				}
+
+				json << (view > 0 ? "," : "") << "{\"bufferView\":" << view << ",\"componentType\":5126,\"count\":" << mesh.corners.size() / 2 << ",\"type\":\"VEC3\",\"min\":[" <<
+					double(min[0]) << ',' << double(min[1]) << ',' << double(min[2]) << "],\"max\":[" << double(max[0]) << ',' << double(max[1]) << ',' << double(max[2]) << "]},"
+					"{\"bufferView\":" << view + 1 << ",\"componentType\":5126,\"count\":" << mesh.corners.size() / 2 << ",\"type\":\"VEC3\"}";
+
+				view += 2;
+			}
+
+			for (size_t i = 0; i < groups.size(); ++i) {
+				const char *types[] = { "VEC3", "VEC4", "VEC3" };
+
+				for (size_t j = 0; j < 3; ++j) {
+					json << (numMeshAccessors > 0 || i > 0 || j > 0 ? "," : "") << "{\"bufferView\":" << instanceView + j << ",\"byteOffset\":" << groups[i].begin * instanceSizes[j] <<
+						",\"componentType\":5126,\"count\":" << groups[i].end - groups[i].begin << ",\"type\":\"" << types[j] << "\"}";
+				}
+			}
+
+			json << "],\"bufferViews\":[";
+
+			for (size_t i = 0; i < views.size(); ++i)
+				json << (i > 0 ? "," : "") << "{\"buffer\":0,\"byteOffset\":" << views[i].first << ",\"byteLength\":" << views[i].second << '}';
+
+			json << "],\"buffers\":[{\"byteLength\":" << binaryLength << "}]}";
+
+			while (json.str().size() % 4 != 0)
+				json << ' ';
+
+			/*
+			 * The header and both chunks. Everything has a known size by now, so the file is written front to back
+			 */
+
+			TextWriter output;
+
+			if (!output.open(filename))
+				return false;
+
+			WriteUInt32(output, 0x46546C67); // glTF
+			WriteUInt32(output, 2);
+			WriteUInt32(output, (unsigned int) (12 + 8 + json.str().size() + 8 + binaryLength));
+
+			WriteUInt32(output, (unsigned int) json.str().size());
+			WriteUInt32(output, 0x4E4F534A); // JSON
+			output << json.str();
+
+			WriteUInt32(output, (unsigned int) binaryLength);
+			WriteUInt32(output, 0x004E4942); // BIN
+
+			for (int i = 0; i < 2; ++i) {
+				if (!used[i])
+					continue;
+
+				const Mesh & mesh(*meshes[i]);
+
+				for (int j = 0; j < 2; ++j) {
+					const std::vector<float> & vertices(j == 0 ? mesh.positions : mesh.normals);
+
+					for (size_t k = j; k < mesh.corners.size(); k += 2)
+						output.write((const char *) &vertices[3 * mesh.corners[k]], 3 * sizeof(float));
+				}
+			}
+
+			for (size_t i = 0; i < instances.size(); ++i)
+				output.write((const char *) instances[i].translation, sizeof(instances[i].translation));
+
+			for (size_t i = 0; i < instances.size(); ++i)
+				output.write((const char *) instances[i].rotation, sizeof(instances[i].rotation));
+
+			for (size_t i = 0; i < instances.size(); ++i)
+				output.write((const char *) instances[i].scale, sizeof(instances[i].scale));
+
+			return output.close();
+		}
+
+		bool MeshExporter::Write(const char *filename, Format format, const Scene & scene, bool cylinders) {
+			const Instances instances(scene, cylinders);
+
+			switch (format) {
+			case kObj:
+				return WriteObj(filename, instances);
+			case kPly:
+				return WritePly(filename, instances);
+			default:
+				return WriteGltf(filename, instances);
+			}
+		}
+
+#if defined(WIN32) || defined(WIN64)
+		typedef std::unordered_map<MObjectHandle, int, Model::ObjectHandleHash> object_color_map_t;
+#else
+		typedef std::tr1::unordered_map<MObjectHandle, int, Model::ObjectHandleHash> object_color_map_t;
+#endif /* N Windows */
+
+		MStatus MeshExporter::Capture(const MObjectArray & helices, Scene & scene) {
+			MStatus status;
+			object_color_map_t baseColors;
+
+			/*
+			 * The orientation of the bases comes from their aimConstraints, which may not have been repaired yet if the file was just opened
+			 */
+
+			unsigned int numChecked, numRepaired;
+			HMEVALUATE_RETURN(status = RepairConstraints::Repair(numChecked, numRepaired), status);
+
+			/*
+			 * Like the oxDNA export, the members of every material are listed once instead of asking every base for its material
+			 */
+
+			Model::Material::Iterator materials_begin;
+			HMEVALUATE_RETURN(materials_begin = Model::Material::AllMaterials_begin(status), status);
+
+			for (Model::Material::Iterator it = materials_begin; it != Model::Material::AllMaterials_end(); ++it) {
+				MSelectionList setList;
+				MObject setObject;
+				float color[3];
+
+				if (!setList.add(it->getMaterial()) || !setList.getDependNode(0, setObject) || !it->getColor(color))
+					continue;
+
+				MFnSet set(setObject, &status);
+
+				if (!status)
+					continue;
+
+				MSelectionList members;
+				HMEVALUATE_RETURN(status = set.getMembers(members, false), status);
+
+				const int rgb = (std::min(int(color[0] * 0x100 + 0.5f), 0xFF) << 16) | (std::min(int(color[1] * 0x100 + 0.5f), 0xFF) << 8) | std::min(int(color[2] * 0x100 + 0.5f), 0xFF);
+
+				for (unsigned int i = 0; i < members.length(); ++i) {
+					MDagPath memberDagPath;
+
+					if (!members.getDagPath(i, memberDagPath))
+						continue;
+
+					// The members are the shapes of the bases. If a base is in several materials, the first one is used like Base::getMaterial.
+					if (!memberDagPath.hasFn(MFn::kTransform))
+						memberDagPath.pop();
+
+					baseColors.insert(std::make_pair(MObjectHandle(memberDagPath.node()), rgb));
+				}
+			}
+
+			scene.helices.resize(helices.length());
+
+			for (unsigned int i = 0; i < helices.length(); ++i) {
+				Model::Helix helix(helices[i]);
+				Scene::Helix & outhelix(scene.helices[i]);
+				MDagPath helixDagPath;
+				MMatrix matrix;
+
+				HMEVALUATE_RETURN(helixDagPath = helix.getDagPath(status), status);
+				HMEVALUATE_RETURN(matrix = helixDagPath.inclusiveMatrix(&status), status);
+				HMEVALUATE_RETURN(status = Decompose(matrix, outhelix.translation, outhelix.rotation, outhelix.scale), status);
+
+				if (!helix.getCylinderRange(outhelix.origo, outhelix.height))
+					outhelix.origo = outhelix.height = 0.0;
+
+				/*
+				 * Every base has its own orientation, set by its aimConstraint along the strand, so its whole transform is taken from its own path
+				 */
+
+				for (Model::Helix::BaseIterator it = helix.begin(); it != helix.end(); ++it) {
+					MObject baseObject;
+					HMEVALUATE_RETURN(baseObject = it->getObject(status), status);
+
+					MDagPath baseDagPath(helixDagPath);
+					HMEVALUATE_RETURN(status = baseDagPath.push(baseObject), status);
+
+					MMatrix baseMatrix;
+					HMEVALUATE_RETURN(baseMatrix = baseDagPath.inclusiveMatrix(&status), status);
+
+					const object_color_map_t::const_iterator color_it(baseColors.find(MObjectHandle(baseObject)));
+					Scene::Base base;
+					base.helix = i;
+					base.color = color_it != baseColors.end() ? color_it->second : -1;
+					HMEVALUATE_RETURN(status = Decompose(baseMatrix, base.translation, base.rotation, base.scale), status);
+
+					scene.bases.push_back(base);
+				}
+			}
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus MeshExporter::Export(const char *filename, const MObjectArray & helices, bool cylinders) {
+			MStatus status;
+			Scene scene;
+			Format format;
+			MTimer timer;
+
+			const Compression::Format compression = Compression::FromFilename(filename);
+
+			if (!Compression::IsSupported(compression)) {
+				MGlobal::displayError(MString("vHelix was built without ") + Compression::Name(compression) + " support, can't write \"" + filename + "\".");
+				return MStatus::kFailure;
+			}
+
+			if (!FormatFromFilename(filename, format)) {
+				MGlobal::displayError(MString("Unknown mesh format of \"") + filename + "\", use ." HELIX_GLTF_FILE_TYPE ", ." HELIX_OBJ_FILE_TYPE " or ." HELIX_PLY_FILE_TYPE);
+				return MStatus::kFailure;
+			}
+
+			timer.beginTimer();
+
+			HMEVALUATE_RETURN(status = Capture(helices, scene), status);
+
+			if (!Write(filename, format, scene, cylinders)) {
+				MGlobal::displayError(MString("Failed to write file \"") + filename + "\"");
+				return MStatus::kFailure;
+			}
+
+			timer.endTimer();
+
+			MGlobal::displayInfo(MString("Exported ") + (unsigned int) scene.bases.size() + " bases and " + (unsigned int) scene.helices.size() + " helices to \"" + filename + "\" in " + timer.elapsedTime() + " s");
+
+			return MStatus::kSuccess;
+		}
+	}
+}
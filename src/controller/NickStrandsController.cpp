@@ -0,0 +1,66 @@
+/*
+ * NickStrandsController.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <controller/NickStrands.h>
+#include <model/Helix.h>
+
+#include <algorithm>
+
+namespace Helix {
+	namespace Controller {
+		MStatus NickStrands::add(Model::StrandIndex::Strand & strand, const std::vector<unsigned int> & sites) {
+			MStatus status;
+
+			/*
+			 * Only added once complete, a failure must not leave a partial strand for optimize
+			 */
+
+			NickOptimizer::Strand description((unsigned int) strand.size(), strand.circular);
+			description.sites = sites;
+			std::sort(description.sites.begin(), description.sites.end());
+
+			/*
+			 * A crossover is where the strand moves on to another helix
+			 */
+
+			Model::Helix previous;
+
+			for (Model::StrandIndex::Strand::iterator it(strand.begin()); it != strand.end(); ++it) {
+				Model::Helix helix(it->getParent(status));
+				HMEVALUATE_RETURN_DESCRIPTION("Base::getParent", status);
+
+				if (it != strand.begin() && helix != previous)
+					description.crossovers.push_back((unsigned int) (it - strand.begin()));
+
+				previous = helix;
+			}
+
+			if (strand.circular && strand.size() > 1) {
+				Model::Helix first(strand.front().getParent(status));
+				HMEVALUATE_RETURN_DESCRIPTION("Base::getParent", status);
+
+				if (previous != first)
+					description.crossovers.insert(description.crossovers.begin(), 0);
+			}
+
+			m_descriptions.push_back(description);
+			m_bases.push_back(strand.bases);
+
+			return MStatus::kSuccess;
+		}
+
+		void NickStrands::optimize(std::vector<Model::Base> & nickBases) {
+			std::vector<NickOptimizer::Result> results;
+			m_infeasible = m_optimizer.optimize(m_descriptions, results);
+
+			for (size_t i = 0; i < results.size(); ++i) {
+				for (std::vector<unsigned int>::const_iterator it(results[i].nicks.begin()); it != results[i].nicks.end(); ++it)
+					nickBases.push_back(m_bases[i][*it]);
+			}
+		}
+	}
+}
@@ -7,99 +7,315 @@
 
 #include <controller/OxDnaExporter.h>
 #include <model/Helix.h>
+#include <Compression.h>
+#include <ExportPipeline.h>
 #include <Utility.h>
 
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
+#include <locale>
+#include <sstream>
+
+#include <maya/MFnSet.h>
+#include <maya/MFnTransform.h>
+#include <maya/MMatrix.h>
+#include <maya/MPoint.h>
+#include <maya/MSelectionList.h>
+#include <maya/MTimer.h>
 
 namespace Helix {
 	namespace Controller {
 		MStatus OxDnaExporter::doExecute(Model::Strand & element) {
+			ExportPhaseTimer timer(m_statistics, ExportStatistics::kTraversal);
 			Strand outstrand;
 			MStatus status;
+			Model::StrandIndex::Strand *indexedStrand = NULL;
+			std::vector<MObjectHandle> bases;
 
-			// Iterate backwards along the strand to find the first base of the strand if not circular.
-			element.rewind();
-			Model::Base & base(element.getDefiningBase());
-			MDagPath baseDagPath;
-			HMEVALUATE_RETURN(baseDagPath = base.getDagPath(status), status);
-			HMEVALUATE_RETURN(outstrand.name = baseDagPath.fullPathName(&status), status);
 			/*
-			Model::Helix parent(base.getParent(status));
-			MEulerRotation parentRotation;
-			HMEVALUATE_RETURN(status = parent.getRotation(parentRotation), status);
-			MVector parentTranslation;
-			parent.getTranslation(parentTranslation, MSpace::kWorld);
-			const MVector normal((MVector(0, 0, 1) * parentRotation.asMatrix()).normal());
-			*/
+			 * Strands that haven't changed since the previous export are taken from the cache without touching the scene
+			 */
 
-			Model::Strand::ForwardIterator it = element.forward_begin();
-			int store_dir = 1;/*erik, janky solution to a crossover bug */
-			for(; it != element.forward_end(); ++it) {
+			if (m_incremental) {
+				HMEVALUATE_RETURN(status = Model::StrandIndex::Instance().find(element.getDefiningBase(), indexedStrand), status);
 
-				/*ERIK: this block was moved into the loop*/
-				Model::Helix parent(it->getParent(status));
-				MEulerRotation parentRotation;
-				HMEVALUATE_RETURN(status = parent.getRotation(parentRotation), status);
-				MVector parentTranslation;
-				parent.getTranslation(parentTranslation, MSpace::kWorld);
-				const MVector normal((MVector(0, 0, 1) * parentRotation.asMatrix()).normal());
-				/*END of moved block*/
+				const CachedStrand *cached = Cache().find(*indexedStrand);
 
+				if (cached && (cached->vhelix || !m_vhelix)) {
+					reuse(*cached);
+					++m_reused;
 
-				/*
-				Model::Helix parent(it->getParent(status));
-				*/
-				Base base;
-				HMEVALUATE_RETURN(status = it->getLabel(base.label), status);
+					return MStatus::kSuccess;
+				}
 
-				HMEVALUATE_RETURN(status = it->getTranslation(base.translation, MSpace::kWorld), status);
+				bases.reserve(indexedStrand->size());
+			}
 
-				MQuaternion rotation;
-				HMEVALUATE_RETURN(status = it->getRotation(rotation), status);
+			const Model::ChangeTracker::revision_t revision = Model::ChangeTracker::Instance().revision();
 
-				if (base.label == DNA::Invalid) {/*ERIK added this to make questionmarks into T's if complementary dna is not assigned it will fall appart*/
-					base.label = 'T';
-					/*const MString errorString(MString("The base ") + it->getDagPath(status).fullPathName() + " does not have an assigned label.");
-					MGlobal::displayError(errorString);
-					HPRINT("%s", errorString.asChar());
+			element.rewind();
+
+			Model::Strand::ForwardIterator it = element.forward_begin();
+			for (; it != element.forward_end(); ++it) {
+				MObject baseObject;
+				HMEVALUATE_RETURN(baseObject = it->getObject(status), status);
+
+				object_index_map_t::const_iterator base_it(m_baseIndices.find(MObjectHandle(baseObject)));
+
+				if (base_it == m_baseIndices.end()) {
+					// First time the strand passes through this helix, capture all of its bases.
+					Model::Helix parent(it->getParent(status));
+					HMEVALUATE_RETURN_DESCRIPTION("Base::getParent", status);
+
+					unsigned int helixIndex;
+					HMEVALUATE_RETURN(status = captureHelix(parent, helixIndex), status);
 
-					return MStatus::kInvalidParameter;*/
+					if ((base_it = m_baseIndices.find(MObjectHandle(baseObject))) == m_baseIndices.end()) {
+						MGlobal::displayError(MString("The base ") + it->getDagPath(status).fullPathName() + " is not a child of its helix.");
+						return MStatus::kFailure;
+					}
 				}
 
-				base.tangent = (normal ^ ((base.translation - parentTranslation) ^ normal)).normal();
+				const Strand::Member member = { base_it->second, 0 };
+				outstrand.strand.push_back(member);
 
-				int direction;
-				HMEVALUATE_RETURN(direction = it->sign_along_axis(MVector::zAxis, MSpace::kTransform, status), status);
+				if (m_incremental)
+					bases.push_back(MObjectHandle(baseObject));
+			}
+
+			outstrand.circular = it.loop();/*ERIK check it the last base is the same  as the first */
+
+			/*
+			 * The direction of a base is given by its neighbour along the strand, the same way as Base::sign_along_axis does
+			 */
+
+			const size_t numBases = outstrand.strand.size();
+			int store_dir = 1;/*erik, janky solution to a crossover bug */
+			for (size_t i = 0; i < numBases; ++i) {
+				const double axial = m_bases[outstrand.strand[i].base].axial;
+				int direction = 1;
+
+				if (i + 1 < numBases || (outstrand.circular && numBases > 1))
+					direction = sgn(m_bases[outstrand.strand[(i + 1) % numBases].base].axial - axial);
+				else if (i > 0)
+					direction = sgn(axial - m_bases[outstrand.strand[i - 1].base].axial);
 
 				if (direction == 0) {/* ERIK crappy solutiton to weird xover bug*/
 					direction = store_dir;
 				}
 
 				store_dir = direction; /*save the dircetion for later next round as it may need to be used again */
+				outstrand.strand[i].direction = direction;
+			}
 
-				base.normal = normal * direction; /* HERE IS THE PROBLEM*/
-				HMEVALUATE_RETURN(base.helixName = parent.getDagPath(status).fullPathName(), status);
-				HMEVALUATE_RETURN(base.name = it->getDagPath(status).partialPathName(), status);
-				Model::Material material;
-				HMEVALUATE_RETURN(status = it->getMaterial(material), status);
-				base.material = material.getMaterial();
-				outstrand.strand.push_back(base);
-
-				if (m_helices.find(base.helixName.asChar()) == m_helices.end()) {
-					Helix helix;
+			m_strands.push_back(outstrand);
 
-					HMEVALUATE_RETURN(status = parent.getTranslation(helix.translation, MSpace::kWorld), status);
+			if (m_incremental)
+				HMEVALUATE_RETURN(status = store(*indexedStrand, outstrand, bases, revision), status);
 
-					MEulerRotation rotation;
-					HMEVALUATE_RETURN(status = parent.getRotation(rotation), status);
-					helix.normal = MVector::zAxis * MTransformationMatrix().rotateTo(rotation).asMatrix();
+			return MStatus::kSuccess;
+		}
 
-					m_helices.insert(std::make_pair(base.helixName.asChar(), helix));
+		void OxDnaExporter::reuse(const CachedStrand & cached) {
+			/*
+			 * The helices are shared with the other strands of this export, but the bases are appended as they are. Helices only
+			 * taken from the cache still have their bases captured if a changed strand passes through them
+			 */
+
+			std::vector<unsigned int> helixIndices(cached.helices.size());
+
+			for (size_t i = 0; i < cached.helices.size(); ++i) {
+				object_index_map_t::const_iterator helix_it(m_helixIndices.find(cached.helices[i].object));
+
+				if (helix_it != m_helixIndices.end())
+					helixIndices[i] = helix_it->second;
+				else {
+					helixIndices[i] = (unsigned int) m_helices.size();
+					m_helices.push_back(cached.helices[i]);
+					m_helices.back().basesCaptured = false;
+					m_helixIndices.insert(std::make_pair(cached.helices[i].object, helixIndices[i]));
 				}
 			}
 
-			outstrand.circular = it.loop();/*ERIK check it the last base is the same  as the first */
+			const unsigned int offset = (unsigned int) m_bases.size();
+
+			for (std::vector<Base>::const_iterator it = cached.bases.begin(); it != cached.bases.end(); ++it) {
+				m_bases.push_back(*it);
+				m_bases.back().helix = helixIndices[it->helix];
+			}
+
+			Strand outstrand(cached.strand);
+
+			for (std::vector<Strand::Member>::iterator it = outstrand.strand.begin(); it != outstrand.strand.end(); ++it)
+				it->base += offset;
+
 			m_strands.push_back(outstrand);
+		}
+
+		MStatus OxDnaExporter::store(Model::StrandIndex::Strand & strand, const Strand & outstrand, const std::vector<MObjectHandle> & bases, Model::ChangeTracker::revision_t revision) const {
+			CachedStrand cached;
+			std::vector<unsigned int> helices; // Indices of the helices of this export, in the order they're stored.
+			cached.strand.circular = outstrand.circular;
+			cached.strand.strand.reserve(outstrand.strand.size());
+			cached.bases.reserve(outstrand.strand.size());
+			cached.vhelix = m_vhelix;
+
+			for (std::vector<Strand::Member>::const_iterator it = outstrand.strand.begin(); it != outstrand.strand.end(); ++it) {
+				Base base(m_bases[it->base]);
+				const std::vector<unsigned int>::iterator helix_it = std::find(helices.begin(), helices.end(), base.helix);
+
+				if (helix_it == helices.end()) {
+					helices.push_back(base.helix);
+					cached.helices.push_back(m_helices[base.helix]);
+					base.helix = (unsigned int) cached.helices.size() - 1;
+				}
+				else
+					base.helix = (unsigned int) (helix_it - helices.begin());
+
+				const Strand::Member member = { (unsigned int) cached.bases.size(), it->direction };
+				cached.strand.strand.push_back(member);
+				cached.bases.push_back(base);
+			}
+
+			return Cache().insert(strand, bases, cached, revision);
+		}
+
+		Model::StrandCache<OxDnaExporter::CachedStrand> & OxDnaExporter::Cache() {
+			static Model::StrandCache<CachedStrand> cache;
+			return cache;
+		}
+
+		MStatus OxDnaExporter::captureHelix(Model::Helix & helix, unsigned int & index) {
+			ExportPhaseTimer timer(m_statistics, ExportStatistics::kCapture);
+			MStatus status;
+			MObject helixObject;
+			HMEVALUATE_RETURN(helixObject = helix.getObject(status), status);
+
+			object_index_map_t::const_iterator helix_it(m_helixIndices.find(MObjectHandle(helixObject)));
+
+			if (helix_it != m_helixIndices.end() && m_helices[helix_it->second].basesCaptured) {
+				index = helix_it->second;
+				return MStatus::kSuccess;
+			}
+
+			MDagPath helixDagPath;
+			HMEVALUATE_RETURN(helixDagPath = helix.getDagPath(status), status);
+
+			MFnTransform helixTransform(helixDagPath);
+			Helix outhelix;
+			HMEVALUATE_RETURN(outhelix.translation = helixTransform.getTranslation(MSpace::kWorld, &status), status);
+
+			MEulerRotation rotation;
+			HMEVALUATE_RETURN(status = helixTransform.getRotation(rotation), status);
+			outhelix.normal = (MVector(0, 0, 1) * rotation.asMatrix()).normal();
+			outhelix.axis = MVector::zAxis * MTransformationMatrix().rotateTo(rotation).asMatrix();
+
+			MMatrix matrix;
+			HMEVALUATE_RETURN(matrix = helixDagPath.inclusiveMatrix(&status), status);
+
+			if (m_vhelix) {
+				HMEVALUATE_RETURN(outhelix.name = helixDagPath.fullPathName(&status).asChar(), status);
+				HMEVALUATE_RETURN(status = captureMaterials(), status);
+			}
+
+			outhelix.object = MObjectHandle(helixObject);
+			outhelix.basesCaptured = true;
+
+			if (helix_it != m_helixIndices.end()) {
+				// Only taken from the cache so far.
+				index = helix_it->second;
+				m_helices[index] = outhelix;
+			}
+			else {
+				index = (unsigned int) m_helices.size();
+				m_helices.push_back(outhelix);
+				m_helixIndices.insert(std::make_pair(MObjectHandle(helixObject), index));
+			}
+
+			for (Model::Helix::BaseIterator it = helix.begin(); it != helix.end(); ++it) {
+				Base base;
+				MObject baseObject;
+				HMEVALUATE_RETURN(baseObject = it->getObject(status), status);
+				HMEVALUATE_RETURN(status = it->getLabel(base.label), status);
+
+				if (base.label == DNA::Invalid) /*ERIK added this to make questionmarks into T's if complementary dna is not assigned it will fall appart*/
+					base.label = 'T';
+
+				MFnTransform baseTransform(baseObject);
+				MVector translation;
+				HMEVALUATE_RETURN(translation = baseTransform.getTranslation(MSpace::kTransform, &status), status);
+
+				base.axial = translation.z;
+				base.translation = MPoint(translation) * matrix;
+				base.tangent = (outhelix.normal ^ ((base.translation - outhelix.translation) ^ outhelix.normal)).normal();
+				base.helix = index;
+
+				if (m_vhelix) {
+					MDagPath baseDagPath(helixDagPath);
+					HMEVALUATE_RETURN(status = baseDagPath.push(baseObject), status);
+					HMEVALUATE_RETURN(base.name = baseDagPath.partialPathName(&status).asChar(), status);
+
+					object_index_map_t::const_iterator material_it(m_baseMaterials.find(MObjectHandle(baseObject)));
+
+					if (material_it != m_baseMaterials.end())
+						base.material = m_materials[material_it->second].getMaterial().asChar();
+				}
+
+				m_baseIndices.insert(std::make_pair(MObjectHandle(baseObject), (unsigned int) m_bases.size()));
+				m_bases.push_back(base);
+			}
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus OxDnaExporter::captureMaterials() {
+			if (m_materialsCaptured)
+				return MStatus::kSuccess;
+
+			m_materialsCaptured = true;
+
+			ExportPhaseTimer timer(m_statistics, ExportStatistics::kMaterials);
+
+			/*
+			 * Instead of asking for the sets of every base like Base::getMaterial does, list the members of every material once
+			 */
+
+			MStatus status;
+			Model::Material::Iterator materials_begin;
+			HMEVALUATE_RETURN(materials_begin = Model::Material::AllMaterials_begin(status), status);
+
+			for (Model::Material::Iterator it = materials_begin; it != Model::Material::AllMaterials_end(); ++it) {
+				MSelectionList setList;
+				MObject setObject;
+
+				if (!setList.add(it->getMaterial()) || !setList.getDependNode(0, setObject))
+					continue;
+
+				MFnSet set(setObject, &status);
+
+				if (!status)
+					continue;
+
+				MSelectionList members;
+				HMEVALUATE_RETURN(status = set.getMembers(members, false), status);
+
+				const unsigned int index = (unsigned int) m_materials.size();
+				m_materials.push_back(*it);
+
+				for (unsigned int i = 0; i < members.length(); ++i) {
+					MDagPath memberDagPath;
+
+					if (!members.getDagPath(i, memberDagPath))
+						continue;
+
+					// The members are the shapes of the bases. If a base is in several materials, the first one is used like Base::getMaterial.
+					if (!memberDagPath.hasFn(MFn::kTransform))
+						memberDagPath.pop();
+
+					m_baseMaterials.insert(std::make_pair(MObjectHandle(memberDagPath.node()), index));
+				}
+			}
 
 			return MStatus::kSuccess;
 		}
@@ -112,86 +328,396 @@ namespace Helix {
 			return MStatus::kSuccess;
 		}
 
+		OxDnaExporter::OxDnaExporter() : m_format(TextWriter::kDefault), m_precision(6), m_reused(0), m_statistics(NULL), m_vhelix(true), m_materialsCaptured(false), m_incremental(true) {
+
+		}
+
+		class OxDnaExporter::StrandFormatter {
+		public:
+			enum File {
+				kTopology,
+				kConfiguration,
+				kVhelix
+			};
+
+			inline StrandFormatter(const OxDnaExporter & exporter) : m_exporter(exporter), m_numBases(0), m_file(kTopology) {
+				int offset = 0;
+
+				m_strands.reserve(exporter.m_strands.size());
+				m_offsets.reserve(exporter.m_strands.size());
+
+				for (std::list<Strand>::const_iterator it = exporter.m_strands.begin(); it != exporter.m_strands.end(); ++it) {
+					m_strands.push_back(&*it);
+					m_offsets.push_back(offset);
+					offset += int(it->strand.size());
+				}
+
+				m_numBases = size_t(offset);
+			}
+
+			inline size_t size() const {
+				return m_strands.size();
+			}
+
+			inline size_t numBases() const {
+				return m_numBases;
+			}
+
+			inline void setFile(File file) {
+				m_file = file;
+			}
+
+			void operator() (size_t index, TextWriter & output) const {
+				const Strand & strand(*m_strands[index]);
+				const int offset = m_offsets[index], size = int(strand.strand.size());
+				int k = 0;
+
+				switch (m_file) {
+				case kTopology:
+					{
+						const int firstIndex = strand.circular ? size - 1 + offset : -1;
+						const int lastIndex = strand.circular ? offset : -1;
+
+						for (std::vector<Strand::Member>::const_reverse_iterator it = strand.strand.rbegin(); it != strand.strand.rend(); ++it, ++k) {
+							const int j = offset + k;
+
+							output << int(index) + 1 << ' ' << m_exporter.m_bases[it->base].label.toChar() << ' ' <<
+								(k == 0 ? firstIndex : j - 1) << ' ' <</* ERIK: I flipped the order to the print out to correct it */
+								(k == size - 1 ? lastIndex : j + 1) << '\n';
+						}
+					}
+					break;
+				case kConfiguration:
+					for (std::vector<Strand::Member>::const_reverse_iterator it = strand.strand.rbegin(); it != strand.strand.rend(); ++it) {
+						const Base & base(m_exporter.m_bases[it->base]);
+						const MVector & translation(base.translation), & normal(m_exporter.m_helices[base.helix].normal);
+						const double direction = it->direction;
+
+						output << (translation.x + base.tangent.x * -0.35) * 1.174 << ' ' << (translation.y + base.tangent.y * -0.35) * 1.174 << ' ' << (translation.z + base.tangent.z * -0.35) * 1.174 << ' ' << /* ERIK I multiply with * 1.174  to change fron nm to oxDNA lenght units  i nudge it with the tangent vector to move from phosphate position to center of mass */
+							base.tangent.x * -1.0 << ' ' << base.tangent.y * -1.0 << ' ' << base.tangent.z * -1.0 << ' ' <</*ERIK, i added minuses to the tangent vectors to flip them*/
+							normal.x * direction * -1.0 << ' ' << normal.y * direction * -1.0 << ' ' << normal.z * direction * -1.0 <<
+							" 0.0 0.0 0.0 0.0 0.0 0.0\n";
+					}
+					break;
+				case kVhelix:
+					for (std::vector<Strand::Member>::const_reverse_iterator it = strand.strand.rbegin(); it != strand.strand.rend(); ++it, ++k) {
+						const Base & base(m_exporter.m_bases[it->base]);
+						output << "base " << (unsigned int) (offset + k) << ' ' << base.name << ' ' << m_exporter.m_helices[base.helix].name << ' ' << base.material << '\n';
+					}
+					break;
+				}
+			}
+
+		private:
+			const OxDnaExporter & m_exporter;
+			std::vector<const Strand *> m_strands;
+			std::vector<int> m_offsets; // Index of the first base of every strand.
+			size_t m_numBases;
+			File m_file;
+		};
+
 		MStatus OxDnaExporter::write(const char *topology_filename, const char *configuration_filename, const char *vhelix_filename, const MVector & minTranslation, const MVector & maxTranslation) const {
+			const char *filenames[] = { topology_filename, configuration_filename, vhelix_filename };
 
-			std::ofstream conf_file(configuration_filename);
-			std::ofstream top_file(topology_filename);
-			std::ofstream vhelix_file(vhelix_filename);
+			for (int i = 0; i < (m_vhelix ? 3 : 2); ++i) {
+				const Compression::Format compression = Compression::FromFilename(filenames[i]);
 
-			if (!conf_file) {
+				if (!Compression::IsSupported(compression)) {
+					MGlobal::displayError(MString("vHelix was built without ") + Compression::Name(compression) + " support, can't write \"" + filenames[i] + "\".");
+					return MStatus::kFailure;
+				}
+			}
+
+			TextWriter conf_file(m_format, m_precision), top_file, vhelix_file(m_format, m_precision);
+
+			if (!conf_file.open(configuration_filename)) {
 				MGlobal::displayError(MString("Can't open file \"") + configuration_filename + "\" for writing.");
 				return MStatus::kFailure;
 			}
 
-			if (!top_file) {
+			if (!top_file.open(topology_filename)) {
 				MGlobal::displayError(MString("Can't open file \"") + topology_filename + "\" for writing.");
 				return MStatus::kFailure;
 			}
 
-			if (!vhelix_file) {
+			if (m_vhelix && !vhelix_file.open(vhelix_filename)) {
 				MGlobal::displayError(MString("Can't open file \"") + vhelix_filename + "\" for writing.");
 				return MStatus::kFailure;
 			}
 
-			size_t numBases = 0;
-			for (std::list<Strand>::const_iterator it = m_strands.begin(); it != m_strands.end(); ++it) {
-				numBases += it->strand.size();
+			/*
+			 * Everything was captured by doExecute, the strands are formatted in parallel by the export pipeline
+			 */
+
+			ExportPhaseTimer timer(m_statistics, ExportStatistics::kFormat);
+			StrandFormatter formatter(*this);
+
+			top_file << formatter.numBases() << ' ' << m_strands.size() << '\n';
+
+			formatter.setFile(StrandFormatter::kTopology);
+			ParallelFormat(top_file, formatter.size(), formatter);
+
+			const MVector dimensions(maxTranslation - minTranslation);/* i changed this to make the box big enough*/
+
+			double largest_side = std::max(dimensions.x, std::max(dimensions.y, dimensions.z)); /*Erik, square boxes are easier to work with, figure out what side is largest  */
+
+			conf_file << "t = 0\nb = " << largest_side * 2.0 << ' ' << largest_side * 2.0 << ' ' << largest_side * 2.0 << "\nE = 0. 0. 0.\n"; /* ERIK, i added a 2x multiplier to box dimensions*/
+
+			formatter.setFile(StrandFormatter::kConfiguration);
+			ParallelFormat(conf_file, formatter.size(), formatter);
+
+			if (m_vhelix) {
+				const std::string date(Date());
+				vhelix_file << "# vHelix glue file for oxDNA export \"" << topology_filename << "\" and \"" << configuration_filename << "\".\n# " << date << "\n\n";
+
+				for (std::vector<Helix>::const_iterator it = m_helices.begin(); it != m_helices.end(); ++it) {
+					const MVector & translation(it->translation);
+
+					vhelix_file << "helix " << it->name << ' ' <<
+							translation.x << ' ' << translation.y << ' ' << translation.z << ' ' <<
+							it->axis.x << ' ' << it->axis.y << ' ' << it->axis.z << '\n';
+				}
+
+				vhelix_file << '\n';
+
+				formatter.setFile(StrandFormatter::kVhelix);
+				ParallelFormat(vhelix_file, formatter.size(), formatter);
 			}
 
-			top_file << numBases << " " << m_strands.size() << std::endl;
+			if (!top_file.close() || !conf_file.close() || !vhelix_file.close()) {
+				MGlobal::displayError(MString("Failed to write the oxDNA files \"") + topology_filename + "\" and \"" + configuration_filename + "\".");
+				return MStatus::kFailure;
+			}
 
-			unsigned int i = 1;
-			int j = 0;
-			//
-			//for (std::list<Strand>::const_iterator it = m_strands.begin(); it != m_strands.end(); ++it, ++i) {
-			//	const int firstIndex = it->circular ? int(it->strand.size()) - 1 : -1;
-			//	const int lastIndex = it->circular ? 0 : -1;
+			if (m_statistics) {
+				m_statistics->addFile(top_file, ExportStatistics::kFormat);
+				m_statistics->addFile(conf_file, ExportStatistics::kFormat);
+				m_statistics->addFile(vhelix_file, ExportStatistics::kFormat);
 
-			//	/*top_file << "# " << it->name.asChar() << std::endl;*/   /* ERIK, i removed this to make the exports work with */
+				m_statistics->helices = m_helices.size();
+				m_statistics->strands = m_strands.size();
+				m_statistics->bases = formatter.numBases();
+				m_statistics->reused = m_reused;
+			}
 
-			//	int k = 0;
-			//	for (std::vector<Base>::const_iterator lit = it->strand.begin(); lit != it->strand.end(); ++lit, ++j, ++k)
-			//		top_file << i << " " << lit->label.toChar() << " " <<
-			//					(k == 0 ? firstIndex : j - 1) << " " <</* ERIK: I flipped the order to the print out to correct it */
-			//					(k == int(it->strand.size()) - 1 ? lastIndex : j + 1) << std::endl;
+			// Strands that were merged or split since they were cached would never be found again.
+			if (m_incremental)
+				Cache().prune();
 
-			//	/*top_file << std::endl;*/
-			//}
+			return MStatus::kSuccess;
+		}
 
-			//top_file.close();
+		/*
+		 * Reads both files entirely, decompressing them if needed, and compares them
+		 */
 
-			//
+		static bool FilesEqual(const char *first, const char *second) {
+			std::vector<char> first_contents, second_contents;
 
-			//const MVector dimensions(maxTranslation - minTranslation);/* i changed this to make the box big enough*/
+			return Compression::ReadFile(first, first_contents) && Compression::ReadFile(second, second_contents) && first_contents == second_contents;
+		}
 
-			//double largest_side = std::max(dimensions.x, std::max(dimensions.y,dimensions.z)); /*Erik, square boxes are easier to work with, figure out what side is largest  */
-			//
-			////conf_file << "t = 0" << std::endl << "b = " << dimensions.x * 2.0 << " " << dimensions.y * 2.0 << " " << dimensions.z * 2.0 << std::endl << "E = 0. 0. 0." << std::endl; /* ERIK, i added a 2x multiplier to box dimensions*/
-			//conf_file << "t = 0" << std::endl << "b = " << largest_side * 2.0 << " " << largest_side * 2.0 << " " << largest_side * 2.0 << std::endl << "E = 0. 0. 0." << std::endl; /* ERIK, i added a 2x multiplier to box dimensions*/
+		static unsigned long long FileSize(const char *filename) {
+			std::ifstream file(filename, std::ios::binary | std::ios::ate);
 
-			//for (std::list<Strand>::const_iterator it = m_strands.begin(); it != m_strands.end(); ++it, ++i) {
-			//	for (std::vector<Base>::const_iterator sit = it->strand.begin(); sit != it->strand.end(); ++sit) {
-			//		const MVector translation(sit->translation/* - minTranslation*/);
-			//		
+			return file ? (unsigned long long) file.tellg() : 0;
+		}
+
+		/*
+		 * The filename without any .gz or .zst suffix
+		 */
+
+		static std::string StripCompressionSuffix(const char *filename) {
+			const std::string str(filename);
+			const Compression::Format compression = Compression::FromFilename(filename);
+
+			return str.substr(0, str.size() - (compression == Compression::kGzip ? 3 : (compression == Compression::kZstd ? 4 : 0)));
+		}
+
+		MStatus OxDnaExporter::benchmark(const char *topology_filename, const char *configuration_filename, const char *vhelix_filename, const MVector & minTranslation, const MVector & maxTranslation, unsigned int iterations, double & writerSeconds, double & streamSeconds) const {
+			MStatus status;
+			const std::string filenames[] = { topology_filename, configuration_filename, vhelix_filename };
+			std::string stream_filenames[3];
 
-			//		conf_file << (translation.x + sit->tangent.x * -0.35) * 1.174 << " " << (translation.y + sit->tangent.y * -0.35) * 1.174 << " " << (translation.z + sit->tangent.z * -0.35) * 1.174 << " " << /* ERIK I multiply with * 1.174  to change fron nm to oxDNA lenght units  i nudge it with the tangent vector to move from phosphate position to center of mass */
-			//				sit->tangent.x * -1.0 << " " << sit->tangent.y * -1.0 << " " << sit->tangent.z * -1.0 << " " <</*ERIK, i added minuses to the tangent vectors to flip them*/
-			//				sit->normal.x << " " << sit->normal.y << " " << sit->normal.z <<
-			//				" 0.0 0.0 0.0 0.0 0.0 0.0" << std::endl;
-			//	}
-			//}
+			for (int i = 0; i < 3; ++i)
+				stream_filenames[i] = filenames[i] + ".benchmark";
 
-			//conf_file.close();
+			MTimer timer;
+			writerSeconds = streamSeconds = 0.0;
+
+			for (unsigned int i = 0; i < iterations; ++i) {
+				timer.beginTimer();
+				HMEVALUATE_RETURN(status = write(topology_filename, configuration_filename, vhelix_filename, minTranslation, maxTranslation), status);
+				timer.endTimer();
+				writerSeconds += timer.elapsedTime();
+
+				timer.beginTimer();
+				HMEVALUATE_RETURN(status = writeStream(stream_filenames[0].c_str(), stream_filenames[1].c_str(), stream_filenames[2].c_str(), minTranslation, maxTranslation), status);
+				timer.endTimer();
+				streamSeconds += timer.elapsedTime();
+			}
+
+			bool equal = true;
+
+			// The vhelix file contains the filenames in its header, which differ.
+			for (int i = 0; i < 2; ++i) {
+				if (!FilesEqual(filenames[i].c_str(), stream_filenames[i].c_str())) {
+					MGlobal::displayError(MString("The file \"") + filenames[i].c_str() + "\" differs from the one written with iostreams \"" + stream_filenames[i].c_str() + "\".");
+					equal = false;
+				}
+			}
+
+			if (equal) {
+				for (int i = 0; i < 3; ++i)
+					std::remove(stream_filenames[i].c_str());
+			}
+
+			return equal ? MStatus::kSuccess : MStatus::kFailure;
+		}
+
+		MStatus OxDnaExporter::benchmarkCompression(const char *topology_filename, const char *configuration_filename, const char *vhelix_filename, const MVector & minTranslation, const MVector & maxTranslation, unsigned int iterations) const {
+			MStatus status;
+			const char *filenames[] = { topology_filename, configuration_filename, vhelix_filename };
+			const Compression::Format formats[] = { Compression::kNone, Compression::kGzip, Compression::kZstd };
+			const char *suffixes[] = { "", ".gz", ".zst" };
+			const Compression::Format requested = Compression::FromFilename(configuration_filename);
+			unsigned long long uncompressedBytes = 0;
+
+			for (int i = 0; i < 3; ++i) {
+				if (!Compression::IsSupported(formats[i])) {
+					MGlobal::displayInfo(MString(Compression::Name(formats[i])) + ": not supported by this build");
+					continue;
+				}
+
+				std::string variants[3];
+
+				for (int j = 0; j < 3; ++j)
+					variants[j] = StripCompressionSuffix(filenames[j]) + suffixes[i];
+
+				MTimer timer;
+				timer.beginTimer();
+
+				for (unsigned int j = 0; j < iterations; ++j)
+					HMEVALUATE_RETURN(status = write(variants[0].c_str(), variants[1].c_str(), variants[2].c_str(), minTranslation, maxTranslation), status);
+
+				timer.endTimer();
+
+				unsigned long long bytes = 0;
+
+				for (int j = 0; j < 3; ++j) {
+					bytes += FileSize(variants[j].c_str());
+
+					if (formats[i] != requested)
+						std::remove(variants[j].c_str());
+				}
+
+				if (formats[i] == Compression::kNone)
+					uncompressedBytes = bytes;
+
+				MGlobal::displayInfo(MString(Compression::Name(formats[i])) + ": " + (timer.elapsedTime() / std::max(iterations, 1u)) + " s per export, " +
+						double(bytes) + " bytes (" + (uncompressedBytes > 0 ? 100.0 * double(bytes) / double(uncompressedBytes) : 100.0) + " % of uncompressed)");
+			}
+
+			return MStatus::kSuccess;
+		}
+
+		/*
+		 * The iostream counterpart of TextWriter::kShortest: 15, 16 or 17 significant digits, the first that reads back as the same double
+		 */
+
+		class ShortestNumPut : public std::num_put<char> {
+		protected:
+			virtual iter_type do_put(iter_type out, std::ios_base &, char_type, double value) const {
+				std::ostringstream printed;
+
+				if (value == 0.0 || !(value - value == 0.0)) { // zero, inf and nan.
+					printed.precision(1);
+					printed << value;
+				}
+				else {
+					for (int digits = 15; digits <= 17; ++digits) {
+						printed.str(std::string());
+						printed.precision(digits);
+						printed << value;
+
+						std::istringstream parser(printed.str());
+						double parsed;
+
+						if (parser >> parsed && parsed == value)
+							break;
+					}
+				}
+
+				const std::string result(printed.str());
+				return std::copy(result.begin(), result.end(), out);
+			}
+		};
+
+		/*
+		 * Make stream format doubles the same way as a TextWriter with the given format
+		 */
+
+		static void SetStreamFormat(std::ostream & stream, TextWriter::Format format, int precision) {
+			switch (format) {
+			case TextWriter::kShortest:
+				stream.imbue(std::locale(stream.getloc(), new ShortestNumPut()));
+				break;
+			case TextWriter::kFixed:
+				stream.setf(std::ios::fixed, std::ios::floatfield);
+				stream.precision(precision);
+				break;
+			default:
+				stream.precision(precision);
+				break;
+			}
+		}
+
+		MStatus OxDnaExporter::writeStream(const char *topology_filename, const char *configuration_filename, const char *vhelix_filename, const MVector & minTranslation, const MVector & maxTranslation) const {
+
+			std::ofstream conf_file(configuration_filename);
+			std::ofstream top_file(topology_filename);
+			std::ofstream vhelix_file;
+
+			if (m_vhelix)
+				vhelix_file.open(vhelix_filename);
+
+			if (!conf_file) {
+				MGlobal::displayError(MString("Can't open file \"") + configuration_filename + "\" for writing.");
+				return MStatus::kFailure;
+			}
+
+			if (!top_file) {
+				MGlobal::displayError(MString("Can't open file \"") + topology_filename + "\" for writing.");
+				return MStatus::kFailure;
+			}
+
+			if (m_vhelix && !vhelix_file) {
+				MGlobal::displayError(MString("Can't open file \"") + vhelix_filename + "\" for writing.");
+				return MStatus::kFailure;
+			}
+
+			SetStreamFormat(conf_file, m_format, m_precision);
+			SetStreamFormat(vhelix_file, m_format, m_precision);
+
+			size_t numBases = 0;
+			for (std::list<Strand>::const_iterator it = m_strands.begin(); it != m_strands.end(); ++it) {
+				numBases += it->strand.size();
+			}
+
+			top_file << numBases << " " << m_strands.size() << std::endl;
+
+			unsigned int i = 1;
+			int j = 0;
 			int nt_counter = 0; /*Erik i added this to keep track of indices in circular strands */
 			for (std::list<Strand>::const_iterator it = m_strands.begin(); it != m_strands.end(); ++it, ++i) {
 				const int firstIndex = it->circular ? int(it->strand.size()) - 1 + nt_counter : -1;
 				const int lastIndex = it->circular ? (0 + nt_counter) : -1;
 
-				/*top_file << "# " << it->name.asChar() << std::endl;*/   /* ERIK, i removed this to make the exports work with */
+				/*top_file << "# " << it->name << std::endl;*/   /* ERIK, i removed this to make the exports work with */
 
 				int k = 0;
-				for (std::vector<Base>::const_reverse_iterator lit = it->strand.rbegin(); lit != it->strand.rend(); ++lit, ++j, ++k,nt_counter++)
-					top_file << i << " " << lit->label.toChar() << " " <<
+				for (std::vector<Strand::Member>::const_reverse_iterator lit = it->strand.rbegin(); lit != it->strand.rend(); ++lit, ++j, ++k,nt_counter++)
+					top_file << i << " " << m_bases[lit->base].label.toChar() << " " <<
 					(k == 0 ? firstIndex : j - 1) << " " <</* ERIK: I flipped the order to the print out to correct it */
 					(k == int(it->strand.size()) - 1 ? lastIndex : j + 1) << std::endl;
 
@@ -210,37 +736,42 @@ namespace Helix {
 			conf_file << "t = 0" << std::endl << "b = " << largest_side * 2.0 << " " << largest_side * 2.0 << " " << largest_side * 2.0 << std::endl << "E = 0. 0. 0." << std::endl; /* ERIK, i added a 2x multiplier to box dimensions*/
 
 			for (std::list<Strand>::const_iterator it = m_strands.begin(); it != m_strands.end(); ++it, ++i) {
-				for (std::vector<Base>::const_reverse_iterator sit = it->strand.rbegin(); sit != it->strand.rend(); ++sit) {
-					const MVector translation(sit->translation/* - minTranslation*/);
-
-
-					conf_file << (translation.x + sit->tangent.x * -0.35) * 1.174 << " " << (translation.y + sit->tangent.y * -0.35) * 1.174 << " " << (translation.z + sit->tangent.z * -0.35) * 1.174 << " " << /* ERIK I multiply with * 1.174  to change fron nm to oxDNA lenght units  i nudge it with the tangent vector to move from phosphate position to center of mass */
-						sit->tangent.x * -1.0 << " " << sit->tangent.y * -1.0 << " " << sit->tangent.z * -1.0 << " " <</*ERIK, i added minuses to the tangent vectors to flip them*/
-						sit->normal.x * -1.0 << " " << sit->normal.y * -1.0 << " " << sit->normal.z * -1.0<<
+				for (std::vector<Strand::Member>::const_reverse_iterator sit = it->strand.rbegin(); sit != it->strand.rend(); ++sit) {
+					const Base & base(m_bases[sit->base]);
+					const MVector translation(base.translation/* - minTranslation*/);
+					const MVector normal(m_helices[base.helix].normal * sit->direction);
+
+					conf_file << (translation.x + base.tangent.x * -0.35) * 1.174 << " " << (translation.y + base.tangent.y * -0.35) * 1.174 << " " << (translation.z + base.tangent.z * -0.35) * 1.174 << " " << /* ERIK I multiply with * 1.174  to change fron nm to oxDNA lenght units  i nudge it with the tangent vector to move from phosphate position to center of mass */
+						base.tangent.x * -1.0 << " " << base.tangent.y * -1.0 << " " << base.tangent.z * -1.0 << " " <</*ERIK, i added minuses to the tangent vectors to flip them*/
+						normal.x * -1.0 << " " << normal.y * -1.0 << " " << normal.z * -1.0<<
 						" 0.0 0.0 0.0 0.0 0.0 0.0" << std::endl;
 				}
 			}
 
 			conf_file.close();
 
+			if (!m_vhelix)
+				return MStatus::kSuccess;
+
 			const std::string date(Date());
 			vhelix_file << "# vHelix glue file for oxDNA export \"" << topology_filename << "\" and \"" << configuration_filename << "\"." << std::endl <<
 					"# " << date.c_str() << std::endl << std::endl;
 
-			for (std::tr1::unordered_map<std::string, Helix>::const_iterator it = m_helices.begin(); it != m_helices.end(); ++it) {
-				const MVector translation(it->second.translation/* - minTranslation*/);
+			for (std::vector<Helix>::const_iterator it = m_helices.begin(); it != m_helices.end(); ++it) {
+				const MVector translation(it->translation/* - minTranslation*/);
 
-				vhelix_file << "helix " << it->first.c_str() << " " <<
+				vhelix_file << "helix " << it->name << " " <<
 						translation.x << " " << translation.y << " " << translation.z << " " <<
-						it->second.normal.x << " " << it->second.normal.y << " " << it->second.normal.z << std::endl;
+						it->axis.x << " " << it->axis.y << " " << it->axis.z << std::endl;
 			}
 
 			vhelix_file << std::endl;
 
 			unsigned int index = 0;
 			for (std::list<Strand>::const_iterator it = m_strands.begin(); it != m_strands.end(); ++it, ++i) {
-				for (std::vector<Base>::const_reverse_iterator bit = it->strand.rbegin(); bit != it->strand.rend(); ++bit) {
-					vhelix_file << "base " << index++ << " " << bit->name << " " << bit->helixName << " " << bit->material.asChar() << std::endl;
+				for (std::vector<Strand::Member>::const_reverse_iterator bit = it->strand.rbegin(); bit != it->strand.rend(); ++bit) {
+					const Base & base(m_bases[bit->base]);
+					vhelix_file << "base " << index++ << " " << base.name << " " << m_helices[base.helix].name << " " << base.material << std::endl;
 				}
 			}
 
@@ -6,12 +6,16 @@
  */
 
 #include <controller/OxDnaImporter.h>
+#include <controller/OxDnaTrajectory.h>
+#include <model/Material.h>
+#include <Compression.h>
+#include <Tokenizer.h>
 #include <Utility.h>
 
-#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <sstream>
 #include <string>
-#include <cstdio>
-#include <map>
 
 #if defined(WIN32) || defined(WIN64)
 #include <unordered_map>
@@ -25,181 +29,289 @@
 namespace Helix {
 	namespace Controller {
 		MStatus OxDnaImporter::read(const char *topology_filename, const char *configuration_filename, const char *vhelix_filename) {
-			std::ifstream topology_file(topology_filename);
-			std::ifstream configuration_file(configuration_filename);
-			std::ifstream vhelix_file(vhelix_filename);
+			MStatus status;
+			Plan plan;
+
+			HMEVALUATE_RETURN(status = CreatePlan(topology_filename, configuration_filename, vhelix_filename, plan), status);
+			HMEVALUATE_RETURN(status = build(plan), status);
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus OxDnaImporter::CreatePlan(const char *topology_filename, const char *configuration_filename, const char *vhelix_filename, Plan & plan) {
+			MStatus status;
+
+			HMEVALUATE_RETURN(status = ReadTopology(topology_filename, plan), status);
+			HMEVALUATE_RETURN(status = ReadConfiguration(configuration_filename, plan), status);
+			HMEVALUATE_RETURN(status = ReadVHelix(vhelix_filename, plan), status);
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus OxDnaImporter::DryRun(const char *topology_filename, const char *configuration_filename, const char *vhelix_filename, ImportStatistics & statistics) {
+			MStatus status;
+			Plan plan;
+
+			HMEVALUATE_RETURN(status = CreatePlan(topology_filename, configuration_filename, vhelix_filename, plan), status);
+
+			statistics.helices = plan.helices.size();
+			statistics.bases = plan.bases.size();
+			statistics.strands = plan.strandOffsets.size();
+
+			for (size_t i = 0; i < plan.bases.size(); ++i) {
+				const Plan::Base & base = plan.bases[i];
+				const int neighbours[] = { base.forward, base.backward };
+
+				for (int j = 0; j < 2; ++j) {
+					if (neighbours[j] != -1 && (neighbours[j] < 0 || size_t(neighbours[j]) >= plan.bases.size())) {
+						std::ostringstream description;
+						description << "base " << i << " is connected to base " << neighbours[j] << " which does not exist";
+						statistics.addDangling(description.str());
+					}
+				}
+
+				if (!base.helixName.empty() && base.helix == -1) {
+					std::ostringstream description;
+					description << "base " << i << " belongs to helix \"" << base.helixName << "\" which does not exist";
+					statistics.addDangling(description.str());
+				}
 
-			if (!topology_file) {
-				MGlobal::displayError(MString("Unable to open file \"") + topology_filename + "\" for reading.");
+				if (base.forward >= 0 && size_t(base.forward) < plan.bases.size() && base.helix != plan.bases[base.forward].helix)
+					++statistics.crossovers;
+			}
+
+			if (plan.configurations != plan.bases.size()) {
+				std::ostringstream description;
+				description << plan.bases.size() << " bases in the topology but " << plan.configurations << " in the configuration";
+				statistics.addDangling(description.str());
+			}
+
+			return MStatus::kSuccess;
+		}
+
+		/*
+		 * Returns the next line of the buffer, advancing it
+		 */
+
+		static inline bool NextLine(const char * & it, const char *end, const char * & line_begin, const char * & line_end) {
+			if (it >= end)
+				return false;
+
+			const char *newline = static_cast<const char *>(memchr(it, '\n', size_t(end - it)));
+
+			line_begin = it;
+			line_end = newline ? newline : end;
+			it = line_end + 1;
+
+			return true;
+		}
+
+		MStatus OxDnaImporter::ReadTopology(const char *filename, Plan & plan) {
+			// The file is decompressed transparently if it's compressed.
+			std::vector<char> buffer;
+
+			if (!Compression::ReadFile(filename, buffer)) {
+				MGlobal::displayError(MString("Unable to open file \"") + filename + "\" for reading.");
 				return MStatus::kFailure;
 			}
 
-			if (!configuration_file) {
-				MGlobal::displayError(MString("Unable to open file \"") + configuration_filename + "\" for reading.");
+			const char *it = buffer.empty() ? NULL : &buffer[0], *end = it + buffer.size(), *line_begin, *line_end;
+			Tokenizer tokenizer;
+			unsigned int numBases, numStrands;
+
+			if (!NextLine(it, end, line_begin, line_end) || tokenizer.tokenize(line_begin, line_end) < 2 || !tokenizer.toUnsigned(0, numBases) || !tokenizer.toUnsigned(1, numStrands)) {
+				HPRINT("Error when parsing file \"%s\", expected the number of bases and strands", filename);
 				return MStatus::kFailure;
 			}
 
-			HPRINT("1");
-			std::tr1::unordered_map<int, Base> bases;
+			plan.bases.reserve(numBases);
+			plan.strandOffsets.reserve(numStrands);
 
-			unsigned int numBases, numStrands;
-			topology_file >> numBases >> numStrands;
-			onProcessStart(numBases * 5);
+			unsigned int previousStrand = 0;
 
-			int baseIndex = 0;
-			std::map<unsigned int, int> strandBaseIndexOffset; // Stores the global base index each strand starts at.
-			unsigned int previousStrandIndex = 0;
+			while (NextLine(it, end, line_begin, line_end)) {
+				if (tokenizer.tokenize(line_begin, line_end) < 4 || tokenizer[0].begin[0] == '#')
+					continue;
 
-			while (topology_file.good()) {
-				std::string line;
-				std::getline(topology_file, line);
+				Plan::Base base;
 
-				if (line[0] == '#' || line.length() == 0)
+				if (!tokenizer.toUnsigned(0, base.strand) || tokenizer[1].length() != 1 || !tokenizer.toInt(2, base.forward) || !tokenizer.toInt(3, base.backward))
 					continue;
 
-				Base base;
-				char name;
+				if (previousStrand != base.strand) {
+					previousStrand = base.strand;
+					plan.strandOffsets.push_back((unsigned int) plan.bases.size());
+				}
 
-				if (sscanf(line.c_str(), "%u %c %d %d", &base.strand, &name, &base.forward, &base.backward) == 4) {/*ERIK Do i need to flip the connection order here ?*/
-					if (previousStrandIndex != base.strand) {
-						previousStrandIndex = base.strand;
-						strandBaseIndexOffset.insert(std::make_pair(previousStrandIndex, baseIndex));
-					}
+				base.label = tokenizer[1].begin[0];
+				plan.bases.push_back(base);
+			}
 
-					base.label = name;
+			if (plan.bases.size() != numBases)
+				HPRINT("Warning: The topology file \"%s\" declares %u bases but %u were read", filename, numBases, (unsigned int) plan.bases.size());
 
-					std::cerr << "Inserting baseIndex: " << baseIndex << std::endl;
-					bases.insert(std::make_pair(baseIndex, base));
-					++baseIndex;
+			return MStatus::kSuccess;
+		}
 
-					onProcessStep();
-				}
-			}
+		MStatus OxDnaImporter::ReadConfiguration(const char *filename, Plan & plan) {
+			/*
+			 * A configuration is read as the first frame of a trajectory, a file with several frames can be played back with the oxDnaTrajectory command
+			 */
 
-			HPRINT("2");
-			topology_file.close();
+			OxDnaTrajectory trajectory;
+			std::vector<double> translations;
+
+			if (!trajectory.open(filename)) {
+				MGlobal::displayError(MString("Unable to open file \"") + filename + "\" for reading.");
+				return MStatus::kFailure;
+			}
 
 			// TODO: Parse bounding box
 
-			baseIndex = 0;
-			while (configuration_file.good()) {
-				std::string line;
-				std::getline(configuration_file, line);
+			if (!trajectory.readFrame(0, translations)) {
+				HPRINT("Error when parsing file \"%s\", failed to read the first configuration", filename);
+				return MStatus::kFailure;
+			}
 
-				if (line[0] == '#' || line.length() == 0)
-					continue;
+			plan.configurations = (unsigned int) (translations.size() / 3);
+			plan.frames = (unsigned int) trajectory.frames();
 
-				MVector baseTranslation, baseVector, normalVector, velocity, angularVelocity; // Only translation is used.
-				// TODO: Use vectors for direction? How would that work with constraints?
-
-				if (sscanf(line.c_str(), "%lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf",
-						&baseTranslation.x, &baseTranslation.y, &baseTranslation.z,
-						&baseVector.x, &baseVector.y, &baseVector.z,
-						&normalVector.x, &normalVector.y, &normalVector.z,
-						&velocity.x, &velocity.y, &velocity.z,
-						&angularVelocity.x, &angularVelocity.y, &angularVelocity.z) == 15) {
-					std::tr1::unordered_map<int, Base>::iterator it = bases.find(baseIndex);
-					if (it == bases.end()) {
-						HPRINT("Error when parsing file, base index %d out of bounds.", baseIndex);
-						return MStatus::kFailure;
-					}
-					baseTranslation.x = (baseTranslation.x + baseVector.x * -0.35) * 0.8518;/*Erik rescale from center of bas to backbone posiston and from oxDNA units to nm*/
-					baseTranslation.y = (baseTranslation.y + baseVector.y * -0.35) * 0.8518;
-					baseTranslation.z = (baseTranslation.z + baseVector.z * -0.35) * 0.8518;
+			if (plan.configurations > plan.bases.size()) {
+				HPRINT("Error when parsing file, base index %u out of bounds.", (unsigned int) plan.bases.size());
+				return MStatus::kFailure;
+			}
 
-					it->second.translation = baseTranslation;;
+			for (size_t i = 0; i < plan.configurations; ++i)
+				std::copy(translations.begin() + i * 3, translations.begin() + i * 3 + 3, plan.bases[i].translation);
 
-					++baseIndex;
-				}
+			return MStatus::kSuccess;
+		}
 
-				onProcessStep();
+		MStatus OxDnaImporter::ReadVHelix(const char *filename, Plan & plan) {
+			std::vector<char> buffer;
+
+			if (!Compression::ReadFile(filename, buffer)) {
+				MGlobal::displayError(MString("Unable to open file \"") + filename + "\" for reading.");
+				return MStatus::kFailure;
 			}
 
-			std::tr1::unordered_map<std::string, Helix> helices;
+#if defined(WIN32) || defined(WIN64)
+			typedef std::unordered_map<std::string, int> helix_index_map_t;
+#else
+			typedef std::tr1::unordered_map<std::string, int> helix_index_map_t;
+#endif /* N Windows */
+
+			helix_index_map_t helixIndices;
+			const char *position = buffer.empty() ? NULL : &buffer[0], *end = position + buffer.size(), *line_begin, *line_end;
+			Tokenizer tokenizer;
 
-			HPRINT("3");
-			while (vhelix_file.good()) {
-				std::string line;
-				std::getline(vhelix_file, line);
+			while (NextLine(position, end, line_begin, line_end)) {
+				const size_t count = tokenizer.tokenize(line_begin, line_end);
 
-				if (line[0] == '#' || line.length() == 0)
+				if (count == 0 || tokenizer[0].begin[0] == '#')
 					continue;
 
-				int base;
-				char name[1024], helixName[1024], material[1024];
-				Helix helix;
+				int index;
+				Plan::Helix helix;
 
-				if (sscanf(line.c_str(), "base %d %s %s %s", &base, name, helixName, material) == 4) {
-					std::tr1::unordered_map<int, Base>::iterator it = bases.find(base);
-					if (it == bases.end()) {
-						HPRINT("Error when parsing file, base index %d out of bounds.", base);
+				if (tokenizer[0] == "base" && count >= 5 && tokenizer.toInt(1, index)) {
+					if (index < 0 || size_t(index) >= plan.bases.size()) {
+						HPRINT("Error when parsing file, base index %d out of bounds.", index);
 						return MStatus::kFailure;
 					}
 
-					it->second.name = name;
-					it->second.helixName = helixName;
-					it->second.material = material;
+					Plan::Base & base = plan.bases[index];
+					base.name = tokenizer[2].str();
+					base.helixName = tokenizer[3].str();
+					base.material = tokenizer[4].str();
+				}
+				else if (tokenizer[0] == "helix" && count >= 8
+					&& tokenizer.toDouble(2, helix.translation[0]) && tokenizer.toDouble(3, helix.translation[1]) && tokenizer.toDouble(4, helix.translation[2])
+					&& tokenizer.toDouble(5, helix.normal[0]) && tokenizer.toDouble(6, helix.normal[1]) && tokenizer.toDouble(7, helix.normal[2])) {
+					helix.name = tokenizer[1].str();
 
-					HPRINT("Named base at index: %d %s, helix: %s", base, name, helixName);
-					onProcessStep();
-				} else if (sscanf(line.c_str(), "helix %s %lf %lf %lf %lf %lf %lf", name, &helix.translation.x, &helix.translation.y, &helix.translation.z, &helix.normal.x, &helix.normal.y, &helix.normal.z) == 7) {
-					helices.insert(std::make_pair(name, helix));
-				} else {
-					HPRINT("Unknown line \"%s\"", line.c_str());
+					if (helixIndices.insert(std::make_pair(helix.name, int(plan.helices.size()))).second)
+						plan.helices.push_back(helix);
 				}
+				else
+					HPRINT("Unknown line \"%s\"", std::string(line_begin, line_end).c_str());
+			}
+
+			/*
+			 * Base lines may appear before the helix they refer to
+			 */
+
+			for (std::vector<Plan::Base>::iterator it = plan.bases.begin(); it != plan.bases.end(); ++it) {
+				helix_index_map_t::const_iterator helix_it = helixIndices.find(it->helixName);
+
+				if (helix_it != helixIndices.end())
+					it->helix = helix_it->second;
 			}
 
+			return MStatus::kSuccess;
+		}
+
+		MStatus OxDnaImporter::build(const Plan & plan) {
 			MStatus status;
 
-			for (std::tr1::unordered_map<std::string, Helix>::iterator it = helices.begin(); it != helices.end(); ++it) {
+			onProcessStart(int(plan.bases.size() * 2));
+
+			std::vector<Model::Helix> helices(plan.helices.size());
+			std::vector<Model::Base> & bases(m_bases);
+			bases.assign(plan.bases.size(), Model::Base());
+			m_frames = plan.frames;
+
+			for (size_t i = 0; i < plan.helices.size(); ++i) {
+				const Plan::Helix & helix = plan.helices[i];
+				const MVector normal(helix.normal);
 				MTransformationMatrix transform;
-				const MVector & normal(it->second.normal);
+
 				transform.rotateTo(MQuaternion(normal.angle(MVector::zAxis), MVector::zAxis ^ normal));
-				HMEVALUATE_RETURN(status = transform.setTranslation(it->second.translation, MSpace::kWorld), status);
+				HMEVALUATE_RETURN(status = transform.setTranslation(MVector(helix.translation), MSpace::kWorld), status);
 
-				HMEVALUATE_RETURN(status = Model::Helix::Create(it->first.c_str(), transform, it->second.helix), status);
+				HMEVALUATE_RETURN(status = Model::Helix::Create(helix.name.c_str(), transform, helices[i]), status);
 			}
 
 			// Create the bases...
-			for (std::tr1::unordered_map<int, Base>::iterator it = bases.begin(); it != bases.end(); ++it) {
-				std::tr1::unordered_map<std::string, Helix>::iterator helix = helices.find(it->second.helixName.asChar());
-				if (helix == helices.end()) {
-					HPRINT("Error when parsing file, unknown helix \"%s\" out of bounds for base \"%s\" at index %d.", it->second.helixName.asChar(), it->second.name.asChar(), it->first);
-					return MStatus::kSuccess;
+			for (size_t i = 0; i < plan.bases.size(); ++i) {
+				const Plan::Base & base = plan.bases[i];
+
+				if (base.helix == -1) {
+					HPRINT("Error when parsing file, unknown helix \"%s\" for base \"%s\" at index %u.", base.helixName.c_str(), base.name.c_str(), (unsigned int) i);
+					return MStatus::kFailure;
 				}
 
-				HMEVALUATE_RETURN(status = Model::Base::Create(helix->second.helix, it->second.name, it->second.translation, it->second.base, MSpace::kWorld), status);
+				HMEVALUATE_RETURN(status = Model::Base::Create(helices[base.helix], base.name.c_str(), MVector(base.translation), bases[i], MSpace::kWorld), status);
 
 				Model::Material material;
-				if (!(status = Model::Material::Find(it->second.material, material))) {
+				if (!(status = Model::Material::Find(base.material.c_str(), material))) {
 					if (status != MStatus::kNotFound) {
 						HMEVALUATE_RETURN_DESCRIPTION("Failed to obtain the material", status);
 					} else {
-						HPRINT("Warning: Can't find material \"%s\" for base \"%s\"", it->second.material.asChar(), it->second.base.getDagPath(status).fullPathName().asChar());
+						HPRINT("Warning: Can't find material \"%s\" for base \"%s\"", base.material.c_str(), bases[i].getDagPath(status).fullPathName().asChar());
 						HMEVALUATE_RETURN(material = *Model::Material::AllMaterials_begin(status), status);
 					}
 				}
-				it->second.base.setMaterial(material);
+				bases[i].setMaterial(material);
 
-				HMEVALUATE_RETURN(status = it->second.base.setLabel(it->second.label), status);
+				HMEVALUATE_RETURN(status = bases[i].setLabel(base.label), status);
 
 				onProcessStep();
 			}
 
 			// Make forward connections...
-			for (std::tr1::unordered_map<int, Base>::iterator it = bases.begin(); it != bases.end(); ++it) {
-				if (it->second.forward == -1)
+			for (size_t i = 0; i < plan.bases.size(); ++i) {
+				const int forward = plan.bases[i].forward;
+
+				if (forward == -1)
 					continue;
 
-				std::tr1::unordered_map<int, Base>::iterator forward = bases.find(it->second.forward);
-				if (forward == bases.end()) {
-					HPRINT("Error when parsing file, base index %d out of bounds.", it->second.forward);
+				if (forward < 0 || size_t(forward) >= bases.size()) {
+					HPRINT("Error when parsing file, base index %d out of bounds.", forward);
 					return MStatus::kFailure;
 				}
 
-				HPRINT("From base %s forward to %s (indices %d and %d)", it->second.name.asChar(), forward->second.name.asChar(), it->first, forward->first);
-
-				HMEVALUATE_RETURN(status = it->second.base.connect_forward(forward->second.base, true), status);
+				HMEVALUATE_RETURN(status = bases[i].connect_forward(bases[forward], true), status);
 
 				onProcessStep();
 			}
@@ -208,5 +320,3 @@ namespace Helix {
 		}
 	}
 }
-
-
@@ -0,0 +1,256 @@
+/*
+ * OxDnaTrajectoryController.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <controller/OxDnaTrajectory.h>
+#include <Compression.h>
+#include <Tokenizer.h>
+
+#include <algorithm>
+#include <cstring>
+
+/*
+ * The frame index is built by reading the file in chunks of this size
+ */
+
+#define OXDNA_TRAJECTORY_SCAN_BUFFER_SIZE (1 << 20)
+
+namespace Helix {
+	namespace Controller {
+		/*
+		 * Frames start with a "t = <time>" line. Scanned with a small state machine so that headers split between two chunks are still found
+		 */
+
+		class FrameScanner {
+		public:
+			inline FrameScanner(std::vector<long long> & offsets) : m_offsets(offsets), m_state(kLineStart), m_candidate(0) {
+
+			}
+
+			void scan(const char *begin, const char *end, long long offset) {
+				const char *it = begin;
+
+				while (it != end) {
+					switch (m_state) {
+					case kLineStart:
+						if (*it == 't') {
+							m_candidate = offset + (it - begin);
+							m_state = kT;
+						}
+						else if (*it != '\n')
+							m_state = kLine;
+						++it;
+						break;
+					case kT:
+						if (*it == '=') {
+							m_offsets.push_back(m_candidate);
+							m_state = kLine;
+						}
+						else if (*it == '\n')
+							m_state = kLineStart;
+						else if (*it != ' ' && *it != '\t')
+							m_state = kLine;
+						++it;
+						break;
+					case kLine:
+						{
+							const char *newline = static_cast<const char *>(memchr(it, '\n', size_t(end - it)));
+
+							if (newline) {
+								it = newline + 1;
+								m_state = kLineStart;
+							}
+							else
+								it = end;
+						}
+						break;
+					}
+				}
+			}
+
+		private:
+			std::vector<long long> & m_offsets;
+
+			enum {
+				kLineStart,
+				kT,
+				kLine
+			} m_state;
+
+			long long m_candidate;
+		};
+
+		bool OxDnaTrajectory::open(const char *filename, size_t nucleotides) {
+			close();
+
+			if (!m_input.open(filename))
+				return false;
+
+			m_filename = filename;
+			m_nucleotides = nucleotides;
+
+			FrameScanner scanner(m_offsets);
+
+			if (m_input.format() != Compression::kNone) {
+				/*
+				 * Compressed files are scanned while they are decompressed and kept open to read the frames from
+				 */
+
+				std::vector<char> buffer(OXDNA_TRAJECTORY_SCAN_BUFFER_SIZE);
+				size_t count;
+
+				while ((count = m_input.read(&buffer[0], buffer.size())) > 0)
+					scanner.scan(&buffer[0], &buffer[0] + count, (long long) m_input.position() - (long long) count);
+
+				if (!m_input.good()) {
+					close();
+					return false;
+				}
+
+				m_size = (long long) m_input.position();
+			}
+			else {
+				m_input.close();
+				m_file.open(filename, std::ios_base::in | std::ios_base::binary);
+
+				if (!m_file) {
+					m_filename.clear();
+					return false;
+				}
+
+				std::vector<char> buffer(OXDNA_TRAJECTORY_SCAN_BUFFER_SIZE);
+				long long offset = 0;
+
+				for (;;) {
+					m_file.read(&buffer[0], std::streamsize(buffer.size()));
+					const std::streamsize count = m_file.gcount();
+
+					if (count <= 0)
+						break;
+
+					scanner.scan(&buffer[0], &buffer[0] + count, offset);
+					offset += count;
+				}
+
+				m_size = offset;
+				m_file.clear();
+			}
+
+			/*
+			 * A configuration without a header is a single frame
+			 */
+
+			if (m_offsets.empty() && m_size > 0)
+				m_offsets.push_back(0);
+
+			return true;
+		}
+
+		void OxDnaTrajectory::close() {
+			if (m_file.is_open())
+				m_file.close();
+
+			m_file.clear();
+			m_filename.clear();
+			m_offsets.clear();
+			m_input.close();
+			m_size = 0;
+			m_nucleotides = 0;
+		}
+
+		bool OxDnaTrajectory::readFrame(size_t index, std::vector<double> & translations) {
+			translations.clear();
+
+			if (index >= m_offsets.size())
+				return false;
+
+			const long long begin = m_offsets[index], end = index + 1 < m_offsets.size() ? m_offsets[index + 1] : m_size;
+
+			if (end == begin)
+				return m_nucleotides == 0;
+
+			m_buffer.resize(size_t(end - begin));
+
+			if (m_input.isOpen()) {
+				if ((unsigned long long) begin < m_input.position() && !m_input.rewind())
+					return false;
+
+				/*
+				 * Skip forward to the frame, through the buffer of the frame
+				 */
+
+				while (m_input.position() < (unsigned long long) begin) {
+					const size_t count = size_t(std::min((unsigned long long) m_buffer.size(), (unsigned long long) begin - m_input.position()));
+
+					if (m_input.read(&m_buffer[0], count) == 0)
+						return false;
+				}
+
+				for (size_t offset = 0; offset < m_buffer.size();) {
+					const size_t count = m_input.read(&m_buffer[offset], m_buffer.size() - offset);
+
+					if (count == 0)
+						return false;
+
+					offset += count;
+				}
+
+				return ParseFrame(&m_buffer[0], &m_buffer[0] + m_buffer.size(), translations) && (m_nucleotides == 0 || translations.size() == m_nucleotides * 3);
+			}
+
+			m_file.clear();
+			m_file.seekg(std::streamoff(begin), std::ios_base::beg);
+
+			if (!m_file.read(&m_buffer[0], std::streamsize(m_buffer.size())))
+				return false;
+
+			return ParseFrame(&m_buffer[0], &m_buffer[0] + m_buffer.size(), translations) && (m_nucleotides == 0 || translations.size() == m_nucleotides * 3);
+		}
+
+		/*
+		 * The "t = ", "b = " and "E = " lines, with or without spaces around the '='
+		 */
+
+		static bool IsHeader(const Tokenizer & tokenizer) {
+			const Tokenizer::Token & first(tokenizer[0]);
+
+			if (*first.begin != 't' && *first.begin != 'b' && *first.begin != 'E')
+				return false;
+
+			return first.length() > 1 ? first.begin[1] == '=' : tokenizer.size() > 1 && *tokenizer[1].begin == '=';
+		}
+
+		bool OxDnaTrajectory::ParseFrame(const char *begin, const char *end, std::vector<double> & translations) {
+			Tokenizer tokenizer;
+
+			for (const char *it = begin; it < end;) {
+				const char *newline = static_cast<const char *>(memchr(it, '\n', size_t(end - it)));
+				const char *line_end = newline ? newline : end;
+
+				/*
+				 * Nucleotide lines are position, base vector, normal, velocity and angular velocity. Only the position and base vector are used
+				 */
+
+				double position[3], baseVector[3];
+				const size_t numTokens = tokenizer.tokenize(it, line_end);
+				it = line_end + 1;
+
+				if (numTokens == 0 || IsHeader(tokenizer))
+					continue;
+
+				if (numTokens < 15
+					|| !tokenizer.toDouble(0, position[0]) || !tokenizer.toDouble(1, position[1]) || !tokenizer.toDouble(2, position[2])
+					|| !tokenizer.toDouble(3, baseVector[0]) || !tokenizer.toDouble(4, baseVector[1]) || !tokenizer.toDouble(5, baseVector[2]))
+					return false;
+
+				for (int i = 0; i < 3; ++i)
+					translations.push_back((position[i] + baseVector[i] * OXDNA_BACKBONE_OFFSET) * OXDNA_LENGTH_UNIT);
+			}
+
+			return true;
+		}
+	}
+}
@@ -0,0 +1,367 @@
+/*
+ * PdbExporterController.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <controller/PdbExporter.h>
+#include <Compression.h>
+#include <ExportPipeline.h>
+#include <Utility.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace Helix {
+	namespace Controller {
+		/*
+		 * Right align the decimal digits of value in the width characters starting at field, which must be filled with spaces
+		 */
+
+		static void FormatRight(char *field, size_t width, unsigned long long value) {
+			char *it = field + width;
+
+			do {
+				*--it = char('0' + value % 10);
+				value /= 10;
+			} while (value != 0 && it != field);
+		}
+
+		/*
+		 * Right align value with three decimals in the width characters starting at field. Coordinates too large for the column are
+		 * written as stars like Fortran does, they're 1 µm from the origin
+		 */
+
+		static void FormatRight(char *field, size_t width, double value) {
+			char buffer[TEXTWRITER_DOUBLE_SIZE];
+			const size_t length = TextWriter::FormatDouble(value, buffer, TextWriter::kFixed, 3);
+
+			if (length <= width)
+				memcpy(field + width - length, buffer, length);
+			else
+				memset(field, '*', width);
+		}
+
+		/*
+		 * mmCIF chain names: A to Z, then AA, AB and so on
+		 */
+
+		static std::string ChainName(unsigned int index) {
+			std::string name;
+
+			do {
+				name.insert(name.begin(), char('A' + index % 26));
+				index /= 26;
+			} while (index-- > 0);
+
+			return name;
+		}
+
+		PdbExporter::PdbExporter() {
+			/*
+			 * Only the geometry and sequence of the bases are written
+			 */
+
+			setVhelix(false);
+		}
+
+		PdbExporter::Format PdbExporter::FormatFromFilename(const char *filename) {
+			std::string name(filename);
+
+			switch (Compression::FromFilename(filename)) {
+			case Compression::kGzip:
+				name.resize(name.size() - 3);
+				break;
+			case Compression::kZstd:
+				name.resize(name.size() - 4);
+				break;
+			default:
+				break;
+			}
+
+			std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+			const char *suffixes[] = { "." HELIX_MMCIF_FILE_TYPE, ".mmcif" };
+
+			for (int i = 0; i < 2; ++i) {
+				const size_t length = strlen(suffixes[i]);
+
+				if (name.size() > length && name.compare(name.size() - length, length, suffixes[i]) == 0)
+					return kMmCif;
+			}
+
+			return kPdb;
+		}
+
+		class PdbExporter::ResidueFormatter {
+		public:
+			/*
+			 * The residues are numbered in advance so that every nucleotide can be formatted on its own
+			 */
+
+			struct Residue {
+				const Base *base;
+				const NucleotideTemplate *nucleotide;
+				unsigned long long serial; // Of the first atom written.
+				unsigned int number, chain;
+				int direction;
+				bool fivePrime, last; // The 5' end has no phosphate, last is the 3' end that terminates the chain.
+			};
+
+			inline ResidueFormatter(const PdbExporter & exporter, Format format) : m_exporter(exporter), m_format(format), m_numAtoms(0), m_longestChain(0) {
+				const char bases[] = { 'A', 'T', 'G', 'C' };
+
+				m_templates.reserve(4);
+
+				for (int i = 0; i < 4; ++i)
+					m_templates.push_back(NucleotideTemplate(bases[i], DNA::OPPOSITE_ROTATION / 2));
+
+				size_t numResidues = 0;
+
+				for (std::list<Strand>::const_iterator it = exporter.m_strands.begin(); it != exporter.m_strands.end(); ++it)
+					numResidues += it->strand.size();
+
+				m_residues.reserve(numResidues);
+
+				unsigned long long serial = 1;
+				unsigned int chain = 0;
+
+				for (std::list<Strand>::const_iterator it = exporter.m_strands.begin(); it != exporter.m_strands.end(); ++it, ++chain) {
+					unsigned int number = 1;
+
+					for (std::vector<Strand::Member>::const_iterator member_it = it->strand.begin(); member_it != it->strand.end(); ++member_it, ++number) {
+						Residue residue;
+						residue.base = &exporter.m_bases[member_it->base];
+						residue.nucleotide = &nucleotide(residue.base->label);
+						residue.serial = serial;
+						residue.number = number;
+						residue.chain = chain;
+						residue.direction = member_it->direction;
+						residue.fivePrime = !it->circular && member_it == it->strand.begin();
+						residue.last = member_it + 1 == it->strand.end();
+
+						const size_t numAtoms = residue.nucleotide->size() - (residue.fivePrime ? NUCLEOTIDE_PHOSPHATE_ATOMS : 0);
+						m_numAtoms += numAtoms;
+						serial += numAtoms;
+
+						if (residue.last && format == kPdb)
+							++serial; // TER
+
+						m_residues.push_back(residue);
+					}
+
+					m_longestChain = std::max(m_longestChain, size_t(number - 1));
+
+					if (format == kMmCif)
+						m_chainNames.push_back(ChainName(chain));
+				}
+
+				m_lastSerial = serial - 1;
+			}
+
+			inline size_t size() const {
+				return m_residues.size();
+			}
+
+			inline unsigned long long numAtoms() const {
+				return m_numAtoms;
+			}
+
+			inline unsigned long long lastSerial() const {
+				return m_lastSerial;
+			}
+
+			inline size_t longestChain() const {
+				return m_longestChain;
+			}
+
+			void operator() (size_t index, TextWriter & output) const {
+				const Residue & residue(m_residues[index]);
+				const Base & base(*residue.base);
+				const Helix & helix(m_exporter.m_helices[base.helix]);
+
+				/*
+				 * The frame of the base: Its projection on the helix axis, which is converted from nm to Ångström, the direction
+				 * from the axis to the base and the direction of the strand along the axis
+				 */
+
+				const MVector center(helix.translation + helix.normal * ((base.translation - helix.translation) * helix.normal));
+				const double origin[] = { center.x * 10.0, center.y * 10.0, center.z * 10.0 };
+				const double radial[] = { base.tangent.x, base.tangent.y, base.tangent.z };
+				const double axial[] = { helix.normal.x * residue.direction, helix.normal.y * residue.direction, helix.normal.z * residue.direction };
+
+				double x[NUCLEOTIDE_MAX_ATOMS], y[NUCLEOTIDE_MAX_ATOMS], z[NUCLEOTIDE_MAX_ATOMS];
+				residue.nucleotide->transform(origin, radial, axial, x, y, z);
+
+				unsigned long long serial = residue.serial;
+
+				for (size_t i = residue.fivePrime ? NUCLEOTIDE_PHOSPHATE_ATOMS : 0; i < residue.nucleotide->size(); ++i, ++serial) {
+					if (m_format == kPdb)
+						writePdbAtom(output, residue, serial, i, x[i], y[i], z[i]);
+					else
+						writeCifAtom(output, residue, serial, i, x[i], y[i], z[i]);
+				}
+
+				if (residue.last && m_format == kPdb)
+					writePdbTer(output, residue, serial);
+			}
+
+		private:
+			/*
+			 * Labels that are not A, T, G or C are written as T, like the oxDNA export
+			 */
+
+			inline const NucleotideTemplate & nucleotide(const DNA::Name & label) const {
+				switch (label.toChar()) {
+				case 'A':
+					return m_templates[0];
+				case 'G':
+					return m_templates[2];
+				case 'C':
+					return m_templates[3];
+				default:
+					return m_templates[1];
+				}
+			}
+
+			/*
+			 * The columns of the residue shared by ATOM and TER records: residue name, chain and residue number
+			 */
+
+			inline void formatResidue(char *line, const Residue & residue) const {
+				const char *residueName = residue.nucleotide->residueName();
+				const size_t length = strlen(residueName);
+
+				memcpy(line + 20 - length, residueName, length);
+				line[21] = PDB_CHAINS[residue.chain % (sizeof(PDB_CHAINS) - 1)];
+				FormatRight(line + 22, 4, (unsigned long long) (residue.number % (PDB_MAX_RESIDUE + 1)));
+			}
+
+			void writePdbAtom(TextWriter & output, const Residue & residue, unsigned long long serial, size_t atom, double x, double y, double z) const {
+				char line[79];
+				memset(line, ' ', sizeof(line));
+
+				memcpy(line, "ATOM", 4);
+				FormatRight(line + 6, 5, serial % (PDB_MAX_SERIAL + 1));
+
+				const char *name = residue.nucleotide->atomName(atom);
+				const size_t length = strlen(name);
+				memcpy(line + (length < 4 ? 13 : 12), name, length);
+
+				formatResidue(line, residue);
+
+				FormatRight(line + 30, 8, x);
+				FormatRight(line + 38, 8, y);
+				FormatRight(line + 46, 8, z);
+				memcpy(line + 54, "  1.00  0.00", 12);
+
+				line[77] = residue.nucleotide->element(atom);
+				line[78] = '\n';
+
+				output.write(line, sizeof(line));
+			}
+
+			void writePdbTer(TextWriter & output, const Residue & residue, unsigned long long serial) const {
+				char line[27];
+				memset(line, ' ', sizeof(line));
+
+				memcpy(line, "TER", 3);
+				FormatRight(line + 6, 5, serial % (PDB_MAX_SERIAL + 1));
+				formatResidue(line, residue);
+				line[26] = '\n';
+
+				output.write(line, sizeof(line));
+			}
+
+			/*
+			 * Same order as the _atom_site loop written by writeAtoms. Atom names with a prime must be quoted
+			 */
+
+			void writeCifAtom(TextWriter & output, const Residue & residue, unsigned long long serial, size_t atom, double x, double y, double z) const {
+				const char *name = residue.nucleotide->atomName(atom);
+				const std::string & chain(m_chainNames[residue.chain]);
+
+				output << "ATOM " << serial << ' ' << residue.nucleotide->element(atom) << ' ';
+
+				if (strchr(name, '\''))
+					output << '"' << name << '"';
+				else
+					output << name;
+
+				output << " . " << residue.nucleotide->residueName() << ' ' << chain << ' ' << residue.chain + 1 << ' ' << residue.number << " ? " <<
+					x << ' ' << y << ' ' << z << " 1 0 " << residue.number << ' ' << chain << " 1\n";
+			}
+
+			const PdbExporter & m_exporter;
+			const Format m_format;
+			std::vector<NucleotideTemplate> m_templates;
+			std::vector<Residue> m_residues;
+			std::vector<std::string> m_chainNames;
+			unsigned long long m_numAtoms, m_lastSerial;
+			size_t m_longestChain;
+		};
+
+		MStatus PdbExporter::writeAtoms(const char *filename, unsigned long long & numAtoms) const {
+			const Compression::Format compression = Compression::FromFilename(filename);
+
+			if (!Compression::IsSupported(compression)) {
+				MGlobal::displayError(MString("vHelix was built without ") + Compression::Name(compression) + " support, can't write \"" + filename + "\".");
+				return MStatus::kFailure;
+			}
+
+			const Format format = FormatFromFilename(filename);
+			ExportPhaseTimer timer(statistics(), ExportStatistics::kFormat);
+			TextWriter file(TextWriter::kFixed, 3);
+
+			if (!file.open(filename)) {
+				MGlobal::displayError(MString("Can't open file \"") + filename + "\" for writing.");
+				return MStatus::kFailure;
+			}
+
+			/*
+			 * Only the residues are kept in memory, their atoms are generated and formatted in parallel by the export pipeline
+			 */
+
+			ResidueFormatter formatter(*this, format);
+			const std::string date(Date());
+
+			if (format == kPdb) {
+				if (formatter.lastSerial() > PDB_MAX_SERIAL || formatter.longestChain() > PDB_MAX_RESIDUE || m_strands.size() > sizeof(PDB_CHAINS) - 1)
+					MGlobal::displayWarning(MString("The structure has too many atoms, residues or strands for the PDB format, the numbering of \"") + filename + "\" wraps around. Use the mmCIF format (.cif) instead.");
+
+				file << "TITLE     VHELIX ALL-ATOM MODEL, " << date << '\n';
+			}
+			else {
+				file << "data_vhelix\n#\n_struct.title 'vHelix all-atom model, " << date << "'\n#\nloop_\n"
+					"_atom_site.group_PDB\n_atom_site.id\n_atom_site.type_symbol\n_atom_site.label_atom_id\n_atom_site.label_alt_id\n"
+					"_atom_site.label_comp_id\n_atom_site.label_asym_id\n_atom_site.label_entity_id\n_atom_site.label_seq_id\n"
+					"_atom_site.pdbx_PDB_ins_code\n_atom_site.Cartn_x\n_atom_site.Cartn_y\n_atom_site.Cartn_z\n_atom_site.occupancy\n"
+					"_atom_site.B_iso_or_equiv\n_atom_site.auth_seq_id\n_atom_site.auth_asym_id\n_atom_site.pdbx_PDB_model_num\n";
+			}
+
+			const bool formatted = ParallelFormat(file, formatter.size(), formatter, PDB_EXPORT_CHUNK_SIZE);
+
+			file << (format == kPdb ? "END\n" : "#\n");
+
+			if (!file.close() || !formatted) {
+				MGlobal::displayError(MString("Failed to write \"") + filename + "\".");
+				return MStatus::kFailure;
+			}
+
+			numAtoms = formatter.numAtoms();
+
+			if (statistics()) {
+				statistics()->addFile(file, ExportStatistics::kFormat);
+
+				statistics()->helices = m_helices.size();
+				statistics()->strands = m_strands.size();
+				statistics()->bases = formatter.size();
+				statistics()->reused = reused();
+			}
+
+			return MStatus::kSuccess;
+		}
+	}
+}
@@ -1,15 +1,114 @@
+#include <controller/BuildExecutor.h>
 #include <controller/RoutedMeshImporter.h>
-#include <controller/PaintStrand.h>
-#include <Creator.h>
-
-#include <maya/MQuaternion.h>
-
+#include <model/Base.h>
+#include <model/Helix.h>
+#include <model/Material.h>
+#include <DNA.h>
+#include <HelixBase.h>
+#include <Tokenizer.h>
+
+#include <cmath>
 #include <fstream>
+#include <sstream>
 #include <string>
 
+#include <maya/MDGModifier.h>
+#include <maya/MProgressWindow.h>
+
+/*
+ * Number of bases per MEL command when setting up aimConstraints and materials
+ */
+
+#define COMMAND_BATCH_SIZE 1000
+
 namespace Helix {
 	namespace Controller {
+		/*
+		 * Minimal vector math for planning, the plan does not depend on Maya
+		 */
+
+		struct Vector3 {
+			double x, y, z;
+
+			inline Vector3(double x = 0.0, double y = 0.0, double z = 0.0) : x(x), y(y), z(z) {}
+			inline Vector3(const double v[3]) : x(v[0]), y(v[1]), z(v[2]) {}
+
+			inline Vector3 operator+(const Vector3 & v) const {
+				return Vector3(x + v.x, y + v.y, z + v.z);
+			}
+
+			inline Vector3 operator-(const Vector3 & v) const {
+				return Vector3(x - v.x, y - v.y, z - v.z);
+			}
+
+			inline Vector3 operator*(double s) const {
+				return Vector3(x * s, y * s, z * s);
+			}
+
+			inline Vector3 operator/(double s) const {
+				return Vector3(x / s, y / s, z / s);
+			}
+
+			inline Vector3 & operator+=(const Vector3 & v) {
+				x += v.x; y += v.y; z += v.z;
+				return *this;
+			}
+
+			inline Vector3 & operator-=(const Vector3 & v) {
+				x -= v.x; y -= v.y; z -= v.z;
+				return *this;
+			}
+
+			inline double dot(const Vector3 & v) const {
+				return x * v.x + y * v.y + z * v.z;
+			}
+
+			inline Vector3 cross(const Vector3 & v) const {
+				return Vector3(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x);
+			}
+
+			inline double length() const {
+				return std::sqrt(dot(*this));
+			}
+
+			inline Vector3 normal() const {
+				const double l = length();
+				return l > 0.0 ? *this / l : *this;
+			}
+
+			/*
+			 * Rotate counter-clockwise around the given unit axis, same as MVector::rotateBy(MQuaternion(radians, axis))
+			 */
+
+			inline Vector3 rotateBy(double radians, const Vector3 & axis) const {
+				const double c = std::cos(radians), s = std::sin(radians);
+				return *this * c + axis.cross(*this) * s + axis * (axis.dot(*this) * (1.0 - c));
+			}
+		};
+
+		/*
+		 * The default tangent is the y-axis projected onto the plane perpendicular to the helix axis, rotated around the axis
+		 */
+
+		static Vector3 DefaultTangent(const Vector3 & normal, double rotation) {
+			Vector3 tangent(normal.cross(Vector3(0.0, 1.0, 0.0)).cross(normal).normal());
+
+			if (tangent.length() == 0.0)
+				tangent = normal.cross(Vector3(1.0, 0.0, 0.0)).cross(normal).normal();
+
+			return tangent.rotateBy(toRadians(rotation), normal);
+		}
+
 		MStatus RoutedMeshImporter::read(const char *filename) {
+			MStatus status;
+			Plan plan;
+
+			HMEVALUATE_RETURN(status = CreatePlan(filename, plan), status);
+
+			return build(plan);
+		}
+
+		MStatus RoutedMeshImporter::Read(const char *filename, std::vector<Vertex> & vertices, std::vector<Edge> & edges, double & initialRotation) {
 			std::ifstream file(filename);
 
 			if (!file) {
@@ -19,189 +118,382 @@ namespace Helix {
 				return MStatus::kFailure;
 			}
 
-			while (file.good()) {
-				std::string line;
-				std::getline(file, line);
+			std::string line;
+			Tokenizer tokenizer;
 
-				if (line.length() == 0 || line[0] == '#')
+			while (std::getline(file, line)) {
+				if (tokenizer.tokenize(line) == 0 || tokenizer[0].begin[0] == '#')
 					continue;
 
-				switch (line[0]) {
-				case 'v':
-				{
-					MVector vertex;
-					if (sscanf(line.c_str(), "v %lf %lf %lf", &vertex.x, &vertex.y, &vertex.z) != 3) {
+				if (tokenizer[0] == "v") {
+					Vertex vertex;
+
+					if (tokenizer.size() < 4 || !tokenizer.toDouble(1, vertex.position[0]) || !tokenizer.toDouble(2, vertex.position[1]) || !tokenizer.toDouble(3, vertex.position[2])) {
 						HPRINT("Unformatted vertex line: %s", line.c_str());
 						return MStatus::kFailure;
 					}
-					m_vertices.push_back(vertex);
+
+					vertices.push_back(vertex);
 				}
-					break;
-				case 'e':
-				{
+				else if (tokenizer[0] == "e") {
 					Edge edge;
-					switch (sscanf(line.c_str(), "e %u %lf %lf %lf", &edge.vertex, &edge.cylinder[0], &edge.cylinder[1], &edge.angle)) {
-					case 4:
-						HPRINT("Parsed \"%s\" as e %u %f %f %f", line.c_str(), edge.vertex, edge.cylinder[0], edge.cylinder[1], edge.angle);
-						edge.hasCylinder = true;
-						edge.hasAngle = true;
-						break;
-					case 3:
-						HPRINT("Parsed \"%s\" as e %u %f %f", line.c_str(), edge.vertex, edge.cylinder[0], edge.cylinder[1]);
-						edge.hasCylinder = true;
-						edge.hasAngle = false;
-						break;
-					case 1:
-						HPRINT("Parsed \"%s\" as e %u", line.c_str(), edge.vertex);
-						edge.hasCylinder = false;
-						edge.hasAngle = false;
-						break;
-					default:
+
+					if (tokenizer.size() < 2 || !tokenizer.toUnsigned(1, edge.vertex) || edge.vertex == 0) {
 						HPRINT("Unformatted edge line: %s", line.c_str());
 						return MStatus::kFailure;
 					}
+
+					edge.hasCylinder = tokenizer.size() >= 4 && tokenizer.toDouble(2, edge.cylinder[0]) && tokenizer.toDouble(3, edge.cylinder[1]);
+					edge.hasAngle = edge.hasCylinder && tokenizer.size() >= 5 && tokenizer.toDouble(4, edge.angle);
+
 					--edge.vertex; // In the file the indices are [1, N] but here we
 								   // index arrays so [0, N-1].
-					m_edges.push_back(edge);
+					edges.push_back(edge);
 				}
-					break;
-				case 'r':
-					if (sscanf(line.c_str(), "r %lf", &m_initialRotation) != 1) {
+				else if (tokenizer[0] == "r") {
+					if (tokenizer.size() < 2 || !tokenizer.toDouble(1, initialRotation)) {
 						HPRINT("Unformatted initial rotation line: %s", line.c_str());
 						return MStatus::kFailure;
 					}
-					break;
-				default:
+				}
+				else {
 					HPRINT("Unknown command: %s", line.c_str());
 					return MStatus::kFailure;
-					break;
 				}
 			}
 
+			return MStatus::kSuccess;
+		}
+
+		MStatus RoutedMeshImporter::CreatePlan(const char *filename, Plan & plan) {
 			MStatus status;
-			std::vector<Model::Helix> helices;
-			helices.reserve(m_edges.size() - 1);
+			std::vector<Vertex> vertices;
+			std::vector<Edge> edges;
+			double initialRotation = 0.0;
 
-			{
-				double rotation(m_initialRotation);
-				std::vector<Edge>::const_iterator it = m_edges.begin();
-				std::vector<Edge>::const_iterator prev_it = it++;
+			HMEVALUATE_RETURN(status = Read(filename, vertices, edges, initialRotation), status);
 
-				if (prev_it->vertex >= m_vertices.size()) {
-					HPRINT("Index out of range: %u", prev_it->vertex);
+			for (std::vector<Edge>::const_iterator it = edges.begin(); it != edges.end(); ++it) {
+				if (it->vertex >= vertices.size()) {
+					HPRINT("Index out of range: %u", it->vertex + 1);
 					return MStatus::kInvalidParameter;
 				}
+			}
 
-				if (it->vertex >= m_vertices.size()) {
-					HPRINT("Index out of range: %u", it->vertex);
-					return MStatus::kInvalidParameter;
+			plan.filename = filename;
+			plan.helices.clear();
+			plan.crossovers.clear();
+
+			if (edges.size() < 2)
+				return MStatus::kSuccess;
+
+			plan.helices.reserve(edges.size() - 1);
+
+			/*
+			 * Every helix is rotated so that it continues where the previous one ended, unless the edge following it specifies an angle
+			 */
+
+			bool hasPrevious = false;
+			Vector3 end_base;
+
+			for (size_t i = 0; i + 1 < edges.size(); ++i) {
+				const Edge & edge = edges[i], & next = edges[i + 1];
+
+				if (!edge.hasCylinder) {
+					hasPrevious = false;
+					continue;
 				}
 
-				Creator creator;
-				MVector start(m_vertices[prev_it->vertex]);
-				MVector end(m_vertices[it->vertex]);
-				MVector normal((end - start).normal());
+				const Vector3 start(vertices[edge.vertex].position), end(vertices[next.vertex].position);
+				const Vector3 normal((end - start).normal());
+				Vector3 start_cylinder(start + normal * edge.cylinder[0]), end_cylinder(start + normal * edge.cylinder[1]);
+				const double length((end_cylinder - start_cylinder).length());
+				const int bases = DNA::DistanceToBaseCount(length);
 
-				MVector tangent((normal ^ MVector::yAxis ^ normal).normal().rotateBy(MQuaternion(toRadians(rotation), normal)));
-				MVector start_cylinder(start + normal * prev_it->cylinder[0]);
-				MVector end_cylinder(start + normal * prev_it->cylinder[1]);
-				double length((end_cylinder - start_cylinder).length());
+				if (bases <= 0) {
+					hasPrevious = false;
+					continue;
+				}
 
-				MVector error_vector(normal * ((length - DNA::HelixLength(length)) / 2));
+				const Vector3 error_vector(normal * ((length - DNA::HelixLength(length)) / 2));
 				start_cylinder += error_vector;
 				end_cylinder -= error_vector;
 
-				for (; it != m_edges.end(); ++it, ++prev_it) {
-					if (!prev_it->hasCylinder)
-						continue;
+				Vector3 tangent;
 
-					if (prev_it->vertex >= m_vertices.size()) {
-						HPRINT("Index out of range: %u", prev_it->vertex);
-						return MStatus::kInvalidParameter;
-					}
+				if (i == 0)
+					tangent = DefaultTangent(normal, initialRotation);
+				else if (next.hasAngle)
+					tangent = DefaultTangent(normal, next.angle);
+				else if (hasPrevious) {
+					const Vector3 delta(end_base - start_cylinder);
+					tangent = normal.cross(delta.cross(normal)).normal();
+				}
+				else
+					tangent = DefaultTangent(normal, 0.0);
+
+				const Vector3 center((end_cylinder + start_cylinder) / 2);
+				const Vector3 binormal(tangent.cross(normal).normal());
+
+				Plan::Helix helix;
+				const Vector3 *rows[] = { &binormal, &tangent, &normal, &center };
+
+				for (int row = 0; row < 4; ++row) {
+					helix.transform[row][0] = rows[row]->x;
+					helix.transform[row][1] = rows[row]->y;
+					helix.transform[row][2] = rows[row]->z;
+					helix.transform[row][3] = row == 3 ? 1.0 : 0.0;
+				}
+
+				helix.bases = bases;
+
+				if (!plan.helices.empty())
+					plan.crossovers.push_back(std::make_pair((unsigned int) plan.helices.size() - 1, (unsigned int) plan.helices.size()));
+
+				plan.helices.push_back(helix);
+
+				end_base = end_cylinder + tangent.rotateBy(toRadians(DNA::HelixRotation(length)), normal);
+				hasPrevious = true;
+			}
+
+			if (plan.helices.size() > 1 && edges.front().vertex == edges.back().vertex) {
+				// Circular, connect the first and last bases as well.
+				plan.crossovers.push_back(std::make_pair((unsigned int) plan.helices.size() - 1, 0u));
+			}
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus RoutedMeshImporter::DryRun(const char *filename, ImportStatistics & statistics) {
+			MStatus status;
+
+			/*
+			 * Edges referring to vertices that do not exist make CreatePlan fail, report them all instead
+			 */
+
+			{
+				std::vector<Vertex> vertices;
+				std::vector<Edge> edges;
+				double initialRotation = 0.0;
+
+				HMEVALUATE_RETURN(status = Read(filename, vertices, edges, initialRotation), status);
 
-					if (it->vertex >= m_vertices.size()) {
-						HPRINT("Index out of range: %u", it->vertex);
-						return MStatus::kInvalidParameter;
+				for (size_t i = 0; i < edges.size(); ++i) {
+					if (edges[i].vertex >= vertices.size()) {
+						std::ostringstream description;
+						description << "edge " << (i + 1) << " refers to vertex " << (edges[i].vertex + 1) << " of " << vertices.size();
+						statistics.addDangling(description.str());
 					}
+				}
+
+				if (statistics.danglingReferences > 0)
+					return MStatus::kSuccess;
+			}
+
+			Plan plan;
+
+			HMEVALUATE_RETURN(status = CreatePlan(filename, plan), status);
+
+			/*
+			 * The scaffold runs through all helices, every helix has one staple strand
+			 */
+
+			statistics.helices = plan.helices.size();
+			statistics.strands = plan.helices.empty() ? 0 : plan.helices.size() + 1;
+			statistics.crossovers = plan.crossovers.size();
+
+			for (std::vector<Plan::Helix>::const_iterator it = plan.helices.begin(); it != plan.helices.end(); ++it)
+				statistics.bases += size_t(it->bases) * 2;
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus RoutedMeshImporter::build(const Plan & plan) {
+			MStatus status;
+
+			if (plan.helices.empty())
+				return MStatus::kSuccess;
+
+			size_t numMaterials;
+			Model::Material::Iterator materials_begin = Model::Material::AllMaterials_begin(status, numMaterials);
+
+			if (!status) {
+				status.perror("Material::AllMaterials_begin");
+				return status;
+			}
+
+			/*
+			 * Bases are stored per helix as forward and backward pairs, helixOffsets[i] is the index of the first pair of helix i
+			 */
+
+			std::vector<size_t> helixOffsets(plan.helices.size() + 1, 0);
+
+			for (size_t i = 0; i < plan.helices.size(); ++i)
+				helixOffsets[i + 1] = helixOffsets[i] + size_t(plan.helices[i].bases);
+
+			const size_t numBasePairs = helixOffsets.back();
+
+			MProgressWindow::endProgress();
+
+			BuildExecutor executor("Importing routed mesh...");
+			executor.begin(MString("Creating bases from file: \"") + plan.filename.c_str() + "\"", (unsigned int) plan.helices.size());
+
+			/*
+			 * Create the helices and their bases. If the import is cancelled all helices are deleted and with them everything else created
+			 */
+
+			std::vector<Model::Helix> helices(plan.helices.size());
+			std::vector<Model::Base> bases(numBasePairs * 2);
+			const MString strandNames[] = { DNA::GetStrandName(0), DNA::GetStrandName(1) };
+
+			for (size_t i = 0; i < plan.helices.size(); ++i) {
+				const Plan::Helix & helix = plan.helices[i];
+
+				HMEVALUATE_RETURN(status = Model::Helix::Create("helix1", MTransformationMatrix(MMatrix(helix.transform)), helices[i]), status);
+				HMEVALUATE_RETURN(status = helices[i].setCylinderRange(0.0, DNA::STEP * (helix.bases - 1)), status);
+
+				for (int j = 0; j < helix.bases; ++j) {
+					double positions[2][3];
+					DNA::CalculateBasePairPositions(double(j), positions[0], positions[1], 0.0, helix.bases);
+
+					for (int k = 0; k < 2; ++k)
+						HMEVALUATE_RETURN(status = Model::Base::Create(helices[i], strandNames[k] + "_" + (j + 1), MVector(positions[k]), bases[(helixOffsets[i] + j) * 2 + k]), status);
+				}
+
+				if (!executor.step((unsigned int) helix.bases * 2)) {
+					BuildExecutor::RollBack(helices.begin(), helices.end());
+					return executor.finish();
+				}
+			}
+
+			/*
+			 * Forward connections within the helices, the forward strand runs from the first to the last base pair and the backward strand the other way,
+			 * followed by the scaffold crossovers between the helices
+			 */
+
+			std::vector< std::pair<size_t, size_t> > forwardConnections;
+			forwardConnections.reserve(numBasePairs * 2 + plan.crossovers.size());
 
-					const MVector center((end_cylinder + start_cylinder) / 2);
-					const MVector binormal((tangent ^ normal).normal());
-
-					double transformationMatrix[][4] = {
-							{ binormal.x, tangent.x, normal.x, center.x },
-							{ binormal.y, tangent.y, normal.y, center.y },
-							{ binormal.z, tangent.z, normal.z, center.z },
-							{ 0, 0, 0, 1 }
-					};
-
-					Model::Helix helix;
-					HMEVALUATE_RETURN(status = creator.create(DNA::DistanceToBaseCount(length), MMatrix(transformationMatrix).transpose(), helix), status);
-					helices.push_back(helix);
-
-					// Now recalculate start, end, normal, tangent, binormal, start_cylinder, end_cylinder for the upcoming cylinder if any.
-
-					const std::vector<Edge>::const_iterator next_it(it + 1);
-					if (next_it != m_edges.end()) {
-
-						const MVector end_base(end_cylinder + tangent.rotateBy(MQuaternion(toRadians(DNA::HelixRotation(length)), normal)));
-
-						HPRINT("end_base: %f %f %f", end_base.x, end_base.y, end_base.z);
-						start = m_vertices[it->vertex];
-						end = m_vertices[next_it->vertex];
-						normal = (end - start).normal();
-						start_cylinder = start + normal * it->cylinder[0];
-						end_cylinder = start + normal * it->cylinder[1];
-						length = (end_cylinder - start_cylinder).length();
-						MVector error_vector(normal * ((length - DNA::HelixLength(length)) / 2));
-						start_cylinder += error_vector;
-						end_cylinder -= error_vector;
-
-						// TODO: In case we have an angle, cleanup the code above
-						if (next_it->hasAngle)
-							tangent = MVector((normal ^ MVector::yAxis ^ normal).normal().rotateBy(MQuaternion(toRadians(next_it->angle), normal)));
-						else {
-							const MVector delta(end_base - start_cylinder);
-							tangent = (normal ^ (delta ^ normal)).normal();
+			for (size_t i = 0; i < plan.helices.size(); ++i) {
+				for (size_t j = helixOffsets[i] + 1; j < helixOffsets[i + 1]; ++j) {
+					forwardConnections.push_back(std::make_pair((j - 1) * 2, j * 2));
+					forwardConnections.push_back(std::make_pair(j * 2 + 1, (j - 1) * 2 + 1));
+				}
+			}
+
+			for (std::vector< std::pair<unsigned int, unsigned int> >::const_iterator it = plan.crossovers.begin(); it != plan.crossovers.end(); ++it)
+				forwardConnections.push_back(std::make_pair((helixOffsets[it->first + 1] - 1) * 2, helixOffsets[it->second] * 2));
+
+			executor.begin("Connecting bases", (unsigned int) forwardConnections.size());
+
+			/*
+			 * All connections are made with a single modifier. The new bases have no previous connections to remove
+			 */
+
+			{
+				MDGModifier dgModifier;
+
+				for (size_t i = 0; i < numBasePairs; ++i) {
+					MObject object, target;
+
+					HMEVALUATE_RETURN(object = bases[i * 2].getObject(status), status);
+					HMEVALUATE_RETURN(target = bases[i * 2 + 1].getObject(status), status);
+					HMEVALUATE_RETURN(status = dgModifier.connect(MPlug(object, HelixBase::aLabel), MPlug(target, HelixBase::aLabel)), status);
+				}
+
+				for (std::vector< std::pair<size_t, size_t> >::const_iterator it = forwardConnections.begin(); it != forwardConnections.end(); ++it) {
+					MObject object, target;
+
+					HMEVALUATE_RETURN(object = bases[it->first].getObject(status), status);
+					HMEVALUATE_RETURN(target = bases[it->second].getObject(status), status);
+					HMEVALUATE_RETURN(status = dgModifier.connect(MPlug(target, HelixBase::aBackward), MPlug(object, HelixBase::aForward)), status);
+				}
+
+				HMEVALUATE_RETURN(status = dgModifier.doIt(), status);
+			}
+
+			/*
+			 * Same aimConstraints as Base::connect_forward, but executed in batches
+			 */
+
+			{
+				MString command;
+
+				for (size_t i = 0; i < forwardConnections.size(); ++i) {
+					MDagPath object, target;
+
+					HMEVALUATE_RETURN(object = bases[forwardConnections[i].first].getDagPath(status), status);
+					HMEVALUATE_RETURN(target = bases[forwardConnections[i].second].getDagPath(status), status);
+
+					command += MString("aimConstraint -aimVector 0 0 -1.0 ") + target.fullPathName() + " " + object.fullPathName() + ";\n";
+
+					if ((i + 1) % COMMAND_BATCH_SIZE == 0 || i + 1 == forwardConnections.size()) {
+						HMEVALUATE_RETURN(status = MGlobal::executeCommand(command, false), status);
+
+						command = MString();
+
+						if (!executor.advance((unsigned int) (i % COMMAND_BATCH_SIZE) + 1)) {
+							BuildExecutor::RollBack(helices.begin(), helices.end());
+							return executor.finish();
 						}
 					}
 				}
 			}
 
-			// Connect scaffold
-			std::vector<Model::Helix>::iterator it = helices.begin();
-			std::vector<Model::Helix>::iterator prev_it = it++;
+			executor.end();
 
-			for (; it != helices.end(); ++it, ++prev_it) {
-				Model::Base forward_threeprime, forward_fiveprime;
-				HMEVALUATE_RETURN(status = prev_it->getForwardThreePrime(forward_threeprime), status);
-				HMEVALUATE_RETURN(status = it->getForwardFivePrime(forward_fiveprime), status);
+			/*
+			 * The scaffold gets a single random material and every helix a random staple material different from the scaffold.
+			 * Materials are assigned with one sets command per material and helix, batched like the aimConstraints
+			 */
 
-				HMEVALUATE_RETURN(status = forward_threeprime.connect_forward(forward_fiveprime, true), status);
-			}
+			if (numMaterials > 0) {
+				const size_t scaffoldMaterial = size_t(rand()) % numMaterials;
+				MString command;
+				size_t batched = 0;
 
-			if (helices.size() > 1) {
-				// Paint the scaffold.
-				Controller::PaintMultipleStrandsWithNewColorFunctor functor;
-				HMEVALUATE_RETURN(status = functor.loadMaterials(), status);
-				Model::Base fiveprime;
-				HMEVALUATE_RETURN(status = helices.begin()->getForwardFivePrime(fiveprime), status);
-				functor(fiveprime);
-				HMEVALUATE_DESCRIPTION("Controller::PaintMultipleStrandsWithNewColorFunctor", functor.status());
+				for (size_t i = 0; i < plan.helices.size(); ++i) {
+					size_t stapleMaterial = size_t(rand()) % numMaterials;
 
-				if (m_edges.begin()->vertex == (--m_edges.end())->vertex) {
-					// Circular, connect the first and last bases as well.
-					std::vector<Model::Helix>::iterator first = helices.begin();
-					std::vector<Model::Helix>::iterator last = --helices.end();
-					Model::Base threeprime, fiveprime;
-					HMEVALUATE_RETURN(status = last->getForwardThreePrime(threeprime), status);
-					HMEVALUATE_RETURN(status = first->getForwardFivePrime(fiveprime), status);
+					while (numMaterials > 1 && stapleMaterial == scaffoldMaterial)
+						stapleMaterial = size_t(rand()) % numMaterials;
 
-					HMEVALUATE_RETURN(status = threeprime.connect_forward(fiveprime, true), status);
+					const MString materials[] = { (materials_begin + scaffoldMaterial)->getMaterial(), (materials_begin + stapleMaterial)->getMaterial() };
+
+					for (int k = 0; k < 2; ++k) {
+						if (materials[k].length() == 0)
+							continue;
+
+						command += MString("sets -noWarnings -forceElement ") + materials[k];
+
+						for (size_t j = helixOffsets[i]; j < helixOffsets[i + 1]; ++j) {
+							MDagPath dagPath;
+
+							HMEVALUATE_RETURN(dagPath = bases[j * 2 + k].getDagPath(status), status);
+							command += MString(" ") + dagPath.fullPathName();
+						}
+
+						command += ";\n";
+					}
+
+					batched += helixOffsets[i + 1] - helixOffsets[i];
+
+					if (batched >= COMMAND_BATCH_SIZE || i + 1 == plan.helices.size()) {
+						HMEVALUATE_RETURN(status = MGlobal::executeCommand(command, false), status);
+
+						command = MString();
+						batched = 0;
+					}
 				}
 			}
 
-			return MStatus::kSuccess;
+			/*
+			 * Refresh cylinder/base view
+			 */
+
+			HMEVALUATE(status = Model::Helix::RefreshCylinderOrBases(), status);
+
+			return executor.finish();
 		}
 	}
 }
@@ -1,8 +1,15 @@
 #include <controller/StrandLengthCount.h>
+#include <model/StrandIndex.h>
 
 namespace Helix {
 	namespace Controller {
 		unsigned int StrandLengthCount::length(Model::Strand & strand) {
+			// The strand index already knows the length of every strand in the scene.
+			MStatus status;
+			Model::StrandIndex::Strand *indexed_strand;
+			if ((status = Model::StrandIndex::Instance().find(strand.getDefiningBase(), indexed_strand)))
+				return (unsigned int) indexed_strand->size();
+
 			// First rewind if the strand is not a loop.
 			Model::Strand::BackwardIterator it(strand.reverse_begin());
 			Model::Base start_base;
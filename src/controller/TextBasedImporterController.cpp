@@ -1,9 +1,11 @@
 #include <Definition.h>
 
 #include <controller/Connect.h>
+#include <controller/NickStrands.h>
 #include <controller/PaintStrand.h>
 #include <controller/TextBasedImporter.h>
 #include <model/Material.h>
+#include <model/StrandIndex.h>
 #include <Creator.h>
 
 #include <cstdio>
@@ -13,30 +15,23 @@
 #include <maya/MQuaternion.h>
 #include <maya/MProgressWindow.h>
 
-#define BUFFER_SIZE 1024
-
 namespace Helix {
 	namespace Controller {
 		struct non_nicked_strand_t {
-			Model::Strand strand;
-			// Bases together with their calculated offset along the strand.
-			std::vector< std::pair<Model::Base, int> > bases;
+			unsigned int strand; // Index in the strand index.
+			// Offsets along the strand of the bases that may be nicked.
+			std::vector<unsigned int> sites;
 
-			inline non_nicked_strand_t(Model::Base & base) : strand(base), bases(1, std::make_pair(base, 0)) {}
-			inline void add_base(Model::Base & base) {
-				bases.push_back(std::make_pair(base, 0));
-			}
+			inline non_nicked_strand_t(unsigned int strand) : strand(strand) {}
 		};
 
-		struct base_offset_comparator_t : public std::binary_function<std::pair<Model::Base, int>, std::pair<Model::Base, int>, bool> {
-			const int offset;
-
-			inline base_offset_comparator_t(int offset) : offset(offset) {}
-
-			inline bool operator() (const std::pair<Model::Base, int> & p1, const std::pair<Model::Base, int> & p2) const {
-				return std::abs(p1.second - offset) < std::abs(p2.second - offset);
-			}
-		};
+#if defined(WIN32) || defined(WIN64)
+		typedef std::unordered_map<unsigned int, size_t> strand_group_map_t;
+		typedef std::unordered_map<std::string, size_t> string_index_map_t;
+#else
+		typedef std::tr1::unordered_map<unsigned int, size_t> strand_group_map_t;
+		typedef std::tr1::unordered_map<std::string, size_t> string_index_map_t;
+#endif /* N Windows */
 
 		TextBasedImporter::Connection::Type TextBasedImporter::Connection::TypeFromString(const char *type) {
 			if (strcmp("f5'", type) == 0)
@@ -73,8 +68,56 @@ namespace Helix {
 			return MStatus::kSuccess;
 		}
 
-		MStatus TextBasedImporter::read(const char *filename, int nicking_min_length, int nicking_max_length) {
-			MStatus status;
+		void TextBasedImporter::parseLine(const Tokenizer & tokenizer, bool & autostaple, std::vector< std::pair<std::string, std::string> > & paintStrands) {
+			const size_t count(tokenizer.size());
+
+			if (count == 0)
+				return;
+
+			const Tokenizer::Token & command(tokenizer[0]);
+			MVector position;
+			MQuaternion orientation;
+
+			if ((command == "h" && count >= 8) || (command == "hb" && count >= 9)) {
+				// h <name> <x> <y> <z> <qx> <qy> <qz> <qw> or hb <name> <bases> <x> <y> <z> <qx> <qy> <qz> <qw>
+				unsigned int bases(0);
+				const size_t first(command == "h" ? 2 : 3);
+
+				if ((first == 3 && !tokenizer.toUnsigned(2, bases))
+					|| !tokenizer.toDouble(first, position.x) || !tokenizer.toDouble(first + 1, position.y) || !tokenizer.toDouble(first + 2, position.z)
+					|| !tokenizer.toDouble(first + 3, orientation.x) || !tokenizer.toDouble(first + 4, orientation.y) || !tokenizer.toDouble(first + 5, orientation.z) || !tokenizer.toDouble(first + 6, orientation.w))
+					return;
+
+				const std::string name(tokenizer[1].str());
+				helixIndices.insert(std::make_pair(name, helices.size()));
+				helices.push_back(Helix(position, orientation, name, bases));
+			}
+			else if (command == "b" && count >= 8) {
+				// b <name> <helix> <x> <y> <z> <material> <label>
+				if (!tokenizer.toDouble(3, position.x) || !tokenizer.toDouble(4, position.y) || !tokenizer.toDouble(5, position.z))
+					return;
+
+				explicitBases.push_back(Base(tokenizer[1].str(), tokenizer[2].str(), position, tokenizer[6].str(), tokenizer[7].begin[0]));
+			}
+			else if (command == "c" && count >= 5) {
+				// c <helix> <base or end> <target helix> <target base or end>
+				const std::string fromName(tokenizer[2].str()), toName(tokenizer[4].str());
+				connections.push_back(Connection(tokenizer[1].str(), fromName, tokenizer[3].str(), toName, Connection::TypeFromString(fromName.c_str()), Connection::TypeFromString(toName.c_str())));
+			}
+			else if (command == "l" && count >= 3)
+				explicitBaseLabels.insert(std::make_pair(tokenizer[1].str(), DNA::Name(tokenizer[2].begin[0])));
+			else if (command == "ps" && count >= 3)
+				paintStrands.push_back(std::make_pair(tokenizer[1].str(), tokenizer[2].str()));
+			else if (count == 1 && (command == "autostaple" || command == "autonick"))
+				autostaple = true;
+		}
+
+		Model::Helix *TextBasedImporter::findHelix(const std::string & name) {
+			helix_index_map_t::const_iterator it(helixIndices.find(name));
+			return it != helixIndices.end() ? &helices[it->second].helix : NULL;
+		}
+
+		MStatus TextBasedImporter::parse(const char *filename, bool & autostaple, std::vector< std::pair<std::string, std::string> > & paintStrands) {
 			std::ifstream file(filename);
 
 			if (file.fail()) {
@@ -82,46 +125,127 @@ namespace Helix {
 				return MStatus::kFailure;
 			}
 
-			MVector position;
-			MQuaternion orientation;
-			unsigned int bases;
-			char nameBuffer[BUFFER_SIZE], helixNameBuffer[BUFFER_SIZE], materialNameBuffer[BUFFER_SIZE], targetNameBuffer[BUFFER_SIZE], targetHelixNameBuffer[BUFFER_SIZE];
-			char label;
+			// The line buffer and the token array are reused for every line.
+			std::string line;
+			Tokenizer tokenizer;
+
+			while (std::getline(file, line)) {
+				tokenizer.tokenize(line);
+				parseLine(tokenizer, autostaple, paintStrands);
+			}
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus TextBasedImporter::DryRun(const char *filename, ImportStatistics & statistics) {
+			MStatus status;
+			TextBasedImporter importer;
+			bool autostaple(true);
+			std::vector< std::pair<std::string, std::string> > paintStrands;
+
+			HMEVALUATE_RETURN(status = importer.parse(filename, autostaple, paintStrands), status);
+
+			/*
+			 * Strands are counted over strand pieces: the forward and backward strand of every helix and every explicit base,
+			 * joined by the explicit connections
+			 */
+
+			const size_t numHelices(importer.helices.size());
+			string_index_map_t baseIndices;
+
+			for (size_t i = 0; i < importer.explicitBases.size(); ++i) {
+				const Base & base(importer.explicitBases[i]);
+				baseIndices.insert(std::make_pair(base.name, numHelices * 2 + i));
+
+				if (importer.helixIndices.find(base.helixName) == importer.helixIndices.end())
+					statistics.addDangling("base \"" + base.name + "\" belongs to helix \"" + base.helixName + "\" which does not exist");
+			}
+
+			std::vector< std::pair<unsigned int, unsigned int> > joins;
+
+			for (std::vector<Connection>::const_iterator it(importer.connections.begin()); it != importer.connections.end(); ++it) {
+				const std::string *helixNames[] = { &it->fromHelixName, &it->toHelixName }, *names[] = { &it->fromName, &it->toName };
+				const Connection::Type types[] = { it->fromType, it->toType };
+				size_t pieces[2];
+				bool valid(true);
+
+				for (int i = 0; i < 2; ++i) {
+					helix_index_map_t::const_iterator helix_it(importer.helixIndices.find(*helixNames[i]));
+
+					if (helix_it == importer.helixIndices.end()) {
+						statistics.addDangling("connection to helix \"" + *helixNames[i] + "\" which does not exist");
+						valid = false;
+					}
+					else if (types[i] == Connection::kNamed) {
+						string_index_map_t::const_iterator base_it(baseIndices.find(*names[i]));
+
+						if (base_it == baseIndices.end()) {
+							statistics.addDangling("connection to base \"" + *names[i] + "\" which does not exist");
+							valid = false;
+						}
+						else
+							pieces[i] = base_it->second;
+					}
+					else if (importer.helices[helix_it->second].bases == 0) {
+						statistics.addDangling("connection to an end of helix \"" + *helixNames[i] + "\" which has no bases");
+						valid = false;
+					}
+					else
+						pieces[i] = helix_it->second * 2 + (types[i] == Connection::kForwardFivePrime || types[i] == Connection::kForwardThreePrime ? 0 : 1);
+				}
+
+				if (valid) {
+					joins.push_back(std::make_pair((unsigned int) pieces[0], (unsigned int) pieces[1]));
+
+					if (*helixNames[0] != *helixNames[1])
+						++statistics.crossovers;
+				}
+			}
+
+			for (explicit_base_labels_t::const_iterator it(importer.explicitBaseLabels.begin()); it != importer.explicitBaseLabels.end(); ++it) {
+				if (baseIndices.find(it->first) == baseIndices.end())
+					statistics.addDangling("label of base \"" + it->first + "\" which does not exist");
+			}
+
+			for (std::vector< std::pair<std::string, std::string> >::const_iterator it(paintStrands.begin()); it != paintStrands.end(); ++it) {
+				if (importer.helixIndices.find(it->first) == importer.helixIndices.end())
+					statistics.addDangling("painting of helix \"" + it->first + "\" which does not exist");
+				else if (Connection::TypeFromString(it->second.c_str()) == Connection::kNamed && baseIndices.find(it->second) == baseIndices.end())
+					statistics.addDangling("painting of base \"" + it->second + "\" which does not exist");
+			}
+
+			/*
+			 * Helices without bases have no strand pieces, don't count them as strands
+			 */
+
+			size_t emptyPieces(0);
+
+			for (std::vector<Helix>::const_iterator it(importer.helices.begin()); it != importer.helices.end(); ++it) {
+				statistics.bases += size_t(it->bases) * 2;
+
+				if (it->bases == 0)
+					emptyPieces += 2;
+			}
+
+			statistics.helices = numHelices;
+			statistics.bases += importer.explicitBases.size();
+			statistics.strands = ImportStatistics::CountStrands(numHelices * 2 + importer.explicitBases.size(), joins) - emptyPieces;
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus TextBasedImporter::read(const char *filename, int nicking_min_length, int nicking_max_length) {
+			MStatus status;
 			bool autostaple(true); /* ERIK I TESTED changing default ot True */
 			std::vector< std::pair<std::string, std::string> > paintStrands;
 			std::vector<Model::Base> paintStrandBases, disconnectBackwardBases;
 
 			std::vector<Model::Base> nonNickedBases;
 
-			while (file.good()) {
-				std::string line;
-				std::getline(file, line);
-
-				if (sscanf(line.c_str(), "h %s %lf %lf %lf %lf %lf %lf %lf", nameBuffer, &position.x, &position.y, &position.z, &orientation.x, &orientation.y, &orientation.z, &orientation.w) == 8)
-					helices.push_back(Helix(position, orientation, nameBuffer));
-				else if (sscanf(line.c_str(), "hb %s %u %lf %lf %lf %lf %lf %lf %lf", nameBuffer, &bases, &position.x, &position.y, &position.z, &orientation.x, &orientation.y, &orientation.z, &orientation.w) == 9)
-					helices.push_back(Helix(position, orientation, nameBuffer, bases));
-				else if (sscanf(line.c_str(), "b %s %s %lf %lf %lf %s %c", nameBuffer, helixNameBuffer, &position.x, &position.y, &position.z, materialNameBuffer, &label) == 7) {
-					std::vector<TextBasedImporter::Helix>::iterator helix_it(std::find(helices.begin(), helices.end(), helixNameBuffer));
-					explicitBases.push_back(TextBasedImporter::Base(nameBuffer, position, materialNameBuffer, label));
-				}
-				else if (sscanf(line.c_str(), "c %s %s %s %s", helixNameBuffer, nameBuffer, targetHelixNameBuffer, targetNameBuffer) == 4)
-					connections.push_back(Connection(helixNameBuffer, nameBuffer, targetHelixNameBuffer, targetNameBuffer, Connection::TypeFromString(nameBuffer), Connection::TypeFromString(targetNameBuffer)));
-				else if (sscanf(line.c_str(), "l %s %c", nameBuffer, &label) == 2)
-					explicitBaseLabels.insert(std::make_pair(nameBuffer, label));
-				else if (sscanf(line.c_str(), "ps %s %s", helixNameBuffer, nameBuffer) == 2)
-					paintStrands.push_back(std::make_pair(std::string(helixNameBuffer), std::string(nameBuffer)));
-				else if (line == "autostaple" || line == "autonick")
-					autostaple = true;
-			}
+			HMEVALUATE_RETURN(status = parse(filename, autostaple, paintStrands), status);
 
 			// Now create the helices, bases and make the connections.
 			Creator creator;
-#if defined(WIN32) || defined(WIN64)
-			typedef std::unordered_map<std::string, Model::Helix> string_helix_map_t;
-#else
-			typedef std::tr1::unordered_map<std::string, Model::Helix> string_helix_map_t;
-#endif /* N Windows */
 
 			if (!MProgressWindow::reserve())
 				MGlobal::displayWarning("Failed to reserve the progress window");
@@ -131,14 +255,12 @@ namespace Helix {
 			MProgressWindow::setProgressRange(0, int(helices.size()));
 			MProgressWindow::startProgress();
 
-			string_helix_map_t helixStructures;
 			for (std::vector<Helix>::iterator it(helices.begin()); it != helices.end(); ++it) {
-				Model::Helix helix;
+				Model::Helix & helix(it->helix);
 				MTransformationMatrix transform;
 				transform.setTranslation(it->position, MSpace::kTransform);
 				transform.rotateTo(it->orientation);
 				HMEVALUATE_RETURN(status = creator.create(it->bases, transform, helix, it->name.c_str(), false), status);
-				helixStructures.insert(std::make_pair(it->name, helix));
 
 				if (autostaple && it->bases > 1) {
 					Model::Base base;
@@ -188,13 +310,15 @@ namespace Helix {
 				MProgressWindow::startProgress();
 
 				for (std::vector<Base>::iterator it(explicitBases.begin()); it != explicitBases.end(); ++it) {
-					if (helixStructures.find(it->helixName) == helixStructures.end()) {
+					Model::Helix *helix(findHelix(it->helixName));
+
+					if (!helix) {
 						HPRINT("Unable to find Helix structure \"%s\"", it->helixName.c_str());
 						return MStatus::kFailure;
 					}
+
 					Model::Base base;
-					Model::Helix & helix(helixStructures[it->helixName]);
-					HMEVALUATE_RETURN(status = Model::Base::Create(helix, it->name.c_str(), it->position, base), status);
+					HMEVALUATE_RETURN(status = Model::Base::Create(*helix, it->name.c_str(), it->position, base), status);
 					base.setLabel(it->label);
 
 					Model::Material material;
@@ -219,13 +343,14 @@ namespace Helix {
 
 				// Set explicit labels
 				for (explicit_base_labels_t::iterator it(explicitBaseLabels.begin()); it != explicitBaseLabels.end(); ++it) {
-					if (baseStructures.find(it->first) == baseStructures.end()) {
+					string_base_map_t::iterator baseIt(baseStructures.find(it->first));
+
+					if (baseIt == baseStructures.end()) {
 						HPRINT("Unable to find Base structure \"%s\"", it->first.c_str());
 						return MStatus::kFailure;
 					}
 
-					Model::Base & base(baseStructures[it->first]);
-					HMEVALUATE_RETURN(status = base.setLabel(it->second), status);
+					HMEVALUATE_RETURN(status = baseIt->second.setLabel(it->second), status);
 
 					MProgressWindow::advanceProgress(1);
 				}
@@ -243,9 +368,9 @@ namespace Helix {
 				MProgressWindow::startProgress();
 
 				for (std::vector< std::pair<std::string, std::string> >::const_iterator it(paintStrands.begin()); it != paintStrands.end(); ++it) {
-					string_helix_map_t::iterator helixIt(helixStructures.find(it->first));
+					Model::Helix *helix(findHelix(it->first));
 
-					if (helixIt == helixStructures.end()) {
+					if (!helix) {
 						HPRINT("Failed to find helix named \"%s\"", it->first.c_str());
 						return MStatus::kFailure;
 					}
@@ -266,7 +391,7 @@ namespace Helix {
 					}
 						break;
 					default:
-						HMEVALUATE_RETURN(status = getBaseFromConnectionType(helixIt->second, type, base), status);
+						HMEVALUATE_RETURN(status = getBaseFromConnectionType(*helix, type, base), status);
 						break;
 					}
 
@@ -290,18 +415,18 @@ namespace Helix {
 				// Create explicit connections
 				Controller::Connect connect;
 				for (std::vector<Connection>::iterator it(connections.begin()); it != connections.end(); ++it) {
-					if (helixStructures.find(it->fromHelixName) == helixStructures.end()) {
+					Model::Helix *fromHelix(findHelix(it->fromHelixName)), *toHelix(findHelix(it->toHelixName));
+
+					if (!fromHelix) {
 						HPRINT("Failed to find helix named \"%s\"", it->fromHelixName.c_str());
 						return MStatus::kFailure;
 					}
 
-					if (helixStructures.find(it->toHelixName) == helixStructures.end()) {
+					if (!toHelix) {
 						HPRINT("Failed to find helix named \"%s\"", it->toHelixName.c_str());
 						return MStatus::kFailure;
 					}
 
-					Model::Helix & fromHelix(helixStructures[it->fromHelixName]), &toHelix(helixStructures[it->toHelixName]);
-
 					Model::Base fromBase, toBase;
 
 					if (it->fromType == Connection::kNamed) {
@@ -315,7 +440,7 @@ namespace Helix {
 						fromBase = baseIt->second;
 					}
 					else
-						HMEVALUATE_RETURN(status = getBaseFromConnectionType(fromHelix, it->fromType, fromBase), status);
+						HMEVALUATE_RETURN(status = getBaseFromConnectionType(*fromHelix, it->fromType, fromBase), status);
 
 					if (it->toType == Connection::kNamed) {
 						string_base_map_t::iterator baseIt(baseStructures.find(it->toName));
@@ -328,7 +453,7 @@ namespace Helix {
 						toBase = baseIt->second;
 					}
 					else
-						HMEVALUATE_RETURN(status = getBaseFromConnectionType(toHelix, it->toType, toBase), status);
+						HMEVALUATE_RETURN(status = getBaseFromConnectionType(*toHelix, it->toType, toBase), status);
 
 					HMEVALUATE_RETURN(status = connect.connect(fromBase, toBase), status);
 
@@ -386,21 +511,27 @@ namespace Helix {
 				MProgressWindow::setProgressRange(0, int(nonNickedBases.size()));
 				MProgressWindow::startProgress();
 
+				/*
+				 * The strand index labels every base with its strand and ordinal in a single traversal of the scene,
+				 * so grouping is a lookup per base and the offsets along the strand come for free.
+				 * Nothing is nicked until all bases are grouped, thus the index is only built once.
+				 */
+
+				Model::StrandIndex & strandIndex(Model::StrandIndex::Instance());
+				strand_group_map_t strandGroups;
+
 				for (std::vector<Model::Base>::iterator base_it(nonNickedBases.begin()); base_it != nonNickedBases.end(); ++base_it) {
-					Model::Strand strand(*base_it);
-					bool found = false;
-					for (std::vector<non_nicked_strand_t>::iterator it(nonNickedStrands.begin()); it != nonNickedStrands.end(); ++it) {
-						bool contains_base;
-						HMEVALUATE_RETURN(contains_base = it->strand.contains_base(*base_it, status), status);
-						if (contains_base) {
-							//HPRINT("Paired with strand of %s", it->strand.getDefiningBase().getDagPath(status).fullPathName().asChar());
-							it->add_base(*base_it);
-							found = true;
-						}
+					Model::StrandIndex::Entry entry;
+					HMEVALUATE_RETURN(status = strandIndex.find(*base_it, entry), status);
+
+					strand_group_map_t::iterator group_it(strandGroups.find(entry.strand));
+
+					if (group_it == strandGroups.end()) {
+						group_it = strandGroups.insert(std::make_pair(entry.strand, nonNickedStrands.size())).first;
+						nonNickedStrands.push_back(non_nicked_strand_t(entry.strand));
 					}
 
-					if (!found)
-						nonNickedStrands.push_back(non_nicked_strand_t(*base_it));
+					nonNickedStrands[group_it->second].sites.push_back(entry.ordinal);
 
 					MProgressWindow::advanceProgress(1);
 				}
@@ -409,43 +540,35 @@ namespace Helix {
 			}
 
 			if (!nonNickedStrands.empty()) {
+				/*
+				 * The nick sites are chosen among the grouped bases by the Maya independent optimizer, running on all strands in parallel.
+				 * All strands are described before anything is disconnected so the strand index stays valid
+				 */
+
+				const unsigned int maxLength(nicking_max_length > 0 ? (unsigned int) nicking_max_length : DNA::SHORTEST_LONGEST_STAPLE);
+				const unsigned int minLength(std::min(nicking_min_length > 0 ? (unsigned int) nicking_min_length : DNA::SHORTEST_STAPLE, maxLength));
+
+				Model::StrandIndex & strandIndex(Model::StrandIndex::Instance());
+				Controller::NickStrands nickStrands(NickOptimizer::Options(minLength, maxLength));
+
+				for (std::vector<non_nicked_strand_t>::iterator it(nonNickedStrands.begin()); it != nonNickedStrands.end(); ++it)
+					HMEVALUATE_RETURN(status = nickStrands.add(strandIndex.strand(it->strand), it->sites), status);
+
+				std::vector<Model::Base> nickBases;
+				nickStrands.optimize(nickBases);
+
+				HPRINT("Nicking %u non-nicked strands at %u sites, %u of them could not be nicked into staples of %u to %u bases", (unsigned int) nonNickedStrands.size(), (unsigned int) nickBases.size(), (unsigned int) nickStrands.infeasible(), minLength, maxLength);
+
 				if (!MProgressWindow::reserve())
 					MGlobal::displayWarning("Failed to reserve the progress window");
 
 				MProgressWindow::setTitle("Import routed polygon");
 				MProgressWindow::setProgressStatus("Nicking previously non-nicked strands...");
-				MProgressWindow::setProgressRange(0, int(nonNickedStrands.size()));
+				MProgressWindow::setProgressRange(0, int(nickBases.size()));
 				MProgressWindow::startProgress();
 
-				for (std::vector<non_nicked_strand_t>::iterator it(nonNickedStrands.begin()); it != nonNickedStrands.end(); ++it) {
-					it->strand.rewind();
-					unsigned int length(0);
-					for (Model::Strand::ForwardIterator fit(it->strand.forward_begin()); fit != it->strand.forward_end(); ++fit, ++length) {
-						for (std::vector< std::pair<Model::Base, int> >::iterator bit(it->bases.begin()); bit != it->bases.end(); ++bit) {
-							if (bit->first == *fit)
-								bit->second = length;
-						}
-					}
-
-					const int num_nicks(int(std::ceil(double(length) / nicking_max_length)) - 1);
-					HPRINT("Strand %s with length %u, will be nicked %u times.", it->strand.getDefiningBase().getDagPath(status).fullPathName().asChar(), length, num_nicks);
-					for (int i = 0; i < num_nicks; ++i) {
-						const unsigned int offset(i * nicking_max_length);
-
-						std::vector< std::pair<Model::Base, int> >::iterator base_min_iterator(std::min_element(it->bases.begin(), it->bases.end(), base_offset_comparator_t(offset)));
-						{
-							Model::Base & base(base_min_iterator->first);
-							for (std::vector< std::pair<Model::Base, int> >::iterator t_it(it->bases.begin()); t_it != it->bases.end(); ++t_it) {
-								std::cerr << "base: " << t_it->first.getDagPath(status).fullPathName().asChar() << " offset: " << t_it->second << std::endl;
-							}
-							HPRINT("Disconnecting %s at offset: %u", base.getDagPath(status).fullPathName().asChar(), offset);
-							base.disconnect_backward();
-						}
-
-						// Uncomment this to pick nicking sites with replacement.
-						it->bases.erase(base_min_iterator);
-					}
-
+				for (std::vector<Model::Base>::iterator it(nickBases.begin()); it != nickBases.end(); ++it) {
+					HMEVALUATE(status = it->disconnect_backward(), status);
 					MProgressWindow::advanceProgress(1);
 				}
 
@@ -23,18 +23,23 @@
 #include <Duplicate.h>
 #include <FillStrandGaps.h>
 #include <FindFivePrimeEnds.h>
+#include <RepairConstraints.h>
 #include <PaintStrand.h>
 #include <ApplySequence.h>
 #include <ApplySequenceGui.h>
 #include <ExtendStrand.h>
 #include <ExtendGui.h>
 #include <StrandLengthCount.h>
+#include <NickStrands.h>
+#include <OxDnaTrajectory.h>
 #include <ToggleCylinderBaseView.h>
 #include <ToggleLocatorRender.h>
 #include <ToggleShowSuggestedConnections.h>
 #include <ExportStrands.h>
 #include <JSONTranslator.h>
+#include <MeshTranslator.h>
 #include <OxDnaTranslator.h>
+#include <PdbTranslator.h>
 #include <RoutedMeshTranslator.h>
 #include <TextBasedTranslator.h>
 #include <RetargetBase.h>
@@ -49,6 +54,11 @@
 #include <view/ConnectSuggestionsContextCommand.h>
 #include <view/ConnectSuggestionsToolCommand.h>
 
+#include <model/StrandIndex.h>
+#include <model/HelixEndIndex.h>
+#include <model/ChangeTracker.h>
+#include <model/NodeRegistry.h>
+
 #include <maya/MFnPlugin.h>
 #include <maya/MGlobal.h>
 #include <maya/MSelectionList.h>
@@ -60,6 +70,8 @@
 #include <maya/MPlugArray.h>
 #include <maya/MProgressWindow.h>
 #include <maya/MSceneMessage.h>
+#include <maya/MDGMessage.h>
+#include <maya/MNodeMessage.h>
 
 #include <ctime>
 
@@ -70,6 +82,7 @@
 	new RegisterCommand(MEL_DISCONNECTBASE_COMMAND, Helix::Disconnect::creator, Helix::Disconnect::newSyntax),																																										\
 	new RegisterCommand(MEL_DUPLICATEHELICES_COMMAND, Helix::Duplicate::creator, Helix::Duplicate::newSyntax),																																										\
 	new RegisterCommand(MEL_FINDFIVEPRIMEENDS_COMMAND, Helix::FindFivePrimeEnds::creator, Helix::FindFivePrimeEnds::newSyntax),																																						\
+	new RegisterCommand(MEL_REPAIRCONSTRAINTS_COMMAND, Helix::RepairConstraints::creator, Helix::RepairConstraints::newSyntax),																																						\
 	new RegisterCommand(MEL_FILLSTRANDGAPS_COMMAND, Helix::FillStrandGaps::creator, Helix::FillStrandGaps::newSyntax),																																								\
 	new RegisterCommand(MEL_PAINTSTRAND_COMMAND, Helix::PaintStrand::creator, Helix::PaintStrand::newSyntax),																																										\
 	new RegisterCommand(MEL_APPLYSEQUENCE_COMMAND, Helix::ApplySequence::creator, Helix::ApplySequence::newSyntax),																																									\
@@ -80,6 +93,8 @@
 	new RegisterCommand(MEL_TOGGLELOCATORRENDER_COMMAND, Helix::ToggleLocatorRender::creator, Helix::ToggleLocatorRender::newSyntax),																																				\
 	new RegisterCommand(MEL_TOGGLESHOWSUGGESTEDCONNECTIONS_COMMAND, Helix::ToggleShowSuggestedConnections::creator, Helix::ToggleShowSuggestedConnections::newSyntax),																												\
 	new RegisterCommand(MEL_STRANDLENGTHCOUNT_COMMAND, Helix::StrandLengthCount::creator, Helix::StrandLengthCount::newSyntax),																																						\
+	new RegisterCommand(MEL_NICKSTRANDS_COMMAND, Helix::NickStrands::creator, Helix::NickStrands::newSyntax),																																										\
+	new RegisterCommand(MEL_OXDNATRAJECTORY_COMMAND, Helix::OxDnaTrajectory::creator, Helix::OxDnaTrajectory::newSyntax),																																							\
 	new RegisterCommand(MEL_EXPORTSTRANDS_COMMAND, Helix::ExportStrands::creator, Helix::ExportStrands::newSyntax),																																									\
 	new RegisterCommand(MEL_RETARGETBASE_COMMAND, Helix::RetargetBase::creator, Helix::RetargetBase::newSyntax),																																									\
 	new RegisterCommand(MEL_TARGET_HELIXBASE_BACKWARD, Helix::TargetHelixBaseBackward::creator, Helix::TargetHelixBaseBackward::newSyntax),																																			\
@@ -90,7 +105,9 @@
 	new RegisterTransform(HELIX_HELIXBASE_NAME, Helix::HelixBase::id, Helix::HelixBase::creator, Helix::HelixBase::initialize, MPxTransformationMatrix::creator, MPxTransformationMatrix::baseTransformationMatrixId.id()),															\
 	new RegisterTransform(HELIX_HELIX_NAME, Helix::Helix::id, Helix::Helix::creator, Helix::Helix::initialize, MPxTransformationMatrix::creator, MPxTransformationMatrix::baseTransformationMatrixId.id()),																			\
 	new RegisterFileTranslator(HELIX_CADNANO_JSON_FILE_TYPE, Helix::JSONTranslator::creator),																																														\
+	new RegisterFileTranslator(HELIX_MESH_FILE_DESCRIPTION, Helix::MeshTranslator::creator),																																															\
 	new RegisterFileTranslator(HELIX_OXDNA_FILE_TYPE, Helix::OxDnaTranslator::creator),																																																\
+	new RegisterFileTranslator(HELIX_PDB_FILE_DESCRIPTION, Helix::PdbTranslator::creator),																																																\
 	new RegisterFileTranslator(HELIX_ROUTED_MESH_FILE_TYPE, Helix::RoutedMeshTranslator::creator),																																													\
 	new RegisterFileTranslator(HELIX_TEXT_BASED_FILE_DESCRIPTION, Helix::TextBasedTranslator::creator),																																												\
 	new RegisterShape(BASE_SHAPE_NAME, Helix::View::BaseShape::id, Helix::View::BaseShape::creator, Helix::View::BaseShape::initialize, Helix::View::BaseShapeUI::creator),																											\
@@ -387,7 +404,12 @@ enum {
 	ACCEL_SHIFT = 4
 };
 
-MCallbackId g_afterImport_CallbackId, g_afterOpen_CallbackId;
+MCallbackId g_afterImport_CallbackId, g_afterOpen_CallbackId, g_beforeImport_CallbackId, g_beforeOpen_CallbackId;
+MCallbackId g_strandIndexConnection_CallbackId, g_strandIndexNodeAdded_CallbackId, g_strandIndexNodeRemoved_CallbackId, g_strandIndexAfterNew_CallbackId;
+MCallbackId g_registryNodeAdded_CallbackId[2], g_registryNodeRemoved_CallbackId[2];
+MCallbackId g_helixEndIndexConnection_CallbackId, g_helixEndIndexBaseRemoved_CallbackId, g_helixEndIndexHelixRemoved_CallbackId, g_helixEndIndexAfterNew_CallbackId;
+MCallbackId g_changeTrackerConnection_CallbackId, g_changeTrackerBaseRemoved_CallbackId, g_changeTrackerHelixRemoved_CallbackId, g_changeTrackerNameChanged_CallbackId, g_changeTrackerAfterNew_CallbackId, g_changeTrackerAfterOpen_CallbackId;
+MCallbackId g_oxDnaTrajectoryTimeChange_CallbackId, g_oxDnaTrajectoryBeforeNew_CallbackId, g_oxDnaTrajectoryBeforeOpen_CallbackId;
 
 MLL_EXPORT MStatus initializePlugin(MObject obj) {
 	MStatus status;
@@ -510,9 +532,24 @@ MLL_EXPORT MStatus initializePlugin(MObject obj) {
 	}
 
 	/*
-	 * There seems to be a bug with newly opened/imported files that their aimConstraints fails to retarget the bases. Thus we have to manually try to solve it after a file has been opened/imported
+	 * There seems to be a bug with newly opened/imported files that their aimConstraints fails to retarget the bases. Thus we have to manually try to solve it after a file has been opened/imported.
+	 * The repair itself is deferred to the repairConstraints command, see RepairConstraints.h
 	 */
 
+	g_beforeImport_CallbackId = MSceneMessage::addCallback(MSceneMessage::kBeforeImport, &Helix::RepairConstraints::MSceneMessage_BeforeRead_CallbackFunc, NULL, &status);
+
+	if (!status) {
+		status.perror("MSceneMessage::addCallback(MSceneMessage::kBeforeImport, ...)");
+		return status;
+	}
+
+	g_beforeOpen_CallbackId = MSceneMessage::addCallback(MSceneMessage::kBeforeOpen, &Helix::RepairConstraints::MSceneMessage_BeforeRead_CallbackFunc, NULL, &status);
+
+	if (!status) {
+		status.perror("MSceneMessage::addCallback(MSceneMessage::kBeforeOpen, ...)");
+		return status;
+	}
+
 	g_afterImport_CallbackId = MSceneMessage::addCallback(MSceneMessage::kAfterImport, &Helix::MSceneMessage_AfterImportOpen_CallbackFunc, NULL, &status);
 
 	if (!status) {
@@ -527,6 +564,165 @@ MLL_EXPORT MStatus initializePlugin(MObject obj) {
 		return status;
 	}
 
+	/*
+	 * Track all helices and bases in the scene
+	 */
+
+	{
+		const char *nodeTypes[] = { HELIX_HELIX_NAME, HELIX_HELIXBASE_NAME };
+
+		for (size_t i = 0; i < 2; ++i) {
+			g_registryNodeAdded_CallbackId[i] = MDGMessage::addNodeAddedCallback(&Helix::Model::NodeRegistry::MDGMessage_NodeAdded_CallbackFunc, nodeTypes[i], NULL, &status);
+
+			if (!status) {
+				status.perror("MDGMessage::addNodeAddedCallback");
+				return status;
+			}
+
+			g_registryNodeRemoved_CallbackId[i] = MDGMessage::addNodeRemovedCallback(&Helix::Model::NodeRegistry::MDGMessage_NodeRemoved_CallbackFunc, nodeTypes[i], NULL, &status);
+
+			if (!status) {
+				status.perror("MDGMessage::addNodeRemovedCallback");
+				return status;
+			}
+		}
+	}
+
+	/*
+	 * The strand index is rebuilt lazily, these only mark it as dirty
+	 */
+
+	g_strandIndexConnection_CallbackId = MDGMessage::addConnectionCallback(&Helix::Model::StrandIndex::MDGMessage_Connection_CallbackFunc, NULL, &status);
+
+	if (!status) {
+		status.perror("MDGMessage::addConnectionCallback");
+		return status;
+	}
+
+	g_strandIndexNodeAdded_CallbackId = MDGMessage::addNodeAddedCallback(&Helix::Model::StrandIndex::MDGMessage_NodeAddedRemoved_CallbackFunc, HELIX_HELIXBASE_NAME, NULL, &status);
+
+	if (!status) {
+		status.perror("MDGMessage::addNodeAddedCallback");
+		return status;
+	}
+
+	g_strandIndexNodeRemoved_CallbackId = MDGMessage::addNodeRemovedCallback(&Helix::Model::StrandIndex::MDGMessage_NodeAddedRemoved_CallbackFunc, HELIX_HELIXBASE_NAME, NULL, &status);
+
+	if (!status) {
+		status.perror("MDGMessage::addNodeRemovedCallback");
+		return status;
+	}
+
+	g_strandIndexAfterNew_CallbackId = MSceneMessage::addCallback(MSceneMessage::kAfterNew, &Helix::Model::StrandIndex::MSceneMessage_Invalidate_CallbackFunc, NULL, &status);
+
+	if (!status) {
+		status.perror("MSceneMessage::addCallback(MSceneMessage::kAfterNew, ...)");
+		return status;
+	}
+
+	/*
+	 * The end bases of the helices are reevaluated per base on changes
+	 */
+
+	g_helixEndIndexConnection_CallbackId = MDGMessage::addConnectionCallback(&Helix::Model::HelixEndIndex::MDGMessage_Connection_CallbackFunc, NULL, &status);
+
+	if (!status) {
+		status.perror("MDGMessage::addConnectionCallback");
+		return status;
+	}
+
+	g_helixEndIndexBaseRemoved_CallbackId = MDGMessage::addNodeRemovedCallback(&Helix::Model::HelixEndIndex::MDGMessage_NodeAddedRemoved_CallbackFunc, HELIX_HELIXBASE_NAME, NULL, &status);
+
+	if (!status) {
+		status.perror("MDGMessage::addNodeRemovedCallback");
+		return status;
+	}
+
+	g_helixEndIndexHelixRemoved_CallbackId = MDGMessage::addNodeRemovedCallback(&Helix::Model::HelixEndIndex::MDGMessage_NodeAddedRemoved_CallbackFunc, HELIX_HELIX_NAME, NULL, &status);
+
+	if (!status) {
+		status.perror("MDGMessage::addNodeRemovedCallback");
+		return status;
+	}
+
+	g_helixEndIndexAfterNew_CallbackId = MSceneMessage::addCallback(MSceneMessage::kAfterNew, &Helix::Model::HelixEndIndex::MSceneMessage_Clear_CallbackFunc, NULL, &status);
+
+	if (!status) {
+		status.perror("MSceneMessage::addCallback(MSceneMessage::kAfterNew, ...)");
+		return status;
+	}
+
+	/*
+	 * Changes to the bases and helices are tracked for the incremental exports
+	 */
+
+	g_changeTrackerConnection_CallbackId = MDGMessage::addConnectionCallback(&Helix::Model::ChangeTracker::MDGMessage_Connection_CallbackFunc, NULL, &status);
+
+	if (!status) {
+		status.perror("MDGMessage::addConnectionCallback");
+		return status;
+	}
+
+	g_changeTrackerBaseRemoved_CallbackId = MDGMessage::addNodeRemovedCallback(&Helix::Model::ChangeTracker::MDGMessage_NodeRemoved_CallbackFunc, HELIX_HELIXBASE_NAME, NULL, &status);
+
+	if (!status) {
+		status.perror("MDGMessage::addNodeRemovedCallback");
+		return status;
+	}
+
+	g_changeTrackerHelixRemoved_CallbackId = MDGMessage::addNodeRemovedCallback(&Helix::Model::ChangeTracker::MDGMessage_NodeRemoved_CallbackFunc, HELIX_HELIX_NAME, NULL, &status);
+
+	if (!status) {
+		status.perror("MDGMessage::addNodeRemovedCallback");
+		return status;
+	}
+
+	g_changeTrackerNameChanged_CallbackId = MNodeMessage::addNameChangedCallback(MObject::kNullObj, &Helix::Model::ChangeTracker::MNodeMessage_NameChanged_CallbackFunc, NULL, &status);
+
+	if (!status) {
+		status.perror("MNodeMessage::addNameChangedCallback");
+		return status;
+	}
+
+	g_changeTrackerAfterNew_CallbackId = MSceneMessage::addCallback(MSceneMessage::kAfterNew, &Helix::Model::ChangeTracker::MSceneMessage_Clear_CallbackFunc, NULL, &status);
+
+	if (!status) {
+		status.perror("MSceneMessage::addCallback(MSceneMessage::kAfterNew, ...)");
+		return status;
+	}
+
+	g_changeTrackerAfterOpen_CallbackId = MSceneMessage::addCallback(MSceneMessage::kAfterOpen, &Helix::Model::ChangeTracker::MSceneMessage_Clear_CallbackFunc, NULL, &status);
+
+	if (!status) {
+		status.perror("MSceneMessage::addCallback(MSceneMessage::kAfterOpen, ...)");
+		return status;
+	}
+
+	/*
+	 * oxDNA trajectories follow the time slider and are detached when the scene is replaced
+	 */
+
+	g_oxDnaTrajectoryTimeChange_CallbackId = MDGMessage::addTimeChangeCallback(&Helix::OxDnaTrajectory::MDGMessage_TimeChange_CallbackFunc, NULL, &status);
+
+	if (!status) {
+		status.perror("MDGMessage::addTimeChangeCallback");
+		return status;
+	}
+
+	g_oxDnaTrajectoryBeforeNew_CallbackId = MSceneMessage::addCallback(MSceneMessage::kBeforeNew, &Helix::OxDnaTrajectory::MSceneMessage_Unload_CallbackFunc, NULL, &status);
+
+	if (!status) {
+		status.perror("MSceneMessage::addCallback(MSceneMessage::kBeforeNew, ...)");
+		return status;
+	}
+
+	g_oxDnaTrajectoryBeforeOpen_CallbackId = MSceneMessage::addCallback(MSceneMessage::kBeforeOpen, &Helix::OxDnaTrajectory::MSceneMessage_Unload_CallbackFunc, NULL, &status);
+
+	if (!status) {
+		status.perror("MSceneMessage::addCallback(MSceneMessage::kBeforeOpen, ...)");
+		return status;
+	}
+
 	MProgressWindow::endProgress();
 
 	return MStatus::kSuccess;
@@ -557,6 +753,33 @@ MLL_EXPORT MStatus uninitializePlugin(MObject obj)
 			MProgressWindow::advanceProgress(1);
 		}*/
 
+		for (size_t i = 0; i < 2; ++i) {
+			MMessage::removeCallback(g_registryNodeAdded_CallbackId[i]);
+			MMessage::removeCallback(g_registryNodeRemoved_CallbackId[i]);
+		}
+
+		MMessage::removeCallback(g_beforeImport_CallbackId);
+		MMessage::removeCallback(g_beforeOpen_CallbackId);
+		MMessage::removeCallback(g_strandIndexConnection_CallbackId);
+		MMessage::removeCallback(g_strandIndexNodeAdded_CallbackId);
+		MMessage::removeCallback(g_strandIndexNodeRemoved_CallbackId);
+		MMessage::removeCallback(g_strandIndexAfterNew_CallbackId);
+		MMessage::removeCallback(g_helixEndIndexConnection_CallbackId);
+		MMessage::removeCallback(g_helixEndIndexBaseRemoved_CallbackId);
+		MMessage::removeCallback(g_helixEndIndexHelixRemoved_CallbackId);
+		MMessage::removeCallback(g_helixEndIndexAfterNew_CallbackId);
+		MMessage::removeCallback(g_changeTrackerConnection_CallbackId);
+		MMessage::removeCallback(g_changeTrackerBaseRemoved_CallbackId);
+		MMessage::removeCallback(g_changeTrackerHelixRemoved_CallbackId);
+		MMessage::removeCallback(g_changeTrackerNameChanged_CallbackId);
+		MMessage::removeCallback(g_changeTrackerAfterNew_CallbackId);
+		MMessage::removeCallback(g_changeTrackerAfterOpen_CallbackId);
+		MMessage::removeCallback(g_oxDnaTrajectoryTimeChange_CallbackId);
+		MMessage::removeCallback(g_oxDnaTrajectoryBeforeNew_CallbackId);
+		MMessage::removeCallback(g_oxDnaTrajectoryBeforeOpen_CallbackId);
+
+		Helix::OxDnaTrajectory::Unload();
+
 		MGlobal::executeCommand(MString(MEL_DEREGISTER_MENU_COMMAND " \"") + g_menuName + "\"", false);
 
 		return MStatus::kSuccess;
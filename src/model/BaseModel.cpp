@@ -7,6 +7,7 @@
 
 #include <model/Base.h>
 #include <model/Helix.h>
+#include <model/NodeRegistry.h>
 #include <view/BaseShape.h>
 #include <view/HelixShape.h>
 
@@ -126,6 +127,10 @@ namespace Helix {
 			return GetSelectedObjectsOfType(selectedBases, ::Helix::HelixBase::id);
 		}
 
+		MStatus Base::All(MObjectArray & bases) {
+			return NodeRegistry::Instance().bases(bases);
+		}
+
 		MStatus Base::setMaterial(const Material & material) {
 			if (material.getMaterial().length() == 0)
 				return MStatus::kSuccess;
@@ -0,0 +1,82 @@
+/*
+ * ChangeTrackerModel.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <model/ChangeTracker.h>
+
+#include <Helix.h>
+#include <HelixBase.h>
+
+#include <maya/MFnDagNode.h>
+#include <maya/MFnDependencyNode.h>
+
+namespace Helix {
+	namespace Model {
+		ChangeTracker & ChangeTracker::Instance() {
+			static ChangeTracker tracker;
+			return tracker;
+		}
+
+		void ChangeTracker::clear() {
+			m_revisions.clear();
+			m_cleared = ++m_revision;
+		}
+
+		void ChangeTracker::touchNode(const MObject & node) {
+			MStatus status;
+
+			if (node.hasFn(MFn::kShape)) {
+				MFnDagNode dagNode(node, &status);
+
+				if (!status || dagNode.parentCount() == 0)
+					return;
+
+				MObject parent = dagNode.parent(0, &status);
+
+				if (status && MFnDependencyNode(parent).typeId() == HelixBase::id)
+					touch(parent);
+
+				return;
+			}
+
+			if (!node.hasFn(MFn::kTransform))
+				return;
+
+			const MTypeId typeId = MFnDependencyNode(node).typeId(&status);
+
+			if (status && (typeId == HelixBase::id || typeId == ::Helix::Helix::id))
+				touch(node);
+		}
+
+		void ChangeTracker::MDGMessage_Connection_CallbackFunc(MPlug & srcPlug, MPlug & destPlug, bool made, void *clientData) {
+			/*
+			 * Besides the forward, backward and label connections, this catches materials being assigned, which connects the shape of the base
+			 */
+
+			Instance().touchNode(srcPlug.node());
+			Instance().touchNode(destPlug.node());
+		}
+
+		void ChangeTracker::MDGMessage_NodeRemoved_CallbackFunc(MObject & node, void *clientData) {
+			Instance().m_revisions.erase(MObjectHandle(node));
+		}
+
+		void ChangeTracker::MNodeMessage_NameChanged_CallbackFunc(MObject & node, const MString & previousName, void *clientData) {
+			/*
+			 * The material names are exported too, they're not worth tracking per base
+			 */
+
+			if (node.hasFn(MFn::kShadingEngine))
+				Instance().clear();
+			else
+				Instance().touchNode(node);
+		}
+
+		void ChangeTracker::MSceneMessage_Clear_CallbackFunc(void *clientData) {
+			Instance().clear();
+		}
+	}
+}
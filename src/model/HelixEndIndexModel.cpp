@@ -0,0 +1,170 @@
+/*
+ * HelixEndIndex.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <model/HelixEndIndex.h>
+
+#include <Helix.h>
+#include <HelixBase.h>
+#include <Utility.h>
+
+#include <maya/MFnDagNode.h>
+#include <maya/MObjectHandle.h>
+
+#include <algorithm>
+
+namespace Helix {
+	namespace Model {
+		/*
+		 * Helpers for keeping the end base arrays sorted
+		 */
+
+		class less_z {
+		public:
+			inline bool operator() (const std::pair<Base, double> & p1, const std::pair<Base, double> & p2) const {
+				return p1.second < p2.second;
+			}
+		};
+
+		class equals_first {
+		public:
+			inline equals_first(const Base & base) : m_base(base) { }
+
+			inline bool operator() (const std::pair<Base, double> & p) const {
+				return p.first == m_base;
+			}
+
+		private:
+			const Base & m_base;
+		};
+
+		HelixEndIndex & HelixEndIndex::Instance() {
+			static HelixEndIndex index;
+			return index;
+		}
+
+		MStatus HelixEndIndex::find(Helix & helix, Base::Type type, bool largestZ, Base & base) {
+			MStatus status;
+			helix_ends_map_t::iterator it = m_helices.find(helix);
+
+			if (it == m_helices.end()) {
+				it = m_helices.insert(std::make_pair(helix, Ends())).first;
+
+				if (!(status = build(helix, it->second))) {
+					m_helices.erase(it);
+					HMEVALUATE_RETURN_DESCRIPTION("HelixEndIndex::build", status);
+				}
+			}
+			else
+				HMEVALUATE_RETURN(status = update(helix, it->second), status);
+
+			const end_bases_t & bases = type == Base::FIVE_PRIME_END ? it->second.fivePrime : it->second.threePrime;
+
+			if (bases.empty())
+				return MStatus::kNotFound;
+
+			base = largestZ ? bases.back().first : bases.front().first;
+
+			return MStatus::kSuccess;
+		}
+
+		void HelixEndIndex::invalidate(const MObject & base) {
+			if (m_helices.empty())
+				return;
+
+			MStatus status;
+			MFnDagNode dagNode(base);
+
+			if (dagNode.parentCount(&status) == 0)
+				return;
+
+			helix_ends_map_t::iterator it = m_helices.find(Helix(dagNode.parent(0, &status)));
+
+			if (it != m_helices.end())
+				it->second.pending.insert(Base(base));
+		}
+
+		MStatus HelixEndIndex::build(Helix & helix, Ends & ends) {
+			MStatus status;
+
+			for (Helix::BaseIterator it = helix.begin(); it != helix.end(); ++it)
+				HMEVALUATE_RETURN(status = insert(*it, ends), status);
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus HelixEndIndex::update(Helix & helix, Ends & ends) {
+			MStatus status;
+
+			for (base_set_t::const_iterator it = ends.pending.begin(); it != ends.pending.end(); ++it) {
+				ends.fivePrime.erase(std::remove_if(ends.fivePrime.begin(), ends.fivePrime.end(), equals_first(*it)), ends.fivePrime.end());
+				ends.threePrime.erase(std::remove_if(ends.threePrime.begin(), ends.threePrime.end(), equals_first(*it)), ends.threePrime.end());
+
+				Base base(*it);
+				MObject object = base.getObject(status);
+
+				/*
+				 * The base might have been deleted or moved to another helix since it was queued
+				 */
+
+				if (!status || !MObjectHandle(object).isValid())
+					continue;
+
+				MFnDagNode dagNode(object);
+
+				if (dagNode.parentCount() == 0 || !(helix == dagNode.parent(0)))
+					continue;
+
+				HMEVALUATE_RETURN(status = insert(base, ends), status);
+			}
+
+			ends.pending.clear();
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus HelixEndIndex::insert(Base & base, Ends & ends) {
+			MStatus status;
+			const Base::Type type = base.type(status);
+			HMEVALUATE_RETURN_DESCRIPTION("Base::type", status);
+
+			if (type != Base::FIVE_PRIME_END && type != Base::THREE_PRIME_END)
+				return MStatus::kSuccess;
+
+			MVector translation;
+			HMEVALUATE_RETURN(status = base.getTranslation(translation, MSpace::kTransform), status);
+
+			end_bases_t & bases = type == Base::FIVE_PRIME_END ? ends.fivePrime : ends.threePrime;
+			const std::pair<Base, double> element(base, translation.z);
+			bases.insert(std::upper_bound(bases.begin(), bases.end(), element, less_z()), element);
+
+			return MStatus::kSuccess;
+		}
+
+		void HelixEndIndex::MDGMessage_Connection_CallbackFunc(MPlug & srcPlug, MPlug & destPlug, bool made, void *clientData) {
+			const MObject srcAttribute = srcPlug.attribute(), destAttribute = destPlug.attribute();
+
+			if (srcAttribute == HelixBase::aForward || srcAttribute == HelixBase::aBackward)
+				Instance().invalidate(srcPlug.node());
+
+			if (destAttribute == HelixBase::aForward || destAttribute == HelixBase::aBackward)
+				Instance().invalidate(destPlug.node());
+		}
+
+		void HelixEndIndex::MDGMessage_NodeAddedRemoved_CallbackFunc(MObject & node, void *clientData) {
+			MStatus status;
+
+			if (MFnDagNode(node).typeId(&status) == ::Helix::Helix::id)
+				Instance().m_helices.erase(Helix(node));
+			else
+				Instance().invalidate(node);
+		}
+
+		void HelixEndIndex::MSceneMessage_Clear_CallbackFunc(void *clientData) {
+			Instance().clear();
+		}
+	}
+}
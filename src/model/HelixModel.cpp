@@ -7,13 +7,14 @@
 
 #include <model/Helix.h>
 #include <model/Base.h>
+#include <model/HelixEndIndex.h>
+#include <model/NodeRegistry.h>
 #include <view/HelixShape.h>
 
 #include <maya/MFnDagNode.h>
 #include <maya/MFnDependencyNode.h>
 #include <maya/MGlobal.h>
 #include <maya/MPlugArray.h>
-#include <maya/MItDag.h>
 
 #include <Helix.h>
 #include <HelixBase.h>
@@ -852,28 +853,7 @@ namespace Helix {
 		}
 
 		MStatus Helix::All(MObjectArray & helices) {
-			MStatus status;
-			MItDag dagIt(MItDag::kBreadthFirst, MFn::kTransform, &status);
-			HMEVALUATE_RETURN_DESCRIPTION("MItDag::#ctor", status);
-
-			if (!status) {
-				status.perror("MItDag::#ctor");
-				return status;
-			}
-
-			for(; !dagIt.isDone(); dagIt.next()) {
-				MObject obj;
-				HMEVALUATE_RETURN(obj = dagIt.currentItem(&status), status);
-
-
-				MFnDagNode dagNode(obj);
-
-				if (dagNode.typeId(&status) == ::Helix::Helix::id) {
-					HMEVALUATE_RETURN(status = helices.append(obj), status);
-				}
-			}
-
-			return MStatus::kSuccess;
+			return NodeRegistry::Instance().helices(helices);
 		}
 
 		/*
@@ -1141,100 +1121,20 @@ namespace Helix {
 			return helix_dagNode.childCount(&status);
 		}
 
-		/*
-		 * Helper for min_element below
-		 */
-
-		template<typename PairT>
-		class less_select2nd {
-		public:
-			inline bool operator() (const PairT & p1, const PairT & p2) const {
-				return p1.second < p2.second;
-			}
-		};
-
-		/*
-		 * Helper for search
-		 */
-		template<Base::Type Type, typename ContainerT>
-		MStatus GetBaseAndZCoordinateOfBaseType(Helix::BaseIterator begin, Helix::BaseIterator end, ContainerT & bases) {
-			MStatus status;
-
-			for(Helix::BaseIterator it = begin; it != end; ++it) {
-				if (it->type(status) == Type) {
-					MVector translation;
-
-					if (!(status = it->getTranslation(translation, MSpace::kTransform))) {
-						status.perror("Base::getTranslation");
-						return status;
-					}
-
-					bases.push_back(std::make_pair(*it, translation.z));
-				}
-
-				if (!status) {
-					status.perror("Base::type");
-					return status;
-				}
-			}
-
-			return MStatus::kSuccess;
-		}
-
 		MStatus Helix::getForwardThreePrime(Model::Base & base) {
-			MStatus status;
-			std::list< std::pair<Base, double> > bases;
-
-			if (!(status = GetBaseAndZCoordinateOfBaseType<Base::THREE_PRIME_END>(begin(), end(), bases))) {
-				status.perror("GetBaseAndZCoordinateOfBaseType");
-				return status;
-			}
-
-			base = std::max_element(bases.begin(), bases.end(), less_select2nd< std::pair<Base, double> > ())->first;
-
-			return MStatus::kSuccess;
+			return HelixEndIndex::Instance().find(*this, Base::THREE_PRIME_END, true, base);
 		}
 
 		MStatus Helix::getForwardFivePrime(Model::Base & base) {
-			MStatus status;
-			std::list< std::pair<Base, double> > bases;
-
-			if (!(status = GetBaseAndZCoordinateOfBaseType<Base::FIVE_PRIME_END>(begin(), end(), bases))) {
-				status.perror("GetBaseAndZCoordinateOfBaseType");
-				return status;
-			}
-
-			base = std::min_element(bases.begin(), bases.end(), less_select2nd< std::pair<Base, double> > ())->first;
-
-			return MStatus::kSuccess;
+			return HelixEndIndex::Instance().find(*this, Base::FIVE_PRIME_END, false, base);
 		}
 
 		MStatus Helix::getBackwardThreePrime(Model::Base & base) {
-			MStatus status;
-			std::list< std::pair<Base, double> > bases;
-
-			if (!(status = GetBaseAndZCoordinateOfBaseType<Base::THREE_PRIME_END>(begin(), end(), bases))) {
-				status.perror("GetBaseAndZCoordinateOfBaseType");
-				return status;
-			}
-
-			base = std::min_element(bases.begin(), bases.end(), less_select2nd< std::pair<Base, double> > ())->first;
-
-			return MStatus::kSuccess;
+			return HelixEndIndex::Instance().find(*this, Base::THREE_PRIME_END, false, base);
 		}
 
 		MStatus Helix::getBackwardFivePrime(Model::Base & base) {
-			MStatus status;
-			std::list< std::pair<Base, double> > bases;
-
-			if (!(status = GetBaseAndZCoordinateOfBaseType<Base::FIVE_PRIME_END>(begin(), end(), bases))) {
-				status.perror("GetBaseAndZCoordinateOfBaseType");
-				return status;
-			}
-
-			base = std::max_element(bases.begin(), bases.end(), less_select2nd< std::pair<Base, double> > ())->first;
-
-			return MStatus::kSuccess;
+			return HelixEndIndex::Instance().find(*this, Base::FIVE_PRIME_END, true, base);
 		}
 	}
 }
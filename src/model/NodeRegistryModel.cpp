@@ -0,0 +1,102 @@
+/*
+ * NodeRegistry.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <model/NodeRegistry.h>
+
+#include <Helix.h>
+#include <HelixBase.h>
+#include <Utility.h>
+
+#include <maya/MFnDependencyNode.h>
+
+namespace Helix {
+	namespace Model {
+		NodeRegistry & NodeRegistry::Instance() {
+			static NodeRegistry registry;
+			return registry;
+		}
+
+		MStatus NodeRegistry::helices(MObjectArray & helices) const {
+			return m_helices.append(helices);
+		}
+
+		MStatus NodeRegistry::bases(MObjectArray & bases) const {
+			return m_bases.append(bases);
+		}
+
+		void NodeRegistry::NodeSet::insert(const MObject & node) {
+			const MObjectHandle handle(node);
+
+			if (indices.find(handle) != indices.end())
+				return;
+
+			indices.insert(std::make_pair(handle, nodes.size()));
+			nodes.push_back(handle);
+		}
+
+		void NodeRegistry::NodeSet::erase(const MObject & node) {
+			const MObjectHandle handle(node);
+			std::vector<MObjectHandle>::size_type index;
+
+			{
+#if defined(WIN32) || defined(WIN64)
+				std::unordered_map<MObjectHandle, size_t, ObjectHandleHash>::iterator it = indices.find(handle);
+#else
+				std::tr1::unordered_map<MObjectHandle, size_t, ObjectHandleHash>::iterator it = indices.find(handle);
+#endif /* N Windows */
+
+				if (it == indices.end())
+					return;
+
+				index = it->second;
+				indices.erase(it);
+			}
+
+			/*
+			 * Move the last node into the removed slot
+			 */
+
+			if (index != nodes.size() - 1) {
+				nodes[index] = nodes.back();
+				indices[nodes[index]] = index;
+			}
+
+			nodes.pop_back();
+		}
+
+		MStatus NodeRegistry::NodeSet::append(MObjectArray & array) const {
+			MStatus status;
+
+			for (std::vector<MObjectHandle>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+				if (it->isValid())
+					HMEVALUATE_RETURN(status = array.append(it->objectRef()), status);
+			}
+
+			return MStatus::kSuccess;
+		}
+
+		void NodeRegistry::MDGMessage_NodeAdded_CallbackFunc(MObject & node, void *clientData) {
+			MStatus status;
+			const MTypeId typeId = MFnDependencyNode(node).typeId(&status);
+
+			if (typeId == ::Helix::Helix::id)
+				Instance().m_helices.insert(node);
+			else if (typeId == HelixBase::id)
+				Instance().m_bases.insert(node);
+		}
+
+		void NodeRegistry::MDGMessage_NodeRemoved_CallbackFunc(MObject & node, void *clientData) {
+			MStatus status;
+			const MTypeId typeId = MFnDependencyNode(node).typeId(&status);
+
+			if (typeId == ::Helix::Helix::id)
+				Instance().m_helices.erase(node);
+			else if (typeId == HelixBase::id)
+				Instance().m_bases.erase(node);
+		}
+	}
+}
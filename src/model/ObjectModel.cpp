@@ -12,6 +12,8 @@
 #include <maya/MVector.h>
 #include <maya/MPlug.h>
 
+#include <cstring>
+
 namespace Helix {
 	namespace Model {
 		MObject Object::getObject(MStatus & status) const {
@@ -23,14 +25,13 @@ namespace Helix {
 					return MObject::kNullObj;
 				}
 
-				MObject object = m_dagPath.node(&status);
+				m_object = m_dagPath.node(&status);
 				
 				if (!status) {
 					status.perror("MDagPath::node");
+					m_object = MObject::kNullObj;
 					return MObject::kNullObj;
 				}
-
-				return object;
 			}
 
 			return m_object;
@@ -105,6 +106,23 @@ namespace Helix {
 			return MDagPath::getAPathTo(m_object, m_dagPath);
 		}
 
+		bool Object::operator<(const Object & object) const {
+			const unsigned int thisHashCode = hashCode(), targetHashCode = object.hashCode();
+
+			if (thisHashCode != targetHashCode)
+				return thisHashCode < targetHashCode;
+
+			if (*this == object)
+				return false;
+
+			/*
+			 * Hash collision between two different nodes, the full path names are unique
+			 */
+
+			MStatus status;
+			return strcmp(getDagPath(status).fullPathName().asChar(), object.getDagPath(status).fullPathName().asChar()) < 0;
+		}
+
 		MStatus Object::getTransform(MTransformationMatrix & matrix) {
 			MStatus status;
 
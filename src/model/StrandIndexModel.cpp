@@ -0,0 +1,142 @@
+/*
+ * StrandIndex.cpp
+ *
+ *  Created on: 18 oct 2026
+ *      Author: johan
+ */
+
+#include <model/StrandIndex.h>
+
+#include <HelixBase.h>
+#include <Utility.h>
+
+namespace Helix {
+	namespace Model {
+		StrandIndex & StrandIndex::Instance() {
+			static StrandIndex index;
+			return index;
+		}
+
+		StrandIndex::iterator StrandIndex::begin() {
+			MStatus status;
+			HMEVALUATE(status = validate(), status);
+			return m_strands.begin();
+		}
+
+		StrandIndex::iterator StrandIndex::end() {
+			MStatus status;
+			HMEVALUATE(status = validate(), status);
+			return m_strands.end();
+		}
+
+		size_t StrandIndex::size() {
+			MStatus status;
+			HMEVALUATE(status = validate(), status);
+			return m_strands.size();
+		}
+
+		MStatus StrandIndex::find(const Base & base, Entry & entry) {
+			MStatus status;
+			HMEVALUATE_RETURN(status = validate(), status);
+
+			MObject object = base.getObject(status);
+			HMEVALUATE_RETURN_DESCRIPTION("Base::getObject", status);
+
+			const MObjectHandle handle(object);
+
+			if (!handle.isValid())
+				return MStatus::kNotFound;
+
+			base_entry_map_t::const_iterator it = m_entries.find(handle);
+
+			/*
+			 * New bases invalidate the index through the node added callback, so a base that is still unknown is not in the scene
+			 */
+
+			if (it == m_entries.end())
+				return MStatus::kNotFound;
+
+			entry = it->second;
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus StrandIndex::find(const Base & base, Strand * & strand) {
+			MStatus status;
+			Entry entry;
+
+			if (!(status = find(base, entry)))
+				return status;
+
+			strand = &m_strands[entry.strand];
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus StrandIndex::validate() {
+			if (!m_dirty)
+				return MStatus::kSuccess;
+
+			MStatus status;
+			HMEVALUATE_RETURN(status = rebuild(), status);
+			m_dirty = false;
+
+			return MStatus::kSuccess;
+		}
+
+		MStatus StrandIndex::rebuild() {
+			MStatus status;
+
+			m_strands.clear();
+			m_entries.clear();
+
+			MObjectArray bases;
+			HMEVALUATE_RETURN(status = Base::All(bases), status);
+
+			for (unsigned int i = 0; i < bases.length(); ++i) {
+				const MObject & object = bases[i];
+
+				if (m_entries.find(MObjectHandle(object)) != m_entries.end())
+					continue;
+
+				/*
+				 * A new strand. Rewind to the 5' end and store all of its bases in order
+				 */
+
+				Model::Strand strand(object);
+				strand.rewind();
+
+				const unsigned int strandIndex = (unsigned int) m_strands.size();
+				m_strands.push_back(Strand());
+				Strand & record = m_strands.back();
+
+				Model::Strand::ForwardIterator it = strand.forward_begin();
+				for (; it != strand.forward_end(); ++it) {
+					Entry entry = { strandIndex, (unsigned int) record.bases.size() };
+					m_entries.insert(std::make_pair(MObjectHandle(it->getObject(status)), entry));
+					record.bases.push_back(*it);
+				}
+
+				record.circular = it.loop();
+			}
+
+			return MStatus::kSuccess;
+		}
+
+		void StrandIndex::MDGMessage_Connection_CallbackFunc(MPlug & srcPlug, MPlug & destPlug, bool made, void *clientData) {
+			const MObject srcAttribute = srcPlug.attribute(), destAttribute = destPlug.attribute();
+
+			if (srcAttribute == HelixBase::aForward || srcAttribute == HelixBase::aBackward ||
+				destAttribute == HelixBase::aForward || destAttribute == HelixBase::aBackward)
+				Instance().invalidate();
+		}
+
+		void StrandIndex::MDGMessage_NodeAddedRemoved_CallbackFunc(MObject & node, void *clientData) {
+			Instance().invalidate();
+		}
+
+		void StrandIndex::MSceneMessage_Invalidate_CallbackFunc(void *clientData) {
+			Instance().invalidate();
+		}
+	}
+}
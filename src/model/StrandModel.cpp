@@ -6,23 +6,33 @@
  */
 
 #include <model/Strand.h>
+#include <model/StrandIndex.h>
 
 #include <Utility.h>
 
 namespace Helix {
 	namespace Model {
 		bool Strand::contains_base(Base & base, MStatus & status) {
-			ForwardIterator it = forward_begin();
-			if (find_itref_nonconst(it, forward_end(), base) != forward_end())
-				return true;
-
-			if (it.loop())
-				return false;
-
-			return find_nonconst(++reverse_begin(), reverse_end(), base) != reverse_end();
+			return contains_base(static_cast<const Base &>(base), status);
 		}
 
 		bool Strand::contains_base(const Base & base, MStatus & status) {
+			/*
+			 * The strand index knows which strand every base belongs to. If connections were changed since it was built, walk the strand
+			 * instead: Rebuilding the whole index for every query would make commands that connect and query in turn quadratic
+			 */
+
+			StrandIndex & index(StrandIndex::Instance());
+
+			if (!index.isDirty()) {
+				StrandIndex::Entry entry, targetEntry;
+
+				if ((status = index.find(m_base, entry)) && (status = index.find(base, targetEntry)))
+					return entry.strand == targetEntry.strand;
+
+				status = MStatus::kSuccess;
+			}
+
 			ForwardIterator it = forward_begin();
 			if (find_itref_nonconst(it, forward_end(), base) != forward_end())
 				return true;
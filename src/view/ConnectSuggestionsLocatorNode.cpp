@@ -553,6 +553,7 @@ namespace Helix {
 		const MTypeId ConnectSuggestionsLocatorNode::id(CONNECT_SUGGESTIONS_LOCATOR_ID);
 		ConnectSuggestionsLocatorNode::DrawData ConnectSuggestionsLocatorNode::s_drawData;
 		std::list<ConnectSuggestionsLocatorNode::BasePair> ConnectSuggestionsLocatorNode::s_closeBasesTable;
+		ConnectSuggestionsLocatorNode::close_bases_index_t ConnectSuggestionsLocatorNode::s_closeBasesIndex;
 		ConnectSuggestionsLocatorNode::SelectedElement ConnectSuggestionsLocatorNode::s_selectedElement = { ConnectSuggestionsLocatorNode::BasePair(), 0.0, 0.0 };
 
 		MStatus ConnectSuggestionsLocatorNode::UpdateBase(Model::Base & base) {
@@ -562,14 +563,7 @@ namespace Helix {
 			 * Remove from already existing suggestions
 			 */
 
-			for(std::list<BasePair>::iterator it = s_closeBasesTable.begin(); it != s_closeBasesTable.end();) {
-				if (it->first == base || it->second == base) {
-					it->detachCallbacks();
-					it = s_closeBasesTable.erase(it);
-				}
-				else
-					++it;
-			}
+			RemoveCloseBases(base);
 
 			Model::Helix helix;
 
@@ -591,18 +585,18 @@ namespace Helix {
 			 * Store potential connections here
 			 */
 
-			MItDag it(MItDag::kDepthFirst, MFn::kTransform, &status);
+			MObjectArray bases;
 
-			if (!status) {
-				status.perror("MItDag::#ctor");
+			if (!(status = Model::Base::All(bases))) {
+				status.perror("Base::All");
 				return status;
 			}
 
-			for(; !it.isDone(); it.next()) {
+			for(unsigned int i = 0; i < bases.length(); ++i) {
 				MDagPath path;
 				
-				if (!(status = it.getPath(path))) {
-					status.perror("MItDag::getPath");
+				if (!(status = MDagPath::getAPathTo(bases[i], path))) {
+					status.perror("MDagPath::getAPathTo");
 					return status;
 				}
 
@@ -613,30 +607,23 @@ namespace Helix {
 					return status;
 				}
 
-				if (transform.typeId(&status) == HelixBase::id) {
-					/*
-					 * NOTE: Do we want suggestions between bases on the same helix?
-					 */
-
-					if (transform.parentCount() > 0 && helix == transform.parent(0, &status))
-						continue;
+				/*
+				 * NOTE: Do we want suggestions between bases on the same helix?
+				 */
 
-					MVector translation = transform.getTranslation(MSpace::kWorld, &status);
+				if (transform.parentCount() > 0 && helix == transform.parent(0, &status))
+					continue;
 
-					if(!status) {
-						status.perror("MFnTransform::getTranslation");
-						return status;
-					}
+				MVector translation = transform.getTranslation(MSpace::kWorld, &status);
 
-					if ((translation - base_translation).length() < CONNECT_SUGGESTIONS_MAX_DISTANCE) {
-						Model::Base otherBase(path);
-						s_closeBasesTable.push_back(BasePair(base, otherBase));
-					}
+				if(!status) {
+					status.perror("MFnTransform::getTranslation");
+					return status;
 				}
 
-				if (!status) {
-					status.perror("MFnDagNode::typeId");
-					return status;
+				if ((translation - base_translation).length() < CONNECT_SUGGESTIONS_MAX_DISTANCE) {
+					Model::Base otherBase(path);
+					AddCloseBases(base, otherBase);
 				}
 			}
 
@@ -912,7 +899,7 @@ namespace Helix {
 							 * Now remove this suggestion. repainting will be done below
 							 */
 
-							s_closeBasesTable.erase(std::remove(s_closeBasesTable.begin(), s_closeBasesTable.end(), s_selectedElement.bases), s_closeBasesTable.end());
+							RemoveCloseBasePair(s_selectedElement.bases);
 						}
 					}
 					else {
@@ -925,7 +912,7 @@ namespace Helix {
 							 * Now remove this suggestion. repainting will be done below
 							 */
 
-							s_closeBasesTable.erase(std::remove(s_closeBasesTable.begin(), s_closeBasesTable.end(), s_selectedElement.bases), s_closeBasesTable.end());
+							RemoveCloseBasePair(s_selectedElement.bases);
 						}
 					}
 				}
@@ -941,17 +928,6 @@ namespace Helix {
 			}
 		}
 		
-		class Condition {
-		public:
-			inline Condition(MObject & node_) : node(node_) { }
-			
-			inline bool operator() (ConnectSuggestionsLocatorNode::BasePair & pair) const {
-				return pair.first == node || pair.second == node;
-			}
-			
-			MObject node;
-		};
-
 		void MNodeMessage_closeBasesTable_base_preRemovalCallback(MObject & node, void *clientData) {
 			/*
 			 * This node is about to be deleted and it is in the list of connection suggestions.
@@ -960,9 +936,58 @@ namespace Helix {
 
 			std::cerr << "Removing all references in the suggestions table for node: " << MFnDagNode(node).fullPathName().asChar() << std::endl;
 
-			std::list<ConnectSuggestionsLocatorNode::BasePair>::iterator it;
-			
-			ConnectSuggestionsLocatorNode::s_closeBasesTable.erase(std::remove_if(ConnectSuggestionsLocatorNode::s_closeBasesTable.begin(), ConnectSuggestionsLocatorNode::s_closeBasesTable.end(), Condition(node)), ConnectSuggestionsLocatorNode::s_closeBasesTable.end());
+			ConnectSuggestionsLocatorNode::RemoveCloseBases(Model::Base(node), false);
+		}
+
+		void ConnectSuggestionsLocatorNode::AddCloseBases(Model::Base & first, Model::Base & second) {
+			std::list<BasePair>::iterator it = s_closeBasesTable.insert(s_closeBasesTable.end(), BasePair(first, second));
+
+			s_closeBasesIndex.insert(std::make_pair(first, it));
+			s_closeBasesIndex.insert(std::make_pair(second, it));
+		}
+
+		void ConnectSuggestionsLocatorNode::UnindexOtherCloseBase(const Model::Base & base, std::list<BasePair>::iterator it) {
+			const Model::Base & other = it->first == base ? it->second : it->first;
+			std::pair<close_bases_index_t::iterator, close_bases_index_t::iterator> range = s_closeBasesIndex.equal_range(other);
+
+			for (close_bases_index_t::iterator index_it = range.first; index_it != range.second; ++index_it) {
+				if (index_it->second == it) {
+					s_closeBasesIndex.erase(index_it);
+					break;
+				}
+			}
+		}
+
+		void ConnectSuggestionsLocatorNode::RemoveCloseBases(const Model::Base & base, bool detachCallbacks) {
+			std::pair<close_bases_index_t::iterator, close_bases_index_t::iterator> range = s_closeBasesIndex.equal_range(base);
+
+			for (close_bases_index_t::iterator index_it = range.first; index_it != range.second; ++index_it) {
+				std::list<BasePair>::iterator it = index_it->second;
+
+				UnindexOtherCloseBase(base, it);
+
+				if (detachCallbacks)
+					it->detachCallbacks();
+
+				s_closeBasesTable.erase(it);
+			}
+
+			s_closeBasesIndex.erase(range.first, range.second);
+		}
+
+		void ConnectSuggestionsLocatorNode::RemoveCloseBasePair(const BasePair & pair) {
+			std::pair<close_bases_index_t::iterator, close_bases_index_t::iterator> range = s_closeBasesIndex.equal_range(pair.first);
+
+			for (close_bases_index_t::iterator index_it = range.first; index_it != range.second; ++index_it) {
+				std::list<BasePair>::iterator it = index_it->second;
+
+				if (*it == pair) {
+					UnindexOtherCloseBase(pair.first, it);
+					s_closeBasesIndex.erase(index_it);
+					s_closeBasesTable.erase(it);
+					break;
+				}
+			}
 		}
 
 		ConnectSuggestionsLocatorNode::BasePair::BasePair(Model::Base & first_, Model::Base & second_) : first(first_), second(second_) {
@@ -59,7 +59,7 @@ namespace Helix {
 
 			//MModelMessage_ConnectSuggestionsLocatorNode_activeListModified(NULL);
 
-			ConnectSuggestionsLocatorNode::s_closeBasesTable.push_back(ConnectSuggestionsLocatorNode::BasePair(m_operation.m_previous_connections[0][0], m_operation.m_previous_connections[1][0]));
+			ConnectSuggestionsLocatorNode::AddCloseBases(m_operation.m_previous_connections[0][0], m_operation.m_previous_connections[1][0]);
 
 			return MStatus::kSuccess;
 		}